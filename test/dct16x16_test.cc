@@ -958,6 +958,17 @@ INSTANTIATE_TEST_SUITE_P(
     ::testing::Values(make_tuple(&vpx_fdct16x16_avx2,
                                  &vpx_idct16x16_256_add_sse2, 0, VPX_BITS_8)));
 
+INSTANTIATE_TEST_SUITE_P(
+    AVX2, Trans16x16HT,
+    ::testing::Values(make_tuple(&vp9_fht16x16_avx2, &vp9_iht16x16_256_add_sse2,
+                                 0, VPX_BITS_8),
+                      make_tuple(&vp9_fht16x16_avx2, &vp9_iht16x16_256_add_sse2,
+                                 1, VPX_BITS_8),
+                      make_tuple(&vp9_fht16x16_avx2, &vp9_iht16x16_256_add_sse2,
+                                 2, VPX_BITS_8),
+                      make_tuple(&vp9_fht16x16_avx2, &vp9_iht16x16_256_add_sse2,
+                                 3, VPX_BITS_8)));
+
 INSTANTIATE_TEST_SUITE_P(AVX2, InvTrans16x16DCT,
                          ::testing::Values(make_tuple(
                              &vpx_idct16x16_256_add_c,
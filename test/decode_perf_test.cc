@@ -71,9 +71,12 @@ const DecodePerfParam kVP9DecodePerfVectors[] = {
    power/temp/min max frame decode times/etc
  */
 
-class DecodePerfTest : public ::testing::TestWithParam<DecodePerfParam> {};
+class DecodePerfTest : public ::testing::TestWithParam<DecodePerfParam> {
+ protected:
+  void RunPerfTest(vpx_codec_flags_t flags);
+};
 
-TEST_P(DecodePerfTest, PerfTest) {
+void DecodePerfTest::RunPerfTest(vpx_codec_flags_t flags) {
   const char *const video_name = GET_PARAM(VIDEO_NAME);
   const unsigned threads = GET_PARAM(THREADS);
 
@@ -82,7 +85,7 @@ TEST_P(DecodePerfTest, PerfTest) {
 
   vpx_codec_dec_cfg_t cfg = vpx_codec_dec_cfg_t();
   cfg.threads = threads;
-  libvpx_test::VP9Decoder decoder(cfg, 0);
+  libvpx_test::VP9Decoder decoder(cfg, flags);
 
   vpx_usec_timer t;
   vpx_usec_timer_start(&t);
@@ -101,12 +104,22 @@ TEST_P(DecodePerfTest, PerfTest) {
   printf("\t\"version\" : \"%s\",\n", vpx_codec_version_str());
   printf("\t\"videoName\" : \"%s\",\n", video_name);
   printf("\t\"threadCount\" : %u,\n", threads);
+  printf("\t\"hugePages\" : %s,\n",
+         flags & VPX_CODEC_USE_HUGE_PAGES ? "true" : "false");
   printf("\t\"decodeTimeSecs\" : %f,\n", elapsed_secs);
   printf("\t\"totalFrames\" : %u,\n", frames);
   printf("\t\"framesPerSecond\" : %f\n", fps);
   printf("}\n");
 }
 
+TEST_P(DecodePerfTest, PerfTest) { RunPerfTest(0); }
+
+// Compare with PerfTest, e.g. running both under
+// perf stat -e dTLB-load-misses shows the TLB miss reduction.
+TEST_P(DecodePerfTest, HugePagesPerfTest) {
+  RunPerfTest(VPX_CODEC_USE_HUGE_PAGES);
+}
+
 INSTANTIATE_TEST_SUITE_P(VP9, DecodePerfTest,
                          ::testing::ValuesIn(kVP9DecodePerfVectors));
 
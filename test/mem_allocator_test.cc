@@ -0,0 +1,414 @@
+/*
+ *  Copyright (c) 2024 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <tuple>
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+#include "third_party/googletest/src/include/gtest/gtest.h"
+
+#include "./vpx_config.h"
+#include "vpx/vp8cx.h"
+#include "vpx/vp8dx.h"
+#include "vpx/vpx_codec.h"
+#include "vpx/vpx_decoder.h"
+#include "vpx/vpx_encoder.h"
+#include "vpx/vpx_image.h"
+
+namespace {
+
+const int kWidth = 176;
+const int kHeight = 144;
+const int kNumFrames = 8;
+
+// Keeps track of its live blocks and refuses allocations over a budget.
+class CountingAllocator {
+ public:
+  explicit CountingAllocator(size_t budget = SIZE_MAX)
+      : budget_(budget), bytes_(0), num_allocs_(0), num_refused_(0),
+        max_size_(0) {
+    allocator_.alloc_cb = Alloc;
+    allocator_.free_cb = Free;
+    allocator_.priv = this;
+  }
+  ~CountingAllocator() { EXPECT_TRUE(blocks_.empty()); }
+
+  const vpx_codec_mem_allocator_t *allocator() const { return &allocator_; }
+  size_t num_blocks() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return blocks_.size();
+  }
+  int num_allocs() const { return num_allocs_; }
+  int num_refused() const { return num_refused_; }
+  size_t max_size() const { return max_size_; }
+
+ private:
+  static void *Alloc(void *priv, size_t size, const char * /*site*/) {
+    CountingAllocator *const self = static_cast<CountingAllocator *>(priv);
+    std::lock_guard<std::mutex> lock(self->mutex_);
+    if (size > self->budget_ - self->bytes_) {
+      ++self->num_refused_;
+      return nullptr;
+    }
+    void *const mem = malloc(size);
+    if (mem == nullptr) return nullptr;
+    self->blocks_[mem] = size;
+    self->bytes_ += size;
+    ++self->num_allocs_;
+    if (size > self->max_size_) self->max_size_ = size;
+    return mem;
+  }
+
+  static void Free(void *priv, void *mem) {
+    CountingAllocator *const self = static_cast<CountingAllocator *>(priv);
+    std::lock_guard<std::mutex> lock(self->mutex_);
+    const auto it = self->blocks_.find(mem);
+    ASSERT_NE(it, self->blocks_.end());
+    self->bytes_ -= it->second;
+    self->blocks_.erase(it);
+    free(mem);
+  }
+
+  vpx_codec_mem_allocator_t allocator_;
+  const size_t budget_;
+  std::mutex mutex_;
+  std::map<void *, size_t> blocks_;
+  size_t bytes_;
+  int num_allocs_;
+  int num_refused_;
+  size_t max_size_;
+};
+
+void FillFrame(vpx_image_t *img, int frame) {
+  for (int plane = 0; plane < 3; ++plane) {
+    const int w = plane ? (kWidth + 1) >> 1 : kWidth;
+    const int h = plane ? (kHeight + 1) >> 1 : kHeight;
+    for (int r = 0; r < h; ++r) {
+      for (int c = 0; c < w; ++c) {
+        img->planes[plane][r * img->stride[plane] + c] =
+            static_cast<unsigned char>((r + 2 * c + 3 * frame) * (plane + 1));
+      }
+    }
+  }
+}
+
+void InitEncoder(vpx_codec_ctx_t *enc) {
+  vpx_codec_enc_cfg_t cfg;
+  ASSERT_EQ(vpx_codec_enc_config_default(vpx_codec_vp9_cx(), &cfg, 0),
+            VPX_CODEC_OK);
+  cfg.g_w = kWidth;
+  cfg.g_h = kHeight;
+  cfg.g_threads = 4;
+  cfg.g_lag_in_frames = 0;
+  ASSERT_EQ(vpx_codec_enc_init(enc, vpx_codec_vp9_cx(), &cfg, 0),
+            VPX_CODEC_OK);
+  ASSERT_EQ(vpx_codec_control(enc, VP8E_SET_CPUUSED, 6), VPX_CODEC_OK);
+  ASSERT_EQ(vpx_codec_control(enc, VP9E_SET_TILE_COLUMNS, 2), VPX_CODEC_OK);
+  ASSERT_EQ(vpx_codec_control(enc, VP9E_SET_ROW_MT, 1), VPX_CODEC_OK);
+}
+
+void ExpectConsistentStats(const vpx_codec_ctx_t *ctx, size_t num_blocks) {
+  vpx_codec_mem_stats_t stats;
+  ASSERT_EQ(vpx_codec_get_mem_stats(ctx, &stats), VPX_CODEC_OK);
+  EXPECT_GT(stats.bytes_in_use, 0u);
+  EXPECT_GE(stats.peak_bytes_in_use, stats.bytes_in_use);
+  EXPECT_EQ(stats.num_allocs - stats.num_frees, num_blocks);
+  EXPECT_EQ(stats.num_failed_allocs, 0u);
+}
+
+TEST(MemAllocatorTest, InvalidParams) {
+  vpx_codec_mem_allocator_t allocator = {};
+  vpx_codec_mem_stats_t stats;
+  vpx_codec_ctx_t ctx = {};
+  allocator.alloc_cb = [](void *, size_t size, const char *) {
+    return malloc(size);
+  };
+  EXPECT_EQ(vpx_codec_set_mem_allocator(&allocator), VPX_CODEC_INVALID_PARAM);
+  EXPECT_EQ(vpx_codec_set_mem_allocator(nullptr), VPX_CODEC_OK);
+  EXPECT_EQ(vpx_codec_get_mem_stats(nullptr, &stats), VPX_CODEC_INVALID_PARAM);
+  EXPECT_EQ(vpx_codec_get_mem_stats(&ctx, nullptr), VPX_CODEC_INVALID_PARAM);
+  EXPECT_EQ(vpx_codec_get_mem_stats(&ctx, &stats), VPX_CODEC_ERROR);
+}
+
+TEST(MemAllocatorTest, DefaultAllocatorKeepsStats) {
+  vpx_codec_ctx_t dec;
+  vpx_codec_mem_stats_t stats;
+  ASSERT_EQ(vpx_codec_set_mem_allocator(nullptr), VPX_CODEC_OK);
+  ASSERT_EQ(vpx_codec_dec_init(&dec, vpx_codec_vp9_dx(), nullptr, 0),
+            VPX_CODEC_OK);
+  ASSERT_EQ(vpx_codec_get_mem_stats(&dec, &stats), VPX_CODEC_OK);
+  EXPECT_GT(stats.num_allocs, 0u);
+  EXPECT_GT(stats.bytes_in_use, 0u);
+  EXPECT_EQ(vpx_codec_destroy(&dec), VPX_CODEC_OK);
+}
+
+// Each instance gets its memory, including what its worker threads allocate,
+// from the allocator it was initialized with, and gives all of it back.
+TEST(MemAllocatorTest, InstancesUseTheirOwnAllocator) {
+  CountingAllocator enc_allocator;
+  CountingAllocator dec_allocator;
+  vpx_codec_ctx_t enc;
+  vpx_codec_ctx_t dec;
+  vpx_codec_dec_cfg_t dec_cfg = vpx_codec_dec_cfg_t();
+  dec_cfg.threads = 4;
+
+  ASSERT_EQ(vpx_codec_set_mem_allocator(enc_allocator.allocator()),
+            VPX_CODEC_OK);
+  ASSERT_NO_FATAL_FAILURE(InitEncoder(&enc));
+  ASSERT_EQ(vpx_codec_set_mem_allocator(dec_allocator.allocator()),
+            VPX_CODEC_OK);
+  ASSERT_EQ(vpx_codec_dec_init(&dec, vpx_codec_vp9_dx(), &dec_cfg, 0),
+            VPX_CODEC_OK);
+  ASSERT_EQ(vpx_codec_set_mem_allocator(nullptr), VPX_CODEC_OK);
+  const size_t enc_init_blocks = enc_allocator.num_blocks();
+  EXPECT_GT(enc_init_blocks, 0u);
+
+  vpx_image_t img;
+  ASSERT_NE(vpx_img_alloc(&img, VPX_IMG_FMT_I420, kWidth, kHeight, 1),
+            nullptr);
+  for (int i = 0; i < kNumFrames; ++i) {
+    FillFrame(&img, i);
+    ASSERT_EQ(vpx_codec_encode(&enc, &img, i, 1, 0, VPX_DL_REALTIME),
+              VPX_CODEC_OK);
+    vpx_codec_iter_t iter = nullptr;
+    const vpx_codec_cx_pkt_t *pkt;
+    while ((pkt = vpx_codec_get_cx_data(&enc, &iter)) != nullptr) {
+      if (pkt->kind != VPX_CODEC_CX_FRAME_PKT) continue;
+      ASSERT_EQ(vpx_codec_decode(
+                    &dec, static_cast<const uint8_t *>(pkt->data.frame.buf),
+                    static_cast<unsigned int>(pkt->data.frame.sz), nullptr, 0),
+                VPX_CODEC_OK);
+      vpx_codec_iter_t dec_iter = nullptr;
+      EXPECT_NE(vpx_codec_get_frame(&dec, &dec_iter), nullptr);
+    }
+  }
+  vpx_img_free(&img);
+
+  EXPECT_GT(enc_allocator.num_blocks(), enc_init_blocks);
+  EXPECT_GT(dec_allocator.num_blocks(), 0u);
+  ExpectConsistentStats(&enc, enc_allocator.num_blocks());
+  ExpectConsistentStats(&dec, dec_allocator.num_blocks());
+
+  EXPECT_EQ(vpx_codec_destroy(&enc), VPX_CODEC_OK);
+  EXPECT_EQ(enc_allocator.num_blocks(), 0u);
+  EXPECT_GT(dec_allocator.num_blocks(), 0u);
+  EXPECT_EQ(vpx_codec_destroy(&dec), VPX_CODEC_OK);
+  EXPECT_EQ(dec_allocator.num_blocks(), 0u);
+}
+
+// Refused allocations make the codec calls fail cleanly.
+TEST(MemAllocatorTest, EnforcesBudget) {
+  CountingAllocator enc_allocator(64 * 1024);
+  vpx_codec_ctx_t enc;
+  vpx_codec_enc_cfg_t cfg;
+  ASSERT_EQ(vpx_codec_enc_config_default(vpx_codec_vp9_cx(), &cfg, 0),
+            VPX_CODEC_OK);
+  ASSERT_EQ(vpx_codec_set_mem_allocator(enc_allocator.allocator()),
+            VPX_CODEC_OK);
+  EXPECT_EQ(vpx_codec_enc_init(&enc, vpx_codec_vp9_cx(), &cfg, 0),
+            VPX_CODEC_MEM_ERROR);
+  EXPECT_GT(enc_allocator.num_refused(), 0);
+  EXPECT_EQ(enc_allocator.num_blocks(), 0u);
+
+  CountingAllocator dec_allocator(64 * 1024);
+  vpx_codec_ctx_t dec;
+  ASSERT_EQ(vpx_codec_set_mem_allocator(dec_allocator.allocator()),
+            VPX_CODEC_OK);
+  ASSERT_EQ(vpx_codec_dec_init(&dec, vpx_codec_vp9_dx(), nullptr, 0),
+            VPX_CODEC_OK);
+  ASSERT_EQ(vpx_codec_set_mem_allocator(nullptr), VPX_CODEC_OK);
+
+  // Get a key frame from an encoder without a budget.
+  vpx_image_t img;
+  ASSERT_NO_FATAL_FAILURE(InitEncoder(&enc));
+  ASSERT_NE(vpx_img_alloc(&img, VPX_IMG_FMT_I420, kWidth, kHeight, 1),
+            nullptr);
+  FillFrame(&img, 0);
+  ASSERT_EQ(vpx_codec_encode(&enc, &img, 0, 1, 0, VPX_DL_REALTIME),
+            VPX_CODEC_OK);
+  vpx_img_free(&img);
+  vpx_codec_iter_t iter = nullptr;
+  const vpx_codec_cx_pkt_t *const pkt = vpx_codec_get_cx_data(&enc, &iter);
+  ASSERT_NE(pkt, nullptr);
+  ASSERT_EQ(pkt->kind, VPX_CODEC_CX_FRAME_PKT);
+
+  EXPECT_NE(vpx_codec_decode(&dec,
+                             static_cast<const uint8_t *>(pkt->data.frame.buf),
+                             static_cast<unsigned int>(pkt->data.frame.sz),
+                             nullptr, 0),
+            VPX_CODEC_OK);
+  vpx_codec_mem_stats_t stats;
+  ASSERT_EQ(vpx_codec_get_mem_stats(&dec, &stats), VPX_CODEC_OK);
+  EXPECT_GT(stats.num_failed_allocs, 0u);
+  EXPECT_LE(stats.peak_bytes_in_use, 64u * 1024);
+
+  EXPECT_EQ(vpx_codec_destroy(&enc), VPX_CODEC_OK);
+  EXPECT_EQ(vpx_codec_destroy(&dec), VPX_CODEC_OK);
+  EXPECT_EQ(dec_allocator.num_blocks(), 0u);
+}
+
+// Huge pages only change where the frame buffers are placed.
+TEST(MemAllocatorTest, HugePagesKeepOutput) {
+  const int kLargeWidth = 1920;
+  const int kLargeHeight = 1080;
+  CountingAllocator allocators[2];
+  vpx_codec_ctx_t enc[2];
+  vpx_codec_ctx_t dec[2];
+  vpx_codec_enc_cfg_t cfg;
+  ASSERT_EQ(vpx_codec_enc_config_default(vpx_codec_vp9_cx(), &cfg, 0),
+            VPX_CODEC_OK);
+  cfg.g_w = kLargeWidth;
+  cfg.g_h = kLargeHeight;
+  cfg.g_lag_in_frames = 0;
+  for (int i = 0; i < 2; ++i) {
+    const vpx_codec_flags_t flags = i ? VPX_CODEC_USE_HUGE_PAGES : 0;
+    ASSERT_EQ(vpx_codec_set_mem_allocator(allocators[i].allocator()),
+              VPX_CODEC_OK);
+    ASSERT_EQ(vpx_codec_dec_init(&dec[i], vpx_codec_vp9_dx(), nullptr, flags),
+              VPX_CODEC_OK);
+    ASSERT_EQ(vpx_codec_set_mem_allocator(nullptr), VPX_CODEC_OK);
+    ASSERT_EQ(vpx_codec_enc_init(&enc[i], vpx_codec_vp9_cx(), &cfg, flags),
+              VPX_CODEC_OK);
+    ASSERT_EQ(vpx_codec_control(&enc[i], VP8E_SET_CPUUSED, 8), VPX_CODEC_OK);
+  }
+
+  vpx_image_t img;
+  ASSERT_NE(vpx_img_alloc(&img, VPX_IMG_FMT_I420, kLargeWidth, kLargeHeight, 1),
+            nullptr);
+  for (int frame = 0; frame < 3; ++frame) {
+    for (int plane = 0; plane < 3; ++plane) {
+      const int h = plane ? (kLargeHeight + 1) >> 1 : kLargeHeight;
+      for (int r = 0; r < h; ++r) {
+        memset(img.planes[plane] + r * img.stride[plane],
+               (r + 5 * frame) * (plane + 1), img.stride[plane]);
+      }
+    }
+    const vpx_image_t *decoded[2];
+    for (int i = 0; i < 2; ++i) {
+      ASSERT_EQ(vpx_codec_encode(&enc[i], &img, frame, 1, 0, VPX_DL_REALTIME),
+                VPX_CODEC_OK);
+      vpx_codec_iter_t iter = nullptr;
+      const vpx_codec_cx_pkt_t *const pkt =
+          vpx_codec_get_cx_data(&enc[i], &iter);
+      ASSERT_NE(pkt, nullptr);
+      ASSERT_EQ(vpx_codec_decode(
+                    &dec[i], static_cast<const uint8_t *>(pkt->data.frame.buf),
+                    static_cast<unsigned int>(pkt->data.frame.sz), nullptr, 0),
+                VPX_CODEC_OK);
+      iter = nullptr;
+      decoded[i] = vpx_codec_get_frame(&dec[i], &iter);
+      ASSERT_NE(decoded[i], nullptr);
+    }
+    for (int plane = 0; plane < 3; ++plane) {
+      const int w = plane ? (kLargeWidth + 1) >> 1 : kLargeWidth;
+      const int h = plane ? (kLargeHeight + 1) >> 1 : kLargeHeight;
+      for (int r = 0; r < h; ++r) {
+        ASSERT_EQ(memcmp(decoded[0]->planes[plane] +
+                             r * decoded[0]->stride[plane],
+                         decoded[1]->planes[plane] +
+                             r * decoded[1]->stride[plane],
+                         w),
+                  0);
+      }
+    }
+  }
+  vpx_img_free(&img);
+
+#if defined(MADV_HUGEPAGE)
+  // The frame buffers of the second decoder leave room for their alignment.
+  EXPECT_GE(allocators[1].max_size(), allocators[0].max_size() + (1 << 20));
+#else
+  // Without madvise() the flag has no effect.
+  EXPECT_EQ(allocators[1].max_size(), allocators[0].max_size());
+#endif
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_EQ(vpx_codec_destroy(&enc[i]), VPX_CODEC_OK);
+    EXPECT_EQ(vpx_codec_destroy(&dec[i]), VPX_CODEC_OK);
+  }
+}
+
+// Parameters: good quality mode with lag, number of threads, and whether the
+// frames are scaled down and back up every kResizeInterval frames.
+class EncoderSteadyStateTest
+    : public ::testing::TestWithParam<std::tuple<bool, int, bool>> {};
+
+const int kResizeInterval = 5;
+
+// Once the encoder has seen every frame type, and every frame buffer in the
+// pool has been used at every frame size, it keeps reusing its buffers
+// instead of allocating new ones.
+TEST_P(EncoderSteadyStateTest, DoesNotAllocate) {
+  const bool good = std::get<0>(GetParam());
+  const int threads = std::get<1>(GetParam());
+  const bool resize = std::get<2>(GetParam());
+  const int warm_up = 10 * kResizeInterval;
+  const int num_frames = warm_up + 20;
+  vpx_codec_ctx_t enc;
+  vpx_codec_enc_cfg_t cfg;
+  ASSERT_EQ(vpx_codec_enc_config_default(vpx_codec_vp9_cx(), &cfg, 0),
+            VPX_CODEC_OK);
+  cfg.g_w = kWidth;
+  cfg.g_h = kHeight;
+  cfg.g_threads = threads;
+  cfg.g_lag_in_frames = good ? 25 : 0;
+  cfg.rc_end_usage = good ? VPX_VBR : VPX_CBR;
+  ASSERT_EQ(vpx_codec_set_mem_allocator(nullptr), VPX_CODEC_OK);
+  ASSERT_EQ(vpx_codec_enc_init(&enc, vpx_codec_vp9_cx(), &cfg, 0),
+            VPX_CODEC_OK);
+  ASSERT_EQ(vpx_codec_control(&enc, VP8E_SET_CPUUSED, good ? 4 : 7),
+            VPX_CODEC_OK);
+  ASSERT_EQ(vpx_codec_control(&enc, VP9E_SET_ROW_MT, threads > 1),
+            VPX_CODEC_OK);
+
+  vpx_image_t img;
+  ASSERT_NE(vpx_img_alloc(&img, VPX_IMG_FMT_I420, kWidth, kHeight, 1),
+            nullptr);
+  vpx_codec_mem_stats_t stats = vpx_codec_mem_stats_t();
+  for (int i = 0; i < num_frames; ++i) {
+    if (resize && i % kResizeInterval == 0) {
+      const VPX_SCALING_MODE mode =
+          (i / kResizeInterval) & 1 ? VP8E_ONETWO : VP8E_NORMAL;
+      vpx_scaling_mode_t scaling_mode = { mode, mode };
+      ASSERT_EQ(vpx_codec_control(&enc, VP8E_SET_SCALEMODE, &scaling_mode),
+                VPX_CODEC_OK);
+    }
+    if (i == warm_up) {
+      ASSERT_EQ(vpx_codec_get_mem_stats(&enc, &stats), VPX_CODEC_OK);
+    }
+    FillFrame(&img, i);
+    ASSERT_EQ(vpx_codec_encode(&enc, &img, i, 1, 0,
+                               good ? VPX_DL_GOOD_QUALITY : VPX_DL_REALTIME),
+              VPX_CODEC_OK);
+    vpx_codec_iter_t iter = nullptr;
+    while (vpx_codec_get_cx_data(&enc, &iter) != nullptr) {
+    }
+  }
+  vpx_img_free(&img);
+
+  vpx_codec_mem_stats_t end_stats;
+  ASSERT_EQ(vpx_codec_get_mem_stats(&enc, &end_stats), VPX_CODEC_OK);
+  EXPECT_EQ(end_stats.num_allocs, stats.num_allocs);
+  EXPECT_EQ(end_stats.num_frees, stats.num_frees);
+  EXPECT_EQ(vpx_codec_destroy(&enc), VPX_CODEC_OK);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    VP9, EncoderSteadyStateTest,
+    ::testing::Values(std::make_tuple(false, 1, false),
+                      std::make_tuple(false, 4, true),
+                      std::make_tuple(true, 1, false),
+                      std::make_tuple(true, 4, true)));
+
+}  // namespace
@@ -332,6 +332,13 @@ INSTANTIATE_TEST_SUITE_P(
                       make_tuple(8, 4, &vp8_sixtap_predict8x4_ssse3),
                       make_tuple(4, 4, &vp8_sixtap_predict4x4_ssse3)));
 #endif
+#if HAVE_AVX2
+INSTANTIATE_TEST_SUITE_P(
+    AVX2, SixtapPredictTest,
+    ::testing::Values(make_tuple(16, 16, &vp8_sixtap_predict16x16_avx2),
+                      make_tuple(8, 8, &vp8_sixtap_predict8x8_avx2),
+                      make_tuple(8, 4, &vp8_sixtap_predict8x4_avx2)));
+#endif
 #if HAVE_MSA
 INSTANTIATE_TEST_SUITE_P(
     MSA, SixtapPredictTest,
@@ -203,6 +203,13 @@ INSTANTIATE_TEST_SUITE_P(
                                  &vp8_regular_quantize_b_c)));
 #endif  // HAVE_SSE4_1
 
+#if HAVE_AVX2
+INSTANTIATE_TEST_SUITE_P(
+    AVX2, QuantizeTest,
+    ::testing::Values(make_tuple(&vp8_fast_quantize_b_avx2,
+                                 &vp8_fast_quantize_b_c)));
+#endif  // HAVE_AVX2
+
 #if HAVE_NEON
 INSTANTIATE_TEST_SUITE_P(NEON, QuantizeTest,
                          ::testing::Values(make_tuple(&vp8_fast_quantize_b_neon,
@@ -64,6 +64,7 @@ typedef TestParams<SadSkipMxNx4Func> SadSkipMxNx4Param;
 typedef void (*SadMxNx8Func)(const uint8_t *src_ptr, int src_stride,
                              const uint8_t *ref_ptr, int ref_stride,
                              unsigned int *sad_array);
+typedef TestParams<SadMxNx8Func> SadMxNx8Param;
 
 using libvpx_test::ACMRandom;
 
@@ -353,6 +354,44 @@ class SADSkipx4Test : public SADTestBase<SadMxNx4Param> {
   }
 };
 
+class SADx8Test : public SADTestBase<SadMxNx8Param> {
+ public:
+  SADx8Test() : SADTestBase(GetParam()) {}
+
+ protected:
+  // The 8 references are GetReference(0) shifted right by 0..7 pixels, so
+  // each fill below covers params_.width + 7 columns.
+  void FillRef(uint16_t fill_constant) {
+    const int tmp_width = params_.width;
+    params_.width += 7;
+    FillConstant(GetReference(0), reference_stride_, fill_constant);
+    params_.width = tmp_width;
+  }
+
+  void FillRefRandom() {
+    FillRandomWH(GetReference(0), reference_stride_, params_.width + 7,
+                 params_.height);
+  }
+
+  void SADs(unsigned int *results) const {
+    ASM_REGISTER_STATE_CHECK(params_.func(source_data_, source_stride_,
+                                          GetReference(0), reference_stride_,
+                                          results));
+  }
+
+  void CheckSADs() const {
+    uint32_t reference_sad;
+    DECLARE_ALIGNED(kDataAlignment, uint32_t, exp_sad[8]);
+
+    SADs(exp_sad);
+    for (int offset = 0; offset < 8; ++offset) {
+      reference_sad = ReferenceSAD(GetBlockRefOffset(0) + offset);
+
+      EXPECT_EQ(reference_sad, exp_sad[offset]) << "offset " << offset;
+    }
+  }
+};
+
 class SADTest : public AbstractBench, public SADTestBase<SadMxNParam> {
  public:
   SADTest() : SADTestBase(GetParam()) {}
@@ -696,6 +735,63 @@ TEST_P(SADx4Test, DISABLED_Speed) {
   reference_stride_ = tmp_stride;
 }
 
+TEST_P(SADx8Test, MaxRef) {
+  FillConstant(source_data_, source_stride_, 0);
+  FillRef(mask_);
+  CheckSADs();
+}
+
+TEST_P(SADx8Test, MaxSrc) {
+  FillConstant(source_data_, source_stride_, mask_);
+  FillRef(0);
+  CheckSADs();
+}
+
+TEST_P(SADx8Test, ShortRef) {
+  int tmp_stride = reference_stride_;
+  reference_stride_ >>= 1;
+  FillRandom(source_data_, source_stride_);
+  FillRefRandom();
+  CheckSADs();
+  reference_stride_ = tmp_stride;
+}
+
+TEST_P(SADx8Test, UnalignedRef) {
+  int tmp_stride = reference_stride_;
+  reference_stride_ -= 1;
+  FillRandom(source_data_, source_stride_);
+  FillRefRandom();
+  CheckSADs();
+  reference_stride_ = tmp_stride;
+}
+
+TEST_P(SADx8Test, ShortSrc) {
+  int tmp_stride = source_stride_;
+  source_stride_ >>= 1;
+  FillRandom(source_data_, source_stride_);
+  FillRefRandom();
+  CheckSADs();
+  source_stride_ = tmp_stride;
+}
+
+TEST_P(SADx8Test, DISABLED_Speed) {
+  FillRandom(source_data_, source_stride_);
+  FillRefRandom();
+  const int kCountSpeedTestBlock = 500000000 / (params_.width * params_.height);
+  DECLARE_ALIGNED(kDataAlignment, uint32_t, exp_sad[8]);
+  vpx_usec_timer timer;
+  vpx_usec_timer_start(&timer);
+  for (int i = 0; i < kCountSpeedTestBlock; ++i) {
+    SADs(exp_sad);
+  }
+  vpx_usec_timer_mark(&timer);
+  CheckSADs();
+  const int elapsed_time =
+      static_cast<int>(vpx_usec_timer_elapsed(&timer) / 1000);
+  printf("sad%dx%dx8 time: %5d ms\n", params_.width, params_.height,
+         elapsed_time);
+}
+
 TEST_P(SADSkipx4Test, MaxRef) {
   FillConstant(source_data_, source_stride_, 0);
   FillConstant(GetReference(0), reference_stride_, mask_);
@@ -1072,6 +1168,23 @@ const SadSkipMxNx4Param skip_x4d_c_tests[] = {
 INSTANTIATE_TEST_SUITE_P(C, SADSkipx4Test,
                          ::testing::ValuesIn(skip_x4d_c_tests));
 
+const SadMxNx8Param x8_c_tests[] = {
+  SadMxNx8Param(64, 64, &vpx_sad64x64x8_c),
+  SadMxNx8Param(64, 32, &vpx_sad64x32x8_c),
+  SadMxNx8Param(32, 64, &vpx_sad32x64x8_c),
+  SadMxNx8Param(32, 32, &vpx_sad32x32x8_c),
+  SadMxNx8Param(32, 16, &vpx_sad32x16x8_c),
+  SadMxNx8Param(16, 32, &vpx_sad16x32x8_c),
+  SadMxNx8Param(16, 16, &vpx_sad16x16x8_c),
+  SadMxNx8Param(16, 8, &vpx_sad16x8x8_c),
+  SadMxNx8Param(8, 16, &vpx_sad8x16x8_c),
+  SadMxNx8Param(8, 8, &vpx_sad8x8x8_c),
+  SadMxNx8Param(8, 4, &vpx_sad8x4x8_c),
+  SadMxNx8Param(4, 8, &vpx_sad4x8x8_c),
+  SadMxNx8Param(4, 4, &vpx_sad4x4x8_c),
+};
+INSTANTIATE_TEST_SUITE_P(C, SADx8Test, ::testing::ValuesIn(x8_c_tests));
+
 //------------------------------------------------------------------------------
 // ARM functions
 #if HAVE_NEON
@@ -1706,6 +1819,26 @@ INSTANTIATE_TEST_SUITE_P(SSE2, SADSkipx4Test,
 // Only functions are x3, which do not have tests.
 #endif  // HAVE_SSSE3
 
+#if HAVE_SSE4_1
+const SadMxNx8Param x8_sse4_1_tests[] = {
+  SadMxNx8Param(64, 64, &vpx_sad64x64x8_sse4_1),
+  SadMxNx8Param(64, 32, &vpx_sad64x32x8_sse4_1),
+  SadMxNx8Param(32, 64, &vpx_sad32x64x8_sse4_1),
+  SadMxNx8Param(32, 32, &vpx_sad32x32x8_sse4_1),
+  SadMxNx8Param(32, 16, &vpx_sad32x16x8_sse4_1),
+  SadMxNx8Param(16, 32, &vpx_sad16x32x8_sse4_1),
+  SadMxNx8Param(16, 16, &vpx_sad16x16x8_sse4_1),
+  SadMxNx8Param(16, 8, &vpx_sad16x8x8_sse4_1),
+  SadMxNx8Param(8, 16, &vpx_sad8x16x8_sse4_1),
+  SadMxNx8Param(8, 8, &vpx_sad8x8x8_sse4_1),
+  SadMxNx8Param(8, 4, &vpx_sad8x4x8_sse4_1),
+  SadMxNx8Param(4, 8, &vpx_sad4x8x8_sse4_1),
+  SadMxNx8Param(4, 4, &vpx_sad4x4x8_sse4_1),
+};
+INSTANTIATE_TEST_SUITE_P(SSE4_1, SADx8Test,
+                         ::testing::ValuesIn(x8_sse4_1_tests));
+#endif  // HAVE_SSE4_1
+
 #if HAVE_AVX2
 const SadMxNParam avx2_tests[] = {
   SadMxNParam(64, 64, &vpx_sad64x64_avx2),
@@ -61,6 +61,7 @@ LIBVPX_TEST_SRCS-$(CONFIG_VP9_ENCODER) += decode_corrupted.cc
 LIBVPX_TEST_SRCS-$(CONFIG_VP9_ENCODER) += vp9_ethread_test.cc
 LIBVPX_TEST_SRCS-$(CONFIG_VP9_ENCODER) += vp9_motion_vector_test.cc
 LIBVPX_TEST_SRCS-$(CONFIG_VP9_ENCODER) += level_test.cc
+LIBVPX_TEST_SRCS-$(CONFIG_VP9_ENCODER) += mem_allocator_test.cc
 LIBVPX_TEST_SRCS-$(CONFIG_VP9_ENCODER) += svc_datarate_test.cc
 LIBVPX_TEST_SRCS-$(CONFIG_VP9_ENCODER) += svc_test.cc
 LIBVPX_TEST_SRCS-$(CONFIG_VP9_ENCODER) += svc_test.h
@@ -138,16 +139,18 @@ endif
 LIBVPX_TEST_SRCS-$(CONFIG_POSTPROC)    += add_noise_test.cc
 LIBVPX_TEST_SRCS-$(CONFIG_POSTPROC)    += pp_filter_test.cc
 LIBVPX_TEST_SRCS-$(CONFIG_VP8_DECODER) += vp8_decrypt_test.cc
-ifneq (, $(filter yes, $(HAVE_SSE2) $(HAVE_SSSE3) $(HAVE_SSE4_1) $(HAVE_NEON) \
-                       $(HAVE_MSA) $(HAVE_MMI)))
+ifneq (, $(filter yes, $(HAVE_SSE2) $(HAVE_SSSE3) $(HAVE_SSE4_1) $(HAVE_AVX2) \
+                       $(HAVE_NEON) $(HAVE_MSA) $(HAVE_MMI)))
 LIBVPX_TEST_SRCS-$(CONFIG_VP8_ENCODER) += quantize_test.cc
 endif
 LIBVPX_TEST_SRCS-$(CONFIG_VP8_ENCODER) += set_roi.cc
 LIBVPX_TEST_SRCS-$(CONFIG_VP8_ENCODER) += variance_test.cc
 LIBVPX_TEST_SRCS-$(CONFIG_VP8_ENCODER) += vp8_fdct4x4_test.cc
+LIBVPX_TEST_SRCS-$(CONFIG_VP8_ENCODER) += vp8_block_error_test.cc
 
 LIBVPX_TEST_SRCS-yes                   += idct_test.cc
 LIBVPX_TEST_SRCS-yes                   += predict_test.cc
+LIBVPX_TEST_SRCS-yes                   += vp8_loopfilter_test.cc
 LIBVPX_TEST_SRCS-yes                   += vpx_scale_test.cc
 LIBVPX_TEST_SRCS-yes                   += vpx_scale_test.h
 
@@ -168,13 +171,27 @@ LIBVPX_TEST_SRCS-yes                   += partial_idct_test.cc
 LIBVPX_TEST_SRCS-yes                   += superframe_test.cc
 LIBVPX_TEST_SRCS-yes                   += tile_independence_test.cc
 LIBVPX_TEST_SRCS-yes                   += vp9_boolcoder_test.cc
+LIBVPX_TEST_SRCS-yes                   += vp9_decode_region_test.cc
 LIBVPX_TEST_SRCS-yes                   += vp9_encoder_parms_get_to_decoder.cc
+LIBVPX_TEST_SRCS-yes                   += vp9_fragments_test.cc
+LIBVPX_TEST_SRCS-yes                   += vp9_min_border_test.cc
+LIBVPX_TEST_SRCS-yes                   += vp9_mode_info_test.cc
+LIBVPX_TEST_SRCS-yes                   += vp9_motion_hints_test.cc
+LIBVPX_TEST_SRCS-yes                   += vp9_put_slice_test.cc
+LIBVPX_TEST_SRCS-yes                   += vp9_rd_cost_cache_test.cc
 LIBVPX_TEST_SRCS-yes                   += vp9_roi_test.cc
+LIBVPX_TEST_SRCS-yes                   += vp9_sb_ref_sad_test.cc
+LIBVPX_TEST_SRCS-yes                   += vp9_semi_planar_test.cc
+LIBVPX_TEST_SRCS-yes                   += vp9_skip_frames_test.cc
+LIBVPX_TEST_SRCS-yes                   += vp9_skip_static_sb_test.cc
+LIBVPX_TEST_SRCS-yes                   += vp9_speed_control_test.cc
+LIBVPX_TEST_SRCS-yes                   += vp9_reduced_decode_test.cc
 endif
 
 LIBVPX_TEST_SRCS-yes                   += convolve_test.cc
 LIBVPX_TEST_SRCS-yes                   += lpf_test.cc
 LIBVPX_TEST_SRCS-yes                   += vp9_intrapred_test.cc
+LIBVPX_TEST_SRCS-yes                   += vp9_merge_probs_test.cc
 LIBVPX_TEST_SRCS-$(CONFIG_VP9_DECODER) += vp9_decrypt_test.cc
 LIBVPX_TEST_SRCS-$(CONFIG_VP9_DECODER) += vp9_thread_test.cc
 LIBVPX_TEST_SRCS-$(CONFIG_VP9_ENCODER) += avg_test.cc
@@ -194,6 +211,10 @@ LIBVPX_TEST_SRCS-$(CONFIG_VP9_ENCODER) += variance_test.cc
 ifneq (, $(filter yes, $(HAVE_SSE2) $(HAVE_AVX2) $(HAVE_NEON)))
 LIBVPX_TEST_SRCS-$(CONFIG_VP9_ENCODER) += vp9_block_error_test.cc
 endif
+ifneq (, $(filter yes, $(HAVE_AVX2) $(HAVE_NEON)))
+LIBVPX_TEST_SRCS-$(CONFIG_VP9_ENCODER) += vp9_nn_predict_test.cc
+endif
+LIBVPX_TEST_SRCS-$(CONFIG_VP9_ENCODER) += vp9_hash_motion_test.cc
 LIBVPX_TEST_SRCS-$(CONFIG_VP9_ENCODER) += vp9_quantize_test.cc
 LIBVPX_TEST_SRCS-$(CONFIG_VP9_ENCODER) += vp9_subtract_test.cc
 
@@ -260,6 +260,28 @@ class RandomVideoSource : public DummyVideoSource {
   int seed_;
 };
 
+// A texture moving diagonally, two pixels right and one down per frame.
+class MovingTextureVideoSource : public DummyVideoSource {
+ protected:
+  void FillFrame() override {
+    if (!img_) return;
+    for (int plane = 0; plane < 3; ++plane) {
+      const int shift = plane ? 1 : 0;
+      const int w = (img_->d_w + shift) >> shift;
+      const int h = (img_->d_h + shift) >> shift;
+      for (int r = 0; r < h; ++r) {
+        uint8_t *const row = img_->planes[plane] + r * img_->stride[plane];
+        for (int c = 0; c < w; ++c) {
+          const int x = c + 2 * static_cast<int>(frame_);
+          const int y = r + static_cast<int>(frame_);
+          row[c] = static_cast<uint8_t>(plane ? 128 + ((x / 8 + y / 8) & 15)
+                                              : (x * 7) ^ (y * 13));
+        }
+      }
+    }
+  }
+};
+
 // Abstract base class for test video sources, which provide a stream of
 // decompressed images to the decoder.
 class CompressedVideoSource {
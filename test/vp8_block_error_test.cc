@@ -0,0 +1,164 @@
+/*
+ *  Copyright (c) 2024 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string.h>
+
+#include "third_party/googletest/src/include/gtest/gtest.h"
+
+#include "./vp8_rtcd.h"
+#include "./vpx_config.h"
+#include "test/acm_random.h"
+#include "test/clear_system_state.h"
+#include "test/register_state_check.h"
+#include "vp8/common/blockd.h"
+#include "vp8/encoder/block.h"
+#include "vp8/encoder/encodeframe.h"
+#include "vpx_mem/vpx_mem.h"
+
+using libvpx_test::ACMRandom;
+
+namespace {
+
+const int kNumIterations = 1000;
+
+// The largest coefficient magnitudes for which the error of the worst case
+// still fits an int: 16 coefficients for one block, which may be the Y2 block,
+// and 256 for the Y or the U and V blocks of a macroblock.
+const int kMaxBlockCoeff = (1 << 13) - 1;
+const int kMaxMbCoeff = (1 << 11) - 1;
+
+typedef int (*BlockErrorFunc)(short *coeff, short *dqcoeff);
+typedef int (*MbBlockErrorFunc)(MACROBLOCK *mb, int dc);
+typedef int (*MbUvErrorFunc)(MACROBLOCK *mb);
+
+// Fills |n| coefficients and their dequantized values, which have the same
+// sign as they do after quantization. In the first iterations all the values
+// are 0 or +/-|max_val|.
+void FillCoeffs(ACMRandom *rnd, int iteration, int max_val, short *coeff,
+                short *dqcoeff, int n) {
+  for (int j = 0; j < n; ++j) {
+    if (iteration < 8) {
+      const int val = iteration < 4 ? max_val : -max_val;
+      coeff[j] = (iteration & 1) ? val : 0;
+      dqcoeff[j] = (iteration & 2) ? val : 0;
+    } else if (rnd->Rand8() & 1) {
+      coeff[j] = rnd->PseudoUniform(max_val + 1);
+      dqcoeff[j] = rnd->PseudoUniform(max_val + 1);
+    } else {
+      coeff[j] = -rnd->PseudoUniform(max_val + 1);
+      dqcoeff[j] = -rnd->PseudoUniform(max_val + 1);
+    }
+  }
+}
+
+class VP8BlockErrorTest : public ::testing::TestWithParam<BlockErrorFunc> {
+ public:
+  void TearDown() override { libvpx_test::ClearSystemState(); }
+};
+GTEST_ALLOW_UNINSTANTIATED_PARAMETERIZED_TEST(VP8BlockErrorTest);
+
+TEST_P(VP8BlockErrorTest, MatchesC) {
+  ACMRandom rnd(ACMRandom::DeterministicSeed());
+  DECLARE_ALIGNED(16, short, coeff[16]);
+  DECLARE_ALIGNED(16, short, dqcoeff[16]);
+  for (int i = 0; i < kNumIterations; ++i) {
+    FillCoeffs(&rnd, i, kMaxBlockCoeff, coeff, dqcoeff, 16);
+    const int ref = vp8_block_error_c(coeff, dqcoeff);
+    int error;
+    ASM_REGISTER_STATE_CHECK(error = GetParam()(coeff, dqcoeff));
+    ASSERT_EQ(ref, error) << "iteration " << i;
+  }
+}
+
+// Holds a MACROBLOCK with its block pointers set up, as the encoder has it.
+class VP8MbErrorTestBase {
+ public:
+  VP8MbErrorTestBase() : mb_(nullptr) {}
+
+  virtual ~VP8MbErrorTestBase() {
+    vpx_free(mb_);
+    libvpx_test::ClearSystemState();
+  }
+
+ protected:
+  void AllocMacroblock() {
+    mb_ = reinterpret_cast<MACROBLOCK *>(vpx_memalign(32, sizeof(*mb_)));
+    ASSERT_NE(mb_, nullptr);
+    memset(mb_, 0, sizeof(*mb_));
+    vp8_setup_block_ptrs(mb_);
+    vp8_setup_block_dptrs(&mb_->e_mbd);
+  }
+
+  // Fills the coefficients of |num_blocks| blocks from |first_block|.
+  void FillBlocks(ACMRandom *rnd, int iteration, int first_block,
+                  int num_blocks) {
+    FillCoeffs(rnd, iteration, kMaxMbCoeff, mb_->coeff + first_block * 16,
+               mb_->e_mbd.dqcoeff + first_block * 16, num_blocks * 16);
+  }
+
+  MACROBLOCK *mb_;
+};
+
+class VP8MbBlockErrorTest : public VP8MbErrorTestBase,
+                            public ::testing::TestWithParam<MbBlockErrorFunc> {
+ protected:
+  void SetUp() override { AllocMacroblock(); }
+};
+GTEST_ALLOW_UNINSTANTIATED_PARAMETERIZED_TEST(VP8MbBlockErrorTest);
+
+TEST_P(VP8MbBlockErrorTest, MatchesC) {
+  ACMRandom rnd(ACMRandom::DeterministicSeed());
+  for (int i = 0; i < kNumIterations; ++i) {
+    FillBlocks(&rnd, i, 0, 16);
+    for (int dc = 0; dc < 2; ++dc) {
+      const int ref = vp8_mbblock_error_c(mb_, dc);
+      int error;
+      ASM_REGISTER_STATE_CHECK(error = GetParam()(mb_, dc));
+      ASSERT_EQ(ref, error) << "iteration " << i << " dc " << dc;
+    }
+  }
+}
+
+class VP8MbUvErrorTest : public VP8MbErrorTestBase,
+                         public ::testing::TestWithParam<MbUvErrorFunc> {
+ protected:
+  void SetUp() override { AllocMacroblock(); }
+};
+GTEST_ALLOW_UNINSTANTIATED_PARAMETERIZED_TEST(VP8MbUvErrorTest);
+
+TEST_P(VP8MbUvErrorTest, MatchesC) {
+  ACMRandom rnd(ACMRandom::DeterministicSeed());
+  for (int i = 0; i < kNumIterations; ++i) {
+    FillBlocks(&rnd, i, 16, 8);
+    const int ref = vp8_mbuverror_c(mb_);
+    int error;
+    ASM_REGISTER_STATE_CHECK(error = GetParam()(mb_));
+    ASSERT_EQ(ref, error) << "iteration " << i;
+  }
+}
+
+#if HAVE_SSE2
+INSTANTIATE_TEST_SUITE_P(SSE2, VP8BlockErrorTest,
+                         ::testing::Values(&vp8_block_error_sse2));
+INSTANTIATE_TEST_SUITE_P(SSE2, VP8MbBlockErrorTest,
+                         ::testing::Values(&vp8_mbblock_error_sse2));
+INSTANTIATE_TEST_SUITE_P(SSE2, VP8MbUvErrorTest,
+                         ::testing::Values(&vp8_mbuverror_sse2));
+#endif  // HAVE_SSE2
+
+#if HAVE_AVX2
+INSTANTIATE_TEST_SUITE_P(AVX2, VP8BlockErrorTest,
+                         ::testing::Values(&vp8_block_error_avx2));
+INSTANTIATE_TEST_SUITE_P(AVX2, VP8MbBlockErrorTest,
+                         ::testing::Values(&vp8_mbblock_error_avx2));
+INSTANTIATE_TEST_SUITE_P(AVX2, VP8MbUvErrorTest,
+                         ::testing::Values(&vp8_mbuverror_avx2));
+#endif  // HAVE_AVX2
+}  // namespace
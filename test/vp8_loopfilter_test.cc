@@ -0,0 +1,136 @@
+/*
+ *  Copyright (c) 2024 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string.h>
+#include <tuple>
+
+#include "third_party/googletest/src/include/gtest/gtest.h"
+
+#include "./vp8_rtcd.h"
+#include "./vpx_config.h"
+#include "test/acm_random.h"
+#include "test/clear_system_state.h"
+#include "test/register_state_check.h"
+#include "test/util.h"
+#include "vp8/common/loopfilter.h"
+#include "vpx/vpx_integer.h"
+#include "vpx_ports/mem.h"
+
+namespace {
+
+using libvpx_test::ACMRandom;
+using std::make_tuple;
+
+typedef void (*LoopFilterFunc)(unsigned char *y_ptr, unsigned char *u_ptr,
+                               unsigned char *v_ptr, int y_stride,
+                               int uv_stride, loop_filter_info *lfi);
+
+typedef std::tuple<LoopFilterFunc, LoopFilterFunc> LoopFilterParam;
+
+const int kNumIterations = 5000;
+const int kYStride = 32;
+const int kUVStride = 16;
+
+class VP8LoopFilterTest : public ::testing::TestWithParam<LoopFilterParam> {
+ public:
+  void SetUp() override {
+    filter_ = GET_PARAM(0);
+    ref_filter_ = GET_PARAM(1);
+  }
+
+  void TearDown() override { libvpx_test::ClearSystemState(); }
+
+ protected:
+  // Fills |buf| with a random level plus small noise so that most edges pass
+  // the filter masks, with the occasional large step that does not.
+  static void FillBlock(ACMRandom *rnd, uint8_t *buf, int size) {
+    const int base = rnd->Rand8();
+    const int noise = 1 + rnd->Rand8() % 32;
+    for (int i = 0; i < size; ++i) {
+      const int v = base + rnd->Rand8() % noise - noise / 2 +
+                    (rnd->Rand8() % 16 == 0 ? rnd->Rand8() - 128 : 0);
+      buf[i] = static_cast<uint8_t>(v < 0 ? 0 : v > 255 ? 255 : v);
+    }
+  }
+
+  LoopFilterFunc filter_;
+  LoopFilterFunc ref_filter_;
+};
+GTEST_ALLOW_UNINSTANTIATED_PARAMETERIZED_TEST(VP8LoopFilterTest);
+
+TEST_P(VP8LoopFilterTest, MatchesReference) {
+  ACMRandom rnd(ACMRandom::DeterministicSeed());
+  DECLARE_ALIGNED(16, uint8_t, y[kYStride * kYStride]);
+  DECLARE_ALIGNED(16, uint8_t, u[kUVStride * kUVStride]);
+  DECLARE_ALIGNED(16, uint8_t, v[kUVStride * kUVStride]);
+  DECLARE_ALIGNED(16, uint8_t, ref_y[kYStride * kYStride]);
+  DECLARE_ALIGNED(16, uint8_t, ref_u[kUVStride * kUVStride]);
+  DECLARE_ALIGNED(16, uint8_t, ref_v[kUVStride * kUVStride]);
+  DECLARE_ALIGNED(16, uint8_t, mblim[16]);
+  DECLARE_ALIGNED(16, uint8_t, blim[16]);
+  DECLARE_ALIGNED(16, uint8_t, lim[16]);
+  DECLARE_ALIGNED(16, uint8_t, hev_thr[16]);
+  loop_filter_info lfi = { mblim, blim, lim, hev_thr };
+  // The macroblock starts 8 pixels in so every edge has 4 pixels on each
+  // side inside the buffers.
+  const int y_offset = 8 * kYStride + 8;
+  const int uv_offset = 4 * kUVStride + 4;
+
+  for (int i = 0; i < kNumIterations; ++i) {
+    const int level = rnd.Rand8() % 64;
+    const int interior = 1 + rnd.Rand8() % 63;
+    memset(mblim, ((level + 2) * 2 + interior) & 0xff, sizeof(mblim));
+    memset(blim, (level * 2 + interior) & 0xff, sizeof(blim));
+    memset(lim, interior, sizeof(lim));
+    memset(hev_thr, rnd.Rand8() % 4, sizeof(hev_thr));
+
+    FillBlock(&rnd, ref_y, sizeof(ref_y));
+    FillBlock(&rnd, ref_u, sizeof(ref_u));
+    FillBlock(&rnd, ref_v, sizeof(ref_v));
+    memcpy(y, ref_y, sizeof(y));
+    memcpy(u, ref_u, sizeof(u));
+    memcpy(v, ref_v, sizeof(v));
+
+    // Odd iterations filter the luma plane only.
+    const bool chroma = (i & 1) == 0;
+    ref_filter_(ref_y + y_offset, chroma ? ref_u + uv_offset : nullptr,
+                chroma ? ref_v + uv_offset : nullptr, kYStride, kUVStride,
+                &lfi);
+    ASM_REGISTER_STATE_CHECK(filter_(y + y_offset,
+                                     chroma ? u + uv_offset : nullptr,
+                                     chroma ? v + uv_offset : nullptr,
+                                     kYStride, kUVStride, &lfi));
+
+    ASSERT_EQ(0, memcmp(ref_y, y, sizeof(y))) << "iteration " << i;
+    ASSERT_EQ(0, memcmp(ref_u, u, sizeof(u))) << "iteration " << i;
+    ASSERT_EQ(0, memcmp(ref_v, v, sizeof(v))) << "iteration " << i;
+  }
+}
+
+#if HAVE_SSE2
+INSTANTIATE_TEST_SUITE_P(
+    SSE2, VP8LoopFilterTest,
+    ::testing::Values(
+        make_tuple(&vp8_loop_filter_mbh_sse2, &vp8_loop_filter_mbh_c),
+        make_tuple(&vp8_loop_filter_mbv_sse2, &vp8_loop_filter_mbv_c),
+        make_tuple(&vp8_loop_filter_bh_sse2, &vp8_loop_filter_bh_c),
+        make_tuple(&vp8_loop_filter_bv_sse2, &vp8_loop_filter_bv_c)));
+#endif
+
+#if HAVE_AVX2
+INSTANTIATE_TEST_SUITE_P(
+    AVX2, VP8LoopFilterTest,
+    ::testing::Values(
+        make_tuple(&vp8_loop_filter_mbh_avx2, &vp8_loop_filter_mbh_c),
+        make_tuple(&vp8_loop_filter_mbv_avx2, &vp8_loop_filter_mbv_c),
+        make_tuple(&vp8_loop_filter_bh_avx2, &vp8_loop_filter_bh_c),
+        make_tuple(&vp8_loop_filter_bv_avx2, &vp8_loop_filter_bv_c)));
+#endif
+}  // namespace
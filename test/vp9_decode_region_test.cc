@@ -0,0 +1,362 @@
+/*
+ *  Copyright (c) 2024 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string.h>
+#include <tuple>
+
+#include "third_party/googletest/src/include/gtest/gtest.h"
+#include "test/codec_factory.h"
+#include "test/encode_test_driver.h"
+#include "test/util.h"
+#include "test/video_source.h"
+#include "vpx/vp8dx.h"
+#include "vpx/vpx_decoder.h"
+
+namespace {
+
+const int kWidth = 1024;
+const int kHeight = 128;
+// Inside the second of four tile columns, a superblock away from its edges.
+const vpx_image_rect_t kRegion = { 320, 0, 128, kHeight };
+
+const vpx_image_t *Decode(vpx_codec_ctx_t *decoder,
+                          const vpx_codec_cx_pkt_t *pkt) {
+  vpx_codec_iter_t iter = nullptr;
+  const vpx_codec_err_t res = vpx_codec_decode(
+      decoder, static_cast<const uint8_t *>(pkt->data.frame.buf),
+      static_cast<unsigned int>(pkt->data.frame.sz), nullptr, 0);
+  EXPECT_EQ(VPX_CODEC_OK, res) << vpx_codec_error_detail(decoder);
+  return res == VPX_CODEC_OK ? vpx_codec_get_frame(decoder, &iter) : nullptr;
+}
+
+// The same noise in every frame, so inter frames are mostly predicted without
+// motion and the decode region stays valid.
+class StaticNoiseVideoSource : public ::libvpx_test::RandomVideoSource {
+ protected:
+  void FillFrame() override {
+    rnd_.Reset(seed_);
+    RandomVideoSource::FillFrame();
+  }
+};
+
+// Noise that is static left of the middle of the first 8x8 block of the second
+// tile column and moves two pixels to the left per frame from there. The block
+// is split in two halves with motion vectors of 0 and 2 pixels. Each of them
+// is a whole chroma pixel, but their average, which predicts the chroma, is
+// half a pixel and reads the first tile column through the filter taps.
+class SplitMotionVideoSource : public ::libvpx_test::DummyVideoSource {
+ protected:
+  static uint8_t Noise(int x, int y) {
+    uint32_t h = static_cast<uint32_t>(x) * 0x9E3779B1u ^
+                 static_cast<uint32_t>(y) * 0x85EBCA77u;
+    h ^= h >> 15;
+    h *= 0x2C1B3C6Du;
+    return static_cast<uint8_t>(h >> 24);
+  }
+
+  void FillFrame() override {
+    if (!img_) return;
+    const int edge = kWidth / 4 + 4;
+    for (int plane = 0; plane < 3; ++plane) {
+      const int shift = plane ? 1 : 0;
+      const int w = (img_->d_w + shift) >> shift;
+      const int h = (img_->d_h + shift) >> shift;
+      for (int r = 0; r < h; ++r) {
+        uint8_t *const row = img_->planes[plane] + r * img_->stride[plane];
+        for (int c = 0; c < w; ++c) {
+          const int moving = !plane && c >= edge;
+          row[c] = Noise(c + (moving ? 2 * static_cast<int>(frame_) : 0),
+                         r + plane * kHeight);
+        }
+      }
+    }
+  }
+};
+
+// Parameters: whether the stream uses frame parallel decoding mode, which
+// allows tiles to be skipped, and the VP9E_SET_DISABLE_LOOPFILTER mode, where 2
+// disables the loop filter on all frames.
+class VP9DecodeRegionTest
+    : public ::libvpx_test::EncoderTest,
+      public ::testing::TestWithParam<std::tuple<int, int>> {
+ protected:
+  VP9DecodeRegionTest()
+      : EncoderTest(&::libvpx_test::kVP9), full_decoder_(), region_decoder_(),
+        region_(kRegion), cpu_used_(7), num_frames_(0), num_valid_frames_(0) {}
+  ~VP9DecodeRegionTest() override {
+    vpx_codec_destroy(&full_decoder_);
+    vpx_codec_destroy(&region_decoder_);
+  }
+
+  void SetUp() override {
+    vpx_codec_dec_cfg_t cfg = vpx_codec_dec_cfg_t();
+    vpx_image_rect_t region = kRegion;
+    ASSERT_EQ(VPX_CODEC_OK, vpx_codec_dec_init(&full_decoder_,
+                                               vpx_codec_vp9_dx(), &cfg, 0));
+    ASSERT_EQ(VPX_CODEC_OK, vpx_codec_dec_init(&region_decoder_,
+                                               vpx_codec_vp9_dx(), &cfg, 0));
+    ASSERT_EQ(VPX_CODEC_OK, vpx_codec_control(&region_decoder_,
+                                              VP9D_SET_DECODE_REGION, &region));
+
+    InitializeConfig();
+    SetMode(::libvpx_test::kRealTime);
+    cfg_.g_lag_in_frames = 0;
+    cfg_.rc_end_usage = VPX_CBR;
+    cfg_.rc_target_bitrate = 1000;
+  }
+
+  void PreEncodeFrameHook(::libvpx_test::VideoSource *video,
+                          ::libvpx_test::Encoder *encoder) override {
+    if (video->frame() == 0) {
+      encoder->Control(VP8E_SET_CPUUSED, cpu_used_);
+      encoder->Control(VP9E_SET_TILE_COLUMNS, 2);
+      encoder->Control(VP9E_SET_FRAME_PARALLEL_DECODING, GET_PARAM(0));
+      encoder->Control(VP9E_SET_DISABLE_LOOPFILTER, GET_PARAM(1));
+    }
+  }
+
+  bool DoDecode() const override { return false; }
+
+  void FramePktHook(const vpx_codec_cx_pkt_t *pkt) override {
+    const vpx_image_t *const full = Decode(&full_decoder_, pkt);
+    const vpx_image_t *const region = Decode(&region_decoder_, pkt);
+    int corrupted = 0;
+    ASSERT_NE(full, nullptr);
+    ASSERT_NE(region, nullptr);
+    ASSERT_EQ(VPX_CODEC_OK, vpx_codec_control(&region_decoder_,
+                                              VP8D_GET_FRAME_CORRUPTED,
+                                              &corrupted));
+    // Otherwise every tile is needed by later frames.
+    const int start = GET_PARAM(0) ? region_.x : 0;
+    const int end = GET_PARAM(0) ? region_.x + region_.w : kWidth;
+    if (!GET_PARAM(0) || (pkt->data.frame.flags & VPX_FRAME_IS_KEY)) {
+      EXPECT_EQ(0, corrupted);
+    }
+    if (GET_PARAM(0) && num_frames_ == 0) {
+      // The first tile column was skipped.
+      EXPECT_NE(0, memcmp(full->planes[VPX_PLANE_Y],
+                          region->planes[VPX_PLANE_Y], 256));
+    }
+    if (!corrupted) {
+      for (int plane = 0; plane < 3; ++plane) {
+        const int shift = plane ? 1 : 0;
+        const int h = (full->d_h + shift) >> shift;
+        const int plane_start = start >> shift;
+        const int plane_end = (end + shift) >> shift;
+        for (int r = 0; r < h; ++r) {
+          ASSERT_EQ(0, memcmp(full->planes[plane] + r * full->stride[plane] +
+                                  plane_start,
+                              region->planes[plane] +
+                                  r * region->stride[plane] + plane_start,
+                              plane_end - plane_start))
+              << "frame " << num_frames_ << " plane " << plane << " row "
+              << r;
+        }
+      }
+      ++num_valid_frames_;
+    }
+    ++num_frames_;
+  }
+
+  vpx_codec_ctx_t full_decoder_;
+  vpx_codec_ctx_t region_decoder_;
+  vpx_image_rect_t region_;
+  int cpu_used_;
+  int num_frames_;
+  int num_valid_frames_;
+};
+
+TEST_P(VP9DecodeRegionTest, RegionMatchesFullDecode) {
+  StaticNoiseVideoSource video;
+  video.SetSize(kWidth, kHeight);
+  video.set_limit(10);
+  ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+  EXPECT_EQ(10, num_frames_);
+  if (!GET_PARAM(0) || GET_PARAM(1)) {
+    // Without the loop filter, static content never reads the skipped tiles.
+    EXPECT_EQ(10, num_valid_frames_);
+  } else {
+    EXPECT_GT(num_valid_frames_, 0);
+  }
+}
+
+// Sub8x8 blocks are only coded by the rd mode search of good quality mode.
+// The region starts at the left edge of the second tile column, so the blocks
+// along it read the skipped first column through the interpolation taps.
+TEST_P(VP9DecodeRegionTest, Sub8x8RegionMatchesFullDecode) {
+  region_.x = kWidth / 4;
+  region_.w = kWidth / 8;
+  ASSERT_EQ(VPX_CODEC_OK, vpx_codec_control(&region_decoder_,
+                                            VP9D_SET_DECODE_REGION, &region_));
+  SetMode(::libvpx_test::kOnePassGood);
+  cpu_used_ = 1;
+  SplitMotionVideoSource video;
+  video.SetSize(kWidth, kHeight);
+  video.set_limit(4);
+  ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+  EXPECT_EQ(4, num_frames_);
+  EXPECT_GT(num_valid_frames_, 0);
+}
+
+INSTANTIATE_TEST_SUITE_P(VP9, VP9DecodeRegionTest,
+                         ::testing::Combine(::testing::Values(0, 1),
+                                            ::testing::Values(0, 2)));
+
+// The loop filter can carry a difference in a skipped column into the decoded
+// ones. The decoder assumes it reaches at most one superblock.
+const int kLoopFilterMargin = 64;
+// Four tile columns of 512 pixels, so the regions that skip one of them can
+// move their edge by the margin seven times.
+const int kEdgeWidth = 2048;
+const int kEdgeHeight = 64;
+const int kNumEdgeRegions = 8;
+const int kNumEdgeFrames = 10;
+
+// Decodes the stream with regions that skip the first or the last tile column
+// and whose inner edge moves by the loop filter margin. Parameter: the
+// VP9E_SET_DISABLE_LOOPFILTER mode, where 2 disables the loop filter on all
+// frames.
+//
+// The columns that stay exact start from the decoded tile columns and, with
+// the loop filter, lose the margin on each side that borders a skipped column.
+// The static content is predicted without motion, so on every inter frame the
+// blocks that read the lost columns of the reference lose the margin again.
+// The pixels next to the edge of each region are compared with the full
+// decode for as long as the region is reported as exact, and the frame that
+// moves the edge past the region must be reported as corrupted.
+class VP9DecodeRegionEdgeTest : public ::libvpx_test::EncoderTest,
+                                public ::testing::TestWithParam<int> {
+ protected:
+  VP9DecodeRegionEdgeTest()
+      : EncoderTest(&::libvpx_test::kVP9), full_decoder_(), num_frames_(0) {
+    memset(region_decoders_, 0, sizeof(region_decoders_));
+    memset(num_valid_frames_, 0, sizeof(num_valid_frames_));
+  }
+  ~VP9DecodeRegionEdgeTest() override {
+    vpx_codec_destroy(&full_decoder_);
+    for (int side = 0; side < 2; ++side) {
+      for (int i = 0; i < kNumEdgeRegions; ++i) {
+        vpx_codec_destroy(&region_decoders_[side][i]);
+      }
+    }
+  }
+
+  // Region |i| of the left side skips the last tile column and ends |i|
+  // margins before it. Those of the right side mirror them.
+  static vpx_image_rect_t EdgeRegion(int side, int i) {
+    const int w = 3 * kEdgeWidth / 4 - i * kLoopFilterMargin;
+    const vpx_image_rect_t region = {
+      side ? static_cast<unsigned int>(kEdgeWidth - w) : 0u, 0u,
+      static_cast<unsigned int>(w), static_cast<unsigned int>(kEdgeHeight)
+    };
+    return region;
+  }
+
+  void SetUp() override {
+    vpx_codec_dec_cfg_t cfg = vpx_codec_dec_cfg_t();
+    ASSERT_EQ(VPX_CODEC_OK, vpx_codec_dec_init(&full_decoder_,
+                                               vpx_codec_vp9_dx(), &cfg, 0));
+    for (int side = 0; side < 2; ++side) {
+      for (int i = 0; i < kNumEdgeRegions; ++i) {
+        vpx_image_rect_t region = EdgeRegion(side, i);
+        vpx_codec_ctx_t *const decoder = &region_decoders_[side][i];
+        ASSERT_EQ(VPX_CODEC_OK,
+                  vpx_codec_dec_init(decoder, vpx_codec_vp9_dx(), &cfg, 0));
+        ASSERT_EQ(VPX_CODEC_OK,
+                  vpx_codec_control(decoder, VP9D_SET_DECODE_REGION, &region));
+      }
+    }
+
+    InitializeConfig();
+    SetMode(::libvpx_test::kRealTime);
+    cfg_.g_lag_in_frames = 0;
+    cfg_.rc_end_usage = VPX_CBR;
+    cfg_.rc_target_bitrate = 1000;
+  }
+
+  void PreEncodeFrameHook(::libvpx_test::VideoSource *video,
+                          ::libvpx_test::Encoder *encoder) override {
+    if (video->frame() == 0) {
+      encoder->Control(VP8E_SET_CPUUSED, 7);
+      encoder->Control(VP9E_SET_TILE_COLUMNS, 2);
+      encoder->Control(VP9E_SET_FRAME_PARALLEL_DECODING, 1);
+      encoder->Control(VP9E_SET_DISABLE_LOOPFILTER, GetParam());
+    }
+  }
+
+  bool DoDecode() const override { return false; }
+
+  void FramePktHook(const vpx_codec_cx_pkt_t *pkt) override {
+    const vpx_image_t *const full =
+        Decode(&full_decoder_, pkt);
+    ASSERT_NE(full, nullptr);
+    for (int side = 0; side < 2; ++side) {
+      for (int i = 0; i < kNumEdgeRegions; ++i) {
+        vpx_codec_ctx_t *const decoder = &region_decoders_[side][i];
+        const vpx_image_rect_t region = EdgeRegion(side, i);
+        const vpx_image_t *const img =
+            Decode(decoder, pkt);
+        int corrupted = 0;
+        ASSERT_NE(img, nullptr);
+        ASSERT_EQ(VPX_CODEC_OK, vpx_codec_control(
+                                    decoder, VP8D_GET_FRAME_CORRUPTED,
+                                    &corrupted));
+        if (num_valid_frames_[side][i] < num_frames_) {
+          // Columns lost in a reference are never restored.
+          EXPECT_NE(0, corrupted) << "frame " << num_frames_;
+        }
+        if (corrupted) continue;
+        // The two luma columns and the chroma column next to the inner edge.
+        const int x = side ? region.x : region.x + region.w - 2;
+        for (int plane = 0; plane < 3; ++plane) {
+          const int shift = plane ? 1 : 0;
+          const int h = (full->d_h + shift) >> shift;
+          const int plane_x = (x + shift) >> shift;
+          const int plane_w = 2 >> shift;
+          for (int r = 0; r < h; ++r) {
+            ASSERT_EQ(0, memcmp(full->planes[plane] + r * full->stride[plane] +
+                                    plane_x,
+                                img->planes[plane] + r * img->stride[plane] +
+                                    plane_x,
+                                plane_w))
+                << "side " << side << " region " << i << " frame "
+                << num_frames_ << " plane " << plane << " row " << r;
+          }
+        }
+        ++num_valid_frames_[side][i];
+      }
+    }
+    ++num_frames_;
+  }
+
+  vpx_codec_ctx_t full_decoder_;
+  vpx_codec_ctx_t region_decoders_[2][kNumEdgeRegions];
+  int num_frames_;
+  int num_valid_frames_[2][kNumEdgeRegions];
+};
+
+TEST_P(VP9DecodeRegionEdgeTest, EdgeMatchesFullDecode) {
+  StaticNoiseVideoSource video;
+  video.SetSize(kEdgeWidth, kEdgeHeight);
+  video.set_limit(kNumEdgeFrames);
+  ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+  EXPECT_EQ(kNumEdgeFrames, num_frames_);
+  for (int side = 0; side < 2; ++side) {
+    for (int i = 0; i < kNumEdgeRegions; ++i) {
+      // Without the loop filter the decoded tile columns stay exact. With it,
+      // region |i| has its edge on the last exact column of frame |i - 1|.
+      EXPECT_EQ(GetParam() ? kNumEdgeFrames : i, num_valid_frames_[side][i])
+          << "side " << side << " region " << i;
+    }
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(VP9, VP9DecodeRegionEdgeTest, ::testing::Values(0, 2));
+}  // namespace
@@ -19,6 +19,7 @@
 #include "test/register_state_check.h"
 #include "test/util.h"
 
+#include "./vp9_rtcd.h"
 #include "vpx_scale/yv12config.h"
 #include "vpx/vpx_integer.h"
 #include "vp9/common/vp9_reconinter.h"
@@ -120,6 +121,21 @@ INSTANTIATE_TEST_SUITE_P(
                       make_tuple(&vp9_denoiser_filter_sse2, BLOCK_64X64)));
 #endif  // HAVE_SSE2
 
+#if HAVE_AVX2
+INSTANTIATE_TEST_SUITE_P(
+    AVX2, VP9DenoiserTest,
+    ::testing::Values(make_tuple(&vp9_denoiser_filter_avx2, BLOCK_8X8),
+                      make_tuple(&vp9_denoiser_filter_avx2, BLOCK_8X16),
+                      make_tuple(&vp9_denoiser_filter_avx2, BLOCK_16X8),
+                      make_tuple(&vp9_denoiser_filter_avx2, BLOCK_16X16),
+                      make_tuple(&vp9_denoiser_filter_avx2, BLOCK_16X32),
+                      make_tuple(&vp9_denoiser_filter_avx2, BLOCK_32X16),
+                      make_tuple(&vp9_denoiser_filter_avx2, BLOCK_32X32),
+                      make_tuple(&vp9_denoiser_filter_avx2, BLOCK_32X64),
+                      make_tuple(&vp9_denoiser_filter_avx2, BLOCK_64X32),
+                      make_tuple(&vp9_denoiser_filter_avx2, BLOCK_64X64)));
+#endif  // HAVE_AVX2
+
 #if HAVE_NEON
 INSTANTIATE_TEST_SUITE_P(
     NEON, VP9DenoiserTest,
@@ -134,4 +150,67 @@ INSTANTIATE_TEST_SUITE_P(
                       make_tuple(&vp9_denoiser_filter_neon, BLOCK_64X32),
                       make_tuple(&vp9_denoiser_filter_neon, BLOCK_64X64)));
 #endif
+
+#if CONFIG_VP9_POSTPROC
+// The MFQE postproc blend, vp9_filter_by_weight{16x16,8x8}().
+typedef void (*MfqeFilterFunc)(const uint8_t *src, int src_stride,
+                               uint8_t *dst, int dst_stride, int src_weight);
+typedef std::tuple<MfqeFilterFunc, MfqeFilterFunc, int> MfqeTestParam;
+
+class VP9MfqeTest : public ::testing::TestWithParam<MfqeTestParam> {
+ public:
+  ~VP9MfqeTest() override = default;
+
+  void TearDown() override { libvpx_test::ClearSystemState(); }
+};
+GTEST_ALLOW_UNINSTANTIATED_PARAMETERIZED_TEST(VP9MfqeTest);
+
+TEST_P(VP9MfqeTest, BitexactCheck) {
+  ACMRandom rnd(ACMRandom::DeterministicSeed());
+  const MfqeFilterFunc filter = GET_PARAM(0);
+  const MfqeFilterFunc ref_filter = GET_PARAM(1);
+  const int size = GET_PARAM(2);
+  const int stride = 64;
+  DECLARE_ALIGNED(16, uint8_t, src[kNumPixels]);
+  DECLARE_ALIGNED(16, uint8_t, dst[kNumPixels]);
+  DECLARE_ALIGNED(16, uint8_t, dst_ref[kNumPixels]);
+
+  for (int i = 0; i < 1000; ++i) {
+    // The weight covers the full range, including the copy at 1 << 4.
+    const int src_weight = i % 17;
+    for (int j = 0; j < kNumPixels; ++j) {
+      src[j] = rnd.Rand8();
+      dst[j] = dst_ref[j] = rnd.Rand8();
+    }
+
+    ref_filter(src, stride, dst_ref, stride, src_weight);
+    ASM_REGISTER_STATE_CHECK(filter(src, stride, dst, stride, src_weight));
+
+    for (int h = 0; h < size; ++h) {
+      for (int w = 0; w < size; ++w) {
+        ASSERT_EQ(dst_ref[h * stride + w], dst[h * stride + w])
+            << "weight " << src_weight << " at " << h << "x" << w;
+      }
+    }
+  }
+}
+
+#if HAVE_SSE2
+INSTANTIATE_TEST_SUITE_P(
+    SSE2, VP9MfqeTest,
+    ::testing::Values(make_tuple(&vp9_filter_by_weight16x16_sse2,
+                                 &vp9_filter_by_weight16x16_c, 16),
+                      make_tuple(&vp9_filter_by_weight8x8_sse2,
+                                 &vp9_filter_by_weight8x8_c, 8)));
+#endif  // HAVE_SSE2
+
+#if HAVE_AVX2
+INSTANTIATE_TEST_SUITE_P(
+    AVX2, VP9MfqeTest,
+    ::testing::Values(make_tuple(&vp9_filter_by_weight16x16_avx2,
+                                 &vp9_filter_by_weight16x16_c, 16),
+                      make_tuple(&vp9_filter_by_weight8x8_avx2,
+                                 &vp9_filter_by_weight8x8_c, 8)));
+#endif  // HAVE_AVX2
+#endif  // CONFIG_VP9_POSTPROC
 }  // namespace
@@ -0,0 +1,161 @@
+/*
+ *  Copyright (c) 2024 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <tuple>
+#include <vector>
+
+#include "third_party/googletest/src/include/gtest/gtest.h"
+#include "test/codec_factory.h"
+#include "test/encode_test_driver.h"
+#include "test/util.h"
+#include "test/video_source.h"
+#include "vpx_ports/mem_ops.h"
+
+namespace {
+
+const int kLog2TileCols = 2;
+const int kNumFrames = 10;
+
+// How the fragments reach the application.
+enum FragmentOutput {
+  // Through the packet list, after the whole frame has been encoded.
+  kPacketList,
+  // Through the output callback, as soon as each one has been packed.
+  kCallback,
+  // Through the output callback, after the frame has survived the post encode
+  // frame drop.
+  kCallbackPostEncodeDrop
+};
+
+// Parameters: number of threads, log2 of the number of tile rows, output.
+class VP9FragmentsTest
+    : public ::libvpx_test::EncoderTest,
+      public ::testing::TestWithParam<std::tuple<int, int, FragmentOutput>> {
+ protected:
+  VP9FragmentsTest()
+      : EncoderTest(&::libvpx_test::kVP9), decoder_(vpx_codec_dec_cfg_t()),
+        num_frames_(0), next_partition_(0), frame_pts_(-1) {}
+  ~VP9FragmentsTest() override = default;
+
+  void SetUp() override {
+    InitializeConfig();
+    SetMode(::libvpx_test::kRealTime);
+    set_init_flags(VPX_CODEC_USE_OUTPUT_PARTITION);
+    cfg_.g_threads = GET_PARAM(0);
+    cfg_.g_lag_in_frames = 0;
+    cfg_.rc_end_usage = VPX_CBR;
+    cfg_.rc_target_bitrate = 1000;
+    if (GET_PARAM(2) == kCallbackPostEncodeDrop) {
+      // Small enough buffers for some frames to be dropped after they are
+      // encoded.
+      cfg_.rc_target_bitrate = 5000;
+      cfg_.rc_buf_initial_sz = 50;
+      cfg_.rc_buf_optimal_sz = 50;
+      cfg_.rc_buf_sz = 100;
+    }
+  }
+
+  static void OutputCallback(vpx_codec_cx_pkt_t *pkt, void *user_data) {
+    VP9FragmentsTest *const test = static_cast<VP9FragmentsTest *>(user_data);
+    ASSERT_EQ(VPX_CODEC_CX_FRAME_PKT, pkt->kind);
+    test->CheckFragment(pkt);
+  }
+
+  void PreEncodeFrameHook(::libvpx_test::VideoSource *video,
+                          ::libvpx_test::Encoder *encoder) override {
+    if (video->frame() == 0) {
+      encoder->Control(VP8E_SET_CPUUSED, 7);
+      encoder->Control(VP9E_SET_TILE_COLUMNS, kLog2TileCols);
+      encoder->Control(VP9E_SET_TILE_ROWS, GET_PARAM(1));
+      if (GET_PARAM(2) != kPacketList) {
+        vpx_codec_priv_output_cx_pkt_cb_pair_t cb = { OutputCallback, this };
+        encoder->Control(VP9E_REGISTER_CX_CALLBACK, &cb);
+      }
+      if (GET_PARAM(2) == kCallbackPostEncodeDrop) {
+        encoder->Control(VP9E_SET_POSTENCODE_DROP, 1);
+      }
+    }
+  }
+
+  // The test decodes the reassembled frames itself.
+  bool DoDecode() const override { return false; }
+
+  void FramePktHook(const vpx_codec_cx_pkt_t *pkt) override {
+    // With a callback registered no frame packet goes to the packet list.
+    ASSERT_EQ(kPacketList, GET_PARAM(2));
+    CheckFragment(pkt);
+  }
+
+  void CheckFragment(const vpx_codec_cx_pkt_t *pkt) {
+    const uint8_t *const buf =
+        reinterpret_cast<const uint8_t *>(pkt->data.frame.buf);
+    const size_t sz = pkt->data.frame.sz;
+    // Multi-threaded realtime encoding forces a single tile row.
+    const int log2_tile_rows = GET_PARAM(0) > 1 ? 0 : GET_PARAM(1);
+    const int num_tiles = 1 << (kLog2TileCols + log2_tile_rows);
+    const bool is_last = !(pkt->data.frame.flags & VPX_FRAME_IS_FRAGMENT);
+
+    ASSERT_EQ(next_partition_, pkt->data.frame.partition_id);
+    if (next_partition_ == 0) {
+      // Frames come out in order, each with its own time stamp.
+      EXPECT_GT(pkt->data.frame.pts, frame_pts_);
+      frame_pts_ = pkt->data.frame.pts;
+    }
+    EXPECT_EQ(frame_pts_, pkt->data.frame.pts);
+    if (next_partition_ > 0 && next_partition_ < num_tiles) {
+      // Every tile but the last starts with its size marker.
+      ASSERT_GE(sz, 4u);
+      EXPECT_EQ(sz - 4, mem_get_be32(buf));
+    }
+    frame_.insert(frame_.end(), buf, buf + sz);
+    ++next_partition_;
+
+    if (is_last) {
+      // One fragment for the frame headers and one per tile.
+      EXPECT_EQ(num_tiles + 1, next_partition_);
+      ASSERT_EQ(VPX_CODEC_OK,
+                decoder_.DecodeFrame(frame_.data(), frame_.size()))
+          << decoder_.DecodeError();
+      ::libvpx_test::DxDataIterator dec_iter = decoder_.GetDxData();
+      EXPECT_NE(dec_iter.Next(), nullptr);
+      frame_.clear();
+      next_partition_ = 0;
+      ++num_frames_;
+    }
+  }
+
+  ::libvpx_test::VP9Decoder decoder_;
+  std::vector<uint8_t> frame_;
+  int num_frames_;
+  int next_partition_;
+  vpx_codec_pts_t frame_pts_;
+};
+
+TEST_P(VP9FragmentsTest, TileFragmentsDecode) {
+  ::libvpx_test::RandomVideoSource video;
+  // Wide enough for 4 tile columns.
+  video.SetSize(1024, 128);
+  video.set_limit(kNumFrames);
+  ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+  if (GET_PARAM(2) == kCallbackPostEncodeDrop) {
+    EXPECT_GT(num_frames_, 0);
+    EXPECT_LT(num_frames_, kNumFrames);
+  } else {
+    EXPECT_EQ(kNumFrames, num_frames_);
+  }
+  EXPECT_EQ(0, next_partition_);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    VP9, VP9FragmentsTest,
+    ::testing::Combine(::testing::Values(1, 4), ::testing::Values(0, 1),
+                       ::testing::Values(kPacketList, kCallback,
+                                         kCallbackPostEncodeDrop)));
+}  // namespace
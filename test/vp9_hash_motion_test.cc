@@ -0,0 +1,134 @@
+/*
+ *  Copyright (c) 2024 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <cstring>
+
+#include "third_party/googletest/src/include/gtest/gtest.h"
+
+#include "test/acm_random.h"
+#include "vp9/encoder/vp9_hash_motion.h"
+
+using libvpx_test::ACMRandom;
+
+namespace {
+
+const int kWidth = 120;
+const int kHeight = 88;
+const int kStride = 128;
+
+class HashMotionTest : public ::testing::Test {
+ protected:
+  HashMotionTest() : rnd_(ACMRandom::DeterministicSeed()), index_() {
+    index_.buf_idx = -1;
+    limits_.col_min = -kWidth;
+    limits_.col_max = kWidth;
+    limits_.row_min = -kHeight;
+    limits_.row_max = kHeight;
+    ref_mv_.row = 0;
+    ref_mv_.col = 0;
+  }
+
+  ~HashMotionTest() override { vp9_block_hash_index_free(&index_); }
+
+  void SetUp() override {
+    for (int i = 0; i < kStride * kHeight; ++i) {
+      ref_[i] = rnd_.Rand8();
+      src_[i] = rnd_.Rand8();
+    }
+  }
+
+  void CopyBlock(int src_col, int src_row, int ref_col, int ref_row, int w,
+                 int h) {
+    for (int r = 0; r < h; ++r) {
+      memcpy(&src_[(src_row + r) * kStride + src_col],
+             &ref_[(ref_row + r) * kStride + ref_col], w);
+    }
+  }
+
+  int Search(int col, int row, MV *mv) {
+    return vp9_block_hash_search(&index_, &src_[row * kStride + col], kStride,
+                                 col, row, 16, 16, &limits_, &ref_mv_, mv);
+  }
+
+  void Build() {
+    ASSERT_EQ(
+        1, vp9_block_hash_index_build(&index_, ref_, kStride, kWidth, kHeight));
+  }
+
+  ACMRandom rnd_;
+  BLOCK_HASH_INDEX index_;
+  MvLimits limits_;
+  MV ref_mv_;
+  uint8_t ref_[kStride * kHeight];
+  uint8_t src_[kStride * kHeight];
+};
+
+TEST_F(HashMotionTest, FindsMovedBlocks) {
+  Build();
+  for (int i = 0; i < 100; ++i) {
+    const int src_col = rnd_.PseudoUniform(kWidth - 16 + 1);
+    const int src_row = rnd_.PseudoUniform(kHeight - 16 + 1);
+    const int ref_col = rnd_.PseudoUniform(kWidth - 16 + 1);
+    const int ref_row = rnd_.PseudoUniform(kHeight - 16 + 1);
+    CopyBlock(src_col, src_row, ref_col, ref_row, 16, 16);
+    MV mv;
+    ASSERT_EQ(1, Search(src_col, src_row, &mv));
+    EXPECT_EQ(ref_col - src_col, mv.col);
+    EXPECT_EQ(ref_row - src_row, mv.row);
+  }
+}
+
+TEST_F(HashMotionTest, RequiresWholeBlockMatch) {
+  Build();
+  CopyBlock(16, 16, 40, 30, 16, 16);
+  src_[31 * kStride + 31] ^= 1;
+  MV mv;
+  EXPECT_EQ(0, Search(16, 16, &mv));
+}
+
+TEST_F(HashMotionTest, RespectsLimits) {
+  Build();
+  CopyBlock(16, 16, 80, 30, 16, 16);
+  MV mv;
+  ASSERT_EQ(1, Search(16, 16, &mv));
+  limits_.col_max = 63;
+  EXPECT_EQ(0, Search(16, 16, &mv));
+}
+
+TEST_F(HashMotionTest, PrefersClosestToReference) {
+  // Two copies of the same block, away from the position searched.
+  CopyBlock(0, 0, 8, 8, 16, 16);
+  for (int r = 0; r < 16; ++r) {
+    memcpy(&ref_[(60 + r) * kStride + 90], &src_[r * kStride], 16);
+  }
+  Build();
+  CopyBlock(40, 40, 8, 8, 16, 16);
+  MV mv;
+  ref_mv_.row = 20 * 8;
+  ref_mv_.col = 50 * 8;
+  ASSERT_EQ(1, Search(40, 40, &mv));
+  EXPECT_EQ(50, mv.col);
+  EXPECT_EQ(20, mv.row);
+  ref_mv_.row = 0;
+  ref_mv_.col = 0;
+  ASSERT_EQ(1, Search(40, 40, &mv));
+  EXPECT_EQ(-32, mv.col);
+  EXPECT_EQ(-32, mv.row);
+}
+
+TEST_F(HashMotionTest, SkipsFlatBlocks) {
+  memset(ref_, 7, sizeof(ref_));
+  memset(src_, 7, sizeof(src_));
+  Build();
+  MV mv;
+  EXPECT_EQ(0, Search(16, 16, &mv));
+}
+
+}  // namespace
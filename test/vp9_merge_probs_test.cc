@@ -0,0 +1,191 @@
+/*
+ *  Copyright (c) 2024 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <tuple>
+
+#include "third_party/googletest/src/include/gtest/gtest.h"
+
+#include "./vpx_config.h"
+#include "./vpx_dsp_rtcd.h"
+#include "test/acm_random.h"
+#include "test/clear_system_state.h"
+#include "test/register_state_check.h"
+#include "test/util.h"
+#include "vpx_dsp/prob.h"
+#include "vpx_ports/vpx_timer.h"
+
+using libvpx_test::ACMRandom;
+
+namespace {
+const int kNumIterations = 1000;
+// Number of coefficient probabilities adapted per frame:
+// TX_SIZES * PLANE_TYPES * REF_TYPES * COEF_BANDS * COEFF_CONTEXTS *
+// UNCONSTRAINED_NODES.
+const int kNumProbs = 4 * 2 * 2 * 6 * 6 * 3;
+
+// { count_sat, max_update_factor } pairs: the VP9 coefficient, after-key and
+// mode/mv adaptation settings plus the largest supported update factor.
+const unsigned int kMergeParams[][2] = {
+  { 24, 112 }, { 24, 128 }, { MODE_MV_COUNT_SAT, 128 }, { 32, 255 }
+};
+
+typedef void (*MergeProbsFunc)(const uint8_t *pre_probs,
+                               const unsigned int *branch_ct, int n,
+                               unsigned int count_sat,
+                               unsigned int max_update_factor, uint8_t *probs);
+typedef std::tuple<MergeProbsFunc, MergeProbsFunc> MergeProbsParam;
+
+class MergeProbsTest : public ::testing::TestWithParam<MergeProbsParam> {
+ public:
+  ~MergeProbsTest() override = default;
+  void SetUp() override {
+    ref_func_ = GET_PARAM(0);
+    tst_func_ = GET_PARAM(1);
+  }
+
+  void TearDown() override { libvpx_test::ClearSystemState(); }
+
+ protected:
+  // Fills the branch counts with a mix of empty, unsaturated, saturated and
+  // very large counts.
+  void FillCounts(ACMRandom *rnd, unsigned int *branch_ct, int n) {
+    for (int i = 0; i < 2 * n; ++i) {
+      switch (rnd->Rand8() & 3) {
+        case 0: branch_ct[i] = 0; break;
+        case 1: branch_ct[i] = rnd->Rand8() & 31; break;
+        case 2: branch_ct[i] = rnd->Rand16(); break;
+        default:
+          branch_ct[i] =
+              rnd->RandRange(testing::internal::Random::kMaxRange);
+          break;
+      }
+    }
+  }
+
+  MergeProbsFunc ref_func_;
+  MergeProbsFunc tst_func_;
+};
+GTEST_ALLOW_UNINSTANTIATED_PARAMETERIZED_TEST(MergeProbsTest);
+
+TEST_P(MergeProbsTest, OperationCheck) {
+  ACMRandom rnd(ACMRandom::DeterministicSeed());
+  uint8_t pre_probs[kNumProbs];
+  unsigned int branch_ct[kNumProbs][2];
+  uint8_t probs_ref[kNumProbs];
+  uint8_t probs_tst[kNumProbs];
+
+  for (int k = 0; k < kNumIterations; ++k) {
+    const unsigned int *const params = kMergeParams[k & 3];
+    // Odd sizes exercise the scalar tail.
+    const int n = (k & 1) ? kNumProbs : 1 + rnd(kNumProbs);
+    for (int i = 0; i < n; ++i) pre_probs[i] = 1 + rnd(MAX_PROB);
+    FillCounts(&rnd, &branch_ct[0][0], n);
+
+    ref_func_(pre_probs, &branch_ct[0][0], n, params[0], params[1],
+              probs_ref);
+    ASM_REGISTER_STATE_CHECK(tst_func_(pre_probs, &branch_ct[0][0], n,
+                                       params[0], params[1], probs_tst));
+
+    for (int i = 0; i < n; ++i) {
+      ASSERT_EQ(probs_ref[i], probs_tst[i])
+          << "Error: merge_probs mismatch at " << i << " counts ("
+          << branch_ct[i][0] << ", " << branch_ct[i][1] << ")";
+    }
+  }
+}
+
+TEST_P(MergeProbsTest, ExtremeValues) {
+  ACMRandom rnd(ACMRandom::DeterministicSeed());
+  const unsigned int kExtremes[] = { 0u, 1u, 23u, 24u, 25u, 0x7fffffffu };
+  const int kNumExtremes = sizeof(kExtremes) / sizeof(kExtremes[0]);
+  uint8_t pre_probs[kNumExtremes * kNumExtremes];
+  unsigned int branch_ct[kNumExtremes * kNumExtremes][2];
+  uint8_t probs_ref[kNumExtremes * kNumExtremes];
+  uint8_t probs_tst[kNumExtremes * kNumExtremes];
+  const int n = kNumExtremes * kNumExtremes;
+
+  for (int i = 0; i < n; ++i) {
+    branch_ct[i][0] = kExtremes[i / kNumExtremes];
+    branch_ct[i][1] = kExtremes[i % kNumExtremes];
+  }
+  for (int k = 0; k < 4; ++k) {
+    for (int i = 0; i < n; ++i) {
+      pre_probs[i] = (k == 0) ? 1 : (k == 1) ? MAX_PROB : 1 + rnd(MAX_PROB);
+    }
+    ref_func_(pre_probs, &branch_ct[0][0], n, kMergeParams[k][0],
+              kMergeParams[k][1], probs_ref);
+    ASM_REGISTER_STATE_CHECK(tst_func_(pre_probs, &branch_ct[0][0], n,
+                                       kMergeParams[k][0], kMergeParams[k][1],
+                                       probs_tst));
+    for (int i = 0; i < n; ++i) ASSERT_EQ(probs_ref[i], probs_tst[i]);
+  }
+}
+
+TEST_P(MergeProbsTest, DISABLED_Speed) {
+  ACMRandom rnd(ACMRandom::DeterministicSeed());
+  const int kNumFrames = 100000;
+  uint8_t pre_probs[kNumProbs];
+  unsigned int branch_ct[kNumProbs][2];
+  uint8_t probs[kNumProbs];
+  MergeProbsFunc funcs[2] = { ref_func_, tst_func_ };
+  double elapsed_time[2];
+
+  for (int i = 0; i < kNumProbs; ++i) pre_probs[i] = 1 + rnd(MAX_PROB);
+  FillCounts(&rnd, &branch_ct[0][0], kNumProbs);
+
+  for (int f = 0; f < 2; ++f) {
+    vpx_usec_timer timer;
+    vpx_usec_timer_start(&timer);
+    for (int frame = 0; frame < kNumFrames; ++frame) {
+      funcs[f](pre_probs, &branch_ct[0][0], kNumProbs, 24, 112, probs);
+    }
+    vpx_usec_timer_mark(&timer);
+    elapsed_time[f] =
+        static_cast<double>(vpx_usec_timer_elapsed(&timer)) / kNumFrames;
+  }
+  printf("Coefficient adaptation per frame: ref %.3f us, test %.3f us "
+         "(%4.2fx)\n",
+         elapsed_time[0], elapsed_time[1], elapsed_time[0] / elapsed_time[1]);
+}
+
+// The batched merge must reproduce the scalar merge_probs() and, with the
+// mode/mv parameters, mode_mv_merge_probs().
+TEST(MergeProbsCTest, MatchesScalarMerge) {
+  ACMRandom rnd(ACMRandom::DeterministicSeed());
+  for (int k = 0; k < 100000; ++k) {
+    const uint8_t pre_prob = 1 + rnd(MAX_PROB);
+    unsigned int ct[2];
+    uint8_t prob;
+    ct[0] = (k & 1) ? rnd(40) : rnd.Rand16();
+    ct[1] = (k & 2) ? rnd(40) : rnd.Rand16();
+
+    vpx_merge_probs_c(&pre_prob, ct, 1, 24, 112, &prob);
+    ASSERT_EQ(merge_probs(pre_prob, ct, 24, 112), prob);
+
+    vpx_merge_probs_c(&pre_prob, ct, 1, MODE_MV_COUNT_SAT,
+                      MODE_MV_MAX_UPDATE_FACTOR, &prob);
+    ASSERT_EQ(mode_mv_merge_probs(pre_prob, ct), prob);
+  }
+}
+
+using std::make_tuple;
+
+INSTANTIATE_TEST_SUITE_P(C, MergeProbsTest,
+                         ::testing::Values(make_tuple(&vpx_merge_probs_c,
+                                                      &vpx_merge_probs_c)));
+
+#if HAVE_SSE2
+INSTANTIATE_TEST_SUITE_P(SSE2, MergeProbsTest,
+                         ::testing::Values(make_tuple(&vpx_merge_probs_c,
+                                                      &vpx_merge_probs_sse2)));
+#endif  // HAVE_SSE2
+}  // namespace
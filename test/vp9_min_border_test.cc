@@ -0,0 +1,126 @@
+/*
+ *  Copyright (c) 2024 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <math.h>
+#include <tuple>
+
+#include "third_party/googletest/src/include/gtest/gtest.h"
+#include "test/codec_factory.h"
+#include "test/encode_test_driver.h"
+#include "test/util.h"
+#include "test/video_source.h"
+#include "vpx/vp8cx.h"
+
+namespace {
+
+// Not a multiple of 8, so the frame is cropped inside the mode info grid.
+const int kWidth = 330;
+const int kHeight = 250;
+const int kNumFrames = 16;
+const int kResizeFrame = 8;
+
+// Content that moves quickly towards the top left corner, so the best
+// predictions at the right and bottom edges come from outside the frame.
+class MovingVideoSource : public ::libvpx_test::DummyVideoSource {
+ protected:
+  void FillFrame() override {
+    if (!img_) return;
+    for (int plane = 0; plane < 3; ++plane) {
+      const int w = plane ? (img_->d_w + 1) >> 1 : img_->d_w;
+      const int h = plane ? (img_->d_h + 1) >> 1 : img_->d_h;
+      const int shift = plane ? 1 : 0;
+      for (int r = 0; r < h; ++r) {
+        uint8_t *const row = img_->planes[plane] + r * img_->stride[plane];
+        for (int c = 0; c < w; ++c) {
+          const double x = ((c << shift) + 37.0 * frame_) / 19.0;
+          const double y = ((r << shift) + 29.0 * frame_) / 15.0;
+          row[c] = static_cast<uint8_t>(128 + (plane ? 40 : 100) * sin(x) *
+                                                  cos(y + plane));
+        }
+      }
+    }
+  }
+};
+
+// Parameters: encoding mode, speed, whether the encoder scales the frames
+// down halfway through, which makes it predict from scaled references, and the
+// number of threads, which encode superblock rows in parallel.
+class VP9MinBorderTest
+    : public ::libvpx_test::EncoderTest,
+      public ::testing::TestWithParam<
+          std::tuple<::libvpx_test::TestMode, int, bool, int>> {
+ protected:
+  VP9MinBorderTest()
+      : EncoderTest(&::libvpx_test::kVP9), min_border_(0), num_frames_(0),
+        psnr_(0.0) {}
+
+  void SetUp() override {
+    InitializeConfig();
+    SetMode(GET_PARAM(0));
+    cfg_.g_lag_in_frames = GET_PARAM(0) == ::libvpx_test::kRealTime ? 0 : 10;
+    cfg_.rc_end_usage = VPX_VBR;
+    cfg_.rc_target_bitrate = 300;
+    cfg_.g_threads = GET_PARAM(3);
+    init_flags_ = VPX_CODEC_USE_PSNR;
+  }
+
+  void PreEncodeFrameHook(::libvpx_test::VideoSource *video,
+                          ::libvpx_test::Encoder *encoder) override {
+    if (video->frame() == 0) {
+      encoder->Control(VP8E_SET_CPUUSED, GET_PARAM(1));
+      encoder->Control(VP9E_SET_MIN_BORDER, min_border_);
+      encoder->Control(VP9E_SET_ROW_MT, GET_PARAM(3) > 1);
+    }
+    if (GET_PARAM(2) && video->frame() == kResizeFrame) {
+      vpx_scaling_mode_t mode = { VP8E_ONETWO, VP8E_ONETWO };
+      encoder->Control(VP8E_SET_SCALEMODE, &mode);
+    }
+  }
+
+  void PSNRPktHook(const vpx_codec_cx_pkt_t *pkt) override {
+    psnr_ += pkt->data.psnr.psnr[0];
+    ++num_frames_;
+  }
+
+  // Encodes the clip and returns the average PSNR. The test driver checks
+  // that the encoder reconstruction matches the decoded frames.
+  double Encode(int min_border) {
+    MovingVideoSource video;
+    min_border_ = min_border;
+    num_frames_ = 0;
+    psnr_ = 0.0;
+    video.SetSize(kWidth, kHeight);
+    video.set_limit(kNumFrames);
+    EXPECT_NO_FATAL_FAILURE(RunLoop(&video));
+    EXPECT_EQ(kNumFrames, num_frames_);
+    return num_frames_ ? psnr_ / num_frames_ : 0.0;
+  }
+
+  int min_border_;
+  int num_frames_;
+  double psnr_;
+};
+
+TEST_P(VP9MinBorderTest, MatchesDecoderAndKeepsQuality) {
+  const double psnr = Encode(0);
+  const double min_border_psnr = Encode(1);
+  EXPECT_GT(min_border_psnr, psnr - 0.2);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    VP9, VP9MinBorderTest,
+    ::testing::Values(std::make_tuple(::libvpx_test::kRealTime, 7, false, 1),
+                      std::make_tuple(::libvpx_test::kRealTime, 5, true, 1),
+                      std::make_tuple(::libvpx_test::kOnePassGood, 2, false, 1),
+                      std::make_tuple(::libvpx_test::kOnePassGood, 1, true, 1),
+                      std::make_tuple(::libvpx_test::kRealTime, 7, false, 2),
+                      std::make_tuple(::libvpx_test::kOnePassGood, 2, false,
+                                      2)));
+}  // namespace
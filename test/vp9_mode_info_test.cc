@@ -0,0 +1,309 @@
+/*
+ *  Copyright (c) 2024 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <math.h>
+#include <string.h>
+#include <vector>
+
+#include "third_party/googletest/src/include/gtest/gtest.h"
+#include "test/codec_factory.h"
+#include "test/decode_test_driver.h"
+#include "test/encode_test_driver.h"
+#include "test/util.h"
+#include "test/video_source.h"
+#include "vpx/vp8cx.h"
+#include "vpx/vp8dx.h"
+#include "vpx/vpx_decoder.h"
+#include "vpx/vpx_encoder.h"
+
+namespace {
+
+const int kWidth = 352;
+const int kHeight = 288;
+const int kNumFrames = 10;
+
+struct Frame {
+  unsigned int width;
+  unsigned int height;
+  std::vector<uint8_t> planes[3];
+};
+
+struct ModeInfo {
+  vpx_mode_info_map_t map;
+  std::vector<vpx_mode_info_t> mode_info;
+};
+
+// Textured content panning one way with a band moving the other way.
+class PanningVideoSource : public ::libvpx_test::DummyVideoSource {
+ protected:
+  void FillFrame() override {
+    if (!img_) return;
+    for (int r = 0; r < kHeight; ++r) {
+      uint8_t *const row = img_->planes[0] + r * img_->stride[0];
+      const bool band = r >= kHeight / 3 && r < kHeight / 2;
+      const int dx = band ? -5 * static_cast<int>(frame_) : 3 * frame_;
+      for (int c = 0; c < kWidth; ++c) {
+        const double x = (c + dx) / 6.0;
+        const double y = (r + 2.0 * frame_) / 9.0;
+        row[c] = static_cast<uint8_t>(128 + 90 * sin(x + sin(y)) * cos(y));
+      }
+    }
+    for (int plane = 1; plane < 3; ++plane) {
+      for (int r = 0; r < kHeight / 2; ++r) {
+        memset(img_->planes[plane] + r * img_->stride[plane],
+               plane == 1 ? 100 : 150, kWidth / 2);
+      }
+    }
+  }
+};
+
+// Serves frames decoded by an earlier encode.
+class StoredVideoSource : public ::libvpx_test::DummyVideoSource {
+ public:
+  explicit StoredVideoSource(const std::vector<Frame> *frames)
+      : frames_(frames) {
+    SetSize((*frames)[0].width, (*frames)[0].height);
+    set_limit(static_cast<unsigned int>(frames->size()));
+  }
+
+ protected:
+  void FillFrame() override {
+    if (!img_ || frame_ >= frames_->size()) return;
+    const Frame &frame = (*frames_)[frame_];
+    for (int plane = 0; plane < 3; ++plane) {
+      const unsigned int w = plane ? (frame.width + 1) / 2 : frame.width;
+      const unsigned int h = plane ? (frame.height + 1) / 2 : frame.height;
+      for (unsigned int r = 0; r < h; ++r) {
+        memcpy(img_->planes[plane] + r * img_->stride[plane],
+               &frame.planes[plane][r * w], w);
+      }
+    }
+  }
+
+  const std::vector<Frame> *frames_;
+};
+
+// Copies |img| into |frame|, downscaled by 1 << scale_log2.
+void StoreFrame(const vpx_image_t &img, int scale_log2, Frame *frame) {
+  const int scale = 1 << scale_log2;
+  frame->width = img.d_w >> scale_log2;
+  frame->height = img.d_h >> scale_log2;
+  for (int plane = 0; plane < 3; ++plane) {
+    const unsigned int w = plane ? (frame->width + 1) / 2 : frame->width;
+    const unsigned int h = plane ? (frame->height + 1) / 2 : frame->height;
+    frame->planes[plane].resize(w * h);
+    for (unsigned int r = 0; r < h; ++r) {
+      for (unsigned int c = 0; c < w; ++c) {
+        int sum = 0;
+        for (int y = 0; y < scale; ++y) {
+          for (int x = 0; x < scale; ++x) {
+            sum += img.planes[plane][(r * scale + y) * img.stride[plane] +
+                                     c * scale + x];
+          }
+        }
+        frame->planes[plane][r * w + c] =
+            static_cast<uint8_t>((sum + scale * scale / 2) / (scale * scale));
+      }
+    }
+  }
+}
+
+bool GetModeInfo(vpx_codec_ctx_t *decoder, ModeInfo *info) {
+  int size[2];
+  if (vpx_codec_control(decoder, VP9D_GET_FRAME_SIZE, size) != VPX_CODEC_OK)
+    return false;
+  info->map = vpx_mode_info_map_t();
+  info->map.rows = (size[1] + 7) / 8;
+  info->map.cols = (size[0] + 7) / 8;
+  info->mode_info.resize(info->map.rows * info->map.cols);
+  info->map.mode_info = &info->mode_info[0];
+  return vpx_codec_control(decoder, VP9D_GET_MODE_INFO, &info->map) ==
+         VPX_CODEC_OK;
+}
+
+TEST(VP9ModeInfoTest, DecoderRejectsInvalidMaps) {
+  vpx_codec_ctx_t dec;
+  ASSERT_EQ(vpx_codec_dec_init(&dec, vpx_codec_vp9_dx(), nullptr, 0),
+            VPX_CODEC_OK);
+  std::vector<vpx_mode_info_t> mode_info(1);
+  vpx_mode_info_map_t map = vpx_mode_info_map_t();
+  map.mode_info = &mode_info[0];
+  map.rows = map.cols = 1;
+  // Nothing was decoded yet.
+  EXPECT_NE(vpx_codec_control(&dec, VP9D_GET_MODE_INFO, &map), VPX_CODEC_OK);
+  EXPECT_EQ(vpx_codec_control(&dec, VP9D_GET_MODE_INFO,
+                              static_cast<vpx_mode_info_map_t *>(nullptr)),
+            VPX_CODEC_INVALID_PARAM);
+  EXPECT_EQ(vpx_codec_destroy(&dec), VPX_CODEC_OK);
+}
+
+TEST(VP9ModeInfoTest, EncoderRejectsInvalidMaps) {
+  vpx_codec_enc_cfg_t cfg;
+  vpx_codec_ctx_t enc;
+  ASSERT_EQ(vpx_codec_enc_config_default(vpx_codec_vp9_cx(), &cfg, 0),
+            VPX_CODEC_OK);
+  cfg.g_w = kWidth;
+  cfg.g_h = kHeight;
+  ASSERT_EQ(vpx_codec_enc_init(&enc, vpx_codec_vp9_cx(), &cfg, 0),
+            VPX_CODEC_OK);
+
+  // A map of another size is scaled.
+  std::vector<vpx_mode_info_t> mode_info(10 * 13);
+  vpx_mode_info_map_t map = vpx_mode_info_map_t();
+  map.mode_info = &mode_info[0];
+  map.width = 100;
+  map.height = 80;
+  map.rows = 10;
+  map.cols = 13;
+  EXPECT_EQ(vpx_codec_control(&enc, VP9E_SET_MODE_INFO, &map), VPX_CODEC_OK);
+  map.cols = 12;
+  EXPECT_EQ(vpx_codec_control(&enc, VP9E_SET_MODE_INFO, &map),
+            VPX_CODEC_INVALID_PARAM);
+  map.cols = 13;
+  map.width = 0;
+  EXPECT_EQ(vpx_codec_control(&enc, VP9E_SET_MODE_INFO, &map),
+            VPX_CODEC_INVALID_PARAM);
+  EXPECT_EQ(vpx_codec_control(&enc, VP9E_SET_MODE_INFO,
+                              static_cast<vpx_mode_info_map_t *>(nullptr)),
+            VPX_CODEC_INVALID_PARAM);
+  EXPECT_EQ(vpx_codec_destroy(&enc), VPX_CODEC_OK);
+}
+
+// Encodes a clip, then transcodes the decoded frames, at the same size or
+// half of it, with and without the mode info of the first stream. Parameter:
+// log2 of the downscaling factor of the transcode.
+class VP9ModeInfoTranscodeTest : public ::libvpx_test::EncoderTest,
+                                 public ::testing::TestWithParam<int> {
+ protected:
+  enum Pass { kSource, kTranscode, kTranscodeWithModeInfo };
+
+  VP9ModeInfoTranscodeTest()
+      : EncoderTest(&::libvpx_test::kVP9), pass_(kSource), num_frames_(0),
+        psnr_(0.0), mismatches_(0) {}
+
+  void SetUp() override {
+    InitializeConfig();
+    SetMode(::libvpx_test::kRealTime);
+    cfg_.g_lag_in_frames = 0;
+    cfg_.rc_end_usage = VPX_CBR;
+    cfg_.rc_dropframe_thresh = 0;
+    // A lossless key frame would take most of the rate of the half size
+    // transcode, and leave too few bits to the inter frames for their quality
+    // to tell the mode decisions apart.
+    cfg_.rc_min_quantizer = 10;
+    init_flags_ = VPX_CODEC_USE_PSNR;
+  }
+
+  void PreEncodeFrameHook(::libvpx_test::VideoSource *video,
+                          ::libvpx_test::Encoder *encoder) override {
+    if (video->frame() == 0) encoder->Control(VP8E_SET_CPUUSED, 7);
+    // The hook is also called to flush the encoder.
+    if (pass_ == kTranscodeWithModeInfo &&
+        video->frame() < source_info_.size()) {
+      ModeInfo *const info = &source_info_[video->frame()];
+      info->map.mode_info = &info->mode_info[0];
+      encoder->Control(VP9E_SET_MODE_INFO, &info->map);
+    }
+  }
+
+  bool HandleDecodeResult(const vpx_codec_err_t res_dec,
+                          const ::libvpx_test::VideoSource &video,
+                          ::libvpx_test::Decoder *decoder) override {
+    EXPECT_EQ(VPX_CODEC_OK, res_dec) << decoder->DecodeError();
+    if (res_dec != VPX_CODEC_OK) return false;
+    ModeInfo info;
+    EXPECT_TRUE(GetModeInfo(decoder->GetDecoder(), &info));
+    if (pass_ == kSource) {
+      source_info_.push_back(info);
+    } else if (pass_ == kTranscodeWithModeInfo && GetParam() == 0 &&
+               video.frame() > 0) {
+      // The partitioning of inter frames is taken from the source.
+      const ModeInfo &source = source_info_[video.frame()];
+      for (size_t i = 0; i < info.mode_info.size(); ++i) {
+        if (info.mode_info[i].width != source.mode_info[i].width ||
+            info.mode_info[i].height != source.mode_info[i].height) {
+          ++mismatches_;
+        }
+      }
+    }
+    return true;
+  }
+
+  void DecompressedFrameHook(const vpx_image_t &img,
+                             vpx_codec_pts_t /*pts*/) override {
+    if (pass_ != kSource) return;
+    Frame frame;
+    StoreFrame(img, GetParam(), &frame);
+    frames_.push_back(frame);
+  }
+
+  void PSNRPktHook(const vpx_codec_cx_pkt_t *pkt) override {
+    psnr_ += pkt->data.psnr.psnr[0];
+    ++num_frames_;
+  }
+
+  void EncodeSource() {
+    PanningVideoSource video;
+    pass_ = kSource;
+    cfg_.rc_target_bitrate = 800;
+    video.SetSize(kWidth, kHeight);
+    video.set_limit(kNumFrames);
+    ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+    ASSERT_EQ(kNumFrames, static_cast<int>(frames_.size()));
+    ASSERT_EQ(kNumFrames, static_cast<int>(source_info_.size()));
+  }
+
+  // Returns the average PSNR of the transcode. The test driver checks that
+  // the encoder reconstruction matches the decoded frames.
+  double Transcode(Pass pass) {
+    StoredVideoSource video(&frames_);
+    pass_ = pass;
+    num_frames_ = 0;
+    psnr_ = 0.0;
+    cfg_.rc_target_bitrate = 400 >> GetParam();
+    EXPECT_NO_FATAL_FAILURE(RunLoop(&video));
+    EXPECT_EQ(kNumFrames, num_frames_);
+    return num_frames_ ? psnr_ / num_frames_ : 0.0;
+  }
+
+  Pass pass_;
+  std::vector<Frame> frames_;
+  std::vector<ModeInfo> source_info_;
+  int num_frames_;
+  double psnr_;
+  int mismatches_;
+};
+
+TEST_P(VP9ModeInfoTranscodeTest, MatchesDecoderAndKeepsQuality) {
+  ASSERT_NO_FATAL_FAILURE(EncodeSource());
+  for (size_t i = 0; i < source_info_.size(); ++i) {
+    EXPECT_EQ(static_cast<unsigned int>(kWidth), source_info_[i].map.width);
+    EXPECT_EQ(static_cast<unsigned int>(kHeight), source_info_[i].map.height);
+  }
+  // The key frame is intra coded.
+  for (size_t i = 0; i < source_info_[0].mode_info.size(); ++i) {
+    ASSERT_EQ(0, source_info_[0].mode_info[i].ref_frame[0]);
+  }
+
+  const double psnr = Transcode(kTranscode);
+  const double mode_info_psnr = Transcode(kTranscodeWithModeInfo);
+  if (GetParam() == 0) {
+    // The mode info of the same frame size is at least as good as the
+    // encoder's own decisions.
+    EXPECT_GT(mode_info_psnr, psnr);
+  } else {
+    EXPECT_GT(mode_info_psnr, psnr - 0.25);
+  }
+  EXPECT_EQ(0, mismatches_);
+}
+
+INSTANTIATE_TEST_SUITE_P(VP9, VP9ModeInfoTranscodeTest,
+                         ::testing::Values(0, 1));
+}  // namespace
@@ -0,0 +1,192 @@
+/*
+ *  Copyright (c) 2024 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <math.h>
+#include <string.h>
+#include <tuple>
+#include <vector>
+
+#include "third_party/googletest/src/include/gtest/gtest.h"
+#include "test/codec_factory.h"
+#include "test/encode_test_driver.h"
+#include "test/util.h"
+#include "test/video_source.h"
+#include "vpx/vp8cx.h"
+#include "vpx/vpx_encoder.h"
+
+namespace {
+
+const int kWidth = 200;
+const int kHeight = 120;
+const int kNumFrames = 12;
+
+// Motion of the left and right halves of the frame, which go different ways
+// by more than the neighboring motion vectors would suggest.
+int MotionRow(int frame, int half) {
+  return half ? 3 + (frame % 3) * 5 : -(frame % 4) * 7;
+}
+int MotionCol(int frame, int half) {
+  return half ? -(frame % 5) * 6 : 4 + (frame % 2) * 11;
+}
+
+// Position of the content of a half of the frame after frame motions.
+int Offset(int frame, int half, int (*motion)(int, int)) {
+  int offset = 0;
+  for (int f = 1; f <= frame; ++f) offset += motion(f, half);
+  return offset;
+}
+
+class TwoHalvesVideoSource : public ::libvpx_test::DummyVideoSource {
+ protected:
+  void FillFrame() override {
+    if (!img_) return;
+    for (int half = 0; half < 2; ++half) {
+      // Moving by (row, col) means the content comes from (+row, +col).
+      const int dy = Offset(frame_, half, MotionRow);
+      const int dx = Offset(frame_, half, MotionCol);
+      for (int r = 0; r < kHeight; ++r) {
+        uint8_t *const row = img_->planes[0] + r * img_->stride[0];
+        for (int c = half * kWidth / 2; c < (half + 1) * kWidth / 2; ++c) {
+          const double x = (c + dx) / 5.0;
+          const double y = (r + dy) / 7.0;
+          row[c] = static_cast<uint8_t>(128 + 90 * sin(x + sin(y)) * cos(y));
+        }
+      }
+    }
+    for (int plane = 1; plane < 3; ++plane) {
+      for (int r = 0; r < kHeight / 2; ++r) {
+        memset(img_->planes[plane] + r * img_->stride[plane], 128,
+               kWidth / 2);
+      }
+    }
+  }
+};
+
+TEST(VP9MotionHintsTest, RejectsInvalidHints) {
+  vpx_codec_enc_cfg_t cfg;
+  vpx_codec_ctx_t enc;
+  ASSERT_EQ(vpx_codec_enc_config_default(vpx_codec_vp9_cx(), &cfg, 0),
+            VPX_CODEC_OK);
+  cfg.g_w = kWidth;
+  cfg.g_h = kHeight;
+  ASSERT_EQ(vpx_codec_enc_init(&enc, vpx_codec_vp9_cx(), &cfg, 0),
+            VPX_CODEC_OK);
+
+  std::vector<vpx_motion_hint_t> hints(((kHeight + 7) / 8) *
+                                       ((kWidth + 7) / 8));
+  vpx_motion_hints_t map = vpx_motion_hints_t();
+  map.hints[0] = &hints[0];
+  map.block_size = 8;
+  map.rows = (kHeight + 7) / 8;
+  map.cols = (kWidth + 7) / 8;
+  EXPECT_EQ(vpx_codec_control(&enc, VP9E_SET_MOTION_HINTS, &map),
+            VPX_CODEC_OK);
+  map.block_size = 16;
+  EXPECT_EQ(vpx_codec_control(&enc, VP9E_SET_MOTION_HINTS, &map),
+            VPX_CODEC_INVALID_PARAM);
+  map.rows = (kHeight + 15) / 16;
+  map.cols = (kWidth + 15) / 16;
+  EXPECT_EQ(vpx_codec_control(&enc, VP9E_SET_MOTION_HINTS, &map),
+            VPX_CODEC_OK);
+  map.block_size = 32;
+  EXPECT_EQ(vpx_codec_control(&enc, VP9E_SET_MOTION_HINTS, &map),
+            VPX_CODEC_INVALID_PARAM);
+  EXPECT_EQ(vpx_codec_control(&enc, VP9E_SET_MOTION_HINTS,
+                              static_cast<vpx_motion_hints_t *>(nullptr)),
+            VPX_CODEC_INVALID_PARAM);
+  EXPECT_EQ(vpx_codec_destroy(&enc), VPX_CODEC_OK);
+}
+
+// Parameters: encoding mode and speed.
+class VP9MotionHintsEncodeTest
+    : public ::libvpx_test::EncoderTest,
+      public ::testing::TestWithParam<
+          std::tuple<::libvpx_test::TestMode, int>> {
+ protected:
+  VP9MotionHintsEncodeTest()
+      : EncoderTest(&::libvpx_test::kVP9), use_hints_(false), num_frames_(0),
+        psnr_(0.0) {}
+
+  void SetUp() override {
+    InitializeConfig();
+    SetMode(std::get<0>(GetParam()));
+    cfg_.g_lag_in_frames = 0;
+    cfg_.rc_end_usage = VPX_VBR;
+    cfg_.rc_target_bitrate = 200;
+    init_flags_ = VPX_CODEC_USE_PSNR;
+  }
+
+  void PreEncodeFrameHook(::libvpx_test::VideoSource *video,
+                          ::libvpx_test::Encoder *encoder) override {
+    const int frame = static_cast<int>(video->frame());
+    if (frame == 0) {
+      encoder->Control(VP8E_SET_CPUUSED, std::get<1>(GetParam()));
+      return;
+    }
+    if (!use_hints_) return;
+    vpx_motion_hints_t map = vpx_motion_hints_t();
+    map.block_size = 16;
+    map.rows = (kHeight + 15) / 16;
+    map.cols = (kWidth + 15) / 16;
+    hints_.resize(map.rows * map.cols);
+    for (unsigned int r = 0; r < map.rows; ++r) {
+      for (unsigned int c = 0; c < map.cols; ++c) {
+        const int half = c * 16 >= kWidth / 2;
+        hints_[r * map.cols + c].row =
+            static_cast<short>(MotionRow(frame, half) * 8);
+        hints_[r * map.cols + c].col =
+            static_cast<short>(MotionCol(frame, half) * 8);
+      }
+    }
+    // Hints for the first row of blocks are missing.
+    for (unsigned int c = 0; c < map.cols; ++c) {
+      hints_[c].row = VPX_MOTION_HINT_NONE;
+    }
+    map.hints[0] = &hints_[0];
+    encoder->Control(VP9E_SET_MOTION_HINTS, &map);
+  }
+
+  void PSNRPktHook(const vpx_codec_cx_pkt_t *pkt) override {
+    psnr_ += pkt->data.psnr.psnr[0];
+    ++num_frames_;
+  }
+
+  // Encodes the clip and returns the average PSNR. The test driver checks
+  // that the encoder reconstruction matches the decoded frames.
+  double Encode(bool use_hints) {
+    TwoHalvesVideoSource video;
+    use_hints_ = use_hints;
+    num_frames_ = 0;
+    psnr_ = 0.0;
+    video.SetSize(kWidth, kHeight);
+    video.set_limit(kNumFrames);
+    EXPECT_NO_FATAL_FAILURE(RunLoop(&video));
+    EXPECT_EQ(kNumFrames, num_frames_);
+    return num_frames_ ? psnr_ / num_frames_ : 0.0;
+  }
+
+  bool use_hints_;
+  std::vector<vpx_motion_hint_t> hints_;
+  int num_frames_;
+  double psnr_;
+};
+
+TEST_P(VP9MotionHintsEncodeTest, MatchesDecoderAndKeepsQuality) {
+  const double psnr = Encode(false);
+  const double hints_psnr = Encode(true);
+  EXPECT_GT(hints_psnr, psnr - 0.3);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    VP9, VP9MotionHintsEncodeTest,
+    ::testing::Values(std::make_tuple(::libvpx_test::kRealTime, 6),
+                      std::make_tuple(::libvpx_test::kRealTime, 8),
+                      std::make_tuple(::libvpx_test::kOnePassGood, 2)));
+}  // namespace
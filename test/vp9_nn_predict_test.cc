@@ -0,0 +1,106 @@
+/*
+ *  Copyright (c) 2024 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <vector>
+
+#include "third_party/googletest/src/include/gtest/gtest.h"
+
+#include "./vpx_config.h"
+#include "./vp9_rtcd.h"
+#include "test/acm_random.h"
+#include "test/clear_system_state.h"
+#include "test/register_state_check.h"
+#include "vp9/encoder/vp9_nn.h"
+
+using libvpx_test::ACMRandom;
+
+namespace {
+
+typedef void (*NnPredictFunc)(const float *features,
+                              const NN_CONFIG *nn_config, float *output);
+
+class NnPredictTest : public ::testing::TestWithParam<NnPredictFunc> {
+ protected:
+  NnPredictTest() : rnd_(ACMRandom::DeterministicSeed()) {}
+  void TearDown() override { libvpx_test::ClearSystemState(); }
+
+  float RandomValue() {
+    return static_cast<float>(rnd_.Rand16()) / 16384.0f - 2.0f;
+  }
+
+  std::vector<float> RandomVector(int size) {
+    std::vector<float> v(size);
+    for (int i = 0; i < size; ++i) v[i] = RandomValue();
+    return v;
+  }
+
+  // Compares the output of the function under test with vp9_nn_predict_c()
+  // for a random model with the given shape.
+  void CheckModel(int num_inputs, int num_hidden_layers, int num_nodes,
+                  int num_outputs) {
+    NN_CONFIG config = NN_CONFIG();
+    std::vector<float> weights[NN_MAX_HIDDEN_LAYERS + 1];
+    std::vector<float> bias[NN_MAX_HIDDEN_LAYERS + 1];
+    int layer_inputs = num_inputs;
+    config.num_inputs = num_inputs;
+    config.num_outputs = num_outputs;
+    config.num_hidden_layers = num_hidden_layers;
+    for (int layer = 0; layer <= num_hidden_layers; ++layer) {
+      const int layer_outputs =
+          layer < num_hidden_layers ? num_nodes : num_outputs;
+      if (layer < num_hidden_layers) config.num_hidden_nodes[layer] = num_nodes;
+      weights[layer] = RandomVector(layer_inputs * layer_outputs);
+      bias[layer] = RandomVector(layer_outputs);
+      config.weights[layer] = weights[layer].data();
+      config.bias[layer] = bias[layer].data();
+      layer_inputs = layer_outputs;
+    }
+
+    const std::vector<float> features = RandomVector(num_inputs);
+    std::vector<float> ref_output(num_outputs);
+    std::vector<float> output(num_outputs);
+    vp9_nn_predict_c(features.data(), &config, ref_output.data());
+    ASM_REGISTER_STATE_CHECK(
+        GetParam()(features.data(), &config, output.data()));
+    for (int i = 0; i < num_outputs; ++i) {
+      EXPECT_EQ(ref_output[i], output[i])
+          << "inputs " << num_inputs << " layers " << num_hidden_layers
+          << " nodes " << num_nodes << " output " << i;
+    }
+  }
+
+  ACMRandom rnd_;
+};
+GTEST_ALLOW_UNINSTANTIATED_PARAMETERIZED_TEST(NnPredictTest);
+
+TEST_P(NnPredictTest, MatchesC) {
+  static const int kNumNodes[] = { 1, 3, 8, 13, 16, 24, 40 };
+  static const int kNumOutputs[] = { 1, 3, 4, 9 };
+  for (int num_inputs = 1; num_inputs <= 26; ++num_inputs) {
+    for (int num_layers = 0; num_layers <= 2; ++num_layers) {
+      for (int num_nodes : kNumNodes) {
+        for (int num_outputs : kNumOutputs) {
+          CheckModel(num_inputs, num_layers, num_nodes, num_outputs);
+        }
+      }
+    }
+  }
+}
+
+TEST_P(NnPredictTest, LargestLayers) {
+  CheckModel(NN_MAX_NODES_PER_LAYER, 2, NN_MAX_NODES_PER_LAYER - 1,
+             NN_MAX_NODES_PER_LAYER);
+}
+
+#if HAVE_AVX2
+INSTANTIATE_TEST_SUITE_P(AVX2, NnPredictTest,
+                         ::testing::Values(&vp9_nn_predict_avx2));
+#endif  // HAVE_AVX2
+}  // namespace
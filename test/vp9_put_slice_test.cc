@@ -0,0 +1,130 @@
+/*
+ *  Copyright (c) 2024 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string.h>
+#include <tuple>
+#include <vector>
+
+#include "third_party/googletest/src/include/gtest/gtest.h"
+#include "test/codec_factory.h"
+#include "test/encode_test_driver.h"
+#include "test/util.h"
+#include "test/video_source.h"
+#include "vpx/vp8dx.h"
+#include "vpx/vpx_decoder.h"
+
+namespace {
+
+// Parameters: number of decoder threads, log2 of the number of tile columns.
+class VP9PutSliceTest
+    : public ::libvpx_test::EncoderTest,
+      public ::testing::TestWithParam<std::tuple<int, int>> {
+ protected:
+  VP9PutSliceTest()
+      : EncoderTest(&::libvpx_test::kVP9), decoder_(), num_frames_(0),
+        num_slices_(0), rows_done_(0) {}
+  ~VP9PutSliceTest() override { vpx_codec_destroy(&decoder_); }
+
+  void SetUp() override {
+    vpx_codec_dec_cfg_t cfg = vpx_codec_dec_cfg_t();
+    cfg.threads = GET_PARAM(0);
+    ASSERT_EQ(VPX_CODEC_OK,
+              vpx_codec_dec_init(&decoder_, vpx_codec_vp9_dx(), &cfg, 0));
+    ASSERT_EQ(VPX_CODEC_OK,
+              vpx_codec_register_put_slice_cb(&decoder_, PutSlice, this));
+
+    InitializeConfig();
+    SetMode(::libvpx_test::kRealTime);
+    cfg_.g_lag_in_frames = 0;
+    cfg_.rc_end_usage = VPX_CBR;
+    cfg_.rc_target_bitrate = 500;
+  }
+
+  void PreEncodeFrameHook(::libvpx_test::VideoSource *video,
+                          ::libvpx_test::Encoder *encoder) override {
+    if (video->frame() == 0) {
+      encoder->Control(VP8E_SET_CPUUSED, 7);
+      encoder->Control(VP9E_SET_TILE_COLUMNS, GET_PARAM(1));
+    }
+  }
+
+  bool DoDecode() const override { return false; }
+
+  // Copies the rows that were reported final into |rows_|, so they can be
+  // compared against the frame eventually returned by the decoder.
+  static void PutSlice(void *user_priv, const vpx_image_t *img,
+                       const vpx_image_rect_t *valid,
+                       const vpx_image_rect_t *update) {
+    VP9PutSliceTest *const test = static_cast<VP9PutSliceTest *>(user_priv);
+    EXPECT_EQ(0u, valid->y);
+    EXPECT_EQ(test->rows_done_, update->y);
+    EXPECT_EQ(update->y + update->h, valid->h);
+    EXPECT_EQ(0u, update->x);
+    EXPECT_EQ(img->d_w, update->w);
+    EXPECT_GT(update->h, 0u);
+    if (test->rows_.empty()) test->rows_.resize(img->d_w * img->d_h);
+    for (unsigned int r = update->y; r < update->y + update->h; ++r) {
+      memcpy(&test->rows_[r * img->d_w],
+             img->planes[VPX_PLANE_Y] + r * img->stride[VPX_PLANE_Y],
+             img->d_w);
+    }
+    test->rows_done_ = update->y + update->h;
+    ++test->num_slices_;
+  }
+
+  void FramePktHook(const vpx_codec_cx_pkt_t *pkt) override {
+    vpx_codec_iter_t iter = nullptr;
+    const vpx_image_t *img;
+
+    rows_done_ = 0;
+    ASSERT_EQ(VPX_CODEC_OK,
+              vpx_codec_decode(
+                  &decoder_, static_cast<const uint8_t *>(pkt->data.frame.buf),
+                  static_cast<unsigned int>(pkt->data.frame.sz), nullptr, 0));
+    img = vpx_codec_get_frame(&decoder_, &iter);
+    ASSERT_NE(img, nullptr);
+    ASSERT_EQ(img->d_h, rows_done_);
+    for (unsigned int r = 0; r < img->d_h; ++r) {
+      ASSERT_EQ(0, memcmp(&rows_[r * img->d_w],
+                          img->planes[VPX_PLANE_Y] +
+                              r * img->stride[VPX_PLANE_Y],
+                          img->d_w))
+          << "frame " << num_frames_ << " row " << r;
+    }
+    ++num_frames_;
+  }
+
+  vpx_codec_ctx_t decoder_;
+  std::vector<uint8_t> rows_;
+  int num_frames_;
+  int num_slices_;
+  unsigned int rows_done_;
+};
+
+TEST_P(VP9PutSliceTest, RowsMatchOutput) {
+  ::libvpx_test::RandomVideoSource video;
+  video.SetSize(GET_PARAM(1) > 0 ? 1024 : 352, 288);
+  video.set_limit(10);
+  ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+  EXPECT_EQ(10, num_frames_);
+  // With a single tile column the rows are reported as they are loop
+  // filtered, otherwise once per frame.
+  if (GET_PARAM(1) == 0) {
+    EXPECT_GT(num_slices_, num_frames_);
+  } else {
+    EXPECT_EQ(num_slices_, num_frames_);
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(VP9, VP9PutSliceTest,
+                         ::testing::Values(std::make_tuple(1, 0),
+                                           std::make_tuple(2, 0),
+                                           std::make_tuple(4, 2)));
+}  // namespace
@@ -0,0 +1,133 @@
+/*
+ *  Copyright (c) 2024 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string>
+#include <vector>
+
+#include "third_party/googletest/src/include/gtest/gtest.h"
+#include "test/codec_factory.h"
+#include "test/encode_test_driver.h"
+#include "test/md5_helper.h"
+#include "test/util.h"
+#include "test/video_source.h"
+#include "vpx/vp8cx.h"
+
+namespace {
+
+const int kNumFrames = 48;
+
+// Parameters: encoding mode and speed.
+class VP9RdCostCacheTest
+    : public ::libvpx_test::EncoderTest,
+      public ::libvpx_test::CodecTestWith2Params<libvpx_test::TestMode, int> {
+ protected:
+  VP9RdCostCacheTest()
+      : EncoderTest(GET_PARAM(0)), encoding_mode_(GET_PARAM(1)),
+        speed_(GET_PARAM(2)), disable_cache_(0), switch_q_(false),
+        post_encode_drop_(false) {}
+
+  void SetUp() override {
+    InitializeConfig();
+    SetMode(encoding_mode_);
+    cfg_.g_lag_in_frames = 0;
+    cfg_.rc_end_usage =
+        encoding_mode_ == ::libvpx_test::kRealTime ? VPX_CBR : VPX_VBR;
+    cfg_.rc_target_bitrate = 500;
+    cfg_.kf_max_dist = 9999;
+  }
+
+  void PreEncodeFrameHook(::libvpx_test::VideoSource *video,
+                          ::libvpx_test::Encoder *encoder) override {
+    if (video->frame() == 0) {
+      encoder->Control(VP8E_SET_CPUUSED, speed_);
+      encoder->Control(VP9E_SET_DISABLE_RD_COST_CACHE, disable_cache_);
+      if (post_encode_drop_) encoder->Control(VP9E_SET_POSTENCODE_DROP, 1);
+    }
+    if (switch_q_ && video->frame() % 3 == 0) {
+      // Moves q across the threshold of allow_high_precision_mv every three
+      // frames.
+      const bool high_q = (video->frame() / 3) & 1;
+      cfg_.rc_min_quantizer = high_q ? 52 : 10;
+      cfg_.rc_max_quantizer = high_q ? 63 : 40;
+      encoder->Config(&cfg_);
+    }
+  }
+
+  void FramePktHook(const vpx_codec_cx_pkt_t *pkt) override {
+    ::libvpx_test::MD5 md5;
+    md5.Add(static_cast<const uint8_t *>(pkt->data.frame.buf),
+            pkt->data.frame.sz);
+    md5s_.push_back(md5.Get());
+  }
+
+  // Encodes the clip with the rate cost tables cached and then rebuilt on
+  // every frame, and checks that every frame comes out the same.
+  void RunAndCompare(::libvpx_test::VideoSource *video) {
+    const vpx_codec_enc_cfg_t cfg = cfg_;
+    disable_cache_ = 0;
+    ASSERT_NO_FATAL_FAILURE(RunLoop(video));
+    const std::vector<std::string> cached_md5s = md5s_;
+    md5s_.clear();
+    cfg_ = cfg;
+    disable_cache_ = 1;
+    ASSERT_NO_FATAL_FAILURE(RunLoop(video));
+    ASSERT_EQ(cached_md5s.size(), md5s_.size());
+    for (size_t i = 0; i < md5s_.size(); ++i) {
+      EXPECT_EQ(cached_md5s[i], md5s_[i]) << "frame " << i;
+    }
+  }
+
+  ::libvpx_test::TestMode encoding_mode_;
+  int speed_;
+  int disable_cache_;
+  bool switch_q_;
+  bool post_encode_drop_;
+  std::vector<std::string> md5s_;
+};
+
+// allow_high_precision_mv goes on and off with q, which changes the mv cost
+// tables without a change of the probabilities.
+TEST_P(VP9RdCostCacheTest, HighPrecisionMvSwitches) {
+  ::libvpx_test::MovingTextureVideoSource video;
+  video.SetSize(352, 288);
+  video.set_limit(kNumFrames);
+  switch_q_ = true;
+  RunAndCompare(&video);
+  EXPECT_EQ(static_cast<size_t>(kNumFrames), md5s_.size());
+}
+
+// A frame dropped after it is encoded goes through restore_coding_context(),
+// which restores the mv cost tables. Post encode drop is only used in realtime
+// mode.
+class VP9RdCostCachePostEncodeDropTest : public VP9RdCostCacheTest {};
+
+TEST_P(VP9RdCostCachePostEncodeDropTest, RestoresMvCosts) {
+  ::libvpx_test::MovingTextureVideoSource video;
+  video.SetSize(352, 288);
+  video.set_limit(kNumFrames);
+  // Small enough buffers for some frames to be dropped after they are
+  // encoded.
+  cfg_.rc_buf_initial_sz = 50;
+  cfg_.rc_buf_optimal_sz = 50;
+  cfg_.rc_buf_sz = 100;
+  post_encode_drop_ = true;
+  RunAndCompare(&video);
+  EXPECT_GT(md5s_.size(), 0u);
+  EXPECT_LT(md5s_.size(), static_cast<size_t>(kNumFrames));
+}
+
+VP9_INSTANTIATE_TEST_SUITE(
+    VP9RdCostCacheTest,
+    ::testing::Values(::libvpx_test::kRealTime, ::libvpx_test::kOnePassGood),
+    ::testing::Values(2, 5, 8));
+VP9_INSTANTIATE_TEST_SUITE(VP9RdCostCachePostEncodeDropTest,
+                           ::testing::Values(::libvpx_test::kRealTime),
+                           ::testing::Values(5, 8));
+}  // namespace
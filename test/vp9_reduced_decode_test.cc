@@ -0,0 +1,165 @@
+/*
+ *  Copyright (c) 2024 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <math.h>
+#include <algorithm>
+#include <tuple>
+
+#include "third_party/googletest/src/include/gtest/gtest.h"
+#include "test/codec_factory.h"
+#include "test/encode_test_driver.h"
+#include "test/util.h"
+#include "test/video_source.h"
+#include "vpx/vp8dx.h"
+#include "vpx/vpx_decoder.h"
+
+namespace {
+
+const int kWidth = 512;
+const int kHeight = 288;
+const int kNumFrames = 20;
+
+// Smooth content panning across the frame, so the downscaled full decode is
+// a meaningful reference.
+class PanningVideoSource : public ::libvpx_test::DummyVideoSource {
+ protected:
+  void FillFrame() override {
+    if (!img_) return;
+    for (int plane = 0; plane < 3; ++plane) {
+      const int w = plane ? (img_->d_w + 1) >> 1 : img_->d_w;
+      const int h = plane ? (img_->d_h + 1) >> 1 : img_->d_h;
+      const int shift = plane ? 1 : 0;
+      for (int r = 0; r < h; ++r) {
+        uint8_t *const row = img_->planes[plane] + r * img_->stride[plane];
+        for (int c = 0; c < w; ++c) {
+          const double x = ((c << shift) + 3.0 * frame_) / 48.0;
+          const double y = ((r << shift) + 2.0 * frame_) / 40.0;
+          row[c] = static_cast<uint8_t>(128 + (plane ? 30 : 80) * sin(x) *
+                                                  cos(y + plane));
+        }
+      }
+    }
+  }
+};
+
+// Parameters: log2 of the downscaling factor, number of decoder threads.
+class VP9ReducedDecodeTest
+    : public ::libvpx_test::EncoderTest,
+      public ::testing::TestWithParam<std::tuple<int, int>> {
+ protected:
+  VP9ReducedDecodeTest()
+      : EncoderTest(&::libvpx_test::kVP9), full_decoder_(), reduced_decoder_(),
+        num_frames_(0), min_psnr_(100.0) {}
+  ~VP9ReducedDecodeTest() override {
+    vpx_codec_destroy(&full_decoder_);
+    vpx_codec_destroy(&reduced_decoder_);
+  }
+
+  void SetUp() override {
+    vpx_codec_dec_cfg_t cfg = vpx_codec_dec_cfg_t();
+    cfg.threads = GET_PARAM(1);
+    ASSERT_EQ(VPX_CODEC_OK, vpx_codec_dec_init(&full_decoder_,
+                                               vpx_codec_vp9_dx(), &cfg, 0));
+    ASSERT_EQ(VPX_CODEC_OK, vpx_codec_dec_init(&reduced_decoder_,
+                                               vpx_codec_vp9_dx(), &cfg, 0));
+    ASSERT_EQ(VPX_CODEC_OK,
+              vpx_codec_control(&reduced_decoder_, VP9D_SET_REDUCED_RESOLUTION,
+                                GET_PARAM(0)));
+
+    InitializeConfig();
+    SetMode(::libvpx_test::kOnePassGood);
+    cfg_.g_lag_in_frames = 0;
+    cfg_.rc_end_usage = VPX_CBR;
+    cfg_.rc_target_bitrate = 400;
+  }
+
+  void PreEncodeFrameHook(::libvpx_test::VideoSource *video,
+                          ::libvpx_test::Encoder *encoder) override {
+    if (video->frame() == 0) {
+      encoder->Control(VP8E_SET_CPUUSED, 4);
+      encoder->Control(VP9E_SET_TILE_COLUMNS, 1);
+    }
+  }
+
+  bool DoDecode() const override { return false; }
+
+  static const vpx_image_t *Decode(vpx_codec_ctx_t *decoder,
+                                   const vpx_codec_cx_pkt_t *pkt) {
+    vpx_codec_iter_t iter = nullptr;
+    const vpx_codec_err_t res = vpx_codec_decode(
+        decoder, static_cast<const uint8_t *>(pkt->data.frame.buf),
+        static_cast<unsigned int>(pkt->data.frame.sz), nullptr, 0);
+    EXPECT_EQ(VPX_CODEC_OK, res) << vpx_codec_error_detail(decoder);
+    return res == VPX_CODEC_OK ? vpx_codec_get_frame(decoder, &iter) : nullptr;
+  }
+
+  // PSNR of the reduced luma against the box filtered full decode.
+  static double ReducedPsnr(const vpx_image_t *full,
+                            const vpx_image_t *reduced, int shift) {
+    const int n = 1 << shift;
+    double sse = 0;
+    for (unsigned int r = 0; r < reduced->d_h; ++r) {
+      for (unsigned int c = 0; c < reduced->d_w; ++c) {
+        int sum = 0;
+        for (int i = 0; i < n; ++i) {
+          for (int j = 0; j < n; ++j) {
+            sum += full->planes[VPX_PLANE_Y][((r << shift) + i) *
+                                                 full->stride[VPX_PLANE_Y] +
+                                             (c << shift) + j];
+          }
+        }
+        const int diff =
+            reduced->planes[VPX_PLANE_Y][r * reduced->stride[VPX_PLANE_Y] +
+                                         c] -
+            (sum + n * n / 2) / (n * n);
+        sse += diff * diff;
+      }
+    }
+    if (sse == 0) return 100.0;
+    return 10.0 * log10(255.0 * 255.0 * reduced->d_w * reduced->d_h / sse);
+  }
+
+  void FramePktHook(const vpx_codec_cx_pkt_t *pkt) override {
+    const int shift = GET_PARAM(0);
+    const vpx_image_t *const full = Decode(&full_decoder_, pkt);
+    const vpx_image_t *const reduced = Decode(&reduced_decoder_, pkt);
+    int frame_size[2];
+    ASSERT_NE(full, nullptr);
+    ASSERT_NE(reduced, nullptr);
+    EXPECT_EQ(kWidth >> shift, static_cast<int>(reduced->d_w));
+    EXPECT_EQ(kHeight >> shift, static_cast<int>(reduced->d_h));
+    ASSERT_EQ(VPX_CODEC_OK, vpx_codec_control(&reduced_decoder_,
+                                              VP9D_GET_FRAME_SIZE, frame_size));
+    EXPECT_EQ(kWidth, frame_size[0]);
+    EXPECT_EQ(kHeight, frame_size[1]);
+    min_psnr_ = std::min(min_psnr_, ReducedPsnr(full, reduced, shift));
+    ++num_frames_;
+  }
+
+  vpx_codec_ctx_t full_decoder_;
+  vpx_codec_ctx_t reduced_decoder_;
+  int num_frames_;
+  double min_psnr_;
+};
+
+TEST_P(VP9ReducedDecodeTest, TracksDownscaledFullDecode) {
+  PanningVideoSource video;
+  video.SetSize(kWidth, kHeight);
+  video.set_limit(kNumFrames);
+  ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+  EXPECT_EQ(kNumFrames, num_frames_);
+  // The reduced decode drifts from the full one, but stays close to it.
+  EXPECT_GT(min_psnr_, 30.0);
+}
+
+INSTANTIATE_TEST_SUITE_P(VP9, VP9ReducedDecodeTest,
+                         ::testing::Combine(::testing::Values(1, 2),
+                                            ::testing::Values(1, 2)));
+}  // namespace
@@ -0,0 +1,63 @@
+/*
+ *  Copyright (c) 2024 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "third_party/googletest/src/include/gtest/gtest.h"
+#include "test/codec_factory.h"
+#include "test/encode_test_driver.h"
+#include "test/util.h"
+#include "test/video_source.h"
+#include "vpx/vp8cx.h"
+
+namespace {
+
+// Parameter: speed.
+class VP9SbRefSadTest : public ::libvpx_test::EncoderTest,
+                        public ::testing::TestWithParam<int> {
+ protected:
+  VP9SbRefSadTest() : EncoderTest(&::libvpx_test::kVP9) {
+    stats_.ref_prunes = 0;
+    stats_.filter_skips = 0;
+  }
+
+  void SetUp() override {
+    InitializeConfig();
+    SetMode(::libvpx_test::kRealTime);
+    cfg_.g_lag_in_frames = 0;
+    cfg_.rc_end_usage = VPX_CBR;
+    cfg_.rc_target_bitrate = 500;
+    cfg_.rc_dropframe_thresh = 0;
+    cfg_.kf_max_dist = 9999;
+  }
+
+  void PreEncodeFrameHook(::libvpx_test::VideoSource *video,
+                          ::libvpx_test::Encoder *encoder) override {
+    if (video->frame() == 0) encoder->Control(VP8E_SET_CPUUSED, GetParam());
+  }
+
+  void PostEncodeFrameHook(::libvpx_test::Encoder *encoder) override {
+    encoder->Control(VP9E_GET_SB_SAD_PRUNE_STATS, &stats_);
+  }
+
+  vpx_sb_sad_prune_stats_t stats_;
+};
+
+// The golden frame falls behind the moving texture, so the superblock sads
+// prune it. The test driver checks that the encoder reconstruction matches the
+// decoded frames.
+TEST_P(VP9SbRefSadTest, PrunesReferences) {
+  ::libvpx_test::MovingTextureVideoSource video;
+  video.SetSize(352, 288);
+  video.set_limit(30);
+  ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+  EXPECT_GT(stats_.ref_prunes, 0u);
+}
+
+INSTANTIATE_TEST_SUITE_P(VP9, VP9SbRefSadTest, ::testing::Values(7, 8));
+}  // namespace
@@ -0,0 +1,159 @@
+/*
+ *  Copyright (c) 2024 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <math.h>
+#include <tuple>
+
+#include "third_party/googletest/src/include/gtest/gtest.h"
+#include "test/codec_factory.h"
+#include "test/encode_test_driver.h"
+#include "test/util.h"
+#include "test/video_source.h"
+#include "vpx/vp8cx.h"
+#include "vpx/vp8dx.h"
+#include "vpx/vpx_decoder.h"
+
+namespace {
+
+// Odd, so the last chroma column and row cover a single luma sample.
+const int kWidth = 351;
+const int kHeight = 287;
+const int kNumFrames = 12;
+
+class MovingVideoSource : public ::libvpx_test::DummyVideoSource {
+ protected:
+  void FillFrame() override {
+    if (!img_) return;
+    for (int plane = 0; plane < 3; ++plane) {
+      const int w = plane ? (img_->d_w + 1) >> 1 : img_->d_w;
+      const int h = plane ? (img_->d_h + 1) >> 1 : img_->d_h;
+      const int shift = plane ? 1 : 0;
+      for (int r = 0; r < h; ++r) {
+        uint8_t *const row = img_->planes[plane] + r * img_->stride[plane];
+        for (int c = 0; c < w; ++c) {
+          const double x = ((c << shift) + 5.0 * frame_) / 21.0;
+          const double y = ((r << shift) + 3.0 * frame_) / 17.0;
+          row[c] = static_cast<uint8_t>(128 + (plane ? 50 : 90) * sin(x) *
+                                                  cos(y + plane));
+        }
+      }
+    }
+  }
+};
+
+// Parameters: number of decoder threads, row based multi-threading.
+class VP9SemiPlanarTest
+    : public ::libvpx_test::EncoderTest,
+      public ::testing::TestWithParam<std::tuple<int, int>> {
+ protected:
+  VP9SemiPlanarTest()
+      : EncoderTest(&::libvpx_test::kVP9), planar_decoder_(),
+        semi_planar_decoder_(), num_frames_(0) {}
+  ~VP9SemiPlanarTest() override {
+    vpx_codec_destroy(&planar_decoder_);
+    vpx_codec_destroy(&semi_planar_decoder_);
+  }
+
+  void SetUp() override {
+    vpx_codec_dec_cfg_t cfg = vpx_codec_dec_cfg_t();
+    cfg.threads = GET_PARAM(0);
+    ASSERT_EQ(VPX_CODEC_OK, vpx_codec_dec_init(&planar_decoder_,
+                                               vpx_codec_vp9_dx(), &cfg, 0));
+    ASSERT_EQ(VPX_CODEC_OK, vpx_codec_dec_init(&semi_planar_decoder_,
+                                               vpx_codec_vp9_dx(), &cfg, 0));
+    ASSERT_EQ(VPX_CODEC_OK,
+              vpx_codec_control(&semi_planar_decoder_, VP9D_SET_ROW_MT,
+                                GET_PARAM(1)));
+    ASSERT_EQ(VPX_CODEC_OK,
+              vpx_codec_control(&semi_planar_decoder_,
+                                VP9D_SET_SEMI_PLANAR_OUTPUT, 1));
+
+    InitializeConfig();
+    SetMode(::libvpx_test::kOnePassGood);
+    cfg_.g_lag_in_frames = 6;
+    cfg_.rc_end_usage = VPX_VBR;
+    cfg_.rc_target_bitrate = 400;
+  }
+
+  void PreEncodeFrameHook(::libvpx_test::VideoSource *video,
+                          ::libvpx_test::Encoder *encoder) override {
+    if (video->frame() == 0) {
+      encoder->Control(VP8E_SET_CPUUSED, 4);
+      encoder->Control(VP8E_SET_ENABLEAUTOALTREF, 1);
+    }
+  }
+
+  bool DoDecode() const override { return false; }
+
+  static const vpx_image_t *Decode(vpx_codec_ctx_t *decoder,
+                                   const vpx_codec_cx_pkt_t *pkt) {
+    vpx_codec_iter_t iter = nullptr;
+    const vpx_codec_err_t res = vpx_codec_decode(
+        decoder, static_cast<const uint8_t *>(pkt->data.frame.buf),
+        static_cast<unsigned int>(pkt->data.frame.sz), nullptr, 0);
+    EXPECT_EQ(VPX_CODEC_OK, res) << vpx_codec_error_detail(decoder);
+    return res == VPX_CODEC_OK ? vpx_codec_get_frame(decoder, &iter) : nullptr;
+  }
+
+  void FramePktHook(const vpx_codec_cx_pkt_t *pkt) override {
+    const vpx_image_t *const planar = Decode(&planar_decoder_, pkt);
+    const vpx_image_t *const semi_planar = Decode(&semi_planar_decoder_, pkt);
+    ASSERT_EQ(planar == nullptr, semi_planar == nullptr);
+    if (planar == nullptr) return;
+    ASSERT_EQ(VPX_IMG_FMT_I420, planar->fmt);
+    ASSERT_EQ(VPX_IMG_FMT_NV12, semi_planar->fmt);
+    ASSERT_EQ(planar->d_w, semi_planar->d_w);
+    ASSERT_EQ(planar->d_h, semi_planar->d_h);
+    EXPECT_EQ(0u, semi_planar->x_chroma_shift);
+    EXPECT_EQ(1u, semi_planar->y_chroma_shift);
+    EXPECT_EQ(semi_planar->planes[VPX_PLANE_U] + 1,
+              semi_planar->planes[VPX_PLANE_V]);
+
+    for (unsigned int r = 0; r < planar->d_h; ++r) {
+      ASSERT_EQ(0, memcmp(planar->planes[VPX_PLANE_Y] +
+                              r * planar->stride[VPX_PLANE_Y],
+                          semi_planar->planes[VPX_PLANE_Y] +
+                              r * semi_planar->stride[VPX_PLANE_Y],
+                          planar->d_w));
+    }
+    for (unsigned int r = 0; r < (planar->d_h + 1) >> 1; ++r) {
+      const uint8_t *const uv = semi_planar->planes[VPX_PLANE_U] +
+                                r * semi_planar->stride[VPX_PLANE_U];
+      for (unsigned int c = 0; c < (planar->d_w + 1) >> 1; ++c) {
+        ASSERT_EQ(planar->planes[VPX_PLANE_U][r * planar->stride[VPX_PLANE_U] +
+                                              c],
+                  uv[2 * c])
+            << "row " << r << " col " << c;
+        ASSERT_EQ(planar->planes[VPX_PLANE_V][r * planar->stride[VPX_PLANE_V] +
+                                              c],
+                  uv[2 * c + 1])
+            << "row " << r << " col " << c;
+      }
+    }
+    ++num_frames_;
+  }
+
+  vpx_codec_ctx_t planar_decoder_;
+  vpx_codec_ctx_t semi_planar_decoder_;
+  int num_frames_;
+};
+
+TEST_P(VP9SemiPlanarTest, MatchesPlanarOutput) {
+  MovingVideoSource video;
+  video.SetSize(kWidth, kHeight);
+  video.set_limit(kNumFrames);
+  ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+  EXPECT_EQ(kNumFrames, num_frames_);
+}
+
+INSTANTIATE_TEST_SUITE_P(VP9, VP9SemiPlanarTest,
+                         ::testing::Combine(::testing::Values(1, 3),
+                                            ::testing::Values(0, 1)));
+}  // namespace
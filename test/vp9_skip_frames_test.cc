@@ -0,0 +1,148 @@
+/*
+ *  Copyright (c) 2024 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string.h>
+
+#include "third_party/googletest/src/include/gtest/gtest.h"
+#include "test/codec_factory.h"
+#include "test/encode_test_driver.h"
+#include "test/util.h"
+#include "test/video_source.h"
+#include "vpx/vp8cx.h"
+#include "vpx/vp8dx.h"
+#include "vpx/vpx_decoder.h"
+
+namespace {
+
+const int kNumFrames = 12;
+const int kKeyFrame = 6;
+// Frame at which the skipping decoder is told to drop frames until the next
+// key frame.
+const int kSkipToKeyFrame = 3;
+
+// Parameter: whether the stream is error resilient, which stops frames from
+// predicting motion vectors from the frame before them.
+class VP9SkipFramesTest : public ::libvpx_test::EncoderTest,
+                          public ::testing::TestWithParam<int> {
+ protected:
+  VP9SkipFramesTest()
+      : EncoderTest(&::libvpx_test::kVP9), full_decoder_(), skip_decoder_(),
+        num_frames_(0), num_shown_(0), num_exact_(0) {}
+  ~VP9SkipFramesTest() override {
+    vpx_codec_destroy(&full_decoder_);
+    vpx_codec_destroy(&skip_decoder_);
+  }
+
+  void SetUp() override {
+    vpx_codec_dec_cfg_t cfg = vpx_codec_dec_cfg_t();
+    ASSERT_EQ(VPX_CODEC_OK, vpx_codec_dec_init(&full_decoder_,
+                                               vpx_codec_vp9_dx(), &cfg, 0));
+    ASSERT_EQ(VPX_CODEC_OK, vpx_codec_dec_init(&skip_decoder_,
+                                               vpx_codec_vp9_dx(), &cfg, 0));
+    ASSERT_EQ(VPX_CODEC_OK, vpx_codec_control(&skip_decoder_,
+                                              VP9D_SET_SKIP_NON_REF_FRAMES, 1));
+
+    InitializeConfig();
+    SetMode(::libvpx_test::kRealTime);
+    cfg_.g_lag_in_frames = 0;
+    cfg_.g_error_resilient = GetParam();
+    cfg_.rc_end_usage = VPX_CBR;
+    cfg_.rc_target_bitrate = 500;
+  }
+
+  void PreEncodeFrameHook(::libvpx_test::VideoSource *video,
+                          ::libvpx_test::Encoder *encoder) override {
+    if (video->frame() == 0) encoder->Control(VP8E_SET_CPUUSED, 7);
+    // Every odd frame is a non-reference frame.
+    frame_flags_ = 0;
+    if (video->frame() & 1) {
+      frame_flags_ =
+          VP8_EFLAG_NO_UPD_LAST | VP8_EFLAG_NO_UPD_GF | VP8_EFLAG_NO_UPD_ARF;
+    } else if (video->frame() == kKeyFrame) {
+      frame_flags_ = VPX_EFLAG_FORCE_KF;
+    }
+  }
+
+  bool DoDecode() const override { return false; }
+
+  static const vpx_image_t *Decode(vpx_codec_ctx_t *decoder,
+                                   const vpx_codec_cx_pkt_t *pkt) {
+    vpx_codec_iter_t iter = nullptr;
+    const vpx_codec_err_t res = vpx_codec_decode(
+        decoder, static_cast<const uint8_t *>(pkt->data.frame.buf),
+        static_cast<unsigned int>(pkt->data.frame.sz), nullptr, 0);
+    EXPECT_EQ(VPX_CODEC_OK, res) << vpx_codec_error_detail(decoder);
+    return res == VPX_CODEC_OK ? vpx_codec_get_frame(decoder, &iter) : nullptr;
+  }
+
+  void FramePktHook(const vpx_codec_cx_pkt_t *pkt) override {
+    if (num_frames_ == kSkipToKeyFrame) {
+      ASSERT_EQ(VPX_CODEC_OK, vpx_codec_control(&skip_decoder_,
+                                                VP9D_SET_SKIP_TO_KEYFRAME, 1));
+    }
+    const vpx_image_t *const full = Decode(&full_decoder_, pkt);
+    const vpx_image_t *const img = Decode(&skip_decoder_, pkt);
+    const bool dropped =
+        (num_frames_ & 1) ||
+        (num_frames_ >= kSkipToKeyFrame && num_frames_ < kKeyFrame);
+    ASSERT_NE(full, nullptr);
+    ++num_frames_;
+    if (dropped) {
+      EXPECT_EQ(img, nullptr) << "frame " << num_frames_ - 1;
+      return;
+    }
+    ASSERT_NE(img, nullptr) << "frame " << num_frames_ - 1;
+    ++num_shown_;
+
+    int corrupted = 0;
+    ASSERT_EQ(VPX_CODEC_OK, vpx_codec_control(&skip_decoder_,
+                                              VP8D_GET_FRAME_CORRUPTED,
+                                              &corrupted));
+    if (GetParam() || (pkt->data.frame.flags & VPX_FRAME_IS_KEY)) {
+      EXPECT_EQ(0, corrupted) << "frame " << num_frames_ - 1;
+    }
+    if (corrupted) return;
+    for (int plane = 0; plane < 3; ++plane) {
+      const int w = plane ? (full->d_w + 1) >> 1 : full->d_w;
+      const int h = plane ? (full->d_h + 1) >> 1 : full->d_h;
+      for (int r = 0; r < h; ++r) {
+        ASSERT_EQ(0, memcmp(full->planes[plane] + r * full->stride[plane],
+                            img->planes[plane] + r * img->stride[plane], w))
+            << "frame " << num_frames_ - 1 << " plane " << plane;
+      }
+    }
+    ++num_exact_;
+  }
+
+  vpx_codec_ctx_t full_decoder_;
+  vpx_codec_ctx_t skip_decoder_;
+  int num_frames_;
+  int num_shown_;
+  int num_exact_;
+};
+
+TEST_P(VP9SkipFramesTest, ShownFramesMatchFullDecode) {
+  ::libvpx_test::RandomVideoSource video;
+  video.SetSize(352, 288);
+  video.set_limit(kNumFrames);
+  ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+  EXPECT_EQ(kNumFrames, num_frames_);
+  // Frames 0, 2, 6, 8 and 10.
+  EXPECT_EQ(5, num_shown_);
+  if (GetParam()) {
+    EXPECT_EQ(num_shown_, num_exact_);
+  } else {
+    // Frames after a dropped frame predict from its motion vectors.
+    EXPECT_GT(num_exact_, 0);
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(VP9, VP9SkipFramesTest, ::testing::Values(0, 1));
+}  // namespace
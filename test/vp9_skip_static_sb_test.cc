@@ -0,0 +1,184 @@
+/*
+ *  Copyright (c) 2024 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string.h>
+#include <tuple>
+#include <vector>
+
+#include "third_party/googletest/src/include/gtest/gtest.h"
+#include "test/codec_factory.h"
+#include "test/encode_test_driver.h"
+#include "test/util.h"
+#include "test/video_source.h"
+#include "vpx/vp8cx.h"
+
+namespace {
+
+// Not a multiple of 64, so the last superblock row and column are partial.
+const int kWidth = 330;
+const int kHeight = 250;
+const int kNumFrames = 20;
+const int kBoxSize = 24;
+const int kSbRows = (kHeight + 63) / 64;
+const int kSbCols = (kWidth + 63) / 64;
+
+// A static textured background with a small box moving across it, so most
+// superblocks are identical to the previous frame.
+class MovingBoxVideoSource : public ::libvpx_test::DummyVideoSource {
+ public:
+  static int BoxCol(int frame) { return 10 + frame * 13; }
+  static int BoxRow(int frame) { return 20 + frame * 9; }
+
+ protected:
+  void FillFrame() override {
+    if (!img_) return;
+    for (int plane = 0; plane < 3; ++plane) {
+      const int shift = plane ? 1 : 0;
+      const int w = (img_->d_w + shift) >> shift;
+      const int h = (img_->d_h + shift) >> shift;
+      for (int r = 0; r < h; ++r) {
+        uint8_t *const row = img_->planes[plane] + r * img_->stride[plane];
+        for (int c = 0; c < w; ++c) {
+          row[c] = static_cast<uint8_t>(
+              plane ? 128 + ((r / 4 + c / 6) & 7) : ((r * 7) ^ (c * 5)) & 0xf0);
+        }
+      }
+    }
+    for (int r = 0; r < kBoxSize; ++r) {
+      memset(img_->planes[0] + (BoxRow(frame_) + r) * img_->stride[0] +
+                 BoxCol(frame_),
+             static_cast<int>(frame_ * 11), kBoxSize);
+    }
+  }
+};
+
+// Parameters: speed and content type.
+class VP9SkipStaticSbTest
+    : public ::libvpx_test::EncoderTest,
+      public ::testing::TestWithParam<std::tuple<int, vp9e_tune_content>> {
+ protected:
+  enum SkipMode { kSkipOff, kSkipCompare, kSkipDirtyMap };
+
+  VP9SkipStaticSbTest()
+      : EncoderTest(&::libvpx_test::kVP9), mode_(kSkipOff), num_frames_(0),
+        psnr_(0.0), bytes_(0), static_sbs_(0) {}
+
+  void SetUp() override {
+    InitializeConfig();
+    SetMode(::libvpx_test::kRealTime);
+    cfg_.g_lag_in_frames = 0;
+    cfg_.rc_end_usage = VPX_CBR;
+    cfg_.rc_target_bitrate = 300;
+    cfg_.rc_dropframe_thresh = 0;
+    init_flags_ = VPX_CODEC_USE_PSNR;
+  }
+
+  void PreEncodeFrameHook(::libvpx_test::VideoSource *video,
+                          ::libvpx_test::Encoder *encoder) override {
+    const int frame = static_cast<int>(video->frame());
+    if (frame == 0) {
+      encoder->Control(VP8E_SET_CPUUSED, std::get<0>(GetParam()));
+      encoder->Control(VP9E_SET_TUNE_CONTENT, std::get<1>(GetParam()));
+      encoder->Control(VP9E_SET_AQ_MODE, 3);
+      encoder->Control(VP9E_SET_SKIP_STATIC_SB, mode_ != kSkipOff);
+    } else if (mode_ == kSkipDirtyMap) {
+      // Mark the superblocks covered by the box in this frame or the last.
+      std::vector<unsigned char> dirty(kSbRows * kSbCols, 0);
+      for (int f = frame - 1; f <= frame; ++f) {
+        const int col = MovingBoxVideoSource::BoxCol(f);
+        const int row = MovingBoxVideoSource::BoxRow(f);
+        for (int r = row / 64; r <= (row + kBoxSize - 1) / 64; ++r) {
+          for (int c = col / 64; c <= (col + kBoxSize - 1) / 64; ++c) {
+            dirty[r * kSbCols + c] = 1;
+          }
+        }
+      }
+      vpx_sb_dirty_map_t map;
+      map.dirty_map = &dirty[0];
+      map.rows = kSbRows;
+      map.cols = kSbCols;
+      encoder->Control(VP9E_SET_SB_DIRTY_MAP, &map);
+    }
+  }
+
+  void PostEncodeFrameHook(::libvpx_test::Encoder *encoder) override {
+    int count = 0;
+    encoder->Control(VP9E_GET_STATIC_SB_COUNT, &count);
+    static_sbs_ += count;
+  }
+
+  void FramePktHook(const vpx_codec_cx_pkt_t *pkt) override {
+    bytes_ += pkt->data.frame.sz;
+  }
+
+  void PSNRPktHook(const vpx_codec_cx_pkt_t *pkt) override {
+    psnr_ += pkt->data.psnr.psnr[0];
+    ++num_frames_;
+  }
+
+  // Encodes the clip, setting the average PSNR, the size of the stream and the
+  // number of superblocks coded as static. The test driver checks that the
+  // encoder reconstruction matches the decoded frames.
+  void Encode(SkipMode mode, double *psnr, size_t *bytes, int *static_sbs) {
+    MovingBoxVideoSource video;
+    mode_ = mode;
+    num_frames_ = 0;
+    psnr_ = 0.0;
+    bytes_ = 0;
+    static_sbs_ = 0;
+    video.SetSize(kWidth, kHeight);
+    video.set_limit(kNumFrames);
+    ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+    ASSERT_EQ(kNumFrames, num_frames_);
+    *psnr = psnr_ / num_frames_;
+    *bytes = bytes_;
+    *static_sbs = static_sbs_;
+  }
+
+  SkipMode mode_;
+  int num_frames_;
+  double psnr_;
+  size_t bytes_;
+  int static_sbs_;
+};
+
+TEST_P(VP9SkipStaticSbTest, MatchesDecoderAndKeepsQuality) {
+  double psnr, skip_psnr;
+  size_t bytes, skip_bytes;
+  int static_sbs, skip_static_sbs;
+  ASSERT_NO_FATAL_FAILURE(Encode(kSkipOff, &psnr, &bytes, &static_sbs));
+  ASSERT_NO_FATAL_FAILURE(
+      Encode(kSkipCompare, &skip_psnr, &skip_bytes, &skip_static_sbs));
+  EXPECT_EQ(0, static_sbs);
+  // Only the superblocks the box covers in a frame or the last change.
+  EXPECT_GT(skip_static_sbs, (kNumFrames - 1) * kSbRows * kSbCols / 2);
+  EXPECT_GT(skip_psnr, psnr - 0.5);
+  EXPECT_LT(skip_bytes, bytes + bytes / 10);
+}
+
+TEST_P(VP9SkipStaticSbTest, DirtyMapMatchesCompare) {
+  double psnr, map_psnr;
+  size_t bytes, map_bytes;
+  int static_sbs, map_static_sbs;
+  ASSERT_NO_FATAL_FAILURE(Encode(kSkipCompare, &psnr, &bytes, &static_sbs));
+  ASSERT_NO_FATAL_FAILURE(
+      Encode(kSkipDirtyMap, &map_psnr, &map_bytes, &map_static_sbs));
+  EXPECT_GT(static_sbs, 0);
+  EXPECT_EQ(static_sbs, map_static_sbs);
+  EXPECT_EQ(bytes, map_bytes);
+  EXPECT_DOUBLE_EQ(psnr, map_psnr);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    VP9, VP9SkipStaticSbTest,
+    ::testing::Combine(::testing::Values(5, 7, 9),
+                       ::testing::Values(VP9E_CONTENT_DEFAULT,
+                                         VP9E_CONTENT_SCREEN)));
+}  // namespace
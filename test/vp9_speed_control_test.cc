@@ -0,0 +1,124 @@
+/*
+ *  Copyright (c) 2024 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <vector>
+
+#include "third_party/googletest/src/include/gtest/gtest.h"
+#include "test/codec_factory.h"
+#include "test/encode_test_driver.h"
+#include "test/util.h"
+#include "test/video_source.h"
+#include "vpx/vp8cx.h"
+
+namespace {
+
+const int kCpuUsed = 5;
+// A speed using the rd mode search.
+const int kRdCpuUsed = 3;
+// Budgets no frame can meet, and every frame meets, in microseconds.
+const unsigned int kTinyBudget = 1;
+const unsigned int kHugeBudget = 1000000000;
+
+class VP9SpeedControlTest : public ::libvpx_test::EncoderTest,
+                            public ::testing::Test {
+ protected:
+  VP9SpeedControlTest()
+      : EncoderTest(&::libvpx_test::kVP9), cpu_used_(kCpuUsed), budget_(0),
+        new_budget_(0), new_budget_frame_(-1) {}
+
+  void SetUp() override {
+    InitializeConfig();
+    SetMode(::libvpx_test::kRealTime);
+    cfg_.g_lag_in_frames = 0;
+    cfg_.rc_end_usage = VPX_CBR;
+    cfg_.rc_target_bitrate = 300;
+    cfg_.rc_dropframe_thresh = 0;
+  }
+
+  void PreEncodeFrameHook(::libvpx_test::VideoSource *video,
+                          ::libvpx_test::Encoder *encoder) override {
+    const int frame = static_cast<int>(video->frame());
+    if (frame == 0) {
+      encoder->Control(VP8E_SET_CPUUSED, cpu_used_);
+      encoder->Control(VP9E_SET_TARGET_FRAME_TIME, static_cast<int>(budget_));
+    } else if (frame == new_budget_frame_) {
+      encoder->Control(VP9E_SET_TARGET_FRAME_TIME,
+                       static_cast<int>(new_budget_));
+    }
+  }
+
+  void PostEncodeFrameHook(::libvpx_test::Encoder *encoder) override {
+    int speed = 0;
+    encoder->Control(VP9E_GET_LAST_SPEED, &speed);
+    speeds_.push_back(speed);
+  }
+
+  // Encodes |num_frames| frames, recording the speed of each. The test driver
+  // checks that the encoder reconstruction matches the decoded frames.
+  void Encode(int num_frames) {
+    ::libvpx_test::MovingTextureVideoSource video;
+    video.SetSize(176, 144);
+    video.set_limit(num_frames);
+    speeds_.clear();
+    ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+    // The last call flushes the encoder.
+    ASSERT_GE(static_cast<int>(speeds_.size()), num_frames);
+    speeds_.resize(num_frames);
+  }
+
+  int cpu_used_;
+  unsigned int budget_;
+  unsigned int new_budget_;
+  int new_budget_frame_;
+  std::vector<int> speeds_;
+};
+
+TEST_F(VP9SpeedControlTest, OffKeepsSpeed) {
+  ASSERT_NO_FATAL_FAILURE(Encode(20));
+  for (size_t i = 0; i < speeds_.size(); ++i) EXPECT_EQ(kCpuUsed, speeds_[i]);
+}
+
+TEST_F(VP9SpeedControlTest, WithinBudgetKeepsSpeed) {
+  budget_ = kHugeBudget;
+  ASSERT_NO_FATAL_FAILURE(Encode(20));
+  for (size_t i = 0; i < speeds_.size(); ++i) EXPECT_EQ(kCpuUsed, speeds_[i]);
+}
+
+TEST_F(VP9SpeedControlTest, OverBudgetRaisesSpeed) {
+  budget_ = kTinyBudget;
+  ASSERT_NO_FATAL_FAILURE(Encode(24));
+  EXPECT_EQ(kCpuUsed, speeds_[0]);
+  for (size_t i = 1; i < speeds_.size(); ++i) {
+    EXPECT_GE(speeds_[i], speeds_[i - 1]);
+    // Each speed is held for a few frames.
+    EXPECT_LE(speeds_[i], speeds_[i - 1] + 1);
+  }
+  EXPECT_EQ(9, speeds_.back());
+}
+
+TEST_F(VP9SpeedControlTest, KeepsRdModeSearch) {
+  cpu_used_ = kRdCpuUsed;
+  budget_ = kTinyBudget;
+  ASSERT_NO_FATAL_FAILURE(Encode(12));
+  EXPECT_EQ(kRdCpuUsed, speeds_[0]);
+  EXPECT_EQ(4, speeds_.back());
+}
+
+TEST_F(VP9SpeedControlTest, LowersSpeedOnceWithinBudget) {
+  budget_ = kTinyBudget;
+  new_budget_ = kHugeBudget;
+  new_budget_frame_ = 20;
+  ASSERT_NO_FATAL_FAILURE(Encode(60));
+  EXPECT_EQ(9, speeds_[new_budget_frame_]);
+  // The speed stays up for a while before it is lowered one step.
+  EXPECT_EQ(9, speeds_[new_budget_frame_ + 10]);
+  EXPECT_EQ(8, speeds_.back());
+}
+}  // namespace
@@ -74,6 +74,23 @@ TEST(VpxImageTest, VpxImgAllocNv12) {
   vpx_img_free(&img);
 }
 
+TEST(VpxImageTest, VpxImgAllocP010) {
+  const int kWidth = 128;
+  const int kHeight = 128;
+
+  vpx_image_t img;
+  vpx_img_fmt_t format = VPX_IMG_FMT_P010;
+  unsigned int align = 32;
+  EXPECT_EQ(vpx_img_alloc(&img, format, kWidth, kHeight, align), &img);
+  EXPECT_EQ(img.stride[VPX_PLANE_Y], 2 * kWidth);
+  EXPECT_EQ(img.stride[VPX_PLANE_U], img.stride[VPX_PLANE_Y]);
+  EXPECT_EQ(img.stride[VPX_PLANE_V], img.stride[VPX_PLANE_U]);
+  EXPECT_EQ(img.planes[VPX_PLANE_U],
+            img.planes[VPX_PLANE_Y] + kHeight * img.stride[VPX_PLANE_Y]);
+  EXPECT_EQ(img.planes[VPX_PLANE_V], img.planes[VPX_PLANE_U] + 2);
+  vpx_img_free(&img);
+}
+
 TEST(VpxImageTest, VpxImgAllocHugeWidth) {
   // The stride (0x80000000 * 2) would overflow unsigned int.
   vpx_image_t *image =
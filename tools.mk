@@ -14,7 +14,7 @@ tiny_ssim.SRCS       += vpx/vpx_integer.h y4minput.c y4minput.h \
                         vpx/vpx_codec.h vpx/src/vpx_image.c
 tiny_ssim.SRCS       += vpx_mem/vpx_mem.c vpx_mem/vpx_mem.h
 tiny_ssim.SRCS       += vpx_dsp/ssim.h vpx_scale/yv12config.h
-tiny_ssim.SRCS       += vpx_ports/mem.h vpx_ports/mem.h
+tiny_ssim.SRCS       += vpx_ports/mem.h vpx_util/vpx_pthread.h
 tiny_ssim.SRCS       += vpx_mem/include/vpx_mem_intrnl.h
 tiny_ssim.GUID        = 3afa9b05-940b-4d68-b5aa-55157d8ed7b4
 tiny_ssim.DESCRIPTION = Generate SSIM/PSNR from raw .yuv files
@@ -52,7 +52,8 @@ BINS-$(NOT_MSVS)           += $(addprefix $(BUILD_PFX),$(TOOLS:.c=$(EXE_SFX)))
 $(foreach bin,$(BINS-yes),\
     $(eval $(bin):)\
     $(eval $(call linker_template,$(bin),\
-        $(call objs,$($(notdir $(bin:$(EXE_SFX)=)).SRCS)) -lm)))
+        $(call objs,$($(notdir $(bin:$(EXE_SFX)=)).SRCS)) -lm \
+        $(if $(filter yesyes,$(CONFIG_MULTITHREAD)$(HAVE_PTHREAD_H)),-lpthread))))
 
 # The following pairs define a mapping of locations in the distribution
 # tree to locations in the source/build trees.
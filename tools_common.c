@@ -224,6 +224,8 @@ int vpx_img_plane_height(const vpx_image_t *img, int plane) {
 void vpx_img_write(const vpx_image_t *img, FILE *file) {
   int plane;
   const int bytespp = (img->fmt & VPX_IMG_FMT_HIGHBITDEPTH) ? 2 : 1;
+  const int semi_planar =
+      img->fmt == VPX_IMG_FMT_NV12 || img->fmt == VPX_IMG_FMT_P010;
 
   for (plane = 0; plane < 3; ++plane) {
     const unsigned char *buf = img->planes[plane];
@@ -232,10 +234,10 @@ void vpx_img_write(const vpx_image_t *img, FILE *file) {
     const int h = vpx_img_plane_height(img, plane);
     int y;
 
-    // Assuming that for nv12 we write all chroma data at once
-    if (img->fmt == VPX_IMG_FMT_NV12 && plane > 1) break;
-    // Fixing NV12 chroma width if it is odd
-    if (img->fmt == VPX_IMG_FMT_NV12 && plane == 1) w = (w + 1) & ~1;
+    // Assuming that for nv12 and p010 we write all chroma data at once
+    if (semi_planar && plane > 1) break;
+    // Fixing NV12 and P010 chroma width if it is odd
+    if (semi_planar && plane == 1) w = (w + 1) & ~1;
 
     for (y = 0; y < h; ++y) {
       fwrite(buf, bytespp, w, file);
@@ -0,0 +1,387 @@
+/*
+ *  Copyright (c) 2024 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <immintrin.h> /* AVX2 */
+
+#include "./vp8_rtcd.h"
+#include "vp8/common/loopfilter.h"
+#include "vpx_ports/mem.h"
+
+/* The 16 Y pixels of an edge go in the low 128-bit lane and the 8 U plus 8 V
+ * pixels in the high lane, so a macroblock edge is filtered in one pass. When
+ * there is no chroma the high lane repeats the Y pixels and is not stored. */
+
+static INLINE __m256i abs_diff(const __m256i a, const __m256i b) {
+  return _mm256_or_si256(_mm256_subs_epu8(a, b), _mm256_subs_epu8(b, a));
+}
+
+/* Arithmetic right shift of signed bytes. */
+static INLINE __m256i srai_epi8(const __m256i a, const int shift) {
+  const __m256i zero = _mm256_setzero_si256();
+  const int shift16 = 8 + shift;
+  const __m256i lo = _mm256_srai_epi16(_mm256_unpacklo_epi8(zero, a), shift16);
+  const __m256i hi = _mm256_srai_epi16(_mm256_unpackhi_epi8(zero, a), shift16);
+  return _mm256_packs_epi16(lo, hi);
+}
+
+static INLINE __m256i load_thresh(const unsigned char *thresh) {
+  return _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i *)thresh));
+}
+
+/* Sets |mask| where the edge should be filtered and |hev| where it has high
+ * edge variance, both as 0xff / 0x00 bytes. */
+static INLINE void filter_mask_hev(const __m256i *const p, const __m256i *q,
+                                   const unsigned char *blimit,
+                                   const unsigned char *limit,
+                                   const unsigned char *thresh, __m256i *mask,
+                                   __m256i *hev) {
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i fe = _mm256_set1_epi8((char)0xfe);
+  const __m256i abs_p1p0 = abs_diff(p[1], p[0]);
+  const __m256i abs_q1q0 = abs_diff(q[1], q[0]);
+  const __m256i flat = _mm256_max_epu8(abs_p1p0, abs_q1q0);
+  __m256i abs_p0q0 = abs_diff(p[0], q[0]);
+  __m256i abs_p1q1 = abs_diff(p[1], q[1]);
+  __m256i m;
+
+  m = _mm256_max_epu8(flat, abs_diff(p[3], p[2]));
+  m = _mm256_max_epu8(m, abs_diff(p[2], p[1]));
+  m = _mm256_max_epu8(m, abs_diff(q[2], q[1]));
+  m = _mm256_max_epu8(m, abs_diff(q[3], q[2]));
+  m = _mm256_subs_epu8(m, load_thresh(limit));
+
+  /* abs(p0 - q0) * 2 + abs(p1 - q1) / 2 > blimit. blimit never exceeds 193,
+   * so saturating at 255 does not change the comparison. */
+  abs_p0q0 = _mm256_adds_epu8(abs_p0q0, abs_p0q0);
+  abs_p1q1 = _mm256_srli_epi16(_mm256_and_si256(abs_p1q1, fe), 1);
+  abs_p0q0 = _mm256_adds_epu8(abs_p0q0, abs_p1q1);
+  m = _mm256_or_si256(m, _mm256_subs_epu8(abs_p0q0, load_thresh(blimit)));
+  *mask = _mm256_cmpeq_epi8(m, zero);
+
+  *hev = _mm256_subs_epu8(flat, load_thresh(thresh));
+  *hev = _mm256_xor_si256(_mm256_cmpeq_epi8(*hev, zero),
+                          _mm256_cmpeq_epi8(zero, zero));
+}
+
+/* clamp(ps1 - qs1) + 3 * (qs0 - ps0), clamped, as in vp8_filter(). */
+static INLINE __m256i filter_value(const __m256i ps1, const __m256i ps0,
+                                   const __m256i qs0, const __m256i qs1) {
+  const __m256i qs0_ps0 = _mm256_subs_epi8(qs0, ps0);
+  __m256i f = _mm256_subs_epi8(ps1, qs1);
+  f = _mm256_adds_epi8(f, qs0_ps0);
+  f = _mm256_adds_epi8(f, qs0_ps0);
+  return _mm256_adds_epi8(f, qs0_ps0);
+}
+
+static INLINE void loop_filter(const __m256i mask, const __m256i hev,
+                               __m256i *const p, __m256i *const q) {
+  const __m256i t80 = _mm256_set1_epi8((char)0x80);
+  const __m256i t1 = _mm256_set1_epi8(1);
+  const __m256i t3 = _mm256_set1_epi8(3);
+  const __m256i t4 = _mm256_set1_epi8(4);
+  __m256i ps1 = _mm256_xor_si256(p[1], t80);
+  __m256i ps0 = _mm256_xor_si256(p[0], t80);
+  __m256i qs0 = _mm256_xor_si256(q[0], t80);
+  __m256i qs1 = _mm256_xor_si256(q[1], t80);
+  const __m256i qs0_ps0 = _mm256_subs_epi8(qs0, ps0);
+  __m256i f, filter1, filter2;
+
+  f = _mm256_and_si256(_mm256_subs_epi8(ps1, qs1), hev);
+  f = _mm256_adds_epi8(f, qs0_ps0);
+  f = _mm256_adds_epi8(f, qs0_ps0);
+  f = _mm256_adds_epi8(f, qs0_ps0);
+  f = _mm256_and_si256(f, mask);
+
+  filter1 = srai_epi8(_mm256_adds_epi8(f, t4), 3);
+  filter2 = srai_epi8(_mm256_adds_epi8(f, t3), 3);
+  qs0 = _mm256_subs_epi8(qs0, filter1);
+  ps0 = _mm256_adds_epi8(ps0, filter2);
+
+  /* Outer tap adjustments. */
+  f = srai_epi8(_mm256_adds_epi8(filter1, t1), 1);
+  f = _mm256_andnot_si256(hev, f);
+  qs1 = _mm256_subs_epi8(qs1, f);
+  ps1 = _mm256_adds_epi8(ps1, f);
+
+  p[1] = _mm256_xor_si256(ps1, t80);
+  p[0] = _mm256_xor_si256(ps0, t80);
+  q[0] = _mm256_xor_si256(qs0, t80);
+  q[1] = _mm256_xor_si256(qs1, t80);
+}
+
+/* clamp((63 + f * tap) >> 7) for the signed bytes of |f|. */
+static INLINE __m256i mbfilter_tap(const __m256i f_lo, const __m256i f_hi,
+                                   const int tap) {
+  const __m256i k63 = _mm256_set1_epi16(63);
+  const __m256i k_tap = _mm256_set1_epi16(tap);
+  const __m256i lo =
+      _mm256_srai_epi16(_mm256_add_epi16(_mm256_mullo_epi16(f_lo, k_tap), k63),
+                        7);
+  const __m256i hi =
+      _mm256_srai_epi16(_mm256_add_epi16(_mm256_mullo_epi16(f_hi, k_tap), k63),
+                        7);
+  return _mm256_packs_epi16(lo, hi);
+}
+
+static INLINE void mbloop_filter(const __m256i mask, const __m256i hev,
+                                 __m256i *const p, __m256i *const q) {
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i t80 = _mm256_set1_epi8((char)0x80);
+  const __m256i t3 = _mm256_set1_epi8(3);
+  const __m256i t4 = _mm256_set1_epi8(4);
+  __m256i ps2 = _mm256_xor_si256(p[2], t80);
+  __m256i ps1 = _mm256_xor_si256(p[1], t80);
+  __m256i ps0 = _mm256_xor_si256(p[0], t80);
+  __m256i qs0 = _mm256_xor_si256(q[0], t80);
+  __m256i qs1 = _mm256_xor_si256(q[1], t80);
+  __m256i qs2 = _mm256_xor_si256(q[2], t80);
+  __m256i f, filter1, filter2, f_lo, f_hi, u;
+
+  f = _mm256_and_si256(filter_value(ps1, ps0, qs0, qs1), mask);
+
+  filter2 = _mm256_and_si256(f, hev);
+  filter1 = srai_epi8(_mm256_adds_epi8(filter2, t4), 3);
+  filter2 = srai_epi8(_mm256_adds_epi8(filter2, t3), 3);
+  qs0 = _mm256_subs_epi8(qs0, filter1);
+  ps0 = _mm256_adds_epi8(ps0, filter2);
+
+  /* Only apply the wider filter where there is no high edge variance. */
+  f = _mm256_andnot_si256(hev, f);
+  f_lo = _mm256_srai_epi16(_mm256_unpacklo_epi8(zero, f), 8);
+  f_hi = _mm256_srai_epi16(_mm256_unpackhi_epi8(zero, f), 8);
+
+  u = mbfilter_tap(f_lo, f_hi, 27);
+  qs0 = _mm256_subs_epi8(qs0, u);
+  ps0 = _mm256_adds_epi8(ps0, u);
+
+  u = mbfilter_tap(f_lo, f_hi, 18);
+  qs1 = _mm256_subs_epi8(qs1, u);
+  ps1 = _mm256_adds_epi8(ps1, u);
+
+  u = mbfilter_tap(f_lo, f_hi, 9);
+  qs2 = _mm256_subs_epi8(qs2, u);
+  ps2 = _mm256_adds_epi8(ps2, u);
+
+  p[2] = _mm256_xor_si256(ps2, t80);
+  p[1] = _mm256_xor_si256(ps1, t80);
+  p[0] = _mm256_xor_si256(ps0, t80);
+  q[0] = _mm256_xor_si256(qs0, t80);
+  q[1] = _mm256_xor_si256(qs1, t80);
+  q[2] = _mm256_xor_si256(qs2, t80);
+}
+
+static INLINE __m256i load_row(const unsigned char *y, const unsigned char *u,
+                               const unsigned char *v, int y_offset,
+                               int uv_offset) {
+  const __m128i y_row = _mm_loadu_si128((const __m128i *)(y + y_offset));
+  __m128i uv_row = y_row;
+  if (u != NULL) {
+    const __m128i u_row = _mm_loadl_epi64((const __m128i *)(u + uv_offset));
+    const __m128i v_row = _mm_loadl_epi64((const __m128i *)(v + uv_offset));
+    uv_row = _mm_unpacklo_epi64(u_row, v_row);
+  }
+  return _mm256_inserti128_si256(_mm256_castsi128_si256(y_row), uv_row, 1);
+}
+
+static INLINE void store_row(const __m256i row, unsigned char *y,
+                             unsigned char *u, unsigned char *v, int y_offset,
+                             int uv_offset) {
+  _mm_storeu_si128((__m128i *)(y + y_offset), _mm256_castsi256_si128(row));
+  if (u != NULL) {
+    const __m128i uv_row = _mm256_extracti128_si256(row, 1);
+    _mm_storel_epi64((__m128i *)(u + uv_offset), uv_row);
+    _mm_storel_epi64((__m128i *)(v + uv_offset), _mm_srli_si128(uv_row, 8));
+  }
+}
+
+/* Filters the horizontal edge above row 0 of |y|, and of |u| and |v| when
+ * |u| is not NULL. */
+static INLINE void horizontal_edge(unsigned char *y, int y_stride,
+                                   unsigned char *u, unsigned char *v,
+                                   int uv_stride, const unsigned char *blimit,
+                                   const unsigned char *limit,
+                                   const unsigned char *thresh, int is_mb) {
+  __m256i p[4], q[4], mask, hev;
+  int i;
+
+  for (i = 0; i < 4; ++i) {
+    p[i] = load_row(y, u, v, -(i + 1) * y_stride, -(i + 1) * uv_stride);
+    q[i] = load_row(y, u, v, i * y_stride, i * uv_stride);
+  }
+
+  filter_mask_hev(p, q, blimit, limit, thresh, &mask, &hev);
+
+  if (is_mb) {
+    mbloop_filter(mask, hev, p, q);
+    store_row(p[2], y, u, v, -3 * y_stride, -3 * uv_stride);
+    store_row(q[2], y, u, v, 2 * y_stride, 2 * uv_stride);
+  } else {
+    loop_filter(mask, hev, p, q);
+  }
+  for (i = 0; i < 2; ++i) {
+    store_row(p[i], y, u, v, -(i + 1) * y_stride, -(i + 1) * uv_stride);
+    store_row(q[i], y, u, v, i * y_stride, i * uv_stride);
+  }
+}
+
+/* Transposes the 16 rows of 8 pixels in the low half of each lane of |in|
+ * into 8 columns of 16 pixels. */
+static INLINE void transpose_16x8(const __m256i *const in, __m256i *const out) {
+  __m256i a[8], b[8], c[8];
+  int i;
+
+  for (i = 0; i < 8; ++i) a[i] = _mm256_unpacklo_epi8(in[2 * i], in[2 * i + 1]);
+  for (i = 0; i < 4; ++i) {
+    b[2 * i] = _mm256_unpacklo_epi16(a[2 * i], a[2 * i + 1]);
+    b[2 * i + 1] = _mm256_unpackhi_epi16(a[2 * i], a[2 * i + 1]);
+  }
+  /* b[0], b[2], b[4], b[6]: columns 0-3 of rows 0-3, 4-7, 8-11, 12-15. */
+  c[0] = _mm256_unpacklo_epi32(b[0], b[2]);
+  c[1] = _mm256_unpackhi_epi32(b[0], b[2]);
+  c[2] = _mm256_unpacklo_epi32(b[1], b[3]);
+  c[3] = _mm256_unpackhi_epi32(b[1], b[3]);
+  c[4] = _mm256_unpacklo_epi32(b[4], b[6]);
+  c[5] = _mm256_unpackhi_epi32(b[4], b[6]);
+  c[6] = _mm256_unpacklo_epi32(b[5], b[7]);
+  c[7] = _mm256_unpackhi_epi32(b[5], b[7]);
+  for (i = 0; i < 4; ++i) {
+    out[2 * i] = _mm256_unpacklo_epi64(c[i], c[i + 4]);
+    out[2 * i + 1] = _mm256_unpackhi_epi64(c[i], c[i + 4]);
+  }
+}
+
+/* Inverse of transpose_16x8(): out[i] holds rows 2 * i and 2 * i + 1. */
+static INLINE void transpose_8x16(const __m256i *const in, __m256i *const out) {
+  __m256i a[8], b[8];
+  int i;
+
+  for (i = 0; i < 4; ++i) {
+    a[2 * i] = _mm256_unpacklo_epi8(in[2 * i], in[2 * i + 1]);
+    a[2 * i + 1] = _mm256_unpackhi_epi8(in[2 * i], in[2 * i + 1]);
+  }
+  /* a[0], a[2], a[4], a[6]: column pairs of rows 0-7. */
+  b[0] = _mm256_unpacklo_epi16(a[0], a[2]);
+  b[1] = _mm256_unpackhi_epi16(a[0], a[2]);
+  b[2] = _mm256_unpacklo_epi16(a[4], a[6]);
+  b[3] = _mm256_unpackhi_epi16(a[4], a[6]);
+  b[4] = _mm256_unpacklo_epi16(a[1], a[3]);
+  b[5] = _mm256_unpackhi_epi16(a[1], a[3]);
+  b[6] = _mm256_unpacklo_epi16(a[5], a[7]);
+  b[7] = _mm256_unpackhi_epi16(a[5], a[7]);
+  for (i = 0; i < 2; ++i) {
+    out[2 * i] = _mm256_unpacklo_epi32(b[i], b[i + 2]);
+    out[2 * i + 1] = _mm256_unpackhi_epi32(b[i], b[i + 2]);
+    out[2 * i + 4] = _mm256_unpacklo_epi32(b[i + 4], b[i + 6]);
+    out[2 * i + 5] = _mm256_unpackhi_epi32(b[i + 4], b[i + 6]);
+  }
+}
+
+/* Filters the vertical edge left of column 0 of |y|, and of |u| and |v| when
+ * |u| is not NULL. */
+static INLINE void vertical_edge(unsigned char *y, int y_stride,
+                                 unsigned char *u, unsigned char *v,
+                                 int uv_stride, const unsigned char *blimit,
+                                 const unsigned char *limit,
+                                 const unsigned char *thresh, int is_mb) {
+  __m256i rows[16], cols[8], p[4], q[4], mask, hev;
+  int i;
+
+  for (i = 0; i < 16; ++i) {
+    const unsigned char *const y_src = y + i * y_stride - 4;
+    const __m128i y_row = _mm_loadl_epi64((const __m128i *)y_src);
+    __m128i uv_row = y_row;
+    if (u != NULL) {
+      const unsigned char *const uv = i < 8 ? u + i * uv_stride
+                                            : v + (i - 8) * uv_stride;
+      uv_row = _mm_loadl_epi64((const __m128i *)(uv - 4));
+    }
+    rows[i] = _mm256_inserti128_si256(_mm256_castsi128_si256(y_row), uv_row, 1);
+  }
+
+  transpose_16x8(rows, cols);
+  for (i = 0; i < 4; ++i) {
+    p[i] = cols[3 - i];
+    q[i] = cols[4 + i];
+  }
+
+  filter_mask_hev(p, q, blimit, limit, thresh, &mask, &hev);
+  if (is_mb) {
+    mbloop_filter(mask, hev, p, q);
+  } else {
+    loop_filter(mask, hev, p, q);
+  }
+
+  for (i = 0; i < 4; ++i) {
+    cols[3 - i] = p[i];
+    cols[4 + i] = q[i];
+  }
+  transpose_8x16(cols, rows);
+
+  for (i = 0; i < 8; ++i) {
+    const __m128i y_rows = _mm256_castsi256_si128(rows[i]);
+    _mm_storel_epi64((__m128i *)(y + 2 * i * y_stride - 4), y_rows);
+    _mm_storel_epi64((__m128i *)(y + (2 * i + 1) * y_stride - 4),
+                     _mm_srli_si128(y_rows, 8));
+    if (u != NULL) {
+      const __m128i uv_rows = _mm256_extracti128_si256(rows[i], 1);
+      unsigned char *const uv =
+          i < 4 ? u + 2 * i * uv_stride : v + (2 * i - 8) * uv_stride;
+      _mm_storel_epi64((__m128i *)(uv - 4), uv_rows);
+      _mm_storel_epi64((__m128i *)(uv + uv_stride - 4),
+                       _mm_srli_si128(uv_rows, 8));
+    }
+  }
+}
+
+void vp8_loop_filter_mbh_avx2(unsigned char *y_ptr, unsigned char *u_ptr,
+                              unsigned char *v_ptr, int y_stride, int uv_stride,
+                              loop_filter_info *lfi) {
+  horizontal_edge(y_ptr, y_stride, u_ptr, v_ptr, uv_stride, lfi->mblim,
+                  lfi->lim, lfi->hev_thr, 1);
+}
+
+void vp8_loop_filter_mbv_avx2(unsigned char *y_ptr, unsigned char *u_ptr,
+                              unsigned char *v_ptr, int y_stride, int uv_stride,
+                              loop_filter_info *lfi) {
+  vertical_edge(y_ptr, y_stride, u_ptr, v_ptr, uv_stride, lfi->mblim, lfi->lim,
+                lfi->hev_thr, 1);
+}
+
+/* The inner edges depend on each other's output, so only the first one
+ * carries the chroma edge in the high lane. */
+void vp8_loop_filter_bh_avx2(unsigned char *y_ptr, unsigned char *u_ptr,
+                             unsigned char *v_ptr, int y_stride, int uv_stride,
+                             loop_filter_info *lfi) {
+  if (u_ptr != NULL) {
+    u_ptr += 4 * uv_stride;
+    v_ptr += 4 * uv_stride;
+  }
+  horizontal_edge(y_ptr + 4 * y_stride, y_stride, u_ptr, v_ptr, uv_stride,
+                  lfi->blim, lfi->lim, lfi->hev_thr, 0);
+  horizontal_edge(y_ptr + 8 * y_stride, y_stride, NULL, NULL, 0, lfi->blim,
+                  lfi->lim, lfi->hev_thr, 0);
+  horizontal_edge(y_ptr + 12 * y_stride, y_stride, NULL, NULL, 0, lfi->blim,
+                  lfi->lim, lfi->hev_thr, 0);
+}
+
+void vp8_loop_filter_bv_avx2(unsigned char *y_ptr, unsigned char *u_ptr,
+                             unsigned char *v_ptr, int y_stride, int uv_stride,
+                             loop_filter_info *lfi) {
+  if (u_ptr != NULL) {
+    u_ptr += 4;
+    v_ptr += 4;
+  }
+  vertical_edge(y_ptr + 4, y_stride, u_ptr, v_ptr, uv_stride, lfi->blim,
+                lfi->lim, lfi->hev_thr, 0);
+  vertical_edge(y_ptr + 8, y_stride, NULL, NULL, 0, lfi->blim, lfi->lim,
+                lfi->hev_thr, 0);
+  vertical_edge(y_ptr + 12, y_stride, NULL, NULL, 0, lfi->blim, lfi->lim,
+                lfi->hev_thr, 0);
+}
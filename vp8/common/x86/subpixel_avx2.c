@@ -0,0 +1,299 @@
+/*
+ *  Copyright (c) 2024 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <immintrin.h> /* AVX2 */
+#include <string.h>
+
+#include "./vp8_rtcd.h"
+#include "vp8/common/filter.h"
+#include "vpx_ports/mem.h"
+
+/* Each 6-tap filter is applied as three pmaddubsw products of the tap pairs
+ * (0, 5), (2, 4) and (1, 3). No pair can overflow, and the sums are added in
+ * the same order as the SSSE3 version so the saturation only ever happens
+ * when the clamped result is 255 anyway. Two rows are filtered at a time, one
+ * per 128-bit lane. */
+
+/* Source byte pairs for the taps, relative to an 8 byte load at src - 2 in
+ * the low half and an 8 byte load at src + 3 in the high half, so 8 output
+ * pixels read exactly the 13 bytes the C code reads. */
+DECLARE_ALIGNED(32, static const uint8_t, shuf_k0k5_8[32]) = {
+  0, 8, 1, 9, 2, 10, 3, 11, 4, 12, 5, 13, 6, 14, 7, 15, 0, 8, 1, 9, 2, 10, 3,
+  11, 4, 12, 5, 13, 6, 14, 7, 15
+};
+DECLARE_ALIGNED(32, static const uint8_t, shuf_k2k4_8[32]) = {
+  2, 4, 3, 5, 4, 6, 5, 7, 6, 11, 7, 12, 11, 13, 12, 14, 2, 4, 3, 5, 4, 6, 5,
+  7, 6, 11, 7, 12, 11, 13, 12, 14
+};
+DECLARE_ALIGNED(32, static const uint8_t, shuf_k1k3_8[32]) = {
+  1, 3, 2, 4, 3, 5, 4, 6, 5, 7, 6, 11, 7, 12, 11, 13, 1, 3, 2, 4, 3, 5, 4, 6,
+  5, 7, 6, 11, 7, 12, 11, 13
+};
+
+/* The pairs for pixels 0-7 relative to a 16 byte load at src - 2, and for
+ * pixels 8-15 relative to a 16 byte load at src + 3. */
+DECLARE_ALIGNED(32, static const uint8_t, shuf_k0k5_16[32]) = {
+  0, 5, 1, 6, 2, 7, 3, 8, 4, 9, 5, 10, 6, 11, 7, 12, 0, 5, 1, 6, 2, 7, 3, 8,
+  4, 9, 5, 10, 6, 11, 7, 12
+};
+DECLARE_ALIGNED(32, static const uint8_t, shuf_k2k4_16[32]) = {
+  2, 4, 3, 5, 4, 6, 5, 7, 6, 8, 7, 9, 8, 10, 9, 11, 2, 4, 3, 5, 4, 6, 5, 7, 6,
+  8, 7, 9, 8, 10, 9, 11
+};
+DECLARE_ALIGNED(32, static const uint8_t, shuf_k1k3_16[32]) = {
+  1, 3, 2, 4, 3, 5, 4, 6, 5, 7, 6, 8, 7, 9, 8, 10, 1, 3, 2, 4, 3, 5, 4, 6, 5,
+  7, 6, 8, 7, 9, 8, 10
+};
+DECLARE_ALIGNED(32, static const uint8_t, shuf_k0k5_16_hi[32]) = {
+  3, 8, 4, 9, 5, 10, 6, 11, 7, 12, 8, 13, 9, 14, 10, 15, 3, 8, 4, 9, 5, 10, 6,
+  11, 7, 12, 8, 13, 9, 14, 10, 15
+};
+DECLARE_ALIGNED(32, static const uint8_t, shuf_k2k4_16_hi[32]) = {
+  5, 7, 6, 8, 7, 9, 8, 10, 9, 11, 10, 12, 11, 13, 12, 14, 5, 7, 6, 8, 7, 9, 8,
+  10, 9, 11, 10, 12, 11, 13, 12, 14
+};
+DECLARE_ALIGNED(32, static const uint8_t, shuf_k1k3_16_hi[32]) = {
+  4, 6, 5, 7, 6, 8, 7, 9, 8, 10, 9, 11, 10, 12, 11, 13, 4, 6, 5, 7, 6, 8, 7,
+  9, 8, 10, 9, 11, 10, 12, 11, 13
+};
+
+static INLINE __m256i pair_taps(const short *filter, int a, int b) {
+  return _mm256_set1_epi16(
+      (short)((uint16_t)(uint8_t)filter[a] | ((uint16_t)filter[b] << 8)));
+}
+
+static INLINE void load_taps(const short *filter, __m256i *taps) {
+  taps[0] = pair_taps(filter, 0, 5);
+  taps[1] = pair_taps(filter, 2, 4);
+  taps[2] = pair_taps(filter, 1, 3);
+}
+
+/* Sums the three pair products, rounds, and shifts to 16-bit pixels. */
+static INLINE __m256i sum_taps(const __m256i k0k5, const __m256i k2k4,
+                               const __m256i k1k3, const __m256i *taps) {
+  const __m256i rounding = _mm256_set1_epi16(VP8_FILTER_WEIGHT >> 1);
+  __m256i sum = _mm256_adds_epi16(_mm256_maddubs_epi16(k0k5, taps[0]),
+                                  _mm256_maddubs_epi16(k2k4, taps[1]));
+  const __m256i k1k3_round =
+      _mm256_adds_epi16(_mm256_maddubs_epi16(k1k3, taps[2]), rounding);
+  sum = _mm256_adds_epi16(sum, k1k3_round);
+  return _mm256_srai_epi16(sum, VP8_FILTER_SHIFT);
+}
+
+static INLINE __m256i load_2rows_128(const unsigned char *src, int stride) {
+  return _mm256_inserti128_si256(
+      _mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)src)),
+      _mm_loadu_si128((const __m128i *)(src + stride)), 1);
+}
+
+static INLINE __m256i load_2rows_64(const unsigned char *src, int stride) {
+  return _mm256_inserti128_si256(
+      _mm256_castsi128_si256(_mm_loadl_epi64((const __m128i *)src)),
+      _mm_loadl_epi64((const __m128i *)(src + stride)), 1);
+}
+
+static INLINE void store_2rows_128(const __m256i rows, unsigned char *dst,
+                                   int stride) {
+  _mm_storeu_si128((__m128i *)dst, _mm256_castsi256_si128(rows));
+  _mm_storeu_si128((__m128i *)(dst + stride),
+                   _mm256_extracti128_si256(rows, 1));
+}
+
+static INLINE void store_2rows_64(const __m256i rows, unsigned char *dst,
+                                  int stride) {
+  _mm_storel_epi64((__m128i *)dst, _mm256_castsi256_si128(rows));
+  _mm_storel_epi64((__m128i *)(dst + stride),
+                   _mm256_extracti128_si256(rows, 1));
+}
+
+/* 8 horizontally filtered 16-bit pixels for each of the rows in |s|, which
+ * holds the bytes from src - 2 of each row. */
+static INLINE __m256i filter_h8(const __m256i s, const __m256i *taps,
+                                const uint8_t *k0k5, const uint8_t *k2k4,
+                                const uint8_t *k1k3) {
+  return sum_taps(
+      _mm256_shuffle_epi8(s, _mm256_load_si256((const __m256i *)k0k5)),
+      _mm256_shuffle_epi8(s, _mm256_load_si256((const __m256i *)k2k4)),
+      _mm256_shuffle_epi8(s, _mm256_load_si256((const __m256i *)k1k3)), taps);
+}
+
+/* Filters |h| rows of 16 pixels horizontally. The last row of an odd |h| is
+ * filtered in both lanes and stored once. */
+static void filter_h16(const unsigned char *src, int src_stride,
+                       unsigned char *dst, int dst_stride, int h,
+                       const short *filter) {
+  __m256i taps[3];
+  int i;
+
+  load_taps(filter, taps);
+  for (i = 0; i < h; i += 2) {
+    const int next = i + 1 < h ? src_stride : 0;
+    const __m256i lo = filter_h8(load_2rows_128(src - 2, next), taps,
+                                 shuf_k0k5_16, shuf_k2k4_16, shuf_k1k3_16);
+    const __m256i hi =
+        filter_h8(load_2rows_128(src + 3, next), taps, shuf_k0k5_16_hi,
+                  shuf_k2k4_16_hi, shuf_k1k3_16_hi);
+    const __m256i rows = _mm256_packus_epi16(lo, hi);
+    if (next) {
+      store_2rows_128(rows, dst, dst_stride);
+    } else {
+      _mm_storeu_si128((__m128i *)dst, _mm256_castsi256_si128(rows));
+    }
+    src += 2 * src_stride;
+    dst += 2 * dst_stride;
+  }
+}
+
+static void filter_h8_rows(const unsigned char *src, int src_stride,
+                           unsigned char *dst, int dst_stride, int h,
+                           const short *filter) {
+  __m256i taps[3];
+  int i;
+
+  load_taps(filter, taps);
+  for (i = 0; i < h; i += 2) {
+    const int next = i + 1 < h ? src_stride : 0;
+    const __m256i s = _mm256_unpacklo_epi64(load_2rows_64(src - 2, next),
+                                            load_2rows_64(src + 3, next));
+    const __m256i res = filter_h8(s, taps, shuf_k0k5_8, shuf_k2k4_8,
+                                  shuf_k1k3_8);
+    const __m256i rows = _mm256_packus_epi16(res, res);
+    if (next) {
+      store_2rows_64(rows, dst, dst_stride);
+    } else {
+      _mm_storel_epi64((__m128i *)dst, _mm256_castsi256_si128(rows));
+    }
+    src += 2 * src_stride;
+    dst += 2 * dst_stride;
+  }
+}
+
+/* Filters |h| rows (|h| even) of 16 pixels vertically. |src| points at the
+ * first output row; the rows from src - 2 * src_stride to
+ * src + (h + 2) * src_stride are read. */
+static void filter_v16(const unsigned char *src, int src_stride,
+                       unsigned char *dst, int dst_stride, int h,
+                       const short *filter) {
+  __m256i taps[3];
+  /* r[k] holds rows k - 2 and k - 1 relative to the current output row. */
+  __m256i r0 = load_2rows_128(src - 2 * src_stride, src_stride);
+  __m256i r1 = load_2rows_128(src - src_stride, src_stride);
+  __m256i r2 = load_2rows_128(src, src_stride);
+  __m256i r3 = load_2rows_128(src + src_stride, src_stride);
+  int i;
+
+  load_taps(filter, taps);
+  for (i = 0; i < h; i += 2) {
+    const __m256i r4 = load_2rows_128(src + 2 * src_stride, src_stride);
+    const __m256i r5 = load_2rows_128(src + 3 * src_stride, src_stride);
+    const __m256i lo =
+        sum_taps(_mm256_unpacklo_epi8(r0, r5), _mm256_unpacklo_epi8(r2, r4),
+                 _mm256_unpacklo_epi8(r1, r3), taps);
+    const __m256i hi =
+        sum_taps(_mm256_unpackhi_epi8(r0, r5), _mm256_unpackhi_epi8(r2, r4),
+                 _mm256_unpackhi_epi8(r1, r3), taps);
+    store_2rows_128(_mm256_packus_epi16(lo, hi), dst, dst_stride);
+    r0 = r2;
+    r1 = r3;
+    r2 = r4;
+    r3 = r5;
+    src += 2 * src_stride;
+    dst += 2 * dst_stride;
+  }
+}
+
+static void filter_v8(const unsigned char *src, int src_stride,
+                      unsigned char *dst, int dst_stride, int h,
+                      const short *filter) {
+  __m256i taps[3];
+  __m256i r0 = load_2rows_64(src - 2 * src_stride, src_stride);
+  __m256i r1 = load_2rows_64(src - src_stride, src_stride);
+  __m256i r2 = load_2rows_64(src, src_stride);
+  __m256i r3 = load_2rows_64(src + src_stride, src_stride);
+  int i;
+
+  load_taps(filter, taps);
+  for (i = 0; i < h; i += 2) {
+    const __m256i r4 = load_2rows_64(src + 2 * src_stride, src_stride);
+    const __m256i r5 = load_2rows_64(src + 3 * src_stride, src_stride);
+    const __m256i res =
+        sum_taps(_mm256_unpacklo_epi8(r0, r5), _mm256_unpacklo_epi8(r2, r4),
+                 _mm256_unpacklo_epi8(r1, r3), taps);
+    store_2rows_64(_mm256_packus_epi16(res, res), dst, dst_stride);
+    r0 = r2;
+    r1 = r3;
+    r2 = r4;
+    r3 = r5;
+    src += 2 * src_stride;
+    dst += 2 * dst_stride;
+  }
+}
+
+static INLINE void sixtap_predict(unsigned char *src_ptr, int src_stride,
+                                  int xoffset, int yoffset,
+                                  unsigned char *dst_ptr, int dst_pitch, int w,
+                                  int h) {
+  /* Rows 2 above to 3 below the block, filtered horizontally. */
+  DECLARE_ALIGNED(32, unsigned char, temp[21 * 16]);
+  const short *const h_filter = vp8_sub_pel_filters[xoffset];
+  const short *const v_filter = vp8_sub_pel_filters[yoffset];
+
+  /* The zero offset filter is a copy, so skip that pass. */
+  if (xoffset && yoffset) {
+    if (w == 16) {
+      filter_h16(src_ptr - 2 * src_stride, src_stride, temp, w, h + 5,
+                 h_filter);
+      filter_v16(temp + 2 * w, w, dst_ptr, dst_pitch, h, v_filter);
+    } else {
+      filter_h8_rows(src_ptr - 2 * src_stride, src_stride, temp, w, h + 5,
+                     h_filter);
+      filter_v8(temp + 2 * w, w, dst_ptr, dst_pitch, h, v_filter);
+    }
+  } else if (xoffset) {
+    if (w == 16) {
+      filter_h16(src_ptr, src_stride, dst_ptr, dst_pitch, h, h_filter);
+    } else {
+      filter_h8_rows(src_ptr, src_stride, dst_ptr, dst_pitch, h, h_filter);
+    }
+  } else if (yoffset) {
+    if (w == 16) {
+      filter_v16(src_ptr, src_stride, dst_ptr, dst_pitch, h, v_filter);
+    } else {
+      filter_v8(src_ptr, src_stride, dst_ptr, dst_pitch, h, v_filter);
+    }
+  } else {
+    int i;
+    for (i = 0; i < h; ++i) {
+      memcpy(dst_ptr + i * dst_pitch, src_ptr + i * src_stride, w);
+    }
+  }
+}
+
+void vp8_sixtap_predict16x16_avx2(unsigned char *src_ptr,
+                                  int src_pixels_per_line, int xoffset,
+                                  int yoffset, unsigned char *dst_ptr,
+                                  int dst_pitch) {
+  sixtap_predict(src_ptr, src_pixels_per_line, xoffset, yoffset, dst_ptr,
+                 dst_pitch, 16, 16);
+}
+
+void vp8_sixtap_predict8x8_avx2(unsigned char *src_ptr, int src_pixels_per_line,
+                                int xoffset, int yoffset,
+                                unsigned char *dst_ptr, int dst_pitch) {
+  sixtap_predict(src_ptr, src_pixels_per_line, xoffset, yoffset, dst_ptr,
+                 dst_pitch, 8, 8);
+}
+
+void vp8_sixtap_predict8x4_avx2(unsigned char *src_ptr, int src_pixels_per_line,
+                                int xoffset, int yoffset,
+                                unsigned char *dst_ptr, int dst_pitch) {
+  sixtap_predict(src_ptr, src_pixels_per_line, xoffset, yoffset, dst_ptr,
+                 dst_pitch, 8, 4);
+}
@@ -0,0 +1,70 @@
+/*
+ *  Copyright (c) 2024 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <immintrin.h> /* AVX2 */
+
+#include "./vp8_rtcd.h"
+#include "vp8/encoder/block.h"
+
+/* Squared error of one 4x4 block as 8 32-bit partial sums, counting only
+ * the coefficients selected by |mask|. Like the SSE2 version the difference
+ * is taken in 16 bits. */
+static INLINE __m256i block_error(const short *coeff, const short *dqcoeff,
+                                  const __m256i mask) {
+  const __m256i c = _mm256_loadu_si256((const __m256i *)coeff);
+  const __m256i d = _mm256_loadu_si256((const __m256i *)dqcoeff);
+  const __m256i diff = _mm256_and_si256(_mm256_sub_epi16(c, d), mask);
+  return _mm256_madd_epi16(diff, diff);
+}
+
+static INLINE int hsum_epi32(const __m256i v) {
+  __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(v),
+                              _mm256_extracti128_si256(v, 1));
+  sum = _mm_add_epi32(sum, _mm_srli_si128(sum, 8));
+  sum = _mm_add_epi32(sum, _mm_srli_si128(sum, 4));
+  return _mm_cvtsi128_si32(sum);
+}
+
+int vp8_block_error_avx2(short *coeff, short *dqcoeff) {
+  return hsum_epi32(block_error(coeff, dqcoeff, _mm256_set1_epi16(-1)));
+}
+
+int vp8_mbblock_error_avx2(MACROBLOCK *mb, int dc) {
+  const short *coeff = mb->coeff;
+  const short *dqcoeff = mb->e_mbd.dqcoeff;
+  /* Skips the first coefficient of each block when the DC is coded in the
+   * Y2 block. */
+  const __m256i mask = _mm256_insert_epi16(_mm256_set1_epi16(-1), dc ? 0 : -1,
+                                           0);
+  __m256i sum = _mm256_setzero_si256();
+  int i;
+
+  for (i = 0; i < 16; ++i) {
+    sum = _mm256_add_epi32(sum, block_error(coeff, dqcoeff, mask));
+    coeff += 16;
+    dqcoeff += 16;
+  }
+  return hsum_epi32(sum);
+}
+
+int vp8_mbuverror_avx2(MACROBLOCK *mb) {
+  const short *coeff = &mb->coeff[256];
+  const short *dqcoeff = &mb->e_mbd.dqcoeff[256];
+  const __m256i mask = _mm256_set1_epi16(-1);
+  __m256i sum = _mm256_setzero_si256();
+  int i;
+
+  for (i = 0; i < 8; ++i) {
+    sum = _mm256_add_epi32(sum, block_error(coeff, dqcoeff, mask));
+    coeff += 16;
+    dqcoeff += 16;
+  }
+  return hsum_epi32(sum);
+}
@@ -0,0 +1,50 @@
+/*
+ *  Copyright (c) 2024 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <immintrin.h> /* AVX2 */
+
+#include "./vp8_rtcd.h"
+#include "vp8/encoder/block.h"
+#include "vpx_ports/bitops.h" /* get_msb */
+
+/* Same as vp8_fast_quantize_b_ssse3() with the whole 4x4 block in one
+ * register. */
+void vp8_fast_quantize_b_avx2(BLOCK *b, BLOCKD *d) {
+  const __m256i z = _mm256_loadu_si256((const __m256i *)b->coeff);
+  const __m256i round = _mm256_loadu_si256((const __m256i *)b->round);
+  const __m256i quant_fast =
+      _mm256_loadu_si256((const __m256i *)b->quant_fast);
+  const __m256i dequant = _mm256_loadu_si256((const __m256i *)d->dequant);
+  const __m128i zig_zag = _mm_setr_epi8(0, 1, 4, 8, 5, 2, 3, 6, 9, 12, 13, 10,
+                                        7, 11, 14, 15);
+  const __m256i sz = _mm256_srai_epi16(z, 15);
+  __m256i x, y, nonzero;
+  __m128i mask;
+  int eob;
+
+  /* y = ((abs(z) + round) * quant) >> 16 */
+  x = _mm256_add_epi16(_mm256_abs_epi16(z), round);
+  y = _mm256_mulhi_epi16(x, quant_fast);
+  nonzero = _mm256_cmpgt_epi16(y, _mm256_setzero_si256());
+
+  /* qcoeff = y with the sign of z restored. */
+  x = _mm256_sub_epi16(_mm256_xor_si256(y, sz), sz);
+  _mm256_storeu_si256((__m256i *)d->qcoeff, x);
+  _mm256_storeu_si256((__m256i *)d->dqcoeff, _mm256_mullo_epi16(x, dequant));
+
+  mask = _mm_packs_epi16(_mm256_castsi256_si128(nonzero),
+                         _mm256_extracti128_si256(nonzero, 1));
+  mask = _mm_shuffle_epi8(mask, zig_zag);
+
+  /* See vp8_fast_quantize_b_ssse3() for the +1. */
+  eob = get_msb(_mm_movemask_epi8(mask) * 2 + 1);
+
+  *d->eob = eob;
+}
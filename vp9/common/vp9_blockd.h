@@ -205,6 +205,11 @@ typedef struct macroblockd {
   struct vpx_internal_error_info *error_info;
 
   PARTITION_TYPE *partition;
+
+  // Scratch of the thread using this MACROBLOCKD, holding the copy of a
+  // reference block that reaches past the border of the reference frame, see
+  // vp9_build_inter_predictors_sb(). Must hold 80 * 2 * 80 * 2 entries.
+  uint16_t *mc_buf;
 } MACROBLOCKD;
 
 static INLINE PLANE_TYPE get_plane_type(int plane) {
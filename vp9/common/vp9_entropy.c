@@ -8,6 +8,7 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include "./vpx_dsp_rtcd.h"
 #include "vp9/common/vp9_entropy.h"
 #include "vp9/common/vp9_blockd.h"
 #include "vp9/common/vp9_onyxc_int.h"
@@ -1061,24 +1062,32 @@ static void adapt_coef_probs(VP9_COMMON *cm, TX_SIZE tx_size,
   vp9_coeff_count_model *counts = cm->counts.coef[tx_size];
   unsigned int(*eob_counts)[REF_TYPES][COEF_BANDS][COEFF_CONTEXTS] =
       cm->counts.eob_branch[tx_size];
-  int i, j, k, l, m;
+  // Branch counts laid out like vp9_coeff_probs_model so that the whole table
+  // is merged in one call. Band 0 only has the first 3 contexts; the remaining
+  // contexts keep zero counts, which leaves their probabilities at pre_probs.
+  unsigned int branch_ct[PLANE_TYPES][REF_TYPES][COEF_BANDS][COEFF_CONTEXTS]
+                        [UNCONSTRAINED_NODES][2];
+  int i, j, k, l;
 
+  memset(branch_ct, 0, sizeof(branch_ct));
   for (i = 0; i < PLANE_TYPES; ++i)
     for (j = 0; j < REF_TYPES; ++j)
       for (k = 0; k < COEF_BANDS; ++k)
         for (l = 0; l < BAND_COEFF_CONTEXTS(k); ++l) {
-          const int n0 = counts[i][j][k][l][ZERO_TOKEN];
-          const int n1 = counts[i][j][k][l][ONE_TOKEN];
-          const int n2 = counts[i][j][k][l][TWO_TOKEN];
-          const int neob = counts[i][j][k][l][EOB_MODEL_TOKEN];
-          const unsigned int branch_ct[UNCONSTRAINED_NODES][2] = {
-            { neob, eob_counts[i][j][k][l] - neob }, { n0, n1 + n2 }, { n1, n2 }
-          };
-          for (m = 0; m < UNCONSTRAINED_NODES; ++m)
-            probs[i][j][k][l][m] =
-                merge_probs(pre_probs[i][j][k][l][m], branch_ct[m], count_sat,
-                            update_factor);
+          const unsigned int *const c = counts[i][j][k][l];
+          unsigned int(*const ct)[2] = branch_ct[i][j][k][l];
+          ct[0][0] = c[EOB_MODEL_TOKEN];
+          ct[0][1] = eob_counts[i][j][k][l] - c[EOB_MODEL_TOKEN];
+          ct[1][0] = c[ZERO_TOKEN];
+          ct[1][1] = c[ONE_TOKEN] + c[TWO_TOKEN];
+          ct[2][0] = c[ONE_TOKEN];
+          ct[2][1] = c[TWO_TOKEN];
         }
+
+  vpx_merge_probs(&pre_probs[0][0][0][0][0], &branch_ct[0][0][0][0][0][0],
+                  PLANE_TYPES * REF_TYPES * COEF_BANDS * COEFF_CONTEXTS *
+                      UNCONSTRAINED_NODES,
+                  count_sat, update_factor, &probs[0][0][0][0][0]);
 }
 
 void vp9_adapt_coef_probs(VP9_COMMON *cm) {
@@ -8,6 +8,7 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include "./vpx_dsp_rtcd.h"
 #include "vp9/common/vp9_onyxc_int.h"
 #include "vp9/common/vp9_entropymv.h"
 
@@ -172,8 +173,8 @@ void vp9_adapt_mv_probs(VP9_COMMON *cm, int allow_hp) {
     vpx_tree_merge_probs(vp9_mv_class0_tree, pre_comp->class0, c->class0,
                          comp->class0);
 
-    for (j = 0; j < MV_OFFSET_BITS; ++j)
-      comp->bits[j] = mode_mv_merge_probs(pre_comp->bits[j], c->bits[j]);
+    vpx_merge_probs(pre_comp->bits, c->bits[0], MV_OFFSET_BITS,
+                    MODE_MV_COUNT_SAT, MODE_MV_MAX_UPDATE_FACTOR, comp->bits);
 
     for (j = 0; j < CLASS0_SIZE; ++j)
       vpx_tree_merge_probs(vp9_mv_fp_tree, pre_comp->class0_fp[j],
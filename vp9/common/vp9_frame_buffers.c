@@ -9,6 +9,7 @@
  */
 
 #include <assert.h>
+#include <string.h>
 
 #include "vp9/common/vp9_frame_buffers.h"
 #include "vpx_mem/vpx_mem.h"
@@ -60,8 +61,9 @@ int vp9_get_frame_buffer(void *cb_priv, size_t min_size,
     // The data must be zeroed to fix a valgrind error from the C loop filter
     // due to access uninitialized memory in frame border. It could be
     // skipped if border were totally removed.
-    int_fb_list->int_fb[i].data = (uint8_t *)vpx_calloc(1, min_size);
+    int_fb_list->int_fb[i].data = (uint8_t *)vpx_memalign_large(32, min_size);
     if (!int_fb_list->int_fb[i].data) return -1;
+    memset(int_fb_list->int_fb[i].data, 0, min_size);
     int_fb_list->int_fb[i].size = min_size;
   }
 
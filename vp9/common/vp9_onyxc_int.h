@@ -80,6 +80,18 @@ typedef struct {
                            // frame.
   vpx_codec_frame_buffer_t raw_frame_buffer;
   YV12_BUFFER_CONFIG buf;
+
+  // Decoder only. The mode info columns decoded for this frame, and the luma
+  // pixel columns that match a full decode. Both span the whole frame unless
+  // tiles of it or of its references were skipped by region decoding.
+  int decoded_mi_col_start;
+  int decoded_mi_col_end;
+  int valid_x_start;
+  int valid_x_end;
+  // Decoder only. The coded size of the frame, which |buf| holds downscaled
+  // when decoding at reduced resolution.
+  int frame_width;
+  int frame_height;
 } RefCntBuffer;
 
 typedef struct BufferPool {
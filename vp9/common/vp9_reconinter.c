@@ -9,6 +9,7 @@
  */
 
 #include <assert.h>
+#include <string.h>
 
 #include "./vpx_scale_rtcd.h"
 #include "./vpx_config.h"
@@ -18,6 +19,7 @@
 #include "vp9/common/vp9_reconintra.h"
 
 #include "vpx/vpx_integer.h"
+#include "vpx_mem/vpx_mem.h"
 #include "vpx_scale/yv12config.h"
 
 #if CONFIG_VP9_HIGHBITDEPTH
@@ -59,6 +61,111 @@ void vp9_build_inter_predictor(const uint8_t *src, int src_stride, uint8_t *dst,
                   h, ref, kernel, sf->x_step_q4, sf->y_step_q4);
 }
 
+void vp9_build_mc_border(const uint8_t *src, int src_stride, uint8_t *dst,
+                         int dst_stride, int x, int y, int b_w, int b_h, int w,
+                         int h) {
+  // Get a pointer to the start of the real data for this row.
+  const uint8_t *ref_row = src - x - y * src_stride;
+
+  if (y >= h)
+    ref_row += (h - 1) * src_stride;
+  else if (y > 0)
+    ref_row += y * src_stride;
+
+  do {
+    int right = 0, copy;
+    int left = x < 0 ? -x : 0;
+
+    if (left > b_w) left = b_w;
+
+    if (x + b_w > w) right = x + b_w - w;
+
+    if (right > b_w) right = b_w;
+
+    copy = b_w - left - right;
+
+    if (left) memset(dst, ref_row[0], left);
+
+    if (copy) memcpy(dst + left, ref_row + x + left, copy);
+
+    if (right) memset(dst + left + copy, ref_row[w - 1], right);
+
+    dst += dst_stride;
+    ++y;
+
+    if (y > 0 && y < h) ref_row += src_stride;
+  } while (--b_h);
+}
+
+#if CONFIG_VP9_HIGHBITDEPTH
+void vp9_highbd_build_mc_border(const uint8_t *src8, int src_stride,
+                                uint16_t *dst, int dst_stride, int x, int y,
+                                int b_w, int b_h, int w, int h) {
+  // Get a pointer to the start of the real data for this row.
+  const uint16_t *src = CONVERT_TO_SHORTPTR(src8);
+  const uint16_t *ref_row = src - x - y * src_stride;
+
+  if (y >= h)
+    ref_row += (h - 1) * src_stride;
+  else if (y > 0)
+    ref_row += y * src_stride;
+
+  do {
+    int right = 0, copy;
+    int left = x < 0 ? -x : 0;
+
+    if (left > b_w) left = b_w;
+
+    if (x + b_w > w) right = x + b_w - w;
+
+    if (right > b_w) right = b_w;
+
+    copy = b_w - left - right;
+
+    if (left) vpx_memset16(dst, ref_row[0], left);
+
+    if (copy) memcpy(dst + left, ref_row + x + left, copy * sizeof(uint16_t));
+
+    if (right) vpx_memset16(dst + left + copy, ref_row[w - 1], right);
+
+    dst += dst_stride;
+    ++y;
+
+    if (y > 0 && y < h) ref_row += src_stride;
+  } while (--b_h);
+}
+#endif  // CONFIG_VP9_HIGHBITDEPTH
+
+// Predicts from a copy of the reference block with the pixels outside of the
+// frame replicated in xd->mc_buf, for blocks that reach beyond the border of
+// the reference.
+static void extend_and_predict(const uint8_t *buf_ptr1, int pre_buf_stride,
+                               int x0, int y0, int b_w, int b_h,
+                               int frame_width, int frame_height,
+                               int border_offset, uint8_t *const dst,
+                               int dst_buf_stride, int subpel_x, int subpel_y,
+                               const InterpKernel *kernel,
+                               const struct scale_factors *sf,
+                               const MACROBLOCKD *xd, int w, int h, int ref,
+                               int xs, int ys) {
+  uint16_t *const mc_buf = xd->mc_buf;
+  assert(mc_buf != NULL);
+#if CONFIG_VP9_HIGHBITDEPTH
+  if (xd->cur_buf->flags & YV12_FLAG_HIGHBITDEPTH) {
+    vp9_highbd_build_mc_border(buf_ptr1, pre_buf_stride, mc_buf, b_w, x0, y0,
+                               b_w, b_h, frame_width, frame_height);
+    highbd_inter_predictor(mc_buf + border_offset, b_w,
+                           CONVERT_TO_SHORTPTR(dst), dst_buf_stride, subpel_x,
+                           subpel_y, sf, w, h, ref, kernel, xs, ys, xd->bd);
+    return;
+  }
+#endif  // CONFIG_VP9_HIGHBITDEPTH
+  vp9_build_mc_border(buf_ptr1, pre_buf_stride, (uint8_t *)mc_buf, b_w, x0, y0,
+                      b_w, b_h, frame_width, frame_height);
+  inter_predictor((uint8_t *)mc_buf + border_offset, b_w, dst, dst_buf_stride,
+                  subpel_x, subpel_y, sf, w, h, ref, kernel, xs, ys);
+}
+
 static INLINE int round_mv_comp_q4(int value) {
   return (value < 0 ? value - 2 : value + 2) / 4;
 }
@@ -150,16 +257,16 @@ static void build_inter_predictors(MACROBLOCKD *xd, int plane, int block,
     const MV mv_q4 = clamp_mv_to_umv_border_sb(
         xd, &mv, bw, bh, pd->subsampling_x, pd->subsampling_y);
 
+    const YV12_BUFFER_CONFIG *const ref_buf = xd->block_refs[ref]->buf;
     uint8_t *pre;
     MV32 scaled_mv;
-    int xs, ys, subpel_x, subpel_y;
+    int xs, ys, subpel_x, subpel_y, x0, y0, x0_16, y0_16;
     const int is_scaled = vp9_is_scaled(sf);
 
     if (is_scaled) {
       // Co-ordinate of containing block to pixel precision.
       const int x_start = (-xd->mb_to_left_edge >> (3 + pd->subsampling_x));
       const int y_start = (-xd->mb_to_top_edge >> (3 + pd->subsampling_y));
-      const YV12_BUFFER_CONFIG *ref_buf = xd->block_refs[ref]->buf;
       uint8_t *buf_array[] = { ref_buf->y_buffer, ref_buf->u_buffer,
                                ref_buf->v_buffer };
       const int stride_array[] = { ref_buf->y_stride, ref_buf->uv_stride,
@@ -179,16 +286,70 @@ static void build_inter_predictors(MACROBLOCKD *xd, int plane, int block,
       scaled_mv = vp9_scale_mv(&mv_q4, mi_x + x, mi_y + y, sf);
       xs = sf->x_step_q4;
       ys = sf->y_step_q4;
+      x0 = sf->scale_value_x(x_start + x, sf);
+      y0 = sf->scale_value_y(y_start + y, sf);
+      x0_16 = sf->scale_value_x((x_start + x) << SUBPEL_BITS, sf);
+      y0_16 = sf->scale_value_y((y_start + y) << SUBPEL_BITS, sf);
     } else {
       pre = pre_buf->buf + ((int64_t)y * pre_buf->stride + x);
       scaled_mv.row = mv_q4.row;
       scaled_mv.col = mv_q4.col;
       xs = ys = 16;
+      x0 = (-xd->mb_to_left_edge >> (3 + pd->subsampling_x)) + x;
+      y0 = (-xd->mb_to_top_edge >> (3 + pd->subsampling_y)) + y;
+      x0_16 = x0 * (1 << SUBPEL_BITS);
+      y0_16 = y0 * (1 << SUBPEL_BITS);
     }
     subpel_x = scaled_mv.col & SUBPEL_MASK;
     subpel_y = scaled_mv.row & SUBPEL_MASK;
     pre += (scaled_mv.row >> SUBPEL_BITS) * pre_buf->stride +
            (scaled_mv.col >> SUBPEL_BITS);
+    x0 += scaled_mv.col >> SUBPEL_BITS;
+    y0 += scaled_mv.row >> SUBPEL_BITS;
+    x0_16 += scaled_mv.col;
+    y0_16 += scaled_mv.row;
+
+    {
+      // The encoder may allocate references with a border that is smaller
+      // than the reach of the motion vectors; fill in the pixels beyond it.
+      const int border_x = ref_buf->border >> pd->subsampling_x;
+      const int border_y = ref_buf->border >> pd->subsampling_y;
+      const int plane_width = plane ? ref_buf->uv_width : ref_buf->y_width;
+      const int plane_height = plane ? ref_buf->uv_height : ref_buf->y_height;
+      int x1 = ((x0_16 + (w - 1) * xs) >> SUBPEL_BITS) + 1;
+      int y1 = ((y0_16 + (h - 1) * ys) >> SUBPEL_BITS) + 1;
+      int x_pad = 0, y_pad = 0;
+
+      if (subpel_x || (sf->x_step_q4 != SUBPEL_SHIFTS)) {
+        x0 -= VP9_INTERP_EXTEND - 1;
+        x1 += VP9_INTERP_EXTEND;
+        x_pad = 1;
+      }
+      if (subpel_y || (sf->y_step_q4 != SUBPEL_SHIFTS)) {
+        y0 -= VP9_INTERP_EXTEND - 1;
+        y1 += VP9_INTERP_EXTEND;
+        y_pad = 1;
+      }
+
+      // Keep clear of the last few pixels of the border, which SIMD filters
+      // may read past.
+      if (x0 < VP9_INTERP_EXTEND - border_x ||
+          x1 >= plane_width + border_x - VP9_INTERP_EXTEND ||
+          y0 < VP9_INTERP_EXTEND - border_y ||
+          y1 >= plane_height + border_y - VP9_INTERP_EXTEND) {
+        const int b_w = x1 - x0 + 1;
+        const int b_h = y1 - y0 + 1;
+        extend_and_predict(
+            pre - y_pad * (VP9_INTERP_EXTEND - 1) * pre_buf->stride -
+                x_pad * (VP9_INTERP_EXTEND - 1),
+            pre_buf->stride, x0, y0, b_w, b_h,
+            plane ? ref_buf->uv_crop_width : ref_buf->y_crop_width,
+            plane ? ref_buf->uv_crop_height : ref_buf->y_crop_height,
+            y_pad * 3 * b_w + x_pad * 3, dst, dst_buf->stride, subpel_x,
+            subpel_y, kernel, sf, xd, w, h, ref, xs, ys);
+        continue;
+      }
+    }
 
 #if CONFIG_VP9_HIGHBITDEPTH
     if (xd->cur_buf->flags & YV12_FLAG_HIGHBITDEPTH) {
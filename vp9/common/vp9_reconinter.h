@@ -74,6 +74,19 @@ void vp9_highbd_build_inter_predictor(
     int bd);
 #endif
 
+// Copies the b_w x b_h block at (x, y) of a w x h plane to dst, replicating
+// the edge pixels of the plane for the part of the block that lies outside.
+// src points at (x, y).
+void vp9_build_mc_border(const uint8_t *src, int src_stride, uint8_t *dst,
+                         int dst_stride, int x, int y, int b_w, int b_h, int w,
+                         int h);
+
+#if CONFIG_VP9_HIGHBITDEPTH
+void vp9_highbd_build_mc_border(const uint8_t *src8, int src_stride,
+                                uint16_t *dst, int dst_stride, int x, int y,
+                                int b_w, int b_h, int w, int h);
+#endif
+
 static INLINE int64_t scaled_buffer_offset(int x_offset, int y_offset,
                                            int stride,
                                            const struct scale_factors *sf) {
@@ -426,6 +426,17 @@ void vp9_predict_intra_block(const MACROBLOCKD *xd, int bwl_in, TX_SIZE tx_size,
                          have_top, have_left, have_right, x, y, plane);
 }
 
+void vp9_predict_intra_from_edges(PREDICTION_MODE mode, TX_SIZE tx_size,
+                                  int have_top, int have_left, uint8_t *dst,
+                                  int dst_stride, const uint8_t *above,
+                                  const uint8_t *left) {
+  if (mode == DC_PRED) {
+    dc_pred[have_left][have_top][tx_size](dst, dst_stride, above, left);
+  } else {
+    pred[mode][tx_size](dst, dst_stride, above, left);
+  }
+}
+
 void vp9_init_intra_predictors(void) {
   once(vp9_init_intra_predictors_internal);
 }
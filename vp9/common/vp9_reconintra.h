@@ -24,6 +24,13 @@ void vp9_predict_intra_block(const MACROBLOCKD *xd, int bwl_in, TX_SIZE tx_size,
                              PREDICTION_MODE mode, const uint8_t *ref,
                              int ref_stride, uint8_t *dst, int dst_stride,
                              int aoff, int loff, int plane);
+
+// Predicts a block from edges the caller has already built: |above| holds
+// 2 * bs pixels with the top left one at above[-1], |left| holds bs pixels.
+void vp9_predict_intra_from_edges(PREDICTION_MODE mode, TX_SIZE tx_size,
+                                  int have_top, int have_left, uint8_t *dst,
+                                  int dst_stride, const uint8_t *above,
+                                  const uint8_t *left);
 #ifdef __cplusplus
 }  // extern "C"
 #endif
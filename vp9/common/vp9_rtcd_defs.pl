@@ -30,6 +30,7 @@ struct search_site_config;
 struct mv;
 union int_mv;
 struct yv12_buffer_config;
+struct NN_CONFIG;
 EOF
 }
 forward_decls qw/vp9_common_forward_decls/;
@@ -50,10 +51,10 @@ if ($opts{arch} eq "x86_64") {
 #
 if (vpx_config("CONFIG_VP9_POSTPROC") eq "yes") {
 add_proto qw/void vp9_filter_by_weight16x16/, "const uint8_t *src, int src_stride, uint8_t *dst, int dst_stride, int src_weight";
-specialize qw/vp9_filter_by_weight16x16 sse2 msa/;
+specialize qw/vp9_filter_by_weight16x16 sse2 avx2 msa/;
 
 add_proto qw/void vp9_filter_by_weight8x8/, "const uint8_t *src, int src_stride, uint8_t *dst, int dst_stride, int src_weight";
-specialize qw/vp9_filter_by_weight8x8 sse2 msa/;
+specialize qw/vp9_filter_by_weight8x8 sse2 avx2 msa/;
 }
 
 #
@@ -123,7 +124,7 @@ if (vpx_config("CONFIG_VP9_ENCODER") eq "yes") {
 #
 if (vpx_config("CONFIG_VP9_TEMPORAL_DENOISING") eq "yes") {
   add_proto qw/int vp9_denoiser_filter/, "const uint8_t *sig, int sig_stride, const uint8_t *mc_avg, int mc_avg_stride, uint8_t *avg, int avg_stride, int increase_denoising, BLOCK_SIZE bs, int motion_magnitude";
-  specialize qw/vp9_denoiser_filter neon sse2/;
+  specialize qw/vp9_denoiser_filter neon sse2 avx2/;
 }
 
 add_proto qw/int64_t vp9_block_error/, "const tran_low_t *coeff, const tran_low_t *dqcoeff, intptr_t block_size, int64_t *ssz";
@@ -166,7 +167,7 @@ if (vpx_config("CONFIG_VP9_HIGHBITDEPTH") ne "yes") {
   # Note that these specializations are appended to the above ones.
   specialize qw/vp9_fht4x4 msa/;
   specialize qw/vp9_fht8x8 msa/;
-  specialize qw/vp9_fht16x16 msa/;
+  specialize qw/vp9_fht16x16 avx2 msa/;
   specialize qw/vp9_fwht4x4 msa/;
 }
 
@@ -176,6 +177,12 @@ if (vpx_config("CONFIG_VP9_HIGHBITDEPTH") ne "yes") {
 add_proto qw/int vp9_diamond_search_sad/, "const struct macroblock *x, const struct search_site_config *cfg,  struct mv *ref_mv, uint32_t start_mv_sad, struct mv *best_mv, int search_param, int sad_per_bit, int *num00, const struct vp9_sad_table *sad_fn_ptr, const struct mv *center_mv";
 specialize qw/vp9_diamond_search_sad neon/;
 
+#
+# Partition search models
+#
+add_proto qw/void vp9_nn_predict/, "const float *features, const struct NN_CONFIG *nn_config, float *output";
+specialize qw/vp9_nn_predict avx2/;
+
 #
 # Apply temporal filter
 #
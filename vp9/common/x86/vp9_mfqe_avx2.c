@@ -0,0 +1,88 @@
+/*
+ *  Copyright (c) 2024 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <immintrin.h>
+
+#include "./vp9_rtcd.h"
+#include "vp9/common/vp9_postproc.h"
+#include "vpx/vpx_integer.h"
+
+// The weights sum to 1 << MFQE_PRECISION, so src and dst are interleaved and
+// blended with one pmaddubsw. (x + 8) >> 4 is done as a rounding multiply by
+// 1 << (15 - MFQE_PRECISION).
+static INLINE __m256i blend(const __m256i src, const __m256i dst,
+                            const __m256i weights) {
+  const __m256i round = _mm256_set1_epi16(1 << (15 - MFQE_PRECISION));
+  const __m256i lo = _mm256_mulhrs_epi16(
+      _mm256_maddubs_epi16(_mm256_unpacklo_epi8(src, dst), weights), round);
+  const __m256i hi = _mm256_mulhrs_epi16(
+      _mm256_maddubs_epi16(_mm256_unpackhi_epi8(src, dst), weights), round);
+  return _mm256_packus_epi16(lo, hi);
+}
+
+static INLINE __m256i weight_pairs(int src_weight) {
+  const int dst_weight = (1 << MFQE_PRECISION) - src_weight;
+  return _mm256_set1_epi16((int16_t)(src_weight | (dst_weight << 8)));
+}
+
+void vp9_filter_by_weight16x16_avx2(const uint8_t *src, int src_stride,
+                                    uint8_t *dst, int dst_stride,
+                                    int src_weight) {
+  const __m256i weights = weight_pairs(src_weight);
+  int r;
+
+  // Two rows per iteration, one in each 128-bit lane.
+  for (r = 0; r < 16; r += 2) {
+    const __m256i s = _mm256_inserti128_si256(
+        _mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)src)),
+        _mm_loadu_si128((const __m128i *)(src + src_stride)), 1);
+    const __m256i d = _mm256_inserti128_si256(
+        _mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)dst)),
+        _mm_loadu_si128((const __m128i *)(dst + dst_stride)), 1);
+    const __m256i res = blend(s, d, weights);
+    _mm_storeu_si128((__m128i *)dst, _mm256_castsi256_si128(res));
+    _mm_storeu_si128((__m128i *)(dst + dst_stride),
+                     _mm256_extracti128_si256(res, 1));
+    src += 2 * src_stride;
+    dst += 2 * dst_stride;
+  }
+}
+
+static INLINE __m256i load_4x8(const uint8_t *p, int stride) {
+  const __m128i r01 =
+      _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i *)p),
+                         _mm_loadl_epi64((const __m128i *)(p + stride)));
+  const __m128i r23 =
+      _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i *)(p + 2 * stride)),
+                         _mm_loadl_epi64((const __m128i *)(p + 3 * stride)));
+  return _mm256_inserti128_si256(_mm256_castsi128_si256(r01), r23, 1);
+}
+
+void vp9_filter_by_weight8x8_avx2(const uint8_t *src, int src_stride,
+                                  uint8_t *dst, int dst_stride,
+                                  int src_weight) {
+  const __m256i weights = weight_pairs(src_weight);
+  int r;
+
+  // Four rows per iteration, two in each 128-bit lane.
+  for (r = 0; r < 8; r += 4) {
+    const __m256i res =
+        blend(load_4x8(src, src_stride), load_4x8(dst, dst_stride), weights);
+    const __m128i r01 = _mm256_castsi256_si128(res);
+    const __m128i r23 = _mm256_extracti128_si256(res, 1);
+    _mm_storel_epi64((__m128i *)dst, r01);
+    _mm_storel_epi64((__m128i *)(dst + dst_stride), _mm_srli_si128(r01, 8));
+    _mm_storel_epi64((__m128i *)(dst + 2 * dst_stride), r23);
+    _mm_storel_epi64((__m128i *)(dst + 3 * dst_stride),
+                     _mm_srli_si128(r23, 8));
+    src += 4 * src_stride;
+    dst += 4 * dst_stride;
+  }
+}
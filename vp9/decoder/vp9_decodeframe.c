@@ -455,81 +455,6 @@ static int reconstruct_inter_block_row_mt(TileWorkerData *twd,
   return eob;
 }
 
-static void build_mc_border(const uint8_t *src, int src_stride, uint8_t *dst,
-                            int dst_stride, int x, int y, int b_w, int b_h,
-                            int w, int h) {
-  // Get a pointer to the start of the real data for this row.
-  const uint8_t *ref_row = src - x - y * src_stride;
-
-  if (y >= h)
-    ref_row += (h - 1) * src_stride;
-  else if (y > 0)
-    ref_row += y * src_stride;
-
-  do {
-    int right = 0, copy;
-    int left = x < 0 ? -x : 0;
-
-    if (left > b_w) left = b_w;
-
-    if (x + b_w > w) right = x + b_w - w;
-
-    if (right > b_w) right = b_w;
-
-    copy = b_w - left - right;
-
-    if (left) memset(dst, ref_row[0], left);
-
-    if (copy) memcpy(dst + left, ref_row + x + left, copy);
-
-    if (right) memset(dst + left + copy, ref_row[w - 1], right);
-
-    dst += dst_stride;
-    ++y;
-
-    if (y > 0 && y < h) ref_row += src_stride;
-  } while (--b_h);
-}
-
-#if CONFIG_VP9_HIGHBITDEPTH
-static void high_build_mc_border(const uint8_t *src8, int src_stride,
-                                 uint16_t *dst, int dst_stride, int x, int y,
-                                 int b_w, int b_h, int w, int h) {
-  // Get a pointer to the start of the real data for this row.
-  const uint16_t *src = CONVERT_TO_SHORTPTR(src8);
-  const uint16_t *ref_row = src - x - y * src_stride;
-
-  if (y >= h)
-    ref_row += (h - 1) * src_stride;
-  else if (y > 0)
-    ref_row += y * src_stride;
-
-  do {
-    int right = 0, copy;
-    int left = x < 0 ? -x : 0;
-
-    if (left > b_w) left = b_w;
-
-    if (x + b_w > w) right = x + b_w - w;
-
-    if (right > b_w) right = b_w;
-
-    copy = b_w - left - right;
-
-    if (left) vpx_memset16(dst, ref_row[0], left);
-
-    if (copy) memcpy(dst + left, ref_row + x + left, copy * sizeof(uint16_t));
-
-    if (right) vpx_memset16(dst + left + copy, ref_row[w - 1], right);
-
-    dst += dst_stride;
-    ++y;
-
-    if (y > 0 && y < h) ref_row += src_stride;
-  } while (--b_h);
-}
-#endif  // CONFIG_VP9_HIGHBITDEPTH
-
 #if CONFIG_VP9_HIGHBITDEPTH
 static void extend_and_predict(TileWorkerData *twd, const uint8_t *buf_ptr1,
                                int pre_buf_stride, int x0, int y0, int b_w,
@@ -541,14 +466,14 @@ static void extend_and_predict(TileWorkerData *twd, const uint8_t *buf_ptr1,
                                int w, int h, int ref, int xs, int ys) {
   uint16_t *mc_buf_high = twd->extend_and_predict_buf;
   if (xd->cur_buf->flags & YV12_FLAG_HIGHBITDEPTH) {
-    high_build_mc_border(buf_ptr1, pre_buf_stride, mc_buf_high, b_w, x0, y0,
-                         b_w, b_h, frame_width, frame_height);
+    vp9_highbd_build_mc_border(buf_ptr1, pre_buf_stride, mc_buf_high, b_w, x0,
+                               y0, b_w, b_h, frame_width, frame_height);
     highbd_inter_predictor(mc_buf_high + border_offset, b_w,
                            CONVERT_TO_SHORTPTR(dst), dst_buf_stride, subpel_x,
                            subpel_y, sf, w, h, ref, kernel, xs, ys, xd->bd);
   } else {
-    build_mc_border(buf_ptr1, pre_buf_stride, (uint8_t *)mc_buf_high, b_w, x0,
-                    y0, b_w, b_h, frame_width, frame_height);
+    vp9_build_mc_border(buf_ptr1, pre_buf_stride, (uint8_t *)mc_buf_high, b_w,
+                        x0, y0, b_w, b_h, frame_width, frame_height);
     inter_predictor(((uint8_t *)mc_buf_high) + border_offset, b_w, dst,
                     dst_buf_stride, subpel_x, subpel_y, sf, w, h, ref, kernel,
                     xs, ys);
@@ -566,8 +491,8 @@ static void extend_and_predict(TileWorkerData *twd, const uint8_t *buf_ptr1,
   uint8_t *mc_buf = (uint8_t *)twd->extend_and_predict_buf;
   const uint8_t *buf_ptr;
 
-  build_mc_border(buf_ptr1, pre_buf_stride, mc_buf, b_w, x0, y0, b_w, b_h,
-                  frame_width, frame_height);
+  vp9_build_mc_border(buf_ptr1, pre_buf_stride, mc_buf, b_w, x0, y0, b_w, b_h,
+                      frame_width, frame_height);
   buf_ptr = mc_buf + border_offset;
 
   inter_predictor(buf_ptr, b_w, dst, dst_buf_stride, subpel_x, subpel_y, sf, w,
@@ -713,13 +638,109 @@ static void dec_build_inter_predictors(
 #endif  // CONFIG_VP9_HIGHBITDEPTH
 }
 
+// Removes columns [start, end) from the span of the new frame that is
+// reconstructed exactly, keeping the side that holds the decode region.
+static void invalidate_cols(VP9Decoder *pbi, int start, int end) {
+  const int center = pbi->region_x_end > 0
+                         ? (pbi->region_x_start + pbi->region_x_end) / 2
+                         : pbi->common.width / 2;
+  if (start >= end || end <= pbi->valid_x_start || start >= pbi->valid_x_end)
+    return;
+  if (start + end < 2 * center)
+    pbi->valid_x_start = VPXMAX(pbi->valid_x_start, end);
+  else
+    pbi->valid_x_end = VPXMIN(pbi->valid_x_end, start);
+}
+
+// Tracks which columns of the new frame stay exact when tiles of it or of its
+// references were skipped. Intra blocks need the luma and chroma columns to
+// their left and the row above to be exact. Each column of an inter block
+// needs the columns it reads in every reference, including the interpolation
+// filter taps.
+static void check_block_region(VP9Decoder *pbi, const MACROBLOCKD *xd,
+                               const MODE_INFO *mi, int mi_col, int bw) {
+  VP9_COMMON *const cm = &pbi->common;
+  const int x0 = mi_col * MI_SIZE;
+  const int x1 = VPXMIN(x0 + bw * MI_SIZE, cm->width);
+  int ref;
+
+  if (!is_inter_block(mi)) {
+    const int left = mi_col > xd->tile.mi_col_start ? 2 : 0;
+    if (x0 - left < pbi->valid_x_start || x1 > pbi->valid_x_end)
+      invalidate_cols(pbi, x0, x1);
+    return;
+  }
+
+  for (ref = 0; ref < 1 + has_second_ref(mi); ++ref) {
+    const RefBuffer *const ref_buf = &cm->frame_refs[mi->ref_frame[ref] - 1];
+    const RefCntBuffer *const ref_frame_buf =
+        &cm->buffer_pool->frame_bufs[ref_buf->idx];
+    const int ref_start = ref_frame_buf->valid_x_start;
+    const int ref_end = ref_frame_buf->valid_x_end;
+    const int ref_width = ref_frame_buf->buf.y_crop_width;
+    int min_mv = mi->mv[ref].as_mv.col, max_mv = min_mv, taps;
+
+    if (ref_start == 0 && ref_end == ref_width) continue;
+    if (vp9_is_scaled(&ref_buf->sf) || ref_start >= ref_end) {
+      invalidate_cols(pbi, x0, x1);
+      continue;
+    }
+    if (mi->sb_type < BLOCK_8X8) {
+      int i;
+      for (i = 0; i < 4; ++i) {
+        min_mv = VPXMIN(min_mv, mi->bmi[i].as_mv[ref].as_mv.col);
+        max_mv = VPXMAX(max_mv, mi->bmi[i].as_mv[ref].as_mv.col);
+      }
+      // The chroma of a sub8x8 block is predicted with the average of its
+      // motion vectors, which can be fractional when none of them is.
+      taps = 2 * VP9_INTERP_EXTEND;
+    } else {
+      // Chroma motion vectors have 1/16 pel precision.
+      taps = (min_mv & 15) ? 2 * VP9_INTERP_EXTEND : 0;
+    }
+    // Reads beyond the frame edge replicate the edge pixels.
+    if (ref_start > 0)
+      invalidate_cols(pbi, x0, VPXMIN(x1, ref_start - (min_mv >> 3) + taps));
+    if (ref_end < ref_width)
+      invalidate_cols(pbi, VPXMAX(x0, ref_end - (max_mv >> 3) - taps), x1);
+  }
+}
+
+// Reduced resolution decoding (VP9D_SET_REDUCED_RESOLUTION) parses every
+// block as usual and reconstructs it at 1 / (1 << shift) of its size into a
+// downscaled frame buffer.
+
+static INLINE int reduced_size(int size, int shift) {
+  return (size + (1 << shift) - 1) >> shift;
+}
+
+static INLINE MV reduce_mv(MV mv, int shift) {
+  const int half = (1 << shift) >> 1;
+  mv.row = (int16_t)((mv.row < 0 ? mv.row - half : mv.row + half) >> shift);
+  mv.col = (int16_t)((mv.col < 0 ? mv.col - half : mv.col + half) >> shift);
+  return mv;
+}
+
+// The optimized convolutions do not handle blocks narrower or shorter than 4
+// pixels, which only occur at reduced resolution.
+static void setup_small_block_predict(struct scale_factors *sf) {
+  int i, j;
+  for (i = 0; i < 2; ++i) {
+    for (j = 0; j < 2; ++j) {
+      sf->predict[i][j][0] = vpx_convolve8_c;
+      sf->predict[i][j][1] = vpx_convolve8_avg_c;
+    }
+  }
+}
+
 static void dec_build_inter_predictors_sb(TileWorkerData *twd,
                                           VP9Decoder *const pbi,
                                           MACROBLOCKD *xd, int mi_row,
                                           int mi_col) {
   int plane;
-  const int mi_x = mi_col * MI_SIZE;
-  const int mi_y = mi_row * MI_SIZE;
+  const int shift = pbi->reduce_log2;
+  const int mi_x = (mi_col * MI_SIZE) >> shift;
+  const int mi_y = (mi_row * MI_SIZE) >> shift;
   const MODE_INFO *mi = xd->mi[0];
   const InterpKernel *kernel = vp9_filter_kernels[mi->interp_filter];
   const BLOCK_SIZE sb_type = mi->sb_type;
@@ -734,6 +755,7 @@ static void dec_build_inter_predictors_sb(TileWorkerData *twd,
     const int idx = ref_buf->idx;
     BufferPool *const pool = pbi->common.buffer_pool;
     RefCntBuffer *const ref_frame_buf = &pool->frame_bufs[idx];
+    struct scale_factors small_sf;
 
     if (!vp9_is_valid_scale(sf))
       vpx_internal_error(xd->error_info, VPX_CODEC_UNSUP_BITSTREAM,
@@ -743,6 +765,10 @@ static void dec_build_inter_predictors_sb(TileWorkerData *twd,
     vp9_setup_pre_planes(xd, ref, ref_buf->buf, mi_row, mi_col,
                          is_scaled ? sf : NULL);
     xd->block_refs[ref] = ref_buf;
+    if (shift) {
+      small_sf = *sf;
+      setup_small_block_predict(&small_sf);
+    }
 
     if (sb_type < BLOCK_8X8) {
       for (plane = 0; plane < MAX_MB_PLANE; ++plane) {
@@ -750,33 +776,37 @@ static void dec_build_inter_predictors_sb(TileWorkerData *twd,
         struct buf_2d *const dst_buf = &pd->dst;
         const int num_4x4_w = pd->n4_w;
         const int num_4x4_h = pd->n4_h;
-        const int n4w_x4 = 4 * num_4x4_w;
-        const int n4h_x4 = 4 * num_4x4_h;
+        const int n4w_x4 = (4 * num_4x4_w) >> shift;
+        const int n4h_x4 = (4 * num_4x4_h) >> shift;
+        const int b4 = 4 >> shift;
         struct buf_2d *const pre_buf = &pd->pre[ref];
         int i = 0, x, y;
         for (y = 0; y < num_4x4_h; ++y) {
           for (x = 0; x < num_4x4_w; ++x) {
-            const MV mv = average_split_mvs(pd, mi, ref, i++);
-            dec_build_inter_predictors(twd, xd, plane, n4w_x4, n4h_x4, 4 * x,
-                                       4 * y, 4, 4, mi_x, mi_y, kernel, sf,
-                                       pre_buf, dst_buf, &mv, ref_frame_buf,
-                                       is_scaled, ref);
+            MV mv = average_split_mvs(pd, mi, ref, i++);
+            if (shift) mv = reduce_mv(mv, shift);
+            dec_build_inter_predictors(
+                twd, xd, plane, n4w_x4, n4h_x4, b4 * x, b4 * y, b4, b4, mi_x,
+                mi_y, kernel, shift ? &small_sf : sf, pre_buf, dst_buf, &mv,
+                ref_frame_buf, is_scaled, ref);
           }
         }
       }
     } else {
-      const MV mv = mi->mv[ref].as_mv;
+      const MV mv = shift ? reduce_mv(mi->mv[ref].as_mv, shift)
+                          : mi->mv[ref].as_mv;
       for (plane = 0; plane < MAX_MB_PLANE; ++plane) {
         struct macroblockd_plane *const pd = &xd->plane[plane];
         struct buf_2d *const dst_buf = &pd->dst;
         const int num_4x4_w = pd->n4_w;
         const int num_4x4_h = pd->n4_h;
-        const int n4w_x4 = 4 * num_4x4_w;
-        const int n4h_x4 = 4 * num_4x4_h;
+        const int n4w_x4 = (4 * num_4x4_w) >> shift;
+        const int n4h_x4 = (4 * num_4x4_h) >> shift;
         struct buf_2d *const pre_buf = &pd->pre[ref];
-        dec_build_inter_predictors(twd, xd, plane, n4w_x4, n4h_x4, 0, 0, n4w_x4,
-                                   n4h_x4, mi_x, mi_y, kernel, sf, pre_buf,
-                                   dst_buf, &mv, ref_frame_buf, is_scaled, ref);
+        dec_build_inter_predictors(
+            twd, xd, plane, n4w_x4, n4h_x4, 0, 0, n4w_x4, n4h_x4, mi_x, mi_y,
+            kernel, n4w_x4 < 4 || n4h_x4 < 4 ? &small_sf : sf, pre_buf,
+            dst_buf, &mv, ref_frame_buf, is_scaled, ref);
       }
     }
   }
@@ -910,6 +940,322 @@ static INLINE void predict_recon_intra(MACROBLOCKD *xd, MODE_INFO *mi,
   }
 }
 
+static void setup_reduced_dst_planes(MACROBLOCKD *xd,
+                                     const YV12_BUFFER_CONFIG *src, int mi_row,
+                                     int mi_col, int shift) {
+  uint8_t *const buffers[MAX_MB_PLANE] = { src->y_buffer, src->u_buffer,
+                                           src->v_buffer };
+  const int strides[MAX_MB_PLANE] = { src->y_stride, src->uv_stride,
+                                      src->uv_stride };
+  int i;
+
+  for (i = 0; i < MAX_MB_PLANE; ++i) {
+    struct macroblockd_plane *const pd = &xd->plane[i];
+    setup_pred_plane(&pd->dst, buffers[i], strides[i], mi_row, mi_col, NULL,
+                     pd->subsampling_x + shift, pd->subsampling_y + shift);
+  }
+}
+
+static INLINE uint8_t *reduced_dst(const struct macroblockd_plane *pd,
+                                   int row, int col, int shift) {
+  return &pd->dst.buf[((4 * row) >> shift) * pd->dst.stride +
+                      ((4 * col) >> shift)];
+}
+
+// Estimates the full resolution pixel next to a block from the two nearest
+// downscaled ones, which are averages centered further away.
+static INLINE uint8_t reduced_edge(int near, int far, int shift) {
+  return clip_pixel(near + ((near - far) * ((1 << shift) - 1) >> (shift + 1)));
+}
+
+// Intra predicts a transform block that is smaller than 4x4 once downscaled.
+// The edges of the full size block are rebuilt from the downscaled neighbours,
+// with the rules of vp9_predict_intra_block(), and the full size prediction is
+// box filtered into place.
+static void reduced_intra_predictor(const MACROBLOCKD *xd, int plane,
+                                    PREDICTION_MODE mode, TX_SIZE tx_size,
+                                    uint8_t *dst, int stride, int aoff,
+                                    int loff, int shift) {
+  const struct macroblockd_plane *const pd = &xd->plane[plane];
+  const int bs = 4 << tx_size;
+  const int m = bs >> shift;
+  const int have_top = loff || xd->above_mi != NULL;
+  const int have_left = aoff || xd->left_mi != NULL;
+  const int have_right = bs == 4 && (aoff + 1) < (1 << pd->n4_wl);
+  const int frame_width = plane ? xd->cur_buf->uv_width : xd->cur_buf->y_width;
+  const int frame_height =
+      plane ? xd->cur_buf->uv_height : xd->cur_buf->y_height;
+  const int x0 =
+      (-xd->mb_to_left_edge >> (3 + pd->subsampling_x)) + ((4 * aoff) >> shift);
+  const int y0 =
+      (-xd->mb_to_top_edge >> (3 + pd->subsampling_y)) + ((4 * loff) >> shift);
+  const uint8_t *const above_ref = dst - stride;
+  const uint8_t *const above_far = y0 > 1 ? above_ref - stride : above_ref;
+  // Tiles to the left may still be decoding.
+  const int tile_x0 =
+      (xd->tile.mi_col_start * MI_SIZE >> pd->subsampling_x) >> shift;
+  const int left_far = x0 - tile_x0 > 1 ? 2 : 1;
+  DECLARE_ALIGNED(16, uint8_t, above_data[16 + 16]);
+  DECLARE_ALIGNED(16, uint8_t, left_col[8]);
+  DECLARE_ALIGNED(16, uint8_t, pred[8 * 8]);
+  uint8_t *const above_row = above_data + 16;
+  int sum[2][2] = { { 0, 0 }, { 0, 0 } };
+  int i, r, c;
+
+  assert(m <= 2);
+  if (have_top) {
+    const int width = VPXMIN(have_right ? 2 * m : m, frame_width - x0);
+    for (i = 0; i < 2 * bs; ++i) {
+      const int k = VPXMIN(i >> shift, width - 1);
+      above_row[i] = reduced_edge(above_ref[k], above_far[k], shift);
+    }
+    above_row[-1] = have_left ? reduced_edge(above_ref[-1],
+                                             above_far[-left_far], shift)
+                              : 129;
+  } else {
+    memset(above_row - 1, 127, 2 * bs + 1);
+  }
+  if (have_left) {
+    const int height = VPXMIN(m, frame_height - y0);
+    for (i = 0; i < bs; ++i) {
+      const uint8_t *const left_ref =
+          dst + VPXMIN(i >> shift, height - 1) * stride;
+      left_col[i] = reduced_edge(left_ref[-1], left_ref[-left_far], shift);
+    }
+  } else {
+    memset(left_col, 129, bs);
+  }
+
+  vp9_predict_intra_from_edges(mode, tx_size, have_top, have_left, pred, bs,
+                               above_row, left_col);
+  for (r = 0; r < bs; ++r)
+    for (c = 0; c < bs; ++c) sum[r >> shift][c >> shift] += pred[r * bs + c];
+  for (r = 0; r < m; ++r)
+    for (c = 0; c < m; ++c)
+      dst[r * stride + c] = ROUND_POWER_OF_TWO(sum[r][c], 2 * shift);
+}
+
+static const transform_2d small_iht[2][TX_TYPES] = {
+  { { idct4_c, idct4_c },
+    { iadst4_c, idct4_c },
+    { idct4_c, iadst4_c },
+    { iadst4_c, iadst4_c } },
+  { { idct8_c, idct8_c },
+    { iadst8_c, idct8_c },
+    { idct8_c, iadst8_c },
+    { iadst8_c, iadst8_c } },
+};
+
+// Adds the residual of an NxN transform block to its (N >> shift) square in
+// the downscaled frame. The low frequency (N >> shift) square of coefficients
+// goes through the inverse transform of that size, which keeps the mean of the
+// block. Below 4x4 the full residual is box filtered instead.
+static void reduced_inverse_transform(MACROBLOCKD *xd, int plane,
+                                      const TX_TYPE tx_type,
+                                      const TX_SIZE tx_size, uint8_t *dst,
+                                      int stride, int eob, int shift) {
+  struct macroblockd_plane *const pd = &xd->plane[plane];
+  tran_low_t *const dqcoeff = pd->dqcoeff;
+  const int n = 4 << tx_size;
+  const int m = n >> shift;
+  assert(eob > 0);
+
+  if (m < 4 && (eob == 1 || xd->lossless)) {
+    int dc, r, c;
+    if (xd->lossless) {
+      dc = ROUND_POWER_OF_TWO(dqcoeff[0], UNIT_QUANT_SHIFT + 2);
+    } else {
+      const tran_low_t out = WRAPLOW(dct_const_round_shift(
+          WRAPLOW(dct_const_round_shift(dqcoeff[0] * cospi_16_64)) *
+          cospi_16_64));
+      dc = ROUND_POWER_OF_TWO(out, tx_size + 4);
+    }
+    for (r = 0; r < m; ++r)
+      for (c = 0; c < m; ++c)
+        dst[r * stride + c] = clip_pixel_add(dst[r * stride + c], dc);
+  } else if (m < 4) {
+    const transform_2d *const iht = &small_iht[tx_size][tx_type];
+    tran_low_t out[8 * 8], temp_in[8], temp_out[8];
+    int sum[2][2] = { { 0, 0 }, { 0, 0 } };
+    int r, c;
+
+    assert(tx_size <= TX_8X8);
+    for (r = 0; r < n; ++r) iht->rows(dqcoeff + r * n, out + r * n);
+    for (c = 0; c < n; ++c) {
+      for (r = 0; r < n; ++r) temp_in[r] = out[r * n + c];
+      iht->cols(temp_in, temp_out);
+      for (r = 0; r < n; ++r) {
+        sum[r >> shift][c >> shift] +=
+            ROUND_POWER_OF_TWO(temp_out[r], tx_size + 4);
+      }
+    }
+    for (r = 0; r < m; ++r) {
+      for (c = 0; c < m; ++c) {
+        dst[r * stride + c] = clip_pixel_add(
+            dst[r * stride + c], ROUND_POWER_OF_TWO(sum[r][c], 2 * shift));
+      }
+    }
+  } else {
+    // Transforms up to 16x16 share one scale, 32x32 is half of it.
+    const int coeff_shift = shift - (tx_size == TX_32X32);
+    const TX_SIZE reduced_tx_size = (TX_SIZE)(tx_size - shift);
+    const int reduced_eob = eob == 1 ? 1 : m * m;
+    DECLARE_ALIGNED(32, tran_low_t, coeff[16 * 16]);
+    int r, c;
+
+    for (r = 0; r < m; ++r) {
+      for (c = 0; c < m; ++c) {
+        coeff[r * m + c] =
+            coeff_shift ? ROUND_POWER_OF_TWO(dqcoeff[r * n + c], coeff_shift)
+                        : dqcoeff[r * n + c];
+      }
+    }
+    switch (reduced_tx_size) {
+      case TX_4X4:
+        vp9_iht4x4_add(tx_type, coeff, dst, stride, reduced_eob);
+        break;
+      case TX_8X8:
+        vp9_iht8x8_add(tx_type, coeff, dst, stride, reduced_eob);
+        break;
+      case TX_16X16:
+        vp9_iht16x16_add(tx_type, coeff, dst, stride, reduced_eob);
+        break;
+      default: assert(0 && "Invalid transform size"); break;
+    }
+  }
+
+  if (eob == 1) {
+    dqcoeff[0] = 0;
+  } else {
+    memset(dqcoeff, 0, n * n * sizeof(dqcoeff[0]));
+  }
+}
+
+static void predict_and_reconstruct_reduced_intra_block(TileWorkerData *twd,
+                                                        MODE_INFO *const mi,
+                                                        int plane, int row,
+                                                        int col,
+                                                        TX_SIZE tx_size,
+                                                        int shift) {
+  MACROBLOCKD *const xd = &twd->xd;
+  struct macroblockd_plane *const pd = &xd->plane[plane];
+  PREDICTION_MODE mode = (plane == 0) ? mi->mode : mi->uv_mode;
+  uint8_t *const dst = reduced_dst(pd, row, col, shift);
+
+  if (mi->sb_type < BLOCK_8X8)
+    if (plane == 0) mode = xd->mi[0]->bmi[(row << 1) + col].as_mode;
+
+  if ((int)tx_size >= shift) {
+    vp9_predict_intra_block(xd, pd->n4_wl - shift, (TX_SIZE)(tx_size - shift),
+                            mode, dst, pd->dst.stride, dst, pd->dst.stride,
+                            col >> shift, row >> shift, plane);
+  } else {
+    reduced_intra_predictor(xd, plane, mode, tx_size, dst, pd->dst.stride,
+                            col, row, shift);
+  }
+
+  if (!mi->skip) {
+    const TX_TYPE tx_type =
+        (plane || xd->lossless) ? DCT_DCT : intra_mode_to_tx_type_lookup[mode];
+    const ScanOrder *sc = (plane || xd->lossless)
+                              ? &vp9_default_scan_orders[tx_size]
+                              : &vp9_scan_orders[tx_size][tx_type];
+    const int eob = vp9_decode_block_tokens(twd, plane, sc, col, row, tx_size,
+                                            mi->segment_id);
+    if (eob > 0) {
+      reduced_inverse_transform(xd, plane, tx_type, tx_size, dst,
+                                pd->dst.stride, eob, shift);
+    }
+  }
+}
+
+static int reconstruct_reduced_inter_block(TileWorkerData *twd,
+                                           MODE_INFO *const mi, int plane,
+                                           int row, int col, TX_SIZE tx_size,
+                                           int shift) {
+  MACROBLOCKD *const xd = &twd->xd;
+  struct macroblockd_plane *const pd = &xd->plane[plane];
+  const ScanOrder *sc = &vp9_default_scan_orders[tx_size];
+  const int eob = vp9_decode_block_tokens(twd, plane, sc, col, row, tx_size,
+                                          mi->segment_id);
+
+  if (eob > 0) {
+    reduced_inverse_transform(xd, plane, DCT_DCT, tx_size,
+                              reduced_dst(pd, row, col, shift), pd->dst.stride,
+                              eob, shift);
+  }
+  return eob;
+}
+
+// Reconstructs a block at reduced resolution once its mode info is read,
+// decoding its coefficients in the same order as decode_block().
+static void decode_reduced_block(TileWorkerData *twd, VP9Decoder *const pbi,
+                                 MODE_INFO *mi, int mi_row, int mi_col) {
+  MACROBLOCKD *const xd = &twd->xd;
+  const int shift = pbi->reduce_log2;
+  const int is_inter = is_inter_block(mi);
+  // The distances to the frame edges are a multiple of 8 pixels, so they
+  // scale exactly.
+  const int mb_to_left_edge = xd->mb_to_left_edge;
+  const int mb_to_right_edge = xd->mb_to_right_edge;
+  const int mb_to_top_edge = xd->mb_to_top_edge;
+  const int mb_to_bottom_edge = xd->mb_to_bottom_edge;
+
+  setup_reduced_dst_planes(xd, get_frame_new_buffer(&pbi->common), mi_row,
+                           mi_col, shift);
+  xd->mb_to_left_edge = mb_to_left_edge / (1 << shift);
+  xd->mb_to_right_edge = mb_to_right_edge / (1 << shift);
+  xd->mb_to_top_edge = mb_to_top_edge / (1 << shift);
+  xd->mb_to_bottom_edge = mb_to_bottom_edge / (1 << shift);
+
+  if (is_inter) dec_build_inter_predictors_sb(twd, pbi, xd, mi_row, mi_col);
+
+  if (!is_inter || !mi->skip) {
+    int eobtotal = 0;
+    int plane;
+
+    for (plane = 0; plane < MAX_MB_PLANE; ++plane) {
+      const struct macroblockd_plane *const pd = &xd->plane[plane];
+      const TX_SIZE tx_size = plane ? get_uv_tx_size(mi, pd) : mi->tx_size;
+      const int num_4x4_w = pd->n4_w;
+      const int num_4x4_h = pd->n4_h;
+      const int step = (1 << tx_size);
+      int row, col;
+      const int max_blocks_wide =
+          num_4x4_w + (mb_to_right_edge >= 0
+                           ? 0
+                           : mb_to_right_edge >> (5 + pd->subsampling_x));
+      const int max_blocks_high =
+          num_4x4_h + (mb_to_bottom_edge >= 0
+                           ? 0
+                           : mb_to_bottom_edge >> (5 + pd->subsampling_y));
+
+      xd->max_blocks_wide = mb_to_right_edge >= 0 ? 0 : max_blocks_wide;
+      xd->max_blocks_high = mb_to_bottom_edge >= 0 ? 0 : max_blocks_high;
+
+      for (row = 0; row < max_blocks_high; row += step) {
+        for (col = 0; col < max_blocks_wide; col += step) {
+          if (is_inter) {
+            eobtotal += reconstruct_reduced_inter_block(twd, mi, plane, row,
+                                                        col, tx_size, shift);
+          } else {
+            predict_and_reconstruct_reduced_intra_block(twd, mi, plane, row,
+                                                        col, tx_size, shift);
+          }
+        }
+      }
+    }
+
+    // The skip flag is the context of later blocks.
+    if (is_inter && mi->sb_type >= BLOCK_8X8 && eobtotal == 0) mi->skip = 1;
+  }
+
+  xd->mb_to_left_edge = mb_to_left_edge;
+  xd->mb_to_right_edge = mb_to_right_edge;
+  xd->mb_to_top_edge = mb_to_top_edge;
+  xd->mb_to_bottom_edge = mb_to_bottom_edge;
+}
+
 static void decode_block(TileWorkerData *twd, VP9Decoder *const pbi, int mi_row,
                          int mi_col, BLOCK_SIZE bsize, int bwl, int bhl) {
   VP9_COMMON *const cm = &pbi->common;
@@ -934,11 +1280,15 @@ static void decode_block(TileWorkerData *twd, VP9Decoder *const pbi, int mi_row,
 
   vp9_read_mode_info(twd, pbi, mi_row, mi_col, x_mis, y_mis);
 
+  if (pbi->check_region) check_block_region(pbi, xd, mi, mi_col, bw);
+
   if (mi->skip) {
     dec_reset_skip_context(xd);
   }
 
-  if (!is_inter_block(mi)) {
+  if (pbi->reduce_log2) {
+    decode_reduced_block(twd, pbi, mi, mi_row, mi_col);
+  } else if (!is_inter_block(mi)) {
     int plane;
     for (plane = 0; plane < MAX_MB_PLANE; ++plane) {
       const struct macroblockd_plane *const pd = &xd->plane[plane];
@@ -1037,6 +1387,8 @@ static void recon_block(TileWorkerData *twd, VP9Decoder *const pbi, int mi_row,
 
   MODE_INFO *mi = set_offsets_recon(cm, xd, mi_row, mi_col, bw, bh, bwl, bhl);
 
+  if (pbi->check_region) check_block_region(pbi, xd, mi, mi_col, bw);
+
   if (bsize >= BLOCK_8X8 && (cm->subsampling_x || cm->subsampling_y)) {
     const BLOCK_SIZE uv_subsize =
         ss_size_lookup[bsize][cm->subsampling_x][cm->subsampling_y];
@@ -1514,7 +1866,8 @@ static void resize_context_buffers(VP9_COMMON *cm, int width, int height) {
   }
 }
 
-static void setup_frame_size(VP9_COMMON *cm, struct vpx_read_bit_buffer *rb) {
+static void setup_frame_size(VP9Decoder *pbi, struct vpx_read_bit_buffer *rb) {
+  VP9_COMMON *const cm = &pbi->common;
   int width, height;
   BufferPool *const pool = cm->buffer_pool;
   vp9_read_frame_size(rb, &width, &height);
@@ -1522,7 +1875,8 @@ static void setup_frame_size(VP9_COMMON *cm, struct vpx_read_bit_buffer *rb) {
   setup_render_size(cm, rb);
 
   if (vpx_realloc_frame_buffer(
-          get_frame_new_buffer(cm), cm->width, cm->height, cm->subsampling_x,
+          get_frame_new_buffer(cm), reduced_size(cm->width, pbi->reduce_log2),
+          reduced_size(cm->height, pbi->reduce_log2), cm->subsampling_x,
           cm->subsampling_y,
 #if CONFIG_VP9_HIGHBITDEPTH
           cm->use_highbitdepth,
@@ -1535,6 +1889,8 @@ static void setup_frame_size(VP9_COMMON *cm, struct vpx_read_bit_buffer *rb) {
   }
 
   pool->frame_bufs[cm->new_fb_idx].released = 0;
+  pool->frame_bufs[cm->new_fb_idx].frame_width = cm->width;
+  pool->frame_bufs[cm->new_fb_idx].frame_height = cm->height;
   pool->frame_bufs[cm->new_fb_idx].buf.subsampling_x = cm->subsampling_x;
   pool->frame_bufs[cm->new_fb_idx].buf.subsampling_y = cm->subsampling_y;
   pool->frame_bufs[cm->new_fb_idx].buf.bit_depth = (unsigned int)cm->bit_depth;
@@ -1552,8 +1908,9 @@ static INLINE int valid_ref_frame_img_fmt(vpx_bit_depth_t ref_bit_depth,
          ref_yss == this_yss;
 }
 
-static void setup_frame_size_with_refs(VP9_COMMON *cm,
+static void setup_frame_size_with_refs(VP9Decoder *pbi,
                                        struct vpx_read_bit_buffer *rb) {
+  VP9_COMMON *const cm = &pbi->common;
   int width, height;
   int found = 0, i;
   int has_valid_ref_frame = 0;
@@ -1561,9 +1918,9 @@ static void setup_frame_size_with_refs(VP9_COMMON *cm,
   for (i = 0; i < REFS_PER_FRAME; ++i) {
     if (vpx_rb_read_bit(rb)) {
       if (cm->frame_refs[i].idx != INVALID_IDX) {
-        YV12_BUFFER_CONFIG *const buf = cm->frame_refs[i].buf;
-        width = buf->y_crop_width;
-        height = buf->y_crop_height;
+        const int idx = cm->frame_refs[i].idx;
+        width = pool->frame_bufs[idx].frame_width;
+        height = pool->frame_bufs[idx].frame_height;
         found = 1;
         break;
       } else {
@@ -1585,8 +1942,9 @@ static void setup_frame_size_with_refs(VP9_COMMON *cm,
     RefBuffer *const ref_frame = &cm->frame_refs[i];
     has_valid_ref_frame |=
         (ref_frame->idx != INVALID_IDX &&
-         valid_ref_frame_size(ref_frame->buf->y_crop_width,
-                              ref_frame->buf->y_crop_height, width, height));
+         valid_ref_frame_size(pool->frame_bufs[ref_frame->idx].frame_width,
+                              pool->frame_bufs[ref_frame->idx].frame_height,
+                              width, height));
   }
   if (!has_valid_ref_frame)
     vpx_internal_error(&cm->error, VPX_CODEC_CORRUPT_FRAME,
@@ -1606,7 +1964,8 @@ static void setup_frame_size_with_refs(VP9_COMMON *cm,
   setup_render_size(cm, rb);
 
   if (vpx_realloc_frame_buffer(
-          get_frame_new_buffer(cm), cm->width, cm->height, cm->subsampling_x,
+          get_frame_new_buffer(cm), reduced_size(cm->width, pbi->reduce_log2),
+          reduced_size(cm->height, pbi->reduce_log2), cm->subsampling_x,
           cm->subsampling_y,
 #if CONFIG_VP9_HIGHBITDEPTH
           cm->use_highbitdepth,
@@ -1619,6 +1978,8 @@ static void setup_frame_size_with_refs(VP9_COMMON *cm,
   }
 
   pool->frame_bufs[cm->new_fb_idx].released = 0;
+  pool->frame_bufs[cm->new_fb_idx].frame_width = cm->width;
+  pool->frame_bufs[cm->new_fb_idx].frame_height = cm->height;
   pool->frame_bufs[cm->new_fb_idx].buf.subsampling_x = cm->subsampling_x;
   pool->frame_bufs[cm->new_fb_idx].buf.subsampling_y = cm->subsampling_y;
   pool->frame_bufs[cm->new_fb_idx].buf.bit_depth = (unsigned int)cm->bit_depth;
@@ -2014,6 +2375,14 @@ static int row_decode_worker_hook(void *arg1, void *arg2) {
   return !corrupted;
 }
 
+// Reports superblock rows up to |sb_row_end| of the new frame as final.
+static void rows_done(VP9Decoder *pbi, int sb_row_end) {
+  if (pbi->rows_done_cb && sb_row_end > pbi->sb_rows_done) {
+    pbi->rows_done_cb(pbi->rows_done_priv, pbi->sb_rows_done, sb_row_end);
+    pbi->sb_rows_done = sb_row_end;
+  }
+}
+
 static const uint8_t *decode_tiles(VP9Decoder *pbi, const uint8_t *data,
                                    const uint8_t *data_end) {
   VP9_COMMON *const cm = &pbi->common;
@@ -2062,7 +2431,8 @@ static const uint8_t *decode_tiles(VP9Decoder *pbi, const uint8_t *data,
 
   // Load all tile information into tile_data.
   for (tile_row = 0; tile_row < tile_rows; ++tile_row) {
-    for (tile_col = 0; tile_col < tile_cols; ++tile_col) {
+    for (tile_col = pbi->tile_col_start; tile_col < pbi->tile_col_end;
+         ++tile_col) {
       const TileBuffer *const buf = &tile_buffers[tile_row][tile_col];
       tile_data = pbi->tile_worker_data + tile_cols * tile_row + tile_col;
       tile_data->xd = pbi->mb;
@@ -2083,16 +2453,19 @@ static const uint8_t *decode_tiles(VP9Decoder *pbi, const uint8_t *data,
     vp9_tile_set_row(&tile, cm, tile_row);
     for (mi_row = tile.mi_row_start; mi_row < tile.mi_row_end;
          mi_row += MI_BLOCK_SIZE) {
-      for (tile_col = 0; tile_col < tile_cols; ++tile_col) {
-        const int col =
-            pbi->inv_tile_order ? tile_cols - tile_col - 1 : tile_col;
+      for (tile_col = pbi->tile_col_start; tile_col < pbi->tile_col_end;
+           ++tile_col) {
+        const int col = pbi->inv_tile_order
+                            ? pbi->tile_col_end - tile_col - 1 +
+                                  pbi->tile_col_start
+                            : tile_col;
         tile_data = pbi->tile_worker_data + tile_cols * tile_row + col;
         vp9_tile_set_col(&tile, cm, col);
         vp9_zero(tile_data->xd.left_context);
         vp9_zero(tile_data->xd.left_seg_context);
         for (mi_col = tile.mi_col_start; mi_col < tile.mi_col_end;
              mi_col += MI_BLOCK_SIZE) {
-          if (pbi->row_mt == 1) {
+          if (pbi->row_mt == 1 && !pbi->reduce_log2) {
             int plane;
             RowMTWorkerData *const row_mt_worker_data = pbi->row_mt_worker_data;
             for (plane = 0; plane < MAX_MB_PLANE; ++plane) {
@@ -2121,6 +2494,9 @@ static const uint8_t *decode_tiles(VP9Decoder *pbi, const uint8_t *data,
           vpx_internal_error(&cm->error, VPX_CODEC_CORRUPT_FRAME,
                              "Failed to decode tile data");
       }
+      if (!cm->lf.filter_level || cm->skip_loop_filter) {
+        rows_done(pbi, (mi_row >> MI_BLOCK_SIZE_LOG2) + 1);
+      }
       // Loopfilter one row.
       if (cm->lf.filter_level && !cm->skip_loop_filter) {
         const int lf_start = mi_row - MI_BLOCK_SIZE;
@@ -2133,6 +2509,9 @@ static const uint8_t *decode_tiles(VP9Decoder *pbi, const uint8_t *data,
         if (mi_row + MI_BLOCK_SIZE >= cm->mi_rows) continue;
 
         winterface->sync(&pbi->lf_worker);
+        // Filtering the next row still modifies the bottom of the last
+        // filtered one.
+        rows_done(pbi, (lf_data->stop >> MI_BLOCK_SIZE_LOG2) - 1);
         lf_data->start = lf_start;
         lf_data->stop = mi_row;
         if (pbi->max_threads > 1) {
@@ -2153,6 +2532,12 @@ static const uint8_t *decode_tiles(VP9Decoder *pbi, const uint8_t *data,
     winterface->execute(&pbi->lf_worker);
   }
 
+  // The last tile was not read when skipped by region decoding.
+  if (pbi->tile_col_end < tile_cols) {
+    const TileBuffer *const buf = &tile_buffers[tile_rows - 1][tile_cols - 1];
+    return buf->data + buf->size;
+  }
+
   // Get last tile data.
   tile_data = pbi->tile_worker_data + tile_cols * tile_rows - 1;
 
@@ -2572,6 +2957,98 @@ static const uint8_t *decode_tiles_mt(VP9Decoder *pbi, const uint8_t *data,
   return bit_reader_end;
 }
 
+// Selects the tile columns to decode for VP9D_SET_DECODE_REGION, and whether
+// the blocks of the new frame need check_block_region().
+static void setup_decode_region(VP9Decoder *pbi) {
+  VP9_COMMON *const cm = &pbi->common;
+  RefCntBuffer *const cur = pbi->cur_buf;
+  const RefCntBuffer *const prev = cm->prev_frame;
+  // Read before |cur| is set up, as the buffer of a non-reference frame can be
+  // reused for the frame after it.
+  const int prev_x_start =
+      prev != NULL ? prev->decoded_mi_col_start * MI_SIZE : 0;
+  const int prev_x_end = prev != NULL ? prev->decoded_mi_col_end * MI_SIZE : 0;
+  const int tile_cols = 1 << cm->log2_tile_cols;
+  // Skipping tiles leaves the symbol counts incomplete, so the adapted
+  // probabilities must not be used by later frames. The loop filter for 4:2:2
+  // and 4:4:0 reads the mode info of every block instead of the masks built
+  // while decoding.
+  const int can_skip =
+      pbi->region_x_end > 0 && !pbi->reduce_log2 &&
+      (cm->error_resilient_mode || cm->frame_parallel_decoding_mode ||
+       !cm->refresh_frame_context) &&
+      cm->subsampling_x == cm->subsampling_y;
+  TileInfo tile;
+  int i;
+
+  pbi->tile_col_start = 0;
+  pbi->tile_col_end = tile_cols;
+  if (can_skip) {
+    for (; pbi->tile_col_start < tile_cols - 1; ++pbi->tile_col_start) {
+      vp9_tile_set_col(&tile, cm, pbi->tile_col_start);
+      if (tile.mi_col_end * MI_SIZE > pbi->region_x_start) break;
+    }
+    for (; pbi->tile_col_end > pbi->tile_col_start + 1; --pbi->tile_col_end) {
+      vp9_tile_set_col(&tile, cm, pbi->tile_col_end - 1);
+      if (tile.mi_col_start * MI_SIZE < pbi->region_x_end) break;
+    }
+  }
+
+  vp9_tile_set_col(&tile, cm, pbi->tile_col_start);
+  cur->decoded_mi_col_start = tile.mi_col_start;
+  vp9_tile_set_col(&tile, cm, pbi->tile_col_end - 1);
+  cur->decoded_mi_col_end = tile.mi_col_end;
+  pbi->valid_x_start = cur->decoded_mi_col_start * MI_SIZE;
+  pbi->valid_x_end = VPXMIN(cur->decoded_mi_col_end * MI_SIZE, cm->width);
+  pbi->check_region = pbi->tile_col_start > 0 || pbi->tile_col_end < tile_cols;
+  // Updated by finish_decode_region() once the frame is decoded.
+  cur->valid_x_start = 0;
+  cur->valid_x_end = cm->width;
+
+  // Motion vectors and segment ids are predicted from the mode info of the
+  // previous frame.
+  if ((cm->use_prev_frame_mvs ||
+       (cm->seg.enabled && cm->width == cm->last_width)) &&
+      prev != NULL) {
+    invalidate_cols(pbi, pbi->valid_x_start, prev_x_start);
+    invalidate_cols(pbi, prev_x_end, pbi->valid_x_end);
+  }
+
+  if (!frame_is_intra_only(cm)) {
+    for (i = 0; i < REFS_PER_FRAME; ++i) {
+      const RefCntBuffer *const ref =
+          &cm->buffer_pool->frame_bufs[cm->frame_refs[i].idx];
+      if (ref->valid_x_start > 0 || ref->valid_x_end < ref->buf.y_crop_width)
+        pbi->check_region = 1;
+    }
+  }
+}
+
+// Records the columns of the new frame that can be used as a reference and
+// whether they cover the decode region.
+static void finish_decode_region(VP9Decoder *pbi) {
+  VP9_COMMON *const cm = &pbi->common;
+  RefCntBuffer *const cur = pbi->cur_buf;
+  // Runs of loop filtered edges can carry a difference further than the taps
+  // of a single filter. It is assumed to stay within a superblock.
+  const int margin = cm->lf.filter_level && !cm->skip_loop_filter
+                         ? MI_BLOCK_SIZE * MI_SIZE
+                         : 0;
+  const int region_start = pbi->region_x_end > 0 ? pbi->region_x_start : 0;
+  const int region_end =
+      pbi->region_x_end > 0 ? VPXMIN(pbi->region_x_end, cm->width) : cm->width;
+
+  cur->valid_x_start = pbi->valid_x_start;
+  cur->valid_x_end = pbi->valid_x_end;
+  if (cur->valid_x_start > 0) cur->valid_x_start += margin;
+  if (cur->valid_x_end < cm->width) cur->valid_x_end -= margin;
+  if (cur->valid_x_start >= cur->valid_x_end) {
+    cur->valid_x_start = cur->valid_x_end = 0;
+  }
+  if (cur->valid_x_start > region_start || cur->valid_x_end < region_end)
+    cur->buf.corrupted = 1;
+}
+
 static void error_handler(void *data) {
   VP9_COMMON *const cm = (VP9_COMMON *)data;
   vpx_internal_error(&cm->error, VPX_CODEC_CORRUPT_FRAME, "Truncated packet");
@@ -2692,13 +3169,20 @@ static size_t read_uncompressed_header(VP9Decoder *pbi,
 
     read_bitdepth_colorspace_sampling(cm, rb);
     pbi->refresh_frame_flags = (1 << REF_FRAMES) - 1;
+    // Every reference is replaced, so the frames predicting from this one
+    // are reconstructed at the same scale.
+#if CONFIG_VP9_HIGHBITDEPTH
+    pbi->reduce_log2 = cm->use_highbitdepth ? 0 : pbi->next_reduce_log2;
+#else
+    pbi->reduce_log2 = pbi->next_reduce_log2;
+#endif
 
     for (i = 0; i < REFS_PER_FRAME; ++i) {
       cm->frame_refs[i].idx = INVALID_IDX;
       cm->frame_refs[i].buf = NULL;
     }
 
-    setup_frame_size(cm, rb);
+    setup_frame_size(pbi, rb);
     if (pbi->need_resync) {
       memset(&cm->ref_frame_map, -1, sizeof(cm->ref_frame_map));
       flush_all_fb_on_key(cm);
@@ -2731,7 +3215,7 @@ static size_t read_uncompressed_header(VP9Decoder *pbi,
       }
 
       pbi->refresh_frame_flags = vpx_rb_read_literal(rb, REF_FRAMES);
-      setup_frame_size(cm, rb);
+      setup_frame_size(pbi, rb);
       if (pbi->need_resync) {
         memset(&cm->ref_frame_map, -1, sizeof(cm->ref_frame_map));
         pbi->need_resync = 0;
@@ -2747,22 +3231,24 @@ static size_t read_uncompressed_header(VP9Decoder *pbi,
         cm->ref_frame_sign_bias[LAST_FRAME + i] = vpx_rb_read_bit(rb);
       }
 
-      setup_frame_size_with_refs(cm, rb);
+      setup_frame_size_with_refs(pbi, rb);
 
       cm->allow_high_precision_mv = vpx_rb_read_bit(rb);
       cm->interp_filter = read_interp_filter(rb);
 
       for (i = 0; i < REFS_PER_FRAME; ++i) {
         RefBuffer *const ref_buf = &cm->frame_refs[i];
+        const int width = reduced_size(cm->width, pbi->reduce_log2);
+        const int height = reduced_size(cm->height, pbi->reduce_log2);
 #if CONFIG_VP9_HIGHBITDEPTH
         vp9_setup_scale_factors_for_frame(
             &ref_buf->sf, ref_buf->buf->y_crop_width,
-            ref_buf->buf->y_crop_height, cm->width, cm->height,
-            cm->use_highbitdepth);
+            ref_buf->buf->y_crop_height, width, height, cm->use_highbitdepth);
 #else
-        vp9_setup_scale_factors_for_frame(
-            &ref_buf->sf, ref_buf->buf->y_crop_width,
-            ref_buf->buf->y_crop_height, cm->width, cm->height);
+        vp9_setup_scale_factors_for_frame(&ref_buf->sf,
+                                          ref_buf->buf->y_crop_width,
+                                          ref_buf->buf->y_crop_height, width,
+                                          height);
 #endif
       }
     }
@@ -2820,6 +3306,8 @@ static size_t read_uncompressed_header(VP9Decoder *pbi,
     vp9_setup_past_independence(cm);
 
   setup_loopfilter(&cm->lf, rb);
+  // Reduced resolution decoding does not filter block edges.
+  if (pbi->reduce_log2) cm->lf.filter_level = 0;
   setup_quantization(cm, &pbi->mb, rb);
   setup_segmentation(&cm->seg, rb);
   setup_segmentation_dequant(cm);
@@ -3001,6 +3489,21 @@ void vp9_decode_frame(VP9Decoder *pbi, const uint8_t *data,
     vpx_internal_error(&cm->error, VPX_CODEC_CORRUPT_FRAME,
                        "Decode failed. Frame data header is corrupted.");
 
+  if (pbi->skip_non_ref_frames && !pbi->refresh_frame_flags &&
+      (cm->error_resilient_mode || cm->frame_parallel_decoding_mode ||
+       !cm->refresh_frame_context)) {
+    // Nothing but the mode info of the previous frame is read from this
+    // frame; setup_decode_region() reports the frames that use it.
+    RefCntBuffer *const cur = pbi->cur_buf;
+    cur->decoded_mi_col_start = cur->decoded_mi_col_end = 0;
+    cur->valid_x_start = cur->valid_x_end = 0;
+    pbi->ready_for_new_data = 1;
+    *p_data_end = data_end;
+    if (cm->refresh_frame_context)
+      cm->frame_contexts[cm->frame_context_idx] = *cm->fc;
+    return;
+  }
+
   if (cm->lf.filter_level && !cm->skip_loop_filter) {
     vp9_loop_filter_frame_init(cm, cm->lf.filter_level);
   }
@@ -3019,9 +3522,15 @@ void vp9_decode_frame(VP9Decoder *pbi, const uint8_t *data,
     pbi->total_tiles = tile_rows * tile_cols;
   }
 
+  setup_decode_region(pbi);
+
+  pbi->sb_rows_done = 0;
+  // The row based decoder reconstructs blocks separately from parsing them,
+  // which reduced resolution decoding does not support.
   if (pbi->max_threads > 1 && tile_rows == 1 &&
-      (tile_cols > 1 || pbi->row_mt == 1)) {
-    if (pbi->row_mt == 1) {
+      (tile_cols > 1 || (pbi->row_mt == 1 && !pbi->reduce_log2)) &&
+      !pbi->check_region) {
+    if (pbi->row_mt == 1 && !pbi->reduce_log2) {
       *p_data_end =
           decode_tiles_row_wise_mt(pbi, data + first_partition_size, data_end);
     } else {
@@ -3047,6 +3556,8 @@ void vp9_decode_frame(VP9Decoder *pbi, const uint8_t *data,
   }
 
   if (!xd->corrupted) {
+    finish_decode_region(pbi);
+    rows_done(pbi, mi_cols_aligned_to_sb(cm->mi_rows) >> MI_BLOCK_SIZE_LOG2);
     if (!cm->error_resilient_mode && !cm->frame_parallel_decoding_mode) {
       vp9_adapt_coef_probs(cm);
 
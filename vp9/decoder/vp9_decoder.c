@@ -333,6 +333,37 @@ vpx_codec_err_t vp9_set_reference_dec(VP9_COMMON *cm,
   return cm->error.error_code;
 }
 
+vpx_codec_err_t vp9_get_mode_info_dec(VP9Decoder *pbi,
+                                      vpx_mode_info_map_t *map) {
+  const VP9_COMMON *const cm = &pbi->common;
+  int r, c, i;
+
+  if (!pbi->mode_info_valid) return VPX_CODEC_ERROR;
+  if (map->mode_info == NULL || (int)map->rows != cm->mi_rows ||
+      (int)map->cols != cm->mi_cols)
+    return VPX_CODEC_INVALID_PARAM;
+
+  for (r = 0; r < cm->mi_rows; ++r) {
+    for (c = 0; c < cm->mi_cols; ++c) {
+      const MODE_INFO *const mi = cm->mi_grid_visible[r * cm->mi_stride + c];
+      vpx_mode_info_t *const info = &map->mode_info[r * map->cols + c];
+      info->width = num_4x4_blocks_wide_lookup[mi->sb_type] * 4;
+      info->height = num_4x4_blocks_high_lookup[mi->sb_type] * 4;
+      for (i = 0; i < 2; ++i) {
+        const int is_inter = mi->ref_frame[i] > INTRA_FRAME;
+        info->ref_frame[i] = mi->ref_frame[i];
+        info->mv_row[i] = is_inter ? mi->mv[i].as_mv.row : 0;
+        info->mv_col[i] = is_inter ? mi->mv[i].as_mv.col : 0;
+      }
+      info->tx_size = mi->tx_size;
+      info->skip = mi->skip;
+    }
+  }
+  map->width = cm->width;
+  map->height = cm->height;
+  return VPX_CODEC_OK;
+}
+
 /* If any buffer updating is signaled it should be done here. */
 static void swap_frame_buffers(VP9Decoder *pbi) {
   int ref_index = 0, mask;
@@ -432,6 +463,7 @@ int vp9_receive_compressed_data(VP9Decoder *pbi, size_t size,
   }
 
   pbi->ready_for_new_data = 0;
+  pbi->mode_info_valid = 0;
 
   // Check if the previous frame was a frame without any references to it.
   if (cm->new_fb_idx >= 0 && frame_bufs[cm->new_fb_idx].ref_count == 0 &&
@@ -479,6 +511,8 @@ int vp9_receive_compressed_data(VP9Decoder *pbi, size_t size,
     cm->last_show_frame = cm->show_frame;
     cm->prev_frame = cm->cur_frame;
     if (cm->seg.enabled) vp9_swap_current_and_last_seg_map(cm);
+    pbi->mode_info_valid = pbi->cur_buf->decoded_mi_col_start == 0 &&
+                           pbi->cur_buf->decoded_mi_col_end == cm->mi_cols;
   }
 
   if (cm->show_frame) cm->cur_show_frame_fb_idx = cm->new_fb_idx;
@@ -512,7 +546,8 @@ int vp9_get_raw_frame(VP9Decoder *pbi, YV12_BUFFER_CONFIG *sd,
   pbi->ready_for_new_data = 1;
 
 #if CONFIG_VP9_POSTPROC
-  if (!cm->show_existing_frame) {
+  // Postprocessing works on full resolution frames.
+  if (!cm->show_existing_frame && !pbi->reduce_log2) {
     ret = vp9_post_proc_frame(cm, sd, flags, cm->width);
   } else {
     *sd = *cm->frame_to_show;
@@ -13,6 +13,7 @@
 
 #include "./vpx_config.h"
 
+#include "vpx/vp8.h"
 #include "vpx/vpx_codec.h"
 #include "vpx_dsp/bitreader.h"
 #include "vpx_scale/yv12config.h"
@@ -92,6 +93,11 @@ typedef struct Job {
   JobType job_type;
 } Job;
 
+// Notification that superblock rows [sb_row_start, sb_row_end) of the frame
+// being decoded are fully reconstructed and loop filtered.
+typedef void (*vp9_rows_done_cb_fn_t)(void *priv, int sb_row_start,
+                                      int sb_row_end);
+
 typedef struct VP9Decoder {
   DECLARE_ALIGNED(16, MACROBLOCKD, mb);
 
@@ -125,6 +131,40 @@ typedef struct VP9Decoder {
   int row_mt;
   int lpf_mt_opt;
   RowMTWorkerData *row_mt_worker_data;
+
+  // Optional, called on the thread running vp9_receive_compressed_data().
+  // Rows are reported as the loop filter passes them when tiles are decoded
+  // on that thread, and all at once after the frame otherwise.
+  vp9_rows_done_cb_fn_t rows_done_cb;
+  void *rows_done_priv;
+  int sb_rows_done;
+
+  // Horizontal extent, in pixels, of the region set by VP9D_SET_DECODE_REGION.
+  // region_x_end of 0 decodes the whole frame.
+  int region_x_start;
+  int region_x_end;
+  // Tile columns decoded in the current frame.
+  int tile_col_start;
+  int tile_col_end;
+  // Set when tiles of the current frame or of its references were skipped.
+  // The columns of the current frame reconstructed exactly so far are then
+  // tracked in [valid_x_start, valid_x_end).
+  int check_region;
+  int valid_x_start;
+  int valid_x_end;
+
+  // Set by VP9D_SET_SKIP_NON_REF_FRAMES.
+  int skip_non_ref_frames;
+
+  // Log2 of the factor by which frames are downscaled while they are
+  // reconstructed. It is set to next_reduce_log2, from
+  // VP9D_SET_REDUCED_RESOLUTION, at key frames, which refresh every reference.
+  int reduce_log2;
+  int next_reduce_log2;
+
+  // Set when the mode info of the last frame passed to
+  // vp9_receive_compressed_data() was decoded for the whole frame.
+  int mode_info_valid;
 } VP9Decoder;
 
 int vp9_receive_compressed_data(struct VP9Decoder *pbi, size_t size,
@@ -141,6 +181,10 @@ vpx_codec_err_t vp9_set_reference_dec(VP9_COMMON *cm,
                                       VP9_REFFRAME ref_frame_flag,
                                       YV12_BUFFER_CONFIG *sd);
 
+// Fills |map| with the mode info of the last decoded frame.
+vpx_codec_err_t vp9_get_mode_info_dec(struct VP9Decoder *pbi,
+                                      vpx_mode_info_map_t *map);
+
 static INLINE uint8_t read_marker(vpx_decrypt_cb decrypt_cb,
                                   void *decrypt_state, const uint8_t *data) {
   if (decrypt_cb) {
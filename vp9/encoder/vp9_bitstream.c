@@ -988,6 +988,17 @@ static void encode_tiles_buffer_alloc(VP9_COMP *const cpi,
   }
 }
 
+// Hands partition |id|, which starts at |buf|, to the application as soon as
+// it has been written when the final pack of the frame streams them.
+static void output_partition(VP9_COMP *cpi, uint8_t *buf, int id) {
+  if (cpi->stream_partitions) {
+    const int is_last = id == cpi->num_partitions - 1;
+    cpi->output_partition(cpi->output_partition_priv, buf,
+                          cpi->partition_sz[id], id, is_last);
+    if (is_last) cpi->partitions_streamed = 1;
+  }
+}
+
 static size_t encode_tiles_mt(VP9_COMP *cpi, uint8_t *data_ptr,
                               size_t data_size) {
   const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
@@ -1046,6 +1057,7 @@ static size_t encode_tiles_mt(VP9_COMP *cpi, uint8_t *data_ptr,
       VPxWorker *const worker = &cpi->workers[j];
       VP9BitstreamWorkerData *const data =
           (VP9BitstreamWorkerData *)worker->data2;
+      const size_t tile_start = total_size;
       uint32_t tile_size;
       int k;
 
@@ -1063,6 +1075,8 @@ static size_t encode_tiles_mt(VP9_COMP *cpi, uint8_t *data_ptr,
         cpi->interp_filter_selected[0][k] += data->interp_filter_selected[0][k];
       }
 
+      cpi->partition_sz[1 + data->tile_idx] = tile_size;
+
       // Prefix the size of the tile on all but the last.
       if (tile_col != tile_cols || j < i - 1) {
         if (data_size - total_size < 4) {
@@ -1071,6 +1085,7 @@ static size_t encode_tiles_mt(VP9_COMP *cpi, uint8_t *data_ptr,
         }
         mem_put_be32(data_ptr + total_size, tile_size);
         total_size += 4;
+        cpi->partition_sz[1 + data->tile_idx] += 4;
       }
       if (j > 0) {
         if (data_size - total_size < tile_size) {
@@ -1080,6 +1095,9 @@ static size_t encode_tiles_mt(VP9_COMP *cpi, uint8_t *data_ptr,
         memcpy(data_ptr + total_size, data->dest, tile_size);
       }
       total_size += tile_size;
+      if (!error) {
+        output_partition(cpi, data_ptr + tile_start, 1 + data->tile_idx);
+      }
     }
     if (error) {
       vpx_internal_error(&cm->error, VPX_CODEC_ERROR,
@@ -1112,7 +1130,7 @@ static size_t encode_tiles(VP9_COMP *cpi, uint8_t *data_ptr, size_t data_size) {
   for (tile_row = 0; tile_row < tile_rows; tile_row++) {
     for (tile_col = 0; tile_col < tile_cols; tile_col++) {
       int tile_idx = tile_row * tile_cols + tile_col;
-
+      const size_t tile_start = total_size;
       size_t offset;
       if (tile_col < tile_cols - 1 || tile_row < tile_rows - 1)
         offset = total_size + 4;
@@ -1132,13 +1150,16 @@ static size_t encode_tiles(VP9_COMP *cpi, uint8_t *data_ptr, size_t data_size) {
         vpx_internal_error(&cm->error, VPX_CODEC_ERROR,
                            "encode_tiles: output buffer full");
       }
+      cpi->partition_sz[1 + tile_idx] = residual_bc.pos;
       if (tile_col < tile_cols - 1 || tile_row < tile_rows - 1) {
         // size of this tile
         mem_put_be32(data_ptr + total_size, residual_bc.pos);
         total_size += 4;
+        cpi->partition_sz[1 + tile_idx] += 4;
       }
 
       total_size += residual_bc.pos;
+      output_partition(cpi, data_ptr + tile_start, 1 + tile_idx);
     }
   }
   return total_size;
@@ -1418,6 +1439,9 @@ void vp9_pack_bitstream(VP9_COMP *cpi, uint8_t *dest, size_t dest_size,
     uncompressed_hdr_size = vpx_wb_bytes_written(&wb);
     data += uncompressed_hdr_size;
     *size = data - dest;
+    cpi->num_partitions = 1;
+    cpi->partition_sz[0] = *size;
+    output_partition(cpi, dest, 0);
     return;
   }
 
@@ -1445,6 +1469,9 @@ void vp9_pack_bitstream(VP9_COMP *cpi, uint8_t *dest, size_t dest_size,
   vpx_wb_write_literal(&saved_wb, (int)compressed_hdr_size, 16);
   assert(!vpx_wb_has_error(&saved_wb));
 
+  cpi->num_partitions = 1 + (1 << (cm->log2_tile_cols + cm->log2_tile_rows));
+  cpi->partition_sz[0] = data - dest;
+  output_partition(cpi, dest, 0);
   data += encode_tiles(cpi, data, data_size);
 
   *size = data - dest;
@@ -192,6 +192,21 @@ struct macroblock {
 
   int zero_temp_sad_source;
 
+  // The superblock is unchanged since the frame coded into LAST_FRAME, and is
+  // coded as a skipped copy of it.
+  int static_sb;
+  // Number of superblocks coded as static in the frame.
+  unsigned int static_sb_count;
+
+  // Sad of each 16x16 block of the superblock, in raster order, against each
+  // reference in sb_ref_sad_refs (a mask of 1 << ref), see set_sb_ref_sad().
+  unsigned int sb_ref_sad[MAX_REF_FRAMES][16];
+  int sb_ref_sad_refs;
+  // Number of references pruned and interpolation filter searches skipped in
+  // the frame based on sb_ref_sad.
+  unsigned int sb_sad_ref_prunes;
+  unsigned int sb_sad_filter_skips;
+
   // For each superblock: saves the content value (e.g., low/high sad/sumdiff)
   // based on source sad, prior to encoding the frame.
   uint8_t content_state_sb;
@@ -297,6 +297,19 @@ static void set_offsets(VP9_COMP *cpi, const TileInfo *const tile,
   mv_limits->col_min = -(((mi_col + mi_width) * MI_SIZE) + VP9_INTERP_EXTEND);
   mv_limits->row_max = (cm->mi_rows - mi_row) * MI_SIZE + VP9_INTERP_EXTEND;
   mv_limits->col_max = (cm->mi_cols - mi_col) * MI_SIZE + VP9_INTERP_EXTEND;
+  if (cpi->border_in_pixels < VP9_ENC_BORDER_IN_PIXELS) {
+    // Motion search reads the reference directly, so keep the block and the
+    // filter taps of the sub-pixel search within the border.
+    const int border = cpi->border_in_pixels - 2 * VP9_INTERP_EXTEND;
+    const int rows_below = (cm->mi_rows - mi_row - mi_height) * MI_SIZE;
+    const int cols_right = (cm->mi_cols - mi_col - mi_width) * MI_SIZE;
+    mv_limits->row_min =
+        VPXMAX(mv_limits->row_min, -(mi_row * MI_SIZE + border));
+    mv_limits->col_min =
+        VPXMAX(mv_limits->col_min, -(mi_col * MI_SIZE + border));
+    mv_limits->row_max = VPXMIN(mv_limits->row_max, rows_below + border);
+    mv_limits->col_max = VPXMIN(mv_limits->col_max, cols_right + border);
+  }
 
   // Set up distance of MB to edge of frame in 1/8th pel units.
   assert(!(mi_col & (mi_width - 1)) && !(mi_row & (mi_height - 1)));
@@ -368,7 +381,7 @@ typedef struct {
   v4x4 split[4];
 } v8x8;
 
-typedef struct {
+typedef struct v16x16 {
   partition_variance part_variances;
   v8x8 split[4];
 } v16x16;
@@ -893,10 +906,11 @@ static void set_low_temp_var_flag(VP9_COMP *cpi, MACROBLOCK *x, MACROBLOCKD *xd,
 }
 
 static void copy_partitioning_helper(VP9_COMP *cpi, MACROBLOCK *x,
-                                     MACROBLOCKD *xd, BLOCK_SIZE bsize,
-                                     int mi_row, int mi_col) {
+                                     MACROBLOCKD *xd,
+                                     const BLOCK_SIZE *prev_part,
+                                     BLOCK_SIZE bsize, int mi_row,
+                                     int mi_col) {
   VP9_COMMON *const cm = &cpi->common;
-  BLOCK_SIZE *prev_part = cpi->prev_partition;
   int start_pos = mi_row * cm->mi_stride + mi_col;
 
   const int bsl = b_width_log2_lookup[bsize];
@@ -907,6 +921,17 @@ static void copy_partitioning_helper(VP9_COMP *cpi, MACROBLOCK *x,
   if (mi_row >= cm->mi_rows || mi_col >= cm->mi_cols) return;
 
   partition = partition_lookup[bsl][prev_part[start_pos]];
+  // An imported partitioning can hold a block larger than bsize, which is not
+  // split further, and blocks crossing the edge of the frame, which have to
+  // be split across it.
+  if (partition == PARTITION_INVALID) partition = PARTITION_NONE;
+  if (mi_row + bs >= cm->mi_rows && mi_col + bs >= cm->mi_cols) {
+    partition = PARTITION_SPLIT;
+  } else if (mi_row + bs >= cm->mi_rows && partition != PARTITION_HORZ) {
+    partition = partition == PARTITION_NONE ? PARTITION_HORZ : PARTITION_SPLIT;
+  } else if (mi_col + bs >= cm->mi_cols && partition != PARTITION_VERT) {
+    partition = partition == PARTITION_NONE ? PARTITION_VERT : PARTITION_SPLIT;
+  }
   subsize = get_subsize(bsize, partition);
 
   if (subsize < BLOCK_8X8) {
@@ -926,10 +951,14 @@ static void copy_partitioning_helper(VP9_COMP *cpi, MACROBLOCK *x,
         break;
       default:
         assert(partition == PARTITION_SPLIT);
-        copy_partitioning_helper(cpi, x, xd, subsize, mi_row, mi_col);
-        copy_partitioning_helper(cpi, x, xd, subsize, mi_row + bs, mi_col);
-        copy_partitioning_helper(cpi, x, xd, subsize, mi_row, mi_col + bs);
-        copy_partitioning_helper(cpi, x, xd, subsize, mi_row + bs, mi_col + bs);
+        copy_partitioning_helper(cpi, x, xd, prev_part, subsize, mi_row,
+                                 mi_col);
+        copy_partitioning_helper(cpi, x, xd, prev_part, subsize, mi_row + bs,
+                                 mi_col);
+        copy_partitioning_helper(cpi, x, xd, prev_part, subsize, mi_row,
+                                 mi_col + bs);
+        copy_partitioning_helper(cpi, x, xd, prev_part, subsize, mi_row + bs,
+                                 mi_col + bs);
         break;
     }
   }
@@ -954,7 +983,8 @@ static int copy_partitioning(VP9_COMP *cpi, MACROBLOCK *x, MACROBLOCKD *xd,
       cpi->prev_segment_id[sb_offset] == CR_SEGMENT_ID_BASE &&
       cpi->copied_frame_cnt[sb_offset] < cpi->max_copied_frame) {
     if (cpi->prev_partition != NULL) {
-      copy_partitioning_helper(cpi, x, xd, BLOCK_64X64, mi_row, mi_col);
+      copy_partitioning_helper(cpi, x, xd, cpi->prev_partition, BLOCK_64X64,
+                               mi_row, mi_col);
       cpi->copied_frame_cnt[sb_offset] += 1;
       memcpy(x->variance_low, &(cpi->prev_variance_low[sb_offset * 25]),
              sizeof(x->variance_low));
@@ -1256,11 +1286,22 @@ static uint64_t avg_source_sad(VP9_COMP *cpi, MACROBLOCK *x, int shift,
   return tmp_sad;
 }
 
+// Sets the content state of a superblock whose source did not change, as
+// avg_source_sad() would find it.
+static void static_sb_source_sad(VP9_COMP *cpi, MACROBLOCK *x, int sb_offset) {
+  x->content_state_sb = kLowSadLowSumdiff;
+  if (cpi->content_state_sb_fd != NULL &&
+      cpi->content_state_sb_fd[sb_offset] < 255)
+    cpi->content_state_sb_fd[sb_offset]++;
+  x->zero_temp_sad_source = 1;
+}
+
 // This function chooses partitioning based on the variance between source and
 // reconstructed last, where variance is computed for down-sampled inputs.
 static int choose_partitioning(VP9_COMP *cpi, const TileInfo *const tile,
-                               MACROBLOCK *x, int mi_row, int mi_col) {
+                               ThreadData *td, int mi_row, int mi_col) {
   VP9_COMMON *const cm = &cpi->common;
+  MACROBLOCK *const x = &td->mb;
   MACROBLOCKD *xd = &x->e_mbd;
   int i, j, k, m;
   v64x64 vt;
@@ -1338,6 +1379,18 @@ static int choose_partitioning(VP9_COMP *cpi, const TileInfo *const tile,
 
   memset(x->variance_low, 0, sizeof(x->variance_low));
 
+  // Use the partitioning of the stream being transcoded when there is one.
+  if (!frame_is_intra_only(cm) && cpi->mode_info_import.enabled &&
+      cpi->mode_info_import.mi_rows == cm->mi_rows &&
+      cpi->mode_info_import.mi_cols == cm->mi_cols) {
+    copy_partitioning_helper(cpi, x, xd, cpi->mode_info_import.partition,
+                             BLOCK_64X64, mi_row, mi_col);
+    if (cpi->sf.copy_partition_flag) {
+      update_prev_partition(cpi, x, segment_id, mi_row, mi_col, sb_offset);
+    }
+    return 0;
+  }
+
   if (cpi->sf.use_source_sad && !is_key_frame) {
     int sb_offset2 = ((cm->mi_cols + 7) >> 3) * (mi_row >> 3) + (mi_col >> 3);
     content_state = x->content_state_sb;
@@ -1552,8 +1605,13 @@ static int choose_partitioning(VP9_COMP *cpi, const TileInfo *const tile,
 #endif  // CONFIG_VP9_HIGHBITDEPTH
   }
 
-  if (low_res && threshold_4x4avg < INT64_MAX)
-    CHECK_MEM_ERROR(&cm->error, vt2, vpx_calloc(16, sizeof(*vt2)));
+  if (low_res && threshold_4x4avg < INT64_MAX) {
+    if (td->vt2 == NULL) {
+      CHECK_MEM_ERROR(&cm->error, td->vt2, vpx_malloc(16 * sizeof(*td->vt2)));
+    }
+    vt2 = td->vt2;
+    memset(vt2, 0, 16 * sizeof(*vt2));
+  }
   // Fill in the entire tree of 8x8 (or 4x4 under some conditions) variances
   // for splits.
   for (i = 0; i < 4; i++) {
@@ -1761,7 +1819,6 @@ static int choose_partitioning(VP9_COMP *cpi, const TileInfo *const tile,
   }
 
   chroma_check(cpi, x, bsize, y_sad, is_key_frame, scene_change_detected);
-  if (vt2) vpx_free(vt2);
   return 0;
 }
 
@@ -1942,6 +1999,20 @@ static void set_mode_info_seg_skip(MACROBLOCK *x, TX_MODE tx_mode,
   vp9_rd_cost_init(rd_cost);
 }
 
+// Codes a block of a static superblock as a skipped copy of LAST_FRAME. Unlike
+// with the segment skip feature the inter mode is coded, which needs its
+// context.
+static void set_mode_info_static_sb(const VP9_COMMON *cm, MACROBLOCK *x,
+                                    int mi_row, int mi_col, RD_COST *rd_cost,
+                                    BLOCK_SIZE bsize, PICK_MODE_CONTEXT *ctx) {
+  MACROBLOCKD *const xd = &x->e_mbd;
+  set_mode_info_seg_skip(x, cm->tx_mode, cm->interp_filter, rd_cost, bsize);
+  vp9_find_mv_refs(cm, xd, xd->mi[0], LAST_FRAME,
+                   x->mbmi_ext->ref_mvs[LAST_FRAME], mi_row, mi_col,
+                   x->mbmi_ext->mode_context);
+  ctx->pred_pixel_ready = 0;
+}
+
 #if !CONFIG_REALTIME_ONLY
 static void set_segment_rdmult(VP9_COMP *const cpi, MACROBLOCK *const x,
                                int mi_row, int mi_col, BLOCK_SIZE bsize,
@@ -3105,53 +3176,6 @@ static INLINE void load_pred_mv(MACROBLOCK *x, PICK_MODE_CONTEXT *ctx) {
   memcpy(x->pred_mv, ctx->pred_mv, sizeof(x->pred_mv));
 }
 
-// Calculate prediction based on the given input features and neural net config.
-// Assume there are no more than NN_MAX_NODES_PER_LAYER nodes in each hidden
-// layer.
-static void nn_predict(const float *features, const NN_CONFIG *nn_config,
-                       float *output) {
-  int num_input_nodes = nn_config->num_inputs;
-  int buf_index = 0;
-  float buf[2][NN_MAX_NODES_PER_LAYER];
-  const float *input_nodes = features;
-
-  // Propagate hidden layers.
-  const int num_layers = nn_config->num_hidden_layers;
-  int layer, node, i;
-  assert(num_layers <= NN_MAX_HIDDEN_LAYERS);
-  for (layer = 0; layer < num_layers; ++layer) {
-    const float *weights = nn_config->weights[layer];
-    const float *bias = nn_config->bias[layer];
-    float *output_nodes = buf[buf_index];
-    const int num_output_nodes = nn_config->num_hidden_nodes[layer];
-    assert(num_output_nodes < NN_MAX_NODES_PER_LAYER);
-    for (node = 0; node < num_output_nodes; ++node) {
-      float val = 0.0f;
-      for (i = 0; i < num_input_nodes; ++i) val += weights[i] * input_nodes[i];
-      val += bias[node];
-      // ReLU as activation function.
-      val = VPXMAX(val, 0.0f);
-      output_nodes[node] = val;
-      weights += num_input_nodes;
-    }
-    num_input_nodes = num_output_nodes;
-    input_nodes = output_nodes;
-    buf_index = 1 - buf_index;
-  }
-
-  // Final output layer.
-  {
-    const float *weights = nn_config->weights[num_layers];
-    for (node = 0; node < nn_config->num_outputs; ++node) {
-      const float *bias = nn_config->bias[num_layers];
-      float val = 0.0f;
-      for (i = 0; i < num_input_nodes; ++i) val += weights[i] * input_nodes[i];
-      output[node] = val + bias[node];
-      weights += num_input_nodes;
-    }
-  }
-}
-
 #if !CONFIG_REALTIME_ONLY
 #define FEATURES 7
 // Machine-learning based partition search early termination.
@@ -3237,7 +3261,7 @@ static int ml_pruning_partition(VP9_COMMON *const cm, MACROBLOCKD *const xd,
   if (linear_score > 0.1f) return 0;
 
   // Predict using neural net model.
-  nn_predict(features, nn_config, &nn_score);
+  vp9_nn_predict(features, nn_config, &nn_score);
 
   if (linear_score < -0.0f && nn_score < 0.1f) return 1;
   if (nn_score < -0.0f && linear_score < 0.1f) return 1;
@@ -3400,7 +3424,7 @@ static void ml_prune_rect_partition(VP9_COMP *const cpi, MACROBLOCK *const x,
     }
 
     assert(feature_index == FEATURES);
-    nn_predict(features, nn_config, score);
+    vp9_nn_predict(features, nn_config, score);
   }
 
   // Make decisions based on the model score.
@@ -3606,7 +3630,7 @@ static void ml_predict_var_rd_partitioning(const VP9_COMP *const cpi,
     assert(feature_idx == FEATURES);
 
     // Feed the features into the model to get the confidence score.
-    nn_predict(features, nn_config, &score);
+    vp9_nn_predict(features, nn_config, &score);
 
     // Higher score means that the model has higher confidence that the split
     // partition is better than the non-split partition. So if the score is
@@ -4563,7 +4587,7 @@ static void encode_rd_sb_row(VP9_COMP *cpi, ThreadData *td,
                        &dummy_rate, &dummy_dist, 1, td->pc_root);
     } else if (sf->partition_search_type == VAR_BASED_PARTITION &&
                cm->frame_type != KEY_FRAME) {
-      choose_partitioning(cpi, tile_info, x, mi_row, mi_col);
+      choose_partitioning(cpi, tile_info, td, mi_row, mi_col);
       rd_use_partition(cpi, td, tile_data, mi, tp, mi_row, mi_col, BLOCK_64X64,
                        &dummy_rate, &dummy_dist, 1, td->pc_root);
     } else {
@@ -4579,22 +4603,31 @@ static void encode_rd_sb_row(VP9_COMP *cpi, ThreadData *td,
             cpi, vp9_get_qindex(&cm->seg, x->segment_id, cm->base_qindex));
       }
 
-      // If required set upper and lower partition size limits
-      if (sf->auto_min_max_partition_size) {
+      if (cpi->recode_reuse_partition) {
+        // Recode at a new q: keep the partitioning found by the previous
+        // iteration and only search the modes of its blocks again.
         set_offsets(cpi, tile_info, x, mi_row, mi_col, BLOCK_64X64);
-        rd_auto_partition_range(cpi, tile_info, xd, mi_row, mi_col,
-                                &x->min_partition_size, &x->max_partition_size);
-      }
-      td->pc_root->none.rdcost = 0;
+        rd_use_partition(cpi, td, tile_data, mi, tp, mi_row, mi_col,
+                         BLOCK_64X64, &dummy_rate, &dummy_dist, 1, td->pc_root);
+      } else {
+        // If required set upper and lower partition size limits
+        if (sf->auto_min_max_partition_size) {
+          set_offsets(cpi, tile_info, x, mi_row, mi_col, BLOCK_64X64);
+          rd_auto_partition_range(cpi, tile_info, xd, mi_row, mi_col,
+                                  &x->min_partition_size,
+                                  &x->max_partition_size);
+        }
+        td->pc_root->none.rdcost = 0;
 
 #if CONFIG_COLLECT_COMPONENT_TIMING
-      start_timing(cpi, rd_pick_partition_time);
+        start_timing(cpi, rd_pick_partition_time);
 #endif
-      rd_pick_partition(cpi, td, tile_data, tp, mi_row, mi_col, BLOCK_64X64,
-                        &dummy_rdc, dummy_rdc, td->pc_root);
+        rd_pick_partition(cpi, td, tile_data, tp, mi_row, mi_col, BLOCK_64X64,
+                          &dummy_rdc, dummy_rdc, td->pc_root);
 #if CONFIG_COLLECT_COMPONENT_TIMING
-      end_timing(cpi, rd_pick_partition_time);
+        end_timing(cpi, rd_pick_partition_time);
 #endif
+      }
     }
     (*(cpi->row_mt_sync_write_ptr))(&tile_data->row_mt_sync, sb_row,
                                     sb_col_in_tile, num_sb_cols);
@@ -4750,6 +4783,8 @@ static void nonrd_pick_sb_modes(VP9_COMP *cpi, TileDataEnc *tile_data,
                                 mi_col);
   else if (segfeature_active(&cm->seg, mi->segment_id, SEG_LVL_SKIP))
     set_mode_info_seg_skip(x, cm->tx_mode, cm->interp_filter, rd_cost, bsize);
+  else if (x->static_sb && !cyclic_refresh_segment_id_boosted(mi->segment_id))
+    set_mode_info_static_sb(cm, x, mi_row, mi_col, rd_cost, bsize, ctx);
   else if (bsize >= BLOCK_8X8) {
     if (cpi->rc.hybrid_intra_scene_change)
       hybrid_search_scene_change(cpi, x, rd_cost, bsize, ctx, tile_data, mi_row,
@@ -4911,7 +4946,7 @@ static int ml_predict_var_partitioning(VP9_COMP *cpi, MACROBLOCK *x,
     }
 
     assert(feature_idx == FEATURES);
-    nn_predict(features, nn_config, score);
+    vp9_nn_predict(features, nn_config, score);
     if (score[0] > thresh) return PARTITION_SPLIT;
     if (score[0] < -thresh) return PARTITION_NONE;
     return -1;
@@ -5522,6 +5557,74 @@ static void get_estimated_pred(VP9_COMP *cpi, const TileInfo *const tile,
   }
 }
 
+// Computes the sad of each 16x16 block of the superblock against LAST_FRAME at
+// the motion vector found for the superblock by the partitioning, and against
+// GOLDEN_FRAME and ALTREF_FRAME at zero motion. All references are checked in
+// one call to the x4d kernel per block. vp9_pick_inter_mode() uses the sads to
+// prune references and the interpolation filter search.
+static void set_sb_ref_sad(VP9_COMP *cpi, MACROBLOCK *x, int mi_row,
+                           int mi_col) {
+  VP9_COMMON *const cm = &cpi->common;
+  const int src_stride = x->plane[0].src.stride;
+  const uint8_t *ref_buf[4];
+  int ref_stride = 0;
+  const MV zero_mv = { 0, 0 };
+  MV mv = { 0, 0 };
+  MV_REFERENCE_FRAME ref_frame;
+  int r, c;
+
+  x->sb_ref_sad_refs = 0;
+  if (!cpi->sf.rt_sb_ref_sad || frame_is_intra_only(cm)) return;
+
+  if (x->sb_use_mv_part) {
+    mv.row = x->sb_mvrow_part >> 3;
+    mv.col = x->sb_mvcol_part >> 3;
+    clamp_mv(&mv, x->mv_limits.col_min, x->mv_limits.col_max,
+             x->mv_limits.row_min, x->mv_limits.row_max);
+  }
+
+  for (ref_frame = LAST_FRAME; ref_frame <= ALTREF_FRAME; ++ref_frame) {
+    const YV12_BUFFER_CONFIG *const yv12 = get_ref_frame_buffer(cpi, ref_frame);
+    const MV *const ref_mv = ref_frame == LAST_FRAME ? &mv : &zero_mv;
+    if (!(cpi->ref_frame_flags & ref_frame_to_flag(ref_frame)) ||
+        yv12 == NULL || vp9_is_scaled(&cm->frame_refs[ref_frame - 1].sf) ||
+        (ref_stride && yv12->y_stride != ref_stride))
+      continue;
+    ref_stride = yv12->y_stride;
+    ref_buf[ref_frame - LAST_FRAME] =
+        yv12->y_buffer + (mi_row * MI_SIZE + ref_mv->row) * ref_stride +
+        mi_col * MI_SIZE + ref_mv->col;
+    x->sb_ref_sad_refs |= 1 << ref_frame;
+  }
+  // The pruning is relative to LAST_FRAME.
+  if (!(x->sb_ref_sad_refs & (1 << LAST_FRAME))) {
+    x->sb_ref_sad_refs = 0;
+    return;
+  }
+  for (ref_frame = GOLDEN_FRAME; ref_frame <= ALTREF_FRAME; ++ref_frame) {
+    if (!(x->sb_ref_sad_refs & (1 << ref_frame)))
+      ref_buf[ref_frame - LAST_FRAME] = ref_buf[0];
+  }
+  ref_buf[3] = ref_buf[0];
+
+  for (r = 0; r < 4 && mi_row + 2 * r < cm->mi_rows; ++r) {
+    for (c = 0; c < 4 && mi_col + 2 * c < cm->mi_cols; ++c) {
+      const int src_offset = (r * src_stride + c) * 16;
+      const int ref_offset = (r * ref_stride + c) * 16;
+      const uint8_t *const block_ref_buf[4] = { ref_buf[0] + ref_offset,
+                                                ref_buf[1] + ref_offset,
+                                                ref_buf[2] + ref_offset,
+                                                ref_buf[3] + ref_offset };
+      uint32_t sads[4];
+      cpi->fn_ptr[BLOCK_16X16].sdx4df(x->plane[0].src.buf + src_offset,
+                                      src_stride, block_ref_buf, ref_stride,
+                                      sads);
+      for (ref_frame = LAST_FRAME; ref_frame <= ALTREF_FRAME; ++ref_frame)
+        x->sb_ref_sad[ref_frame][r * 4 + c] = sads[ref_frame - LAST_FRAME];
+    }
+  }
+}
+
 static void encode_nonrd_sb_row(VP9_COMP *cpi, ThreadData *td,
                                 TileDataEnc *tile_data, int mi_row,
                                 TOKENEXTRA **tp) {
@@ -5551,6 +5654,8 @@ static void encode_nonrd_sb_row(VP9_COMP *cpi, ThreadData *td,
     MODE_INFO **mi = cm->mi_grid_visible + idx_str;
     PARTITION_SEARCH_TYPE partition_search_type = sf->partition_search_type;
     BLOCK_SIZE bsize = BLOCK_64X64;
+    const int sb_offset2 =
+        ((cm->mi_cols + 7) >> 3) * (mi_row >> 3) + (mi_col >> 3);
     int seg_skip = 0;
     int i;
 
@@ -5580,18 +5685,27 @@ static void encode_nonrd_sb_row(VP9_COMP *cpi, ThreadData *td,
     x->sb_pickmode_part = 0;
     x->arf_frame_usage = 0;
     x->lastgolden_frame_usage = 0;
+    x->static_sb = cpi->static_sb_frame && cpi->static_sb_map[sb_offset2];
+    x->static_sb_count += x->static_sb;
+    x->sb_ref_sad_refs = 0;
 
     if (cpi->compute_source_sad_onepass && cpi->sf.use_source_sad) {
-      int shift = cpi->Source->y_stride * (mi_row << 3) + (mi_col << 3);
-      int sb_offset2 = ((cm->mi_cols + 7) >> 3) * (mi_row >> 3) + (mi_col >> 3);
-      int64_t source_sad = avg_source_sad(cpi, x, shift, sb_offset2);
-      if (sf->adapt_partition_source_sad &&
-          (cpi->oxcf.rc_mode == VPX_VBR && !cpi->rc.is_src_frame_alt_ref &&
-           source_sad > sf->adapt_partition_thresh &&
-           (cpi->refresh_golden_frame || cpi->refresh_alt_ref_frame)))
-        partition_search_type = REFERENCE_PARTITION;
+      if (x->static_sb) {
+        static_sb_source_sad(cpi, x, sb_offset2);
+      } else {
+        int shift = cpi->Source->y_stride * (mi_row << 3) + (mi_col << 3);
+        int64_t source_sad = avg_source_sad(cpi, x, shift, sb_offset2);
+        if (sf->adapt_partition_source_sad &&
+            (cpi->oxcf.rc_mode == VPX_VBR && !cpi->rc.is_src_frame_alt_ref &&
+             source_sad > sf->adapt_partition_thresh &&
+             (cpi->refresh_golden_frame || cpi->refresh_alt_ref_frame)))
+          partition_search_type = REFERENCE_PARTITION;
+      }
     }
 
+    // Static superblocks need no partitioning, see set_mode_info_static_sb().
+    if (x->static_sb) partition_search_type = FIXED_PARTITION;
+
     if (seg->enabled) {
       const uint8_t *const map =
           seg->update_map ? cpi->segmentation_map : cm->last_frame_seg_map;
@@ -5631,12 +5745,14 @@ static void encode_nonrd_sb_row(VP9_COMP *cpi, ThreadData *td,
         // support both intra and inter sub8x8 block coding for RTC mode.
         // Tune the thresholds accordingly to use sub8x8 block coding for
         // coding performance improvement.
-        choose_partitioning(cpi, tile_info, x, mi_row, mi_col);
+        choose_partitioning(cpi, tile_info, td, mi_row, mi_col);
+        set_sb_ref_sad(cpi, x, mi_row, mi_col);
         nonrd_use_partition(cpi, td, tile_data, mi, tp, mi_row, mi_col,
                             BLOCK_64X64, 1, &dummy_rdc, td->pc_root);
         break;
       case ML_BASED_PARTITION:
         get_estimated_pred(cpi, tile_info, x, mi_row, mi_col);
+        set_sb_ref_sad(cpi, x, mi_row, mi_col);
         x->max_partition_size = BLOCK_64X64;
         x->min_partition_size = BLOCK_8X8;
         x->sb_pickmode_part = 1;
@@ -5650,7 +5766,7 @@ static void encode_nonrd_sb_row(VP9_COMP *cpi, ThreadData *td,
                             BLOCK_64X64, 1, &dummy_rdc, td->pc_root);
         break;
       case FIXED_PARTITION:
-        if (!seg_skip) bsize = sf->always_this_block_size;
+        if (!seg_skip && !x->static_sb) bsize = sf->always_this_block_size;
         set_fixed_partitioning(cpi, tile_info, mi, mi_row, mi_col, bsize);
         nonrd_use_partition(cpi, td, tile_data, mi, tp, mi_row, mi_col,
                             BLOCK_64X64, 1, &dummy_rdc, td->pc_root);
@@ -5675,7 +5791,7 @@ static void encode_nonrd_sb_row(VP9_COMP *cpi, ThreadData *td,
                                BLOCK_64X64, &dummy_rdc, 1, INT64_MAX,
                                td->pc_root);
         } else {
-          choose_partitioning(cpi, tile_info, x, mi_row, mi_col);
+          choose_partitioning(cpi, tile_info, td, mi_row, mi_col);
           // TODO(marpan): Seems like nonrd_select_partition does not support
           // 4x4 partition. Since 4x4 is used on key frame, use this switch
           // for now.
@@ -6079,6 +6195,9 @@ static void encode_frame_internal(VP9_COMP *cpi) {
   xd->mi[0] = cm->mi;
   vp9_zero(*td->counts);
   vp9_zero(cpi->td.rd_counts);
+  x->sb_sad_ref_prunes = 0;
+  x->sb_sad_filter_skips = 0;
+  x->static_sb_count = 0;
 
   xd->lossless = cm->base_qindex == 0 && cm->y_dc_delta_q == 0 &&
                  cm->uv_dc_delta_q == 0 && cm->uv_ac_delta_q == 0;
@@ -6198,6 +6317,10 @@ static void encode_frame_internal(VP9_COMP *cpi) {
     cpi->time_encode_sb_row += vpx_usec_timer_elapsed(&emr_timer);
   }
 
+  cpi->sb_sad_ref_prunes += x->sb_sad_ref_prunes;
+  cpi->sb_sad_filter_skips += x->sb_sad_filter_skips;
+  cpi->static_sb_count = (int)x->static_sb_count;
+
   sf->skip_encode_frame =
       sf->skip_encode_sb ? get_skip_encode_frame(cm, td) : 0;
 
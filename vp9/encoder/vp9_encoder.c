@@ -102,6 +102,16 @@
 #define FRAME_SIZE_FACTOR 128  // empirical params for context model threshold
 #define FRAME_RATE_FACTOR 8
 
+// Fastest realtime speed the speed control can use.
+#define SPEED_CTRL_MAX_SPEED 9
+// First realtime speed of the non-rd mode search, which also turns on row
+// based multi-threading. The speed control stays on the side of it the
+// application chose.
+#define SPEED_CTRL_NONRD_SPEED 5
+// Frames encoded at a speed before the speed control raises or lowers it.
+#define SPEED_CTRL_UP_FRAMES 4
+#define SPEED_CTRL_DOWN_FRAMES 30
+
 #ifdef OUTPUT_YUV_DENOISED
 FILE *yuv_denoised_file = NULL;
 #endif
@@ -575,6 +585,79 @@ static void apply_active_map(VP9_COMP *cpi) {
   }
 }
 
+static int sb_plane_is_static(const uint8_t *src, int src_stride,
+                              const uint8_t *last_src, int last_src_stride,
+                              int width, int height) {
+  int r;
+  for (r = 0; r < height; ++r) {
+    if (memcmp(src, last_src, width)) return 0;
+    src += src_stride;
+    last_src += last_src_stride;
+  }
+  return 1;
+}
+
+// Marks the superblocks whose source did not change since the frame coded
+// into LAST_FRAME, from the map passed by the application if there is one or
+// else by comparing the source with the previous one.
+static void set_static_sb_map(VP9_COMP *cpi) {
+  VP9_COMMON *const cm = &cpi->common;
+  const YV12_BUFFER_CONFIG *const src = cpi->Source;
+  const YV12_BUFFER_CONFIG *const last_src = cpi->Last_Source;
+  const int sb_rows = (cm->mi_rows + MI_MASK) >> MI_BLOCK_SIZE_LOG2;
+  const int sb_cols = (cm->mi_cols + MI_MASK) >> MI_BLOCK_SIZE_LOG2;
+  const int use_dirty_map = cpi->sb_dirty_map_pending;
+  int sb_row, sb_col;
+
+  cpi->sb_dirty_map_pending = 0;
+  cpi->static_sb_frame =
+      cpi->oxcf.skip_static_sb && cpi->oxcf.mode == REALTIME &&
+      cpi->oxcf.pass == 0 && cpi->oxcf.lag_in_frames == 0 && !cpi->use_svc &&
+      cpi->oxcf.noise_sensitivity == 0 && cpi->sf.use_nonrd_pick_mode &&
+      !cpi->roi.enabled && !frame_is_intra_only(cm) &&
+      (cpi->ref_frame_flags & VP9_LAST_FLAG) &&
+      cpi->last_frame_refresh_frame + 1 == cm->current_video_frame &&
+      !vp9_is_scaled(&cm->frame_refs[LAST_FRAME - 1].sf) && last_src != NULL &&
+      last_src->y_width == src->y_width && last_src->y_height == src->y_height;
+#if CONFIG_VP9_HIGHBITDEPTH
+  if (cm->use_highbitdepth) cpi->static_sb_frame = 0;
+#endif
+  if (!cpi->static_sb_frame) return;
+
+  if (use_dirty_map) {
+    int i;
+    for (i = 0; i < sb_rows * sb_cols; ++i)
+      cpi->static_sb_map[i] = !cpi->sb_dirty_map[i];
+    return;
+  }
+
+  for (sb_row = 0; sb_row < sb_rows; ++sb_row) {
+    for (sb_col = 0; sb_col < sb_cols; ++sb_col) {
+      const int x = sb_col << 6;
+      const int y = sb_row << 6;
+      const int w = VPXMIN(64, src->y_crop_width - x);
+      const int h = VPXMIN(64, src->y_crop_height - y);
+      const int uv_x = x >> src->subsampling_x;
+      const int uv_y = y >> src->subsampling_y;
+      const int uv_w = (w + src->subsampling_x) >> src->subsampling_x;
+      const int uv_h = (h + src->subsampling_y) >> src->subsampling_y;
+      const int uv_offset = uv_y * src->uv_stride + uv_x;
+      const int last_uv_offset = uv_y * last_src->uv_stride + uv_x;
+      cpi->static_sb_map[sb_row * sb_cols + sb_col] =
+          sb_plane_is_static(src->y_buffer + y * src->y_stride + x,
+                             src->y_stride,
+                             last_src->y_buffer + y * last_src->y_stride + x,
+                             last_src->y_stride, w, h) &&
+          sb_plane_is_static(src->u_buffer + uv_offset, src->uv_stride,
+                             last_src->u_buffer + last_uv_offset,
+                             last_src->uv_stride, uv_w, uv_h) &&
+          sb_plane_is_static(src->v_buffer + uv_offset, src->uv_stride,
+                             last_src->v_buffer + last_uv_offset,
+                             last_src->uv_stride, uv_w, uv_h);
+    }
+  }
+}
+
 static void apply_roi_map(VP9_COMP *cpi) {
   VP9_COMMON *cm = &cpi->common;
   struct segmentation *const seg = &cm->seg;
@@ -998,6 +1081,9 @@ static void dealloc_compressor_data(VP9_COMP *cpi) {
   vpx_free(cpi->copied_frame_cnt);
   cpi->copied_frame_cnt = NULL;
 
+  for (i = 0; i < HASH_MAX_INDEXES; ++i)
+    vp9_block_hash_index_free(&cpi->hash_index[i]);
+
   vpx_free(cpi->content_state_sb_fd);
   cpi->content_state_sb_fd = NULL;
 
@@ -1012,6 +1098,17 @@ static void dealloc_compressor_data(VP9_COMP *cpi) {
   vpx_free(cpi->active_map.map);
   cpi->active_map.map = NULL;
 
+  vpx_free(cpi->static_sb_map);
+  cpi->static_sb_map = NULL;
+  vpx_free(cpi->motion_hints.mvs);
+  cpi->motion_hints.mvs = NULL;
+  cpi->motion_hints.alloc_size = 0;
+  vpx_free(cpi->mode_info_import.partition);
+  cpi->mode_info_import.partition = NULL;
+  cpi->mode_info_import.alloc_size = 0;
+  vpx_free(cpi->sb_dirty_map);
+  cpi->sb_dirty_map = NULL;
+
   vpx_free(cpi->roi.roi_map);
   cpi->roi.roi_map = NULL;
 
@@ -1057,6 +1154,8 @@ static void dealloc_compressor_data(VP9_COMP *cpi) {
   cpi->tplist[0][0] = NULL;
 
   vp9_free_pc_tree(&cpi->td);
+  vpx_free(cpi->td.vt2);
+  cpi->td.vt2 = NULL;
 
   for (i = 0; i < cpi->svc.number_spatial_layers; ++i) {
     LAYER_CONTEXT *const lc = &cpi->svc.layer_context[i];
@@ -1129,6 +1228,8 @@ static void restore_coding_context(VP9_COMP *cpi) {
          MV_VALS * sizeof(*cc->nmvcosts_hp[0]));
   memcpy(cpi->nmvcosts_hp[1], cc->nmvcosts_hp[1],
          MV_VALS * sizeof(*cc->nmvcosts_hp[1]));
+  // The mv costs no longer match the probabilities they were built from.
+  cpi->rd.cost_cache.nmv_costs_valid = 0;
 
   vp9_copy(cm->seg.pred_probs, cc->segment_pred_probs);
 
@@ -1293,6 +1394,7 @@ static void alloc_raw_frame_buffers(VP9_COMP *cpi) {
 #if CONFIG_VP9_HIGHBITDEPTH
                                         cm->use_highbitdepth,
 #endif
+                                        cpi->border_in_pixels,
                                         oxcf->lag_in_frames);
   if (!cpi->lookahead)
     vpx_internal_error(&cm->error, VPX_CODEC_MEM_ERROR,
@@ -1304,7 +1406,7 @@ static void alloc_raw_frame_buffers(VP9_COMP *cpi) {
 #if CONFIG_VP9_HIGHBITDEPTH
                                cm->use_highbitdepth,
 #endif
-                               VP9_ENC_BORDER_IN_PIXELS, cm->byte_alignment,
+                               cpi->border_in_pixels, cm->byte_alignment,
                                NULL, NULL, NULL))
     vpx_internal_error(&cm->error, VPX_CODEC_MEM_ERROR,
                        "Failed to allocate altref buffer");
@@ -1317,7 +1419,7 @@ static void alloc_util_frame_buffers(VP9_COMP *cpi) {
 #if CONFIG_VP9_HIGHBITDEPTH
                                cm->use_highbitdepth,
 #endif
-                               VP9_ENC_BORDER_IN_PIXELS, cm->byte_alignment,
+                               cpi->border_in_pixels, cm->byte_alignment,
                                NULL, NULL, NULL))
     vpx_internal_error(&cm->error, VPX_CODEC_MEM_ERROR,
                        "Failed to allocate last frame buffer");
@@ -1327,7 +1429,7 @@ static void alloc_util_frame_buffers(VP9_COMP *cpi) {
 #if CONFIG_VP9_HIGHBITDEPTH
                                cm->use_highbitdepth,
 #endif
-                               VP9_ENC_BORDER_IN_PIXELS, cm->byte_alignment,
+                               cpi->border_in_pixels, cm->byte_alignment,
                                NULL, NULL, NULL))
     vpx_internal_error(&cm->error, VPX_CODEC_MEM_ERROR,
                        "Failed to allocate scaled source buffer");
@@ -1344,7 +1446,7 @@ static void alloc_util_frame_buffers(VP9_COMP *cpi) {
 #if CONFIG_VP9_HIGHBITDEPTH
             cm->use_highbitdepth,
 #endif
-            VP9_ENC_BORDER_IN_PIXELS, cm->byte_alignment, NULL, NULL, NULL))
+            cpi->border_in_pixels, cm->byte_alignment, NULL, NULL, NULL))
       vpx_internal_error(&cpi->common.error, VPX_CODEC_MEM_ERROR,
                          "Failed to allocate scaled_frame for svc ");
   }
@@ -1354,7 +1456,7 @@ static void alloc_util_frame_buffers(VP9_COMP *cpi) {
 #if CONFIG_VP9_HIGHBITDEPTH
                                cm->use_highbitdepth,
 #endif
-                               VP9_ENC_BORDER_IN_PIXELS, cm->byte_alignment,
+                               cpi->border_in_pixels, cm->byte_alignment,
                                NULL, NULL, NULL))
     vpx_internal_error(&cm->error, VPX_CODEC_MEM_ERROR,
                        "Failed to allocate scaled last source buffer");
@@ -1364,7 +1466,7 @@ static void alloc_util_frame_buffers(VP9_COMP *cpi) {
 #if CONFIG_VP9_HIGHBITDEPTH
                                cm->use_highbitdepth,
 #endif
-                               VP9_ENC_BORDER_IN_PIXELS, cm->byte_alignment,
+                               cpi->border_in_pixels, cm->byte_alignment,
                                NULL, NULL, NULL))
     vpx_internal_error(&cm->error, VPX_CODEC_MEM_ERROR,
                        "Failed to allocate unscaled raw source frame buffer");
@@ -1374,7 +1476,7 @@ static void alloc_util_frame_buffers(VP9_COMP *cpi) {
 #if CONFIG_VP9_HIGHBITDEPTH
                                cm->use_highbitdepth,
 #endif
-                               VP9_ENC_BORDER_IN_PIXELS, cm->byte_alignment,
+                               cpi->border_in_pixels, cm->byte_alignment,
                                NULL, NULL, NULL))
     vpx_internal_error(&cm->error, VPX_CODEC_MEM_ERROR,
                        "Failed to allocate scaled raw source frame buffer");
@@ -1486,6 +1588,9 @@ static void init_config(struct VP9_COMP *cpi, const VP9EncoderConfig *oxcf) {
 
   cpi->oxcf = *oxcf;
   cpi->framerate = oxcf->init_framerate;
+  cpi->speed_ctrl.min_speed = oxcf->speed;
+  cpi->speed_ctrl.speed = oxcf->speed;
+  cpi->speed_ctrl.last_speed = oxcf->speed;
   cm->profile = oxcf->profile;
   cm->bit_depth = oxcf->bit_depth;
 #if CONFIG_VP9_HIGHBITDEPTH
@@ -1581,7 +1686,8 @@ void vp9_set_rc_buffer_sizes(VP9_COMP *cpi) {
   cpi->fn_ptr[BT].svf = SVF;                                            \
   cpi->fn_ptr[BT].svaf = SVAF;                                          \
   cpi->fn_ptr[BT].sdx4df = SDX4DF;                                      \
-  cpi->fn_ptr[BT].sdsx4df = SDSX4DF;
+  cpi->fn_ptr[BT].sdsx4df = SDSX4DF;                                    \
+  cpi->fn_ptr[BT].sdx8f = NULL;
 
 #define MAKE_BFP_SAD_WRAPPER(fnname)                                           \
   static unsigned int fnname##_bits8(const uint8_t *src_ptr,                   \
@@ -2004,6 +2110,8 @@ static void highbd_set_var_fns(VP9_COMP *const cpi) {
 
 static void realloc_segmentation_maps(VP9_COMP *cpi) {
   VP9_COMMON *const cm = &cpi->common;
+  const int num_sbs = ((cm->mi_rows + MI_MASK) >> MI_BLOCK_SIZE_LOG2) *
+                      ((cm->mi_cols + MI_MASK) >> MI_BLOCK_SIZE_LOG2);
 
   // Create the encoder segmentation map and set all entries to 0
   vpx_free(cpi->segmentation_map);
@@ -2020,6 +2128,13 @@ static void realloc_segmentation_maps(VP9_COMP *cpi) {
   CHECK_MEM_ERROR(&cm->error, cpi->active_map.map,
                   vpx_calloc(cm->mi_rows * cm->mi_cols, 1));
 
+  // Create the maps of the static superblocks.
+  vpx_free(cpi->static_sb_map);
+  CHECK_MEM_ERROR(&cm->error, cpi->static_sb_map, vpx_calloc(num_sbs, 1));
+  vpx_free(cpi->sb_dirty_map);
+  CHECK_MEM_ERROR(&cm->error, cpi->sb_dirty_map, vpx_calloc(num_sbs, 1));
+  cpi->sb_dirty_map_pending = 0;
+
   // And a place holder structure is the coding context
   // for use if we want to save and restore it
   vpx_free(cpi->coding_context.last_frame_seg_map_copy);
@@ -2065,6 +2180,59 @@ static void free_copy_partition_data(VP9_COMP *cpi) {
   cpi->copied_frame_cnt = NULL;
 }
 
+static int speed_control_enabled(const VP9_COMP *cpi) {
+  const VP9EncoderConfig *const oxcf = &cpi->oxcf;
+  return oxcf->target_frame_time > 0 && oxcf->mode == REALTIME &&
+         oxcf->pass == 0 && !cpi->use_svc;
+}
+
+// Keeps the speed chosen by the speed control across configuration changes,
+// which reset oxcf.speed to the speed set by the application. The encoding
+// mode follows the deadline of each frame, so the speed is only forgotten
+// when the application turns the speed control off.
+static void update_speed_control_config(VP9_COMP *cpi) {
+  SpeedControl *const sc = &cpi->speed_ctrl;
+  if (sc->min_speed != cpi->oxcf.speed) {
+    sc->min_speed = cpi->oxcf.speed;
+    sc->frames_since_change = 0;
+  }
+  if (cpi->oxcf.target_frame_time == 0) sc->speed = sc->min_speed;
+  sc->speed = VPXMAX(sc->speed, sc->min_speed);
+  if (speed_control_enabled(cpi)) cpi->oxcf.speed = sc->speed;
+}
+
+// Raises the speed as soon as the average time to encode a frame exceeds the
+// budget, and only lowers it once frames have taken less than 3/4 of the
+// budget for a while, so the speed does not swing between two levels. Like
+// the buffer level of the rate control, the average is tracked between
+// frames, but it restarts at each change to reflect the current speed only.
+static void update_speed_control(VP9_COMP *cpi, int64_t frame_time) {
+  SpeedControl *const sc = &cpi->speed_ctrl;
+  const int64_t budget = cpi->oxcf.target_frame_time;
+  const int max_speed = sc->min_speed < SPEED_CTRL_NONRD_SPEED
+                            ? SPEED_CTRL_NONRD_SPEED - 1
+                            : SPEED_CTRL_MAX_SPEED;
+
+  sc->avg_frame_time = sc->frames_since_change == 0
+                           ? frame_time
+                           : (7 * sc->avg_frame_time + frame_time) >> 3;
+  ++sc->frames_since_change;
+
+  if (sc->avg_frame_time > budget &&
+      sc->frames_since_change >= SPEED_CTRL_UP_FRAMES &&
+      sc->speed < max_speed) {
+    ++sc->speed;
+  } else if (sc->avg_frame_time * 4 < budget * 3 &&
+             sc->frames_since_change >= SPEED_CTRL_DOWN_FRAMES &&
+             sc->speed > sc->min_speed) {
+    --sc->speed;
+  } else {
+    return;
+  }
+  sc->frames_since_change = 0;
+  cpi->oxcf.speed = sc->speed;
+}
+
 void vp9_change_config(struct VP9_COMP *cpi, const VP9EncoderConfig *oxcf) {
   VP9_COMMON *const cm = &cpi->common;
   RATE_CONTROL *const rc = &cpi->rc;
@@ -2082,12 +2250,20 @@ void vp9_change_config(struct VP9_COMP *cpi, const VP9EncoderConfig *oxcf) {
   set_level_constraint(&cpi->level_constraint,
                        get_level_index(cpi->target_level));
 
+  // The frame buffers are allocated when the first frame is received and keep
+  // their border from then on.
+  if (!cpi->lookahead) {
+    cpi->border_in_pixels = oxcf->min_border ? VP9_ENC_MIN_BORDER_IN_PIXELS
+                                             : VP9_ENC_BORDER_IN_PIXELS;
+  }
+
   if (cm->profile <= PROFILE_1)
     assert(cm->bit_depth == VPX_BITS_8);
   else
     assert(cm->bit_depth > VPX_BITS_8);
 
   cpi->oxcf = *oxcf;
+  update_speed_control_config(cpi);
 #if CONFIG_VP9_HIGHBITDEPTH
   cpi->td.mb.e_mbd.bd = (int)cm->bit_depth;
 #endif  // CONFIG_VP9_HIGHBITDEPTH
@@ -2353,7 +2529,7 @@ static void setup_denoiser_buffer(VP9_COMP *cpi) {
 #if CONFIG_VP9_HIGHBITDEPTH
                            cm->use_highbitdepth,
 #endif
-                           VP9_ENC_BORDER_IN_PIXELS))
+                           cpi->border_in_pixels))
       vpx_internal_error(&cm->error, VPX_CODEC_MEM_ERROR,
                          "Failed to allocate denoiser");
   }
@@ -2377,6 +2553,7 @@ void vp9_update_compressor_with_img_fmt(VP9_COMP *cpi, vpx_img_fmt_t img_fmt) {
 #if CONFIG_VP9_HIGHBITDEPTH
                                       use_highbitdepth,
 #endif
+                                      cpi->border_in_pixels,
                                       oxcf->lag_in_frames);
   alloc_raw_frame_buffers(cpi);
 }
@@ -2467,6 +2644,9 @@ VP9_COMP *vp9_create_compressor(const VP9EncoderConfig *oxcf,
         vpx_calloc(cm->MBs * sizeof(*cpi->mbgraph_stats[i].mb_stats), 1));
   }
 
+  for (i = 0; i < HASH_MAX_INDEXES; ++i)
+    cpi->hash_index[i].buf_idx = INVALID_IDX;
+
   cpi->refresh_alt_ref_frame = 0;
   cpi->b_calculate_psnr = CONFIG_INTERNAL_STATS;
 
@@ -2535,6 +2715,7 @@ VP9_COMP *vp9_create_compressor(const VP9EncoderConfig *oxcf,
   cpi->td.mb.nmvsadcost_hp[0] = &cpi->nmvsadcosts_hp[0][MV_MAX];
   cpi->td.mb.nmvsadcost_hp[1] = &cpi->nmvsadcosts_hp[1][MV_MAX];
   cal_nmvsadcosts_hp(cpi->td.mb.nmvsadcost_hp);
+  cpi->td.mb.e_mbd.mc_buf = cpi->td.mc_buf;
 
 #if CONFIG_VP9_TEMPORAL_DENOISING
 #ifdef OUTPUT_YUV_DENOISED
@@ -2665,67 +2846,77 @@ VP9_COMP *vp9_create_compressor(const VP9EncoderConfig *oxcf,
                   vpx_calloc(cm->MBs, sizeof(cpi->source_diff_var)));
   cpi->source_var_thresh = 0;
   cpi->frames_till_next_var_check = 0;
-#define BFP(BT, SDF, SDSF, SDAF, VF, SVF, SVAF, SDX4DF, SDSX4DF) \
-  cpi->fn_ptr[BT].sdf = SDF;                                     \
-  cpi->fn_ptr[BT].sdsf = SDSF;                                   \
-  cpi->fn_ptr[BT].sdaf = SDAF;                                   \
-  cpi->fn_ptr[BT].vf = VF;                                       \
-  cpi->fn_ptr[BT].svf = SVF;                                     \
-  cpi->fn_ptr[BT].svaf = SVAF;                                   \
-  cpi->fn_ptr[BT].sdx4df = SDX4DF;                               \
-  cpi->fn_ptr[BT].sdsx4df = SDSX4DF;
+#define BFP(BT, SDF, SDSF, SDAF, VF, SVF, SVAF, SDX4DF, SDSX4DF, SDX8F) \
+  cpi->fn_ptr[BT].sdf = SDF;                                            \
+  cpi->fn_ptr[BT].sdsf = SDSF;                                          \
+  cpi->fn_ptr[BT].sdaf = SDAF;                                          \
+  cpi->fn_ptr[BT].vf = VF;                                              \
+  cpi->fn_ptr[BT].svf = SVF;                                            \
+  cpi->fn_ptr[BT].svaf = SVAF;                                          \
+  cpi->fn_ptr[BT].sdx4df = SDX4DF;                                      \
+  cpi->fn_ptr[BT].sdsx4df = SDSX4DF;                                    \
+  cpi->fn_ptr[BT].sdx8f = SDX8F;
 
   BFP(BLOCK_32X16, vpx_sad32x16, vpx_sad_skip_32x16, vpx_sad32x16_avg,
       vpx_variance32x16, vpx_sub_pixel_variance32x16,
-      vpx_sub_pixel_avg_variance32x16, vpx_sad32x16x4d, vpx_sad_skip_32x16x4d)
+      vpx_sub_pixel_avg_variance32x16, vpx_sad32x16x4d, vpx_sad_skip_32x16x4d,
+      vpx_sad32x16x8)
 
   BFP(BLOCK_16X32, vpx_sad16x32, vpx_sad_skip_16x32, vpx_sad16x32_avg,
       vpx_variance16x32, vpx_sub_pixel_variance16x32,
-      vpx_sub_pixel_avg_variance16x32, vpx_sad16x32x4d, vpx_sad_skip_16x32x4d)
+      vpx_sub_pixel_avg_variance16x32, vpx_sad16x32x4d, vpx_sad_skip_16x32x4d,
+      vpx_sad16x32x8)
 
   BFP(BLOCK_64X32, vpx_sad64x32, vpx_sad_skip_64x32, vpx_sad64x32_avg,
       vpx_variance64x32, vpx_sub_pixel_variance64x32,
-      vpx_sub_pixel_avg_variance64x32, vpx_sad64x32x4d, vpx_sad_skip_64x32x4d)
+      vpx_sub_pixel_avg_variance64x32, vpx_sad64x32x4d, vpx_sad_skip_64x32x4d,
+      vpx_sad64x32x8)
 
   BFP(BLOCK_32X64, vpx_sad32x64, vpx_sad_skip_32x64, vpx_sad32x64_avg,
       vpx_variance32x64, vpx_sub_pixel_variance32x64,
-      vpx_sub_pixel_avg_variance32x64, vpx_sad32x64x4d, vpx_sad_skip_32x64x4d)
+      vpx_sub_pixel_avg_variance32x64, vpx_sad32x64x4d, vpx_sad_skip_32x64x4d,
+      vpx_sad32x64x8)
 
   BFP(BLOCK_32X32, vpx_sad32x32, vpx_sad_skip_32x32, vpx_sad32x32_avg,
       vpx_variance32x32, vpx_sub_pixel_variance32x32,
-      vpx_sub_pixel_avg_variance32x32, vpx_sad32x32x4d, vpx_sad_skip_32x32x4d)
+      vpx_sub_pixel_avg_variance32x32, vpx_sad32x32x4d, vpx_sad_skip_32x32x4d,
+      vpx_sad32x32x8)
 
   BFP(BLOCK_64X64, vpx_sad64x64, vpx_sad_skip_64x64, vpx_sad64x64_avg,
       vpx_variance64x64, vpx_sub_pixel_variance64x64,
-      vpx_sub_pixel_avg_variance64x64, vpx_sad64x64x4d, vpx_sad_skip_64x64x4d)
+      vpx_sub_pixel_avg_variance64x64, vpx_sad64x64x4d, vpx_sad_skip_64x64x4d,
+      vpx_sad64x64x8)
 
   BFP(BLOCK_16X16, vpx_sad16x16, vpx_sad_skip_16x16, vpx_sad16x16_avg,
       vpx_variance16x16, vpx_sub_pixel_variance16x16,
-      vpx_sub_pixel_avg_variance16x16, vpx_sad16x16x4d, vpx_sad_skip_16x16x4d)
+      vpx_sub_pixel_avg_variance16x16, vpx_sad16x16x4d, vpx_sad_skip_16x16x4d,
+      vpx_sad16x16x8)
 
   BFP(BLOCK_16X8, vpx_sad16x8, vpx_sad_skip_16x8, vpx_sad16x8_avg,
       vpx_variance16x8, vpx_sub_pixel_variance16x8,
-      vpx_sub_pixel_avg_variance16x8, vpx_sad16x8x4d, vpx_sad_skip_16x8x4d)
+      vpx_sub_pixel_avg_variance16x8, vpx_sad16x8x4d, vpx_sad_skip_16x8x4d,
+      vpx_sad16x8x8)
 
   BFP(BLOCK_8X16, vpx_sad8x16, vpx_sad_skip_8x16, vpx_sad8x16_avg,
       vpx_variance8x16, vpx_sub_pixel_variance8x16,
-      vpx_sub_pixel_avg_variance8x16, vpx_sad8x16x4d, vpx_sad_skip_8x16x4d)
+      vpx_sub_pixel_avg_variance8x16, vpx_sad8x16x4d, vpx_sad_skip_8x16x4d,
+      vpx_sad8x16x8)
 
   BFP(BLOCK_8X8, vpx_sad8x8, vpx_sad_skip_8x8, vpx_sad8x8_avg, vpx_variance8x8,
       vpx_sub_pixel_variance8x8, vpx_sub_pixel_avg_variance8x8, vpx_sad8x8x4d,
-      vpx_sad_skip_8x8x4d)
+      vpx_sad_skip_8x8x4d, vpx_sad8x8x8)
 
   BFP(BLOCK_8X4, vpx_sad8x4, vpx_sad_skip_8x4, vpx_sad8x4_avg, vpx_variance8x4,
       vpx_sub_pixel_variance8x4, vpx_sub_pixel_avg_variance8x4, vpx_sad8x4x4d,
-      vpx_sad_skip_8x4x4d)
+      vpx_sad_skip_8x4x4d, vpx_sad8x4x8)
 
   BFP(BLOCK_4X8, vpx_sad4x8, vpx_sad_skip_4x8, vpx_sad4x8_avg, vpx_variance4x8,
       vpx_sub_pixel_variance4x8, vpx_sub_pixel_avg_variance4x8, vpx_sad4x8x4d,
-      vpx_sad_skip_4x8x4d)
+      vpx_sad_skip_4x8x4d, vpx_sad4x8x8)
 
   BFP(BLOCK_4X4, vpx_sad4x4, vpx_sad_skip_4x4, vpx_sad4x4_avg, vpx_variance4x4,
       vpx_sub_pixel_variance4x4, vpx_sub_pixel_avg_variance4x4, vpx_sad4x4x4d,
-      vpx_sad_skip_4x4x4d)
+      vpx_sad_skip_4x4x4d, vpx_sad4x4x8)
 
 #if CONFIG_VP9_HIGHBITDEPTH
   highbd_set_var_fns(cpi);
@@ -3489,7 +3680,7 @@ void vp9_scale_references(VP9_COMP *cpi) {
           if (vpx_realloc_frame_buffer(&new_fb_ptr->buf, cm->width, cm->height,
                                        cm->subsampling_x, cm->subsampling_y,
                                        cm->use_highbitdepth,
-                                       VP9_ENC_BORDER_IN_PIXELS,
+                                       cpi->border_in_pixels,
                                        cm->byte_alignment, NULL, NULL, NULL))
             vpx_internal_error(&cm->error, VPX_CODEC_MEM_ERROR,
                                "Failed to allocate frame buffer");
@@ -3498,7 +3689,7 @@ void vp9_scale_references(VP9_COMP *cpi) {
 #else
           if (vpx_realloc_frame_buffer(&new_fb_ptr->buf, cm->width, cm->height,
                                        cm->subsampling_x, cm->subsampling_y,
-                                       VP9_ENC_BORDER_IN_PIXELS,
+                                       cpi->border_in_pixels,
                                        cm->byte_alignment, NULL, NULL, NULL))
             vpx_internal_error(&cm->error, VPX_CODEC_MEM_ERROR,
                                "Failed to allocate frame buffer");
@@ -3867,7 +4058,7 @@ static void set_frame_size(VP9_COMP *cpi) {
 #if CONFIG_VP9_HIGHBITDEPTH
                                cm->use_highbitdepth,
 #endif
-                               VP9_ENC_BORDER_IN_PIXELS, cm->byte_alignment,
+                               cpi->border_in_pixels, cm->byte_alignment,
                                NULL, NULL, NULL))
     vpx_internal_error(&cm->error, VPX_CODEC_MEM_ERROR,
                        "Failed to allocate frame buffer");
@@ -4077,7 +4268,7 @@ static int encode_without_recode_loop(VP9_COMP *cpi, size_t *size,
         cpi->oxcf.mode == REALTIME && cpi->oxcf.speed >= 5) ||
        cpi->sf.partition_search_type == SOURCE_VAR_BASED_PARTITION ||
        (cpi->noise_estimate.enabled && !cpi->oxcf.noise_sensitivity) ||
-       cpi->compute_source_sad_onepass))
+       cpi->compute_source_sad_onepass || cpi->oxcf.skip_static_sb))
     cpi->Last_Source = vp9_scale_if_required(
         cm, cpi->unscaled_last_source, &cpi->scaled_last_source,
         (cpi->oxcf.pass == 0), EIGHTTAP, 0);
@@ -4192,6 +4383,8 @@ static int encode_without_recode_loop(VP9_COMP *cpi, size_t *size,
 
   suppress_active_map(cpi);
 
+  set_static_sb_map(cpi);
+
   if (cpi->use_svc) {
     // On non-zero spatial layer, check for disabling inter-layer
     // prediction.
@@ -4658,6 +4851,11 @@ static void encode_with_recode_loop(VP9_COMP *cpi, size_t *size, uint8_t *dest,
       vp9_psnr_aq_mode_setup(&cm->seg);
     }
 
+    // The mode info of the previous iteration is still in place as long as
+    // the frame size did not change.
+    cpi->recode_reuse_partition =
+        cpi->sf.recode_reuse_partition && loop_at_this_size > 0;
+
     vp9_encode_frame(cpi);
 
     // Update the skip mb flag probabilities based on the distribution
@@ -4899,6 +5097,7 @@ static void encode_with_recode_loop(VP9_COMP *cpi, size_t *size, uint8_t *dest,
 #endif
   } while (loop);
 
+  cpi->recode_reuse_partition = 0;
   rc->max_frame_bandwidth = orig_rc_max_frame_bandwidth;
 
 #ifdef AGGRESSIVE_VBR
@@ -5504,6 +5703,13 @@ static void encode_frame_to_data_rate(
 
   if (vp9_svc_check_skip_enhancement_layer(cpi)) return;
 
+  // The motion hints only apply to the frame they were passed for.
+  cpi->motion_hints.enabled = cpi->motion_hints.pending;
+  cpi->motion_hints.pending = 0;
+  cpi->mode_info_import.enabled =
+      cpi->mode_info_import.pending && !cpi->use_svc;
+  cpi->mode_info_import.pending = 0;
+
   set_ext_overrides(cpi);
   vpx_clear_system_state();
 
@@ -5602,6 +5808,10 @@ static void encode_frame_to_data_rate(
     cpi->ext_ratectrl.ext_rdmult = ext_rdmult;
   }
 
+  // Set by encode_without_recode_loop() only.
+  cpi->static_sb_frame = 0;
+  cpi->static_sb_count = 0;
+
   if (cpi->sf.recode_loop == DISALLOW_RECODE) {
     if (!encode_without_recode_loop(cpi, size, dest, dest_size)) return;
   } else {
@@ -5689,8 +5899,15 @@ static void encode_frame_to_data_rate(
 #if CONFIG_COLLECT_COMPONENT_TIMING
   start_timing(cpi, vp9_pack_bitstream_time);
 #endif
-  // build the bitstream
+  // build the bitstream. Its partitions may go out as they are written unless
+  // post_encode_drop_cbr() can still drop the frame below.
+  cpi->stream_partitions =
+      cpi->output_partition != NULL &&
+      !(cpi->rc.use_post_encode_drop &&
+        cm->base_qindex < cpi->rc.worst_quality &&
+        cpi->svc.spatial_layer_id == 0);
   vp9_pack_bitstream(cpi, dest, dest_size, size);
+  cpi->stream_partitions = 0;
 #if CONFIG_COLLECT_COMPONENT_TIMING
   end_timing(cpi, vp9_pack_bitstream_time);
 #endif
@@ -5790,6 +6007,9 @@ static void encode_frame_to_data_rate(
     release_scaled_references(cpi);
   }
   vp9_update_reference_frames(cpi);
+  vp9_update_block_hash_indexes(cpi);
+  if (cpi->refresh_last_frame)
+    cpi->last_frame_refresh_frame = cm->current_video_frame;
 
   if (!cm->show_existing_frame) {
     for (t = TX_4X4; t <= TX_32X32; ++t) {
@@ -6373,6 +6593,10 @@ int vp9_get_compressed_data(VP9_COMP *cpi, unsigned int *frame_flags,
 
   vpx_usec_timer_start(&cmptimer);
 
+  // A previous call may have stopped in vp9_pack_bitstream() on an error.
+  cpi->stream_partitions = 0;
+  cpi->partitions_streamed = 0;
+
   vp9_set_high_precision_mv(cpi, ALTREF_HIGH_PRECISION_MV);
 
   // Is multi-arf enabled.
@@ -6509,6 +6733,8 @@ int vp9_get_compressed_data(VP9_COMP *cpi, unsigned int *frame_flags,
 
     *time_stamp = source->ts_start;
     *time_end = source->ts_end;
+    cpi->source_time_stamp = source->ts_start;
+    cpi->source_end_time_stamp = source->ts_end;
     *frame_flags = (source->flags & VPX_EFLAG_FORCE_KF) ? FRAMEFLAGS_KEY : 0;
   } else {
     *size = 0;
@@ -6695,6 +6921,13 @@ int vp9_get_compressed_data(VP9_COMP *cpi, unsigned int *frame_flags,
   vpx_usec_timer_mark(&cmptimer);
   cpi->time_compress_data += vpx_usec_timer_elapsed(&cmptimer);
 
+  cpi->speed_ctrl.last_speed = cpi->oxcf.speed;
+  // Key frames are much slower to encode and do not reflect the speed.
+  if (speed_control_enabled(cpi) && !cpi->last_frame_dropped &&
+      !frame_is_intra_only(cm)) {
+    update_speed_control(cpi, vpx_usec_timer_elapsed(&cmptimer));
+  }
+
   if (cpi->keep_level_stats && oxcf->pass != 1)
     update_level_info(cpi, size, arf_src_index);
 
@@ -6939,6 +7172,169 @@ int vp9_get_preview_raw_frame(VP9_COMP *cpi, YV12_BUFFER_CONFIG *dest,
   }
 }
 
+int vp9_set_sb_dirty_map(VP9_COMP *cpi, unsigned char *dirty_map, int rows,
+                         int cols) {
+  const VP9_COMMON *const cm = &cpi->common;
+  if (rows == (cm->mi_rows + MI_MASK) >> MI_BLOCK_SIZE_LOG2 &&
+      cols == (cm->mi_cols + MI_MASK) >> MI_BLOCK_SIZE_LOG2) {
+    if (dirty_map) {
+      memcpy(cpi->sb_dirty_map, dirty_map, rows * cols);
+      cpi->sb_dirty_map_pending = 1;
+    } else {
+      cpi->sb_dirty_map_pending = 0;
+    }
+    return 0;
+  } else {
+    return -1;
+  }
+}
+
+int vp9_set_motion_hints(VP9_COMP *cpi, vpx_motion_hints_t *hints) {
+  VP9_COMMON *const cm = &cpi->common;
+  MotionHints *const mh = &cpi->motion_hints;
+  const int map_size = cm->mi_rows * cm->mi_cols;
+  int bs_log2, ref, r, c;
+
+  if (hints == NULL || (hints->block_size != 8 && hints->block_size != 16))
+    return -1;
+  bs_log2 = hints->block_size == 16;
+  if ((int)hints->rows != (cm->mi_rows + bs_log2) >> bs_log2 ||
+      (int)hints->cols != (cm->mi_cols + bs_log2) >> bs_log2)
+    return -1;
+
+  if (mh->alloc_size < map_size * MAX_INTER_REF_FRAMES) {
+    vpx_free(mh->mvs);
+    mh->alloc_size = 0;
+    mh->mvs = (MV *)vpx_malloc(map_size * MAX_INTER_REF_FRAMES *
+                               sizeof(*mh->mvs));
+    if (mh->mvs == NULL) {
+      mh->pending = 0;
+      return -1;
+    }
+    mh->alloc_size = map_size * MAX_INTER_REF_FRAMES;
+  }
+
+  for (ref = 0; ref < MAX_INTER_REF_FRAMES; ++ref) {
+    const vpx_motion_hint_t *const src = hints->hints[ref];
+    MV *const dst = mh->mvs + ref * map_size;
+    mh->has_ref[ref] = src != NULL;
+    if (src == NULL) continue;
+    for (r = 0; r < cm->mi_rows; ++r) {
+      for (c = 0; c < cm->mi_cols; ++c) {
+        const vpx_motion_hint_t *const hint =
+            &src[(r >> bs_log2) * hints->cols + (c >> bs_log2)];
+        dst[r * cm->mi_cols + c].row = hint->row;
+        dst[r * cm->mi_cols + c].col = hint->col;
+      }
+    }
+  }
+  mh->mi_rows = cm->mi_rows;
+  mh->mi_cols = cm->mi_cols;
+  mh->pending = 1;
+  return 0;
+}
+
+static int scale_value(int value, int num, int den) {
+  return (int)((int64_t)value * num / den);
+}
+
+// Returns the index of the power of two block dimension, from 8 to 64 pixels,
+// closest to |size|.
+static int scaled_block_dim(int size) {
+  int i = 0;
+  while (i < 3 && size >= (12 << i)) ++i;
+  return i;
+}
+
+int vp9_set_mode_info(VP9_COMP *cpi, vpx_mode_info_map_t *map) {
+  // Indexed by the dimension indexes of the height and the width.
+  static const BLOCK_SIZE block_sizes[4][4] = {
+    { BLOCK_8X8, BLOCK_16X8, BLOCK_INVALID, BLOCK_INVALID },
+    { BLOCK_8X16, BLOCK_16X16, BLOCK_32X16, BLOCK_INVALID },
+    { BLOCK_INVALID, BLOCK_16X32, BLOCK_32X32, BLOCK_64X32 },
+    { BLOCK_INVALID, BLOCK_INVALID, BLOCK_32X64, BLOCK_64X64 }
+  };
+  VP9_COMMON *const cm = &cpi->common;
+  ModeInfoImport *const import = &cpi->mode_info_import;
+  const int map_size = cm->mi_rows * cm->mi_stride;
+  vpx_motion_hint_t *last_hints;
+  vpx_motion_hints_t hints;
+  int r, c, ret;
+
+  if (map == NULL || map->mode_info == NULL || map->width == 0 ||
+      map->height == 0 || map->rows != (map->height + 7) >> 3 ||
+      map->cols != (map->width + 7) >> 3)
+    return -1;
+
+  if (import->alloc_size < map_size) {
+    vpx_free(import->partition);
+    import->alloc_size = 0;
+    import->partition =
+        (BLOCK_SIZE *)vpx_malloc(map_size * sizeof(*import->partition));
+    if (import->partition == NULL) {
+      import->pending = 0;
+      return -1;
+    }
+    import->alloc_size = map_size;
+  }
+  last_hints = (vpx_motion_hint_t *)vpx_malloc(
+      cm->mi_rows * cm->mi_cols * sizeof(*last_hints));
+  if (last_hints == NULL) {
+    import->pending = 0;
+    return -1;
+  }
+
+  for (r = 0; r < cm->mi_rows; ++r) {
+    // The 8x8 blocks of the map at the centers of the 8x8 blocks of the frame.
+    const int y =
+        scale_value(r * MI_SIZE + MI_SIZE / 2, map->height, cm->height);
+    const int map_row = VPXMIN(y >> 3, (int)map->rows - 1);
+    for (c = 0; c < cm->mi_cols; ++c) {
+      const int x =
+          scale_value(c * MI_SIZE + MI_SIZE / 2, map->width, cm->width);
+      const int map_col = VPXMIN(x >> 3, (int)map->cols - 1);
+      const vpx_mode_info_t *const info =
+          &map->mode_info[map_row * map->cols + map_col];
+      vpx_motion_hint_t *const hint = &last_hints[r * cm->mi_cols + c];
+      int w = scaled_block_dim(scale_value(info->width, cm->width, map->width));
+      int h =
+          scaled_block_dim(scale_value(info->height, cm->height, map->height));
+      // Block sizes are at most twice as wide as high, or high as wide.
+      w = VPXMIN(w, h + 1);
+      h = VPXMIN(h, w + 1);
+      import->partition[r * cm->mi_stride + c] = block_sizes[h][w];
+
+      if (info->ref_frame[0] == LAST_FRAME) {
+        hint->row = (short)clamp(
+            scale_value(info->mv_row[0], cm->height, map->height), MV_LOW + 1,
+            MV_UPP - 1);
+        hint->col = (short)clamp(
+            scale_value(info->mv_col[0], cm->width, map->width), MV_LOW + 1,
+            MV_UPP - 1);
+      } else {
+        hint->row = hint->col = VPX_MOTION_HINT_NONE;
+      }
+    }
+  }
+
+  memset(&hints, 0, sizeof(hints));
+  hints.hints[0] = last_hints;
+  hints.block_size = 8;
+  hints.rows = cm->mi_rows;
+  hints.cols = cm->mi_cols;
+  ret = vp9_set_motion_hints(cpi, &hints);
+  vpx_free(last_hints);
+  if (ret) {
+    import->pending = 0;
+    return -1;
+  }
+
+  import->mi_rows = cm->mi_rows;
+  import->mi_cols = cm->mi_cols;
+  import->pending = 1;
+  return 0;
+}
+
 int vp9_set_internal_size(VP9_COMP *cpi, VPX_SCALING_MODE horiz_mode,
                           VPX_SCALING_MODE vert_mode) {
   VP9_COMMON *cm = &cpi->common;
@@ -44,6 +44,7 @@
 #include "vp9/encoder/vp9_ethread.h"
 #include "vp9/encoder/vp9_ext_ratectrl.h"
 #include "vp9/encoder/vp9_firstpass.h"
+#include "vp9/encoder/vp9_hash_motion.h"
 #include "vp9/encoder/vp9_job_queue.h"
 #include "vp9/encoder/vp9_lookahead.h"
 #include "vp9/encoder/vp9_mbgraph.h"
@@ -284,6 +285,17 @@ typedef struct VP9EncoderConfig {
   unsigned int motion_vector_unit_test;
   int delta_q_uv;
   int use_simple_encode_api;  // Use SimpleEncode APIs or not
+
+  // Allocate frame buffers with VP9_ENC_MIN_BORDER_IN_PIXELS borders.
+  int min_border;
+
+  // Code superblocks identical to the previous source as a skipped copy of
+  // LAST_FRAME, see set_static_sb_map().
+  int skip_static_sb;
+
+  // Time budget to encode a frame, in microseconds, held by raising the speed
+  // above |speed| when needed, see update_speed_control(). 0 is off.
+  unsigned int target_frame_time;
 } VP9EncoderConfig;
 
 static INLINE int is_lossless_requested(const VP9EncoderConfig *cfg) {
@@ -390,6 +402,14 @@ typedef struct ThreadData {
   PICK_MODE_CONTEXT *leaf_tree;
   PC_TREE *pc_tree;
   PC_TREE *pc_root;
+
+  // Scratch for the 4x4 averaged variances of choose_partitioning(), kept
+  // across superblocks.
+  struct v16x16 *vt2;
+
+  // Scratch for mb.e_mbd.mc_buf. A MACROBLOCK copied from another thread must
+  // be pointed back at it.
+  DECLARE_ALIGNED(16, uint16_t, mc_buf[80 * 2 * 80 * 2]);
 } ThreadData;
 
 struct EncWorkerData;
@@ -400,6 +420,46 @@ typedef struct ActiveMap {
   unsigned char *map;
 } ActiveMap;
 
+// Only refine around the motion vectors passed by the application, within 8
+// pixels.
+#define MOTION_HINT_STEP_PARAM (MAX_MVSEARCH_STEPS - 4)
+
+// Motion vectors passed by the application for the next frame, per 8x8 block
+// and reference frame, see vp9_set_motion_hints().
+typedef struct MotionHints {
+  int pending;  // Passed for the next frame.
+  int enabled;  // Passed for the frame being encoded.
+  int has_ref[MAX_INTER_REF_FRAMES];
+  int mi_rows;
+  int mi_cols;
+  MV *mvs;  // MAX_INTER_REF_FRAMES maps of mi_rows x mi_cols.
+  int alloc_size;
+} MotionHints;
+
+// Partitioning of the next frame taken from the mode info of a decoded frame,
+// see vp9_set_mode_info().
+typedef struct ModeInfoImport {
+  int pending;  // Passed for the next frame.
+  int enabled;  // Passed for the frame being encoded.
+  int mi_rows;
+  int mi_cols;
+  // Size of the block covering each 8x8 block, in the layout of
+  // prev_partition.
+  BLOCK_SIZE *partition;
+  int alloc_size;
+} ModeInfoImport;
+
+// State of the speed adaptation to oxcf.target_frame_time.
+typedef struct SpeedControl {
+  int min_speed;   // The speed set by the application.
+  int speed;       // The speed chosen for the next frame.
+  int last_speed;  // The speed the last frame was encoded at.
+  // Average time to encode an inter frame since the speed last changed, in
+  // microseconds.
+  int64_t avg_frame_time;
+  int frames_since_change;
+} SpeedControl;
+
 typedef enum { Y, U, V, ALL } STAT_TYPE;
 
 typedef struct IMAGE_STAT {
@@ -858,6 +918,10 @@ typedef struct VP9_COMP {
   CYCLIC_REFRESH *cyclic_refresh;
   ActiveMap active_map;
 
+  MotionHints motion_hints;
+  ModeInfoImport mode_info_import;
+  SpeedControl speed_ctrl;
+
   fractional_mv_step_fp *find_fractional_mv_step;
   struct scale_factors me_sf;
   vp9_diamond_search_fn_t diamond_search_sad;
@@ -866,6 +930,13 @@ typedef struct VP9_COMP {
   uint64_t time_compress_data;
   uint64_t time_pick_lpf;
   uint64_t time_encode_sb_row;
+  // Totals of the sb_sad_ref_prunes and sb_sad_filter_skips frame counts of
+  // MACROBLOCK.
+  uint64_t sb_sad_ref_prunes;
+  uint64_t sb_sad_filter_skips;
+  // Number of superblocks of the last frame coded as static, see
+  // static_sb_map.
+  int static_sb_count;
 
   TWO_PASS twopass;
 
@@ -919,6 +990,30 @@ typedef struct VP9_COMP {
 
   int droppable;
 
+  // Layout of the last frame written by vp9_pack_bitstream(): the size of the
+  // uncompressed and compressed headers, followed by the size of each tile
+  // including its 4-byte size marker. Used for VPX_CODEC_USE_OUTPUT_PARTITION.
+  int num_partitions;
+  size_t partition_sz[MAX_NUM_TILE_COLS * MAX_NUM_TILE_ROWS + 1];
+
+  // When set, the final vp9_pack_bitstream() of a frame hands each partition
+  // to |output_partition| as soon as it has been written, and sets
+  // |partitions_streamed| once the last one is out. Only used when the frame
+  // can no longer be dropped after it has been packed.
+  void (*output_partition)(void *priv, uint8_t *buf, size_t sz,
+                           int partition_id, int is_last);
+  void *output_partition_priv;
+  int stream_partitions;
+  int partitions_streamed;
+
+  // Time stamps of the source frame being encoded.
+  int64_t source_time_stamp;
+  int64_t source_end_time_stamp;
+
+  // Border of the reference and lookahead frame buffers, fixed once the first
+  // frame has been received.
+  int border_in_pixels;
+
   int initial_width;
   int initial_height;
   int initial_mbs;  // Number of MBs in the full-size frame; to be used to
@@ -952,10 +1047,17 @@ typedef struct VP9_COMP {
   // Indices are:  max_tx_size-1,  tx_size_ctx,    tx_size
   int tx_size_cost[TX_SIZES - 1][TX_SIZE_CONTEXTS][TX_SIZES];
 
+  // Block hashes of the references, see sf.mv.use_hash_search.
+  BLOCK_HASH_INDEX hash_index[HASH_MAX_INDEXES];
+
 #if CONFIG_VP9_TEMPORAL_DENOISING
   VP9_DENOISER denoiser;
 #endif
 
+  // Set while a frame is recoded with the partitioning of the previous
+  // iteration, see sf.recode_reuse_partition.
+  int recode_reuse_partition;
+
   int resize_pending;
   RESIZE_STATE resize_state;
   int external_resize;
@@ -1019,6 +1121,16 @@ typedef struct VP9_COMP {
   // the superblock did not have low source sad.
   uint8_t *content_state_sb_fd;
 
+  // For each superblock: 1 if its source did not change since the frame coded
+  // into LAST_FRAME. Only set when static_sb_frame is on.
+  uint8_t *static_sb_map;
+  int static_sb_frame;
+  // Superblocks of the next frame that changed, passed by the application.
+  uint8_t *sb_dirty_map;
+  int sb_dirty_map_pending;
+  // current_video_frame of the last frame that refreshed LAST_FRAME.
+  unsigned int last_frame_refresh_frame;
+
   int compute_source_sad_onepass;
 
   int compute_frame_low_motion_onepass;
@@ -1250,6 +1362,13 @@ int vp9_set_active_map(VP9_COMP *cpi, unsigned char *new_map_16x16, int rows,
 int vp9_get_active_map(VP9_COMP *cpi, unsigned char *new_map_16x16, int rows,
                        int cols);
 
+int vp9_set_sb_dirty_map(VP9_COMP *cpi, unsigned char *dirty_map, int rows,
+                         int cols);
+
+int vp9_set_motion_hints(VP9_COMP *cpi, vpx_motion_hints_t *hints);
+
+int vp9_set_mode_info(VP9_COMP *cpi, vpx_mode_info_map_t *map);
+
 int vp9_set_internal_size(VP9_COMP *cpi, VPX_SCALING_MODE horiz_mode,
                           VPX_SCALING_MODE vert_mode);
 
@@ -1343,6 +1462,28 @@ static INLINE YV12_BUFFER_CONFIG *get_ref_frame_buffer(
                                 : NULL;
 }
 
+// Returns 1 and the motion vector passed by the application for the block if
+// there is one.
+static INLINE int get_motion_hint(const VP9_COMP *cpi, int ref_frame,
+                                  int mi_row, int mi_col, BLOCK_SIZE bsize,
+                                  MV *mv) {
+  const MotionHints *const hints = &cpi->motion_hints;
+  const VP9_COMMON *const cm = &cpi->common;
+  int row, col;
+  if (!hints->enabled || !hints->has_ref[ref_frame - LAST_FRAME] ||
+      hints->mi_rows != cm->mi_rows || hints->mi_cols != cm->mi_cols)
+    return 0;
+  // Use the hint at the center of the block.
+  row = VPXMIN(mi_row + (num_8x8_blocks_high_lookup[bsize] >> 1),
+               cm->mi_rows - 1);
+  col = VPXMIN(mi_col + (num_8x8_blocks_wide_lookup[bsize] >> 1),
+               cm->mi_cols - 1);
+  *mv = hints->mvs[((ref_frame - LAST_FRAME) * cm->mi_rows + row) *
+                       cm->mi_cols +
+                   col];
+  return mv->row != VPX_MOTION_HINT_NONE;
+}
+
 static INLINE int get_token_alloc(int mb_rows, int mb_cols) {
   // TODO(JBB): double check we can't exceed this token count if we have a
   // 32x32 transform crossing a boundary at a multiple of 16.
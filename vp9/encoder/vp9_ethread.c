@@ -28,6 +28,10 @@ static void accumulate_rd_opt(ThreadData *td, ThreadData *td_t) {
   for (i = 0; i < SWITCHABLE_FILTER_CONTEXTS; i++)
     td->rd_counts.filter_diff[i] += td_t->rd_counts.filter_diff[i];
 
+  td->mb.sb_sad_ref_prunes += td_t->mb.sb_sad_ref_prunes;
+  td->mb.sb_sad_filter_skips += td_t->mb.sb_sad_filter_skips;
+  td->mb.static_sb_count += td_t->mb.static_sb_count;
+
   for (i = 0; i < TX_SIZES; i++)
     for (j = 0; j < PLANE_TYPES; j++)
       for (k = 0; k < REF_TYPES; k++)
@@ -184,6 +188,7 @@ void vp9_encode_free_mt_data(struct VP9_COMP *cpi) {
     // Deallocate allocated thread data.
     if (t < cpi->num_workers - 1) {
       vpx_free(thread_data->td->counts);
+      vpx_free(thread_data->td->vt2);
       vp9_free_pc_tree(thread_data->td);
       vpx_free(thread_data->td);
     }
@@ -211,6 +216,7 @@ void vp9_encode_tiles_mt(VP9_COMP *cpi) {
     // Before encoding a frame, copy the thread data from cpi.
     if (thread_data->td != &cpi->td) {
       thread_data->td->mb = cpi->td.mb;
+      thread_data->td->mb.e_mbd.mc_buf = thread_data->td->mc_buf;
       thread_data->td->rd_counts = cpi->td.rd_counts;
     }
     if (thread_data->td->counts != &cpi->common.counts) {
@@ -494,6 +500,7 @@ void vp9_encode_fp_row_mt(VP9_COMP *cpi) {
     // Before encoding a frame, copy the thread data from cpi.
     if (thread_data->td != &cpi->td) {
       thread_data->td->mb = cpi->td.mb;
+      thread_data->td->mb.e_mbd.mc_buf = thread_data->td->mc_buf;
     }
   }
 
@@ -578,6 +585,7 @@ void vp9_temporal_filter_row_mt(VP9_COMP *cpi) {
     // Before encoding a frame, copy the thread data from cpi.
     if (thread_data->td != &cpi->td) {
       thread_data->td->mb = cpi->td.mb;
+      thread_data->td->mb.e_mbd.mc_buf = thread_data->td->mc_buf;
     }
   }
 
@@ -652,6 +660,7 @@ void vp9_encode_tiles_row_mt(VP9_COMP *cpi) {
     // Before encoding a frame, copy the thread data from cpi.
     if (thread_data->td != &cpi->td) {
       thread_data->td->mb = cpi->td.mb;
+      thread_data->td->mb.e_mbd.mc_buf = thread_data->td->mc_buf;
       thread_data->td->rd_counts = cpi->td.rd_counts;
     }
     if (thread_data->td->counts != &cpi->common.counts) {
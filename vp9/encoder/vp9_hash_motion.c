@@ -0,0 +1,288 @@
+/*
+ *  Copyright (c) 2024 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <assert.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "vpx_mem/vpx_mem.h"
+#include "vp9/encoder/vp9_encoder.h"
+#include "vp9/encoder/vp9_hash_motion.h"
+
+// Blocks are hashed as polynomials of their pixels, first along the rows with
+// kRowMult and then down the columns with kColMult, modulo 2^32. Unlike a CRC
+// this lets the hashes of all positions be computed with a rolling update.
+// Equal hashes are taken as equal blocks.
+static const uint32_t kRowMult = 0x01000193;
+static const uint32_t kColMult = 0x2f0b3d4b;
+static const uint32_t kBucketMult = 0x9e3779b1;
+
+// Limit on the work done per search, as large bucket chains are made of
+// repeated content such as lines of text.
+#define MAX_VISITED 64
+
+// Largest number of 8x8 blocks in a block.
+#define MAX_HASHES ((64 / HASH_BLOCK_SIZE) * (64 / HASH_BLOCK_SIZE))
+
+static uint32_t power(uint32_t mult, int n) {
+  uint32_t p = 1;
+  while (n-- > 0) p *= mult;
+  return p;
+}
+
+// Hash of a block whose pixels all equal 1.
+static uint32_t unit_block_hash(void) {
+  uint32_t row = 0;
+  uint32_t h = 0;
+  int i;
+  for (i = 0; i < HASH_BLOCK_SIZE; ++i) row = row * kRowMult + 1;
+  for (i = 0; i < HASH_BLOCK_SIZE; ++i) h = h * kColMult + row;
+  return h;
+}
+
+static uint32_t block_hash(const uint8_t *buf, int stride) {
+  uint32_t h = 0;
+  int r, c;
+  for (r = 0; r < HASH_BLOCK_SIZE; ++r) {
+    uint32_t row = 0;
+    for (c = 0; c < HASH_BLOCK_SIZE; ++c) row = row * kRowMult + buf[c];
+    h = h * kColMult + row;
+    buf += stride;
+  }
+  return h;
+}
+
+static INLINE int bucket(uint32_t h, int bits) {
+  return (int)((h * kBucketMult) >> (32 - bits));
+}
+
+void vp9_block_hash_index_free(BLOCK_HASH_INDEX *index) {
+  vpx_free(index->head);
+  vpx_free(index->next);
+  vpx_free(index->hash);
+  vpx_free(index->row_hash);
+  vpx_free(index->col_hash);
+  memset(index, 0, sizeof(*index));
+  index->buf_idx = -1;
+}
+
+static int alloc_index(BLOCK_HASH_INDEX *index, int width, int positions,
+                       int bits) {
+  if (positions > index->alloc_positions) {
+    vpx_free(index->next);
+    vpx_free(index->hash);
+    index->next = (int32_t *)vpx_malloc(positions * sizeof(*index->next));
+    index->hash = (uint32_t *)vpx_malloc(positions * sizeof(*index->hash));
+    if (!index->next || !index->hash) return 0;
+    index->alloc_positions = positions;
+  }
+  if (bits > index->alloc_bits) {
+    vpx_free(index->head);
+    index->head = (int32_t *)vpx_malloc(sizeof(*index->head) << bits);
+    if (!index->head) return 0;
+    index->alloc_bits = bits;
+  }
+  if (width > index->alloc_width) {
+    vpx_free(index->row_hash);
+    vpx_free(index->col_hash);
+    index->row_hash = (uint32_t *)vpx_malloc(HASH_BLOCK_SIZE * width *
+                                             sizeof(*index->row_hash));
+    index->col_hash = (uint32_t *)vpx_malloc(width * sizeof(*index->col_hash));
+    if (!index->row_hash || !index->col_hash) return 0;
+    index->alloc_width = width;
+  }
+  return 1;
+}
+
+int vp9_block_hash_index_build(BLOCK_HASH_INDEX *index, const uint8_t *buf,
+                               int stride, int width, int height) {
+  const int cols = width - HASH_BLOCK_SIZE + 1;
+  const int rows = height - HASH_BLOCK_SIZE + 1;
+  const uint32_t row_out = power(kRowMult, HASH_BLOCK_SIZE - 1);
+  const uint32_t col_out = power(kColMult, HASH_BLOCK_SIZE - 1);
+  const uint32_t unit = unit_block_hash();
+  int bits = 8;
+  int x, y;
+
+  index->width = 0;
+  index->height = 0;
+  if (cols <= 0 || rows <= 0) return 1;
+  while (bits < 22 && (1 << bits) < cols * rows / 2) ++bits;
+  if (!alloc_index(index, cols, cols * rows, bits)) {
+    vp9_block_hash_index_free(index);
+    return 0;
+  }
+  index->width = width;
+  index->height = height;
+  index->bits = bits;
+  for (x = 0; x < 1 << bits; ++x) index->head[x] = -1;
+
+  for (y = 0; y < height; ++y) {
+    const uint8_t *const line = buf + y * stride;
+    uint32_t *const row_hash = index->row_hash + (y % HASH_BLOCK_SIZE) * cols;
+    uint32_t h = 0;
+    for (x = 0; x < HASH_BLOCK_SIZE - 1; ++x) h = h * kRowMult + line[x];
+    for (x = 0; x < cols; ++x) {
+      h = h * kRowMult + line[x + HASH_BLOCK_SIZE - 1];
+      // row_hash still holds the line that leaves the block.
+      if (y == 0)
+        index->col_hash[x] = h;
+      else if (y < HASH_BLOCK_SIZE)
+        index->col_hash[x] = index->col_hash[x] * kColMult + h;
+      else
+        index->col_hash[x] =
+            (index->col_hash[x] - row_hash[x] * col_out) * kColMult + h;
+      row_hash[x] = h;
+      h -= line[x] * row_out;
+    }
+    if (y >= HASH_BLOCK_SIZE - 1) {
+      const int top = y - HASH_BLOCK_SIZE + 1;
+      const uint8_t *const block_line = buf + top * stride;
+      for (x = 0; x < cols; ++x) {
+        const uint32_t block = index->col_hash[x];
+        const int pos = top * cols + x;
+        int b;
+        index->hash[pos] = block;
+        if (block == unit * block_line[x]) continue;
+        b = bucket(block, bits);
+        index->next[pos] = index->head[b];
+        index->head[b] = pos;
+      }
+    }
+  }
+  return 1;
+}
+
+int vp9_block_hash_search(const BLOCK_HASH_INDEX *index, const uint8_t *src,
+                          int src_stride, int col, int row, int bw, int bh,
+                          const MvLimits *limits, const MV *ref_mv, MV *mv) {
+  const int cols = index->width - HASH_BLOCK_SIZE + 1;
+  const int hash_cols = bw / HASH_BLOCK_SIZE;
+  const int num_hashes = hash_cols * (bh / HASH_BLOCK_SIZE);
+  const uint32_t unit = unit_block_hash();
+  uint32_t hashes[MAX_HASHES];
+  int first, hashed;
+  int pos;
+  int visited = 0;
+  int best_dist = INT_MAX;
+
+  if (bw < HASH_BLOCK_SIZE || bh < HASH_BLOCK_SIZE ||
+      col + bw > index->width || row + bh > index->height)
+    return 0;
+  assert(num_hashes <= MAX_HASHES);
+
+  // The block is looked up by its first 8x8 block that is not flat, as blank
+  // margins are common in screen content, and matches if all its 8x8 blocks
+  // do.
+  for (first = 0; first < num_hashes; ++first) {
+    const uint8_t *const buf =
+        src + (first / hash_cols) * HASH_BLOCK_SIZE * src_stride +
+        (first % hash_cols) * HASH_BLOCK_SIZE;
+    hashes[first] = block_hash(buf, src_stride);
+    if (hashes[first] != unit * buf[0]) break;
+  }
+  if (first == num_hashes) return 0;
+  hashed = first + 1;
+
+  for (pos = index->head[bucket(hashes[first], index->bits)];
+       pos >= 0 && visited < MAX_VISITED; pos = index->next[pos], ++visited) {
+    const int cand_col = pos % cols - (first % hash_cols) * HASH_BLOCK_SIZE;
+    const int cand_row = pos / cols - (first / hash_cols) * HASH_BLOCK_SIZE;
+    const int mv_col = cand_col - col;
+    const int mv_row = cand_row - row;
+    int dist, i;
+    if (index->hash[pos] != hashes[first] || cand_col < 0 || cand_row < 0 ||
+        cand_col + bw > index->width || cand_row + bh > index->height ||
+        mv_col < limits->col_min || mv_col > limits->col_max ||
+        mv_row < limits->row_min || mv_row > limits->row_max)
+      continue;
+    dist = abs(mv_col * 8 - ref_mv->col) + abs(mv_row * 8 - ref_mv->row);
+    if (dist >= best_dist) continue;
+    for (i = 0; i < num_hashes; ++i) {
+      const int r = (i / hash_cols) * HASH_BLOCK_SIZE;
+      const int c = (i % hash_cols) * HASH_BLOCK_SIZE;
+      if (i == hashed) {
+        // The rest of the block is only hashed once a candidate gets here.
+        hashes[hashed++] = block_hash(src + r * src_stride + c, src_stride);
+      }
+      if (index->hash[(cand_row + r) * cols + cand_col + c] != hashes[i])
+        break;
+    }
+    if (i < num_hashes) continue;
+    mv->col = mv_col;
+    mv->row = mv_row;
+    best_dist = dist;
+  }
+  return best_dist != INT_MAX;
+}
+
+static int is_referenced(const VP9_COMP *cpi, int buf_idx) {
+  const VP9_COMMON *const cm = &cpi->common;
+  const int map_idx[HASH_MAX_INDEXES] = { cpi->lst_fb_idx, cpi->gld_fb_idx,
+                                          cpi->alt_fb_idx };
+  int i;
+  for (i = 0; i < HASH_MAX_INDEXES; ++i) {
+    if (map_idx[i] != INVALID_IDX && cm->ref_frame_map[map_idx[i]] == buf_idx)
+      return 1;
+  }
+  return 0;
+}
+
+void vp9_update_block_hash_indexes(VP9_COMP *cpi) {
+  VP9_COMMON *const cm = &cpi->common;
+  const int new_frame = !cm->show_existing_frame;
+  int use_hash = cpi->sf.mv.use_hash_search;
+  BLOCK_HASH_INDEX *free_index = NULL;
+  int i;
+
+#if CONFIG_VP9_HIGHBITDEPTH
+  if (cm->use_highbitdepth) use_hash = 0;
+#endif
+  for (i = 0; i < HASH_MAX_INDEXES; ++i) {
+    BLOCK_HASH_INDEX *const index = &cpi->hash_index[i];
+    if (!use_hash || !is_referenced(cpi, index->buf_idx) ||
+        (new_frame && index->buf_idx == cm->new_fb_idx))
+      index->buf_idx = INVALID_IDX;
+    if (index->buf_idx == INVALID_IDX) free_index = index;
+  }
+
+  if (use_hash && new_frame && is_referenced(cpi, cm->new_fb_idx)) {
+    const YV12_BUFFER_CONFIG *const src = cpi->Source;
+    // At most one index per reference, and the new frame has none.
+    assert(free_index != NULL);
+    if (!vp9_block_hash_index_build(free_index, src->y_buffer, src->y_stride,
+                                    cm->width, cm->height))
+      vpx_internal_error(&cm->error, VPX_CODEC_MEM_ERROR,
+                         "Failed to allocate block hash index");
+    free_index->buf_idx = cm->new_fb_idx;
+  }
+}
+
+int vp9_hash_motion_search(const VP9_COMP *cpi, const MACROBLOCK *x,
+                           BLOCK_SIZE bsize, int mi_row, int mi_col,
+                           int ref_frame, const MV *ref_mv, MV *mv) {
+  const VP9_COMMON *const cm = &cpi->common;
+  const int buf_idx = get_ref_frame_buf_idx(cpi, ref_frame);
+  int i;
+
+  if (!cpi->sf.mv.use_hash_search || buf_idx == INVALID_IDX) return 0;
+  for (i = 0; i < HASH_MAX_INDEXES; ++i) {
+    const BLOCK_HASH_INDEX *const index = &cpi->hash_index[i];
+    if (index->buf_idx != buf_idx) continue;
+    // Scaled references are not searched.
+    if (index->width != cm->width || index->height != cm->height) return 0;
+    return vp9_block_hash_search(
+        index, x->plane[0].src.buf, x->plane[0].src.stride, mi_col * MI_SIZE,
+        mi_row * MI_SIZE, num_4x4_blocks_wide_lookup[bsize] << 2,
+        num_4x4_blocks_high_lookup[bsize] << 2, &x->mv_limits, ref_mv, mv);
+  }
+  return 0;
+}
@@ -0,0 +1,80 @@
+/*
+ *  Copyright (c) 2024 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef VPX_VP9_ENCODER_VP9_HASH_MOTION_H_
+#define VPX_VP9_ENCODER_VP9_HASH_MOTION_H_
+
+#include "vpx/vpx_integer.h"
+#include "vp9/common/vp9_enums.h"
+#include "vp9/common/vp9_mv.h"
+#include "vp9/encoder/vp9_block.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Size of the blocks that are hashed, at every pixel position of the frame.
+#define HASH_BLOCK_SIZE 8
+
+// One index per distinct LAST, GOLDEN and ALTREF buffer.
+#define HASH_MAX_INDEXES 3
+
+// Hash table of the 8x8 luma blocks of a frame, used to find where blocks of
+// screen content moved by large distances without changing. A frame is
+// indexed from its source when it is coded, since the reconstruction of lossy
+// coding rarely matches the next source exactly.
+typedef struct BLOCK_HASH_INDEX {
+  int buf_idx;  // Frame buffer the frame was coded into, -1 if unused.
+  int width;
+  int height;
+  int bits;        // log2 of the number of buckets.
+  int32_t *head;   // Last position added to each bucket, -1 if empty.
+  int32_t *next;   // Position added to the same bucket before, per position.
+  uint32_t *hash;  // Hash of the block at each position.
+  uint32_t *row_hash;  // Hashes of the rows of the last 8 lines.
+  uint32_t *col_hash;  // Running hashes of the blocks of the current line.
+  int alloc_positions;
+  int alloc_bits;
+  int alloc_width;
+} BLOCK_HASH_INDEX;
+
+// Builds the index of a width x height 8-bit plane. Returns 0 if memory could
+// not be allocated, leaving the index empty.
+int vp9_block_hash_index_build(BLOCK_HASH_INDEX *index, const uint8_t *buf,
+                               int stride, int width, int height);
+
+void vp9_block_hash_index_free(BLOCK_HASH_INDEX *index);
+
+// Looks for a bw x bh block of the indexed plane equal to the block of src at
+// (col, row). Flat blocks are not indexed, since any search finds them, so
+// blocks made only of flat 8x8 blocks are never found. Returns 1 and the full
+// pixel motion vector closest to ref_mv (1/8 pel) within limits if there is
+// one.
+int vp9_block_hash_search(const BLOCK_HASH_INDEX *index, const uint8_t *src,
+                          int src_stride, int col, int row, int bw, int bh,
+                          const MvLimits *limits, const MV *ref_mv, MV *mv);
+
+struct VP9_COMP;
+
+// Indexes the newly coded frame if it is referenced, and drops the indexes of
+// the buffers that no longer are. Called once the references are updated.
+void vp9_update_block_hash_indexes(struct VP9_COMP *cpi);
+
+// Looks for the block at (mi_row, mi_col) in ref_frame, see
+// vp9_block_hash_search(). The motion vector limits of x must be set.
+int vp9_hash_motion_search(const struct VP9_COMP *cpi, const MACROBLOCK *x,
+                           BLOCK_SIZE bsize, int mi_row, int mi_col,
+                           int ref_frame, const MV *ref_mv, MV *mv);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // VPX_VP9_ENCODER_VP9_HASH_MOTION_H_
@@ -49,7 +49,7 @@ struct lookahead_ctx *vp9_lookahead_init(unsigned int width,
 #if CONFIG_VP9_HIGHBITDEPTH
                                          int use_highbitdepth,
 #endif
-                                         unsigned int depth) {
+                                         int border, unsigned int depth) {
   struct lookahead_ctx *ctx = NULL;
 
   // Clamp the lookahead queue depth
@@ -73,7 +73,7 @@ struct lookahead_ctx *vp9_lookahead_init(unsigned int width,
 #if CONFIG_VP9_HIGHBITDEPTH
               use_highbitdepth,
 #endif
-              VP9_ENC_BORDER_IN_PIXELS, legacy_byte_alignment))
+              border, legacy_byte_alignment))
         goto bail;
   }
   return ctx;
@@ -127,7 +127,7 @@ int vp9_lookahead_push(struct lookahead_ctx *ctx, YV12_BUFFER_CONFIG *src,
 #if CONFIG_VP9_HIGHBITDEPTH
                                use_highbitdepth,
 #endif
-                               VP9_ENC_BORDER_IN_PIXELS, 0))
+                               buf->img.border, 0))
       return 1;
     vpx_free_frame_buffer(&buf->img);
     buf->img = new_img;
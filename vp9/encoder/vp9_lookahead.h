@@ -54,7 +54,7 @@ struct lookahead_ctx *vp9_lookahead_init(unsigned int width,
 #if CONFIG_VP9_HIGHBITDEPTH
                                          int use_highbitdepth,
 #endif
-                                         unsigned int depth);
+                                         int border, unsigned int depth);
 
 /**\brief Destroys the lookahead stage
  */
@@ -1677,8 +1677,29 @@ static int exhaustive_mesh_search(const MACROBLOCK *x, MV *ref_mv, MV *best_mv,
           }
         }
       } else {
-        // 4 sads in a single call if we are checking every location
-        if (c + 3 <= end_col) {
+        if (fn_ptr->sdx8f != NULL && c + 7 <= end_col) {
+          // 8 sads in a single call when 8 adjacent columns remain.
+          unsigned int sads[8];
+          const MV start_mv = { fcenter_mv.row + r, fcenter_mv.col + c };
+          fn_ptr->sdx8f(what->buf, what->stride,
+                        get_buf_from_mv(in_what, &start_mv), in_what->stride,
+                        sads);
+
+          for (i = 0; i < 8; ++i) {
+            if (sads[i] < best_sad) {
+              const MV mv = { fcenter_mv.row + r, fcenter_mv.col + c + i };
+              const unsigned int sad =
+                  sads[i] + mvsad_err_cost(x, &mv, ref_mv, sad_per_bit);
+              if (sad < best_sad) {
+                best_sad = sad;
+                *best_mv = mv;
+              }
+            }
+          }
+          // The loop increment covers the other 4 columns.
+          c += 4;
+        } else if (c + 3 <= end_col) {
+          // 4 sads in a single call if we are checking every location
           unsigned int sads[4];
           const uint8_t *addrs[4];
           for (i = 0; i < 4; ++i) {
@@ -1781,6 +1802,26 @@ static int64_t exhaustive_mesh_search_single_step(
   end_col = VPXMIN(center_mv->col + range, mv_limits->col_max);
   for (r = start_row; r <= end_row; r += 1) {
     c = start_col;
+    while (fn_ptr->sdx8f != NULL && c + 7 <= end_col) {
+      unsigned int sads[8];
+      const MV start_mv = { r, c };
+      fn_ptr->sdx8f(src->buf, src->stride, get_buf_from_mv(pre, &start_mv),
+                    pre->stride, sads);
+
+      for (i = 0; i < 8; ++i) {
+        int64_t sad = (int64_t)sads[i] << LOG2_PRECISION;
+        if (sad < best_sad) {
+          const MV mv = { r, c + i };
+          sad +=
+              lambda * vp9_nb_mvs_inconsistency(&mv, nb_full_mvs, full_mv_num);
+          if (sad < best_sad) {
+            best_sad = sad;
+            *best_mv = mv;
+          }
+        }
+      }
+      c += 8;
+    }
     while (c + 3 <= end_col) {
       unsigned int sads[4];
       const uint8_t *addrs[4];
@@ -2286,6 +2327,20 @@ unsigned int vp9_int_pro_motion_estimation(const VP9_COMP *cpi, MACROBLOCK *x,
   const YV12_BUFFER_CONFIG *scaled_ref_frame =
       vp9_get_scaled_ref_frame(cpi, mi->ref_frame[0]);
   MvLimits subpel_mv_limits;
+  int use_zero_mv = 0;
+
+  if (cpi->border_in_pixels < VP9_ENC_BORDER_IN_PIXELS) {
+    // The search window reaches half a block, plus the refinement step, out
+    // of the block on each side; a small border may not hold all of it.
+    const int border = cpi->border_in_pixels;
+    const int x0 = mi_col * MI_SIZE - (bw >> 1) - 1;
+    const int y0 = mi_row * MI_SIZE - (bh >> 1) - 1;
+    const int x1 = x0 + search_width + 2;
+    const int y1 = y0 + search_height + 2;
+    use_zero_mv = x0 < -border || y0 < -border ||
+                  x1 > cpi->common.mi_cols * MI_SIZE + border ||
+                  y1 > cpi->common.mi_rows * MI_SIZE + border;
+  }
 
   if (scaled_ref_frame) {
     int i;
@@ -2299,7 +2354,9 @@ unsigned int vp9_int_pro_motion_estimation(const VP9_COMP *cpi, MACROBLOCK *x,
 #if CONFIG_VP9_HIGHBITDEPTH
   // TODO(jingning): Implement integral projection functions for high bit-depth
   // setting and remove this part of code.
-  if (xd->bd != 8) {
+  if (xd->bd != 8) use_zero_mv = 1;
+#endif
+  if (use_zero_mv) {
     const unsigned int sad = cpi->fn_ptr[bsize].sdf(
         x->plane[0].src.buf, src_stride, xd->plane[0].pre[0].buf, ref_stride);
     tmp_mv->row = 0;
@@ -2311,7 +2368,6 @@ unsigned int vp9_int_pro_motion_estimation(const VP9_COMP *cpi, MACROBLOCK *x,
     }
     return sad;
   }
-#endif
 
   // Set up prediction 1-D reference set
   ref_buf = xd->plane[0].pre[0].buf - (bw >> 1);
@@ -170,6 +170,7 @@ static int combined_motion_search(VP9_COMP *cpi, MACROBLOCK *x,
   int rv = 0;
   int cost_list[5];
   int search_subpel = 1;
+  int hash_mv = 0;
   const YV12_BUFFER_CONFIG *scaled_ref_frame =
       vp9_get_scaled_ref_frame(cpi, ref);
   if (scaled_ref_frame) {
@@ -204,13 +205,25 @@ static int combined_motion_search(VP9_COMP *cpi, MACROBLOCK *x,
   else
     center_mv = tmp_mv->as_mv;
 
-  if (x->sb_use_mv_part) {
+  if (!scaled_ref_frame &&
+      vp9_hash_motion_search(cpi, x, bsize, mi_row, mi_col, ref, &ref_mv,
+                             &tmp_mv->as_mv)) {
+    hash_mv = 1;
+  } else if (x->sb_use_mv_part) {
     tmp_mv->as_mv.row = x->sb_mvrow_part >> 3;
     tmp_mv->as_mv.col = x->sb_mvcol_part >> 3;
   } else {
-    vp9_full_pixel_search(
-        cpi, x, bsize, &mvp_full, step_param, cpi->sf.mv.search_method, sadpb,
-        cond_cost_list(cpi, cost_list), &center_mv, &tmp_mv->as_mv, INT_MAX, 0);
+    int this_step_param = step_param;
+    MV hint_mv;
+    if (get_motion_hint(cpi, ref, mi_row, mi_col, bsize, &hint_mv)) {
+      mvp_full.row = hint_mv.row >> 3;
+      mvp_full.col = hint_mv.col >> 3;
+      this_step_param = VPXMAX(step_param, MOTION_HINT_STEP_PARAM);
+    }
+    vp9_full_pixel_search(cpi, x, bsize, &mvp_full, this_step_param,
+                          cpi->sf.mv.search_method, sadpb,
+                          cond_cost_list(cpi, cost_list), &center_mv,
+                          &tmp_mv->as_mv, INT_MAX, 0);
   }
 
   x->mv_limits = tmp_mv_limits;
@@ -232,7 +245,10 @@ static int combined_motion_search(VP9_COMP *cpi, MACROBLOCK *x,
     if (mvp_full.row == 0 && mvp_full.col == 0) search_subpel = 0;
   }
 
-  if (rv && search_subpel) {
+  if (hash_mv) {
+    // The block moved by whole pixels, there is nothing to refine.
+    tmp_mv->as_mv = mvp_full;
+  } else if (rv && search_subpel) {
     SUBPEL_FORCE_STOP subpel_force_stop = cpi->sf.mv.subpel_force_stop;
     if (use_base_mv && cpi->sf.base_mv_aggressive) subpel_force_stop = HALF_PEL;
     if (cpi->sf.mv.enable_adaptive_subpel_force_stop) {
@@ -1614,7 +1630,15 @@ static int search_new_mv(VP9_COMP *cpi, MACROBLOCK *x,
         x->nmvjointcost, x->mvcost, &dis, &x->pred_sse[ref_frame], NULL, 0, 0,
         cpi->sf.use_accurate_subpel_search);
   } else if (svc->use_base_mv && svc->spatial_layer_id) {
-    if (frame_mv[NEWMV][ref_frame].as_int != INVALID_MV) {
+    const MV *const base_mv = &frame_mv[NEWMV][ref_frame].as_mv;
+    // With a small border the base layer mv may point past the reference.
+    const int base_mv_in_border =
+        cpi->border_in_pixels >= VP9_ENC_BORDER_IN_PIXELS ||
+        ((base_mv->row >> 3) >= x->mv_limits.row_min &&
+         (base_mv->row >> 3) <= x->mv_limits.row_max &&
+         (base_mv->col >> 3) >= x->mv_limits.col_min &&
+         (base_mv->col >> 3) <= x->mv_limits.col_max);
+    if (frame_mv[NEWMV][ref_frame].as_int != INVALID_MV && base_mv_in_border) {
       const int pre_stride = xd->plane[0].pre[0].stride;
       unsigned int base_mv_sse = UINT_MAX;
       int scale = (cpi->rc.avg_frame_low_motion > 60) ? 2 : 4;
@@ -1671,6 +1695,52 @@ static int search_new_mv(VP9_COMP *cpi, MACROBLOCK *x,
   return 0;
 }
 
+// Sums the sads of the 16x16 blocks of the superblock covered by the block for
+// each reference, see set_sb_ref_sad(). A block smaller than 16x16 takes the
+// sad of its 16x16 block. Returns the number of pixels the sums cover.
+static int get_sb_ref_sad(const VP9_COMMON *cm, const MACROBLOCK *x,
+                          int mi_row, int mi_col, BLOCK_SIZE bsize,
+                          unsigned int sad[MAX_REF_FRAMES]) {
+  const int sb_mi_row = mi_row & ~MI_MASK;
+  const int sb_mi_col = mi_col & ~MI_MASK;
+  const int row_start = (mi_row & MI_MASK) >> 1;
+  const int col_start = (mi_col & MI_MASK) >> 1;
+  const int row_end = VPXMIN(
+      ((mi_row & MI_MASK) + num_8x8_blocks_high_lookup[bsize] + 1) >> 1,
+      (cm->mi_rows - sb_mi_row + 1) >> 1);
+  const int col_end = VPXMIN(
+      ((mi_col & MI_MASK) + num_8x8_blocks_wide_lookup[bsize] + 1) >> 1,
+      (cm->mi_cols - sb_mi_col + 1) >> 1);
+  MV_REFERENCE_FRAME ref_frame;
+  int r, c;
+
+  for (ref_frame = LAST_FRAME; ref_frame <= ALTREF_FRAME; ++ref_frame) {
+    sad[ref_frame] = 0;
+    if (!(x->sb_ref_sad_refs & (1 << ref_frame))) continue;
+    for (r = row_start; r < row_end; ++r)
+      for (c = col_start; c < col_end; ++c)
+        sad[ref_frame] += x->sb_ref_sad[ref_frame][r * 4 + c];
+  }
+  return (row_end - row_start) * (col_end - col_start) * 16 * 16;
+}
+
+// Returns 1 if another reference the block can use has a sad lower than the
+// sad of ref_frame divided by 1 << shift.
+static int sb_sad_has_better_ref(const MACROBLOCK *x,
+                                 MV_REFERENCE_FRAME ref_frame,
+                                 MV_REFERENCE_FRAME usable_ref_frame,
+                                 const unsigned int sad[MAX_REF_FRAMES],
+                                 int shift) {
+  MV_REFERENCE_FRAME i;
+  if (!(x->sb_ref_sad_refs & (1 << ref_frame))) return 0;
+  for (i = LAST_FRAME; i <= usable_ref_frame; ++i) {
+    if (i != ref_frame && (x->sb_ref_sad_refs & (1 << i)) &&
+        sad[ref_frame] > ((uint64_t)sad[i] << shift))
+      return 1;
+  }
+  return 0;
+}
+
 static INLINE void init_best_pickmode(BEST_PICKMODE *bp) {
   bp->best_mode = ZEROMV;
   bp->best_ref_frame = LAST_FRAME;
@@ -1746,6 +1816,10 @@ void vp9_pick_inter_mode(VP9_COMP *cpi, MACROBLOCK *x, TileDataEnc *tile_data,
   int skip_ref_find_pred[4] = { 0 };
   unsigned int sse_zeromv_normalized = UINT_MAX;
   unsigned int best_sse_sofar = UINT_MAX;
+  unsigned int sb_ref_sad[MAX_REF_FRAMES];
+  int sb_sad_pixels = 0;
+  int sb_sad_prune_mask = 0;
+  int sb_sad_filter_skip_mask = 0;
   int gf_temporal_ref = 0;
   int force_test_gf_zeromv = 0;
 #if CONFIG_VP9_TEMPORAL_DENOISING
@@ -1988,11 +2062,34 @@ void vp9_pick_inter_mode(VP9_COMP *cpi, MACROBLOCK *x, TileDataEnc *tile_data,
     thresh_svc_skip_golden = 0;
   }
 
+  // The superblock sads are not used with compound modes, which need all the
+  // references set up, or when the segment forces the reference.
+  if (x->sb_ref_sad_refs && comp_modes == 0 && !cpi->rc.is_src_frame_alt_ref &&
+      !segfeature_active(seg, mi->segment_id, SEG_LVL_REF_FRAME)) {
+    sb_sad_pixels = get_sb_ref_sad(cm, x, mi_row, mi_col, bsize, sb_ref_sad);
+  }
+
   for (ref_frame = LAST_FRAME; ref_frame <= usable_ref_frame; ++ref_frame) {
     // Skip find_predictor if the reference frame is not in the
     // ref_frame_flags (i.e., not used as a reference for this frame).
     skip_ref_find_pred[ref_frame] =
         !(cpi->ref_frame_flags & ref_frame_to_flag(ref_frame));
+    if (!skip_ref_find_pred[ref_frame] && sb_sad_pixels) {
+      if (ref_frame != LAST_FRAME &&
+          sb_sad_has_better_ref(x, ref_frame, usable_ref_frame, sb_ref_sad,
+                                1)) {
+        // Prune a reference with more than twice the sad of another one, as
+        // reference_masking does with pred_mv_sad. LAST_FRAME is always kept.
+        skip_ref_find_pred[ref_frame] = 1;
+        sb_sad_prune_mask |= 1 << ref_frame;
+        ++x->sb_sad_ref_prunes;
+      } else if (sb_sad_has_better_ref(x, ref_frame, usable_ref_frame,
+                                       sb_ref_sad, 0)) {
+        // Another reference predicts the block better, so do not spend the
+        // interpolation filter search on this one.
+        sb_sad_filter_skip_mask |= 1 << ref_frame;
+      }
+    }
     if (!skip_ref_find_pred[ref_frame]) {
       find_predictors(cpi, x, ref_frame, frame_mv, const_motion,
                       &ref_frame_skip_mask, tile_data, mi_row, mi_col, yv12_mb,
@@ -2045,6 +2142,7 @@ void vp9_pick_inter_mode(VP9_COMP *cpi, MACROBLOCK *x, TileDataEnc *tile_data,
     int is_skippable;
     int this_early_term = 0;
     int rd_computed = 0;
+    int filter_search;
     int flag_preduv_computed[2] = { 0 };
     int inter_mv_mode = 0;
     int skip_this_mv = 0;
@@ -2197,7 +2295,8 @@ void vp9_pick_inter_mode(VP9_COMP *cpi, MACROBLOCK *x, TileDataEnc *tile_data,
         if (usable_ref_frame < ALTREF_FRAME) {
           if (!force_skip_low_temp_var && usable_ref_frame > LAST_FRAME) {
             i = (ref_frame == LAST_FRAME) ? GOLDEN_FRAME : LAST_FRAME;
-            if ((cpi->ref_frame_flags & ref_frame_to_flag(i)))
+            if ((cpi->ref_frame_flags & ref_frame_to_flag(i)) &&
+                !(sb_sad_prune_mask & (1 << i)))
               if (x->pred_mv_sad[ref_frame] > (x->pred_mv_sad[i] << 1))
                 ref_frame_skip_mask |= (1 << ref_frame);
           }
@@ -2207,8 +2306,10 @@ void vp9_pick_inter_mode(VP9_COMP *cpi, MACROBLOCK *x, TileDataEnc *tile_data,
           int ref1 = (ref_frame == GOLDEN_FRAME) ? LAST_FRAME : GOLDEN_FRAME;
           int ref2 = (ref_frame == ALTREF_FRAME) ? LAST_FRAME : ALTREF_FRAME;
           if (((cpi->ref_frame_flags & ref_frame_to_flag(ref1)) &&
+               !(sb_sad_prune_mask & (1 << ref1)) &&
                (x->pred_mv_sad[ref_frame] > (x->pred_mv_sad[ref1] << 1))) ||
               ((cpi->ref_frame_flags & ref_frame_to_flag(ref2)) &&
+               !(sb_sad_prune_mask & (1 << ref2)) &&
                (x->pred_mv_sad[ref_frame] > (x->pred_mv_sad[ref2] << 1))))
             ref_frame_skip_mask |= (1 << ref_frame);
         }
@@ -2304,12 +2405,19 @@ void vp9_pick_inter_mode(VP9_COMP *cpi, MACROBLOCK *x, TileDataEnc *tile_data,
       }
     }
 
-    if ((this_mode == NEWMV || filter_ref == SWITCHABLE) &&
+    filter_search =
+        (this_mode == NEWMV || filter_ref == SWITCHABLE) &&
         pred_filter_search &&
         (ref_frame == LAST_FRAME ||
          (ref_frame == GOLDEN_FRAME && !force_mv_inter_layer &&
           (cpi->use_svc || cpi->oxcf.rc_mode == VPX_VBR))) &&
-        (((mi->mv[0].as_mv.row | mi->mv[0].as_mv.col) & 0x07) != 0)) {
+        (((mi->mv[0].as_mv.row | mi->mv[0].as_mv.col) & 0x07) != 0);
+    if (filter_search && (sb_sad_filter_skip_mask & (1 << ref_frame))) {
+      filter_search = 0;
+      ++x->sb_sad_filter_skips;
+    }
+
+    if (filter_search) {
       rd_computed = 1;
       search_filter_ref(cpi, x, &this_rdc, mi_row, mi_col, tmp, bsize,
                         reuse_inter_pred, &this_mode_pred, &var_y, &sse_y,
@@ -11,6 +11,7 @@
 #include <assert.h>
 #include <math.h>
 #include <stdio.h>
+#include <string.h>
 
 #include "./vp9_rtcd.h"
 
@@ -91,49 +92,77 @@ static const uint8_t rd_thresh_block_size_factor[BLOCK_SIZES] = {
 
 static void fill_mode_costs(VP9_COMP *cpi) {
   const FRAME_CONTEXT *const fc = cpi->common.fc;
+  RD_COST_CACHE *const cache = &cpi->rd.cost_cache;
+  const int valid = cache->mode_costs_valid;
   int i, j;
 
-  for (i = 0; i < INTRA_MODES; ++i) {
-    for (j = 0; j < INTRA_MODES; ++j) {
-      vp9_cost_tokens(cpi->y_mode_costs[i][j], vp9_kf_y_mode_prob[i][j],
-                      vp9_intra_mode_tree);
+  // The key frame costs use fixed probabilities.
+  if (!valid) {
+    for (i = 0; i < INTRA_MODES; ++i) {
+      for (j = 0; j < INTRA_MODES; ++j) {
+        vp9_cost_tokens(cpi->y_mode_costs[i][j], vp9_kf_y_mode_prob[i][j],
+                        vp9_intra_mode_tree);
+      }
+      vp9_cost_tokens(cpi->intra_uv_mode_cost[KEY_FRAME][i],
+                      vp9_kf_uv_mode_prob[i], vp9_intra_mode_tree);
     }
   }
 
-  vp9_cost_tokens(cpi->mbmode_cost, fc->y_mode_prob[1], vp9_intra_mode_tree);
+  if (!valid || memcmp(cache->y_mode_prob, fc->y_mode_prob[1],
+                       sizeof(cache->y_mode_prob))) {
+    vp9_cost_tokens(cpi->mbmode_cost, fc->y_mode_prob[1], vp9_intra_mode_tree);
+    memcpy(cache->y_mode_prob, fc->y_mode_prob[1],
+           sizeof(cache->y_mode_prob));
+  }
   for (i = 0; i < INTRA_MODES; ++i) {
-    vp9_cost_tokens(cpi->intra_uv_mode_cost[KEY_FRAME][i],
-                    vp9_kf_uv_mode_prob[i], vp9_intra_mode_tree);
+    if (valid && !memcmp(cache->uv_mode_prob[i], fc->uv_mode_prob[i],
+                         sizeof(cache->uv_mode_prob[i])))
+      continue;
     vp9_cost_tokens(cpi->intra_uv_mode_cost[INTER_FRAME][i],
                     fc->uv_mode_prob[i], vp9_intra_mode_tree);
+    memcpy(cache->uv_mode_prob[i], fc->uv_mode_prob[i],
+           sizeof(cache->uv_mode_prob[i]));
   }
 
   for (i = 0; i < SWITCHABLE_FILTER_CONTEXTS; ++i) {
+    if (valid && !memcmp(cache->switchable_interp_prob[i],
+                         fc->switchable_interp_prob[i],
+                         sizeof(cache->switchable_interp_prob[i])))
+      continue;
     vp9_cost_tokens(cpi->switchable_interp_costs[i],
                     fc->switchable_interp_prob[i], vp9_switchable_interp_tree);
+    memcpy(cache->switchable_interp_prob[i], fc->switchable_interp_prob[i],
+           sizeof(cache->switchable_interp_prob[i]));
   }
 
-  for (i = TX_8X8; i < TX_SIZES; ++i) {
-    for (j = 0; j < TX_SIZE_CONTEXTS; ++j) {
-      const vpx_prob *tx_probs = get_tx_probs(i, j, &fc->tx_probs);
-      int k;
-      for (k = 0; k <= i; ++k) {
-        int cost = 0;
-        int m;
-        for (m = 0; m <= k - (k == i); ++m) {
-          if (m == k)
-            cost += vp9_cost_zero(tx_probs[m]);
-          else
-            cost += vp9_cost_one(tx_probs[m]);
+  if (!valid ||
+      memcmp(&cache->tx_probs, &fc->tx_probs, sizeof(cache->tx_probs))) {
+    for (i = TX_8X8; i < TX_SIZES; ++i) {
+      for (j = 0; j < TX_SIZE_CONTEXTS; ++j) {
+        const vpx_prob *tx_probs = get_tx_probs(i, j, &fc->tx_probs);
+        int k;
+        for (k = 0; k <= i; ++k) {
+          int cost = 0;
+          int m;
+          for (m = 0; m <= k - (k == i); ++m) {
+            if (m == k)
+              cost += vp9_cost_zero(tx_probs[m]);
+            else
+              cost += vp9_cost_one(tx_probs[m]);
+          }
+          cpi->tx_size_cost[i - 1][j][k] = cost;
         }
-        cpi->tx_size_cost[i - 1][j][k] = cost;
       }
     }
+    cache->tx_probs = fc->tx_probs;
   }
+
+  cache->mode_costs_valid = 1;
 }
 
 static void fill_token_costs(vp9_coeff_cost *c,
-                             vp9_coeff_probs_model (*p)[PLANE_TYPES]) {
+                             vp9_coeff_probs_model (*p)[PLANE_TYPES],
+                             RD_COST_CACHE *cache) {
   int i, j, k, l;
   TX_SIZE t;
   for (t = TX_4X4; t <= TX_32X32; ++t)
@@ -142,13 +171,51 @@ static void fill_token_costs(vp9_coeff_cost *c,
         for (k = 0; k < COEF_BANDS; ++k)
           for (l = 0; l < BAND_COEFF_CONTEXTS(k); ++l) {
             vpx_prob probs[ENTROPY_NODES];
+            if (cache->coef_costs_valid &&
+                !memcmp(cache->coef_probs[t][i][j][k][l], p[t][i][j][k][l],
+                        sizeof(cache->coef_probs[t][i][j][k][l])))
+              continue;
             vp9_model_to_full_probs(p[t][i][j][k][l], probs);
             vp9_cost_tokens((int *)c[t][i][j][k][0][l], probs, vp9_coef_tree);
             vp9_cost_tokens_skip((int *)c[t][i][j][k][1][l], probs,
                                  vp9_coef_tree);
             assert(c[t][i][j][k][0][l][EOB_TOKEN] ==
                    c[t][i][j][k][1][l][EOB_TOKEN]);
+            memcpy(cache->coef_probs[t][i][j][k][l], p[t][i][j][k][l],
+                   sizeof(cache->coef_probs[t][i][j][k][l]));
           }
+  cache->coef_costs_valid = 1;
+}
+
+static void fill_partition_costs(VP9_COMP *cpi, const MACROBLOCKD *xd) {
+  RD_COST_CACHE *const cache = &cpi->rd.cost_cache;
+  int i;
+  for (i = 0; i < PARTITION_CONTEXTS; ++i) {
+    const vpx_prob *const probs = get_partition_probs(xd, i);
+    if (cache->partition_costs_valid &&
+        !memcmp(cache->partition_prob[i], probs,
+                sizeof(cache->partition_prob[i])))
+      continue;
+    vp9_cost_tokens(cpi->partition_cost[i], probs, vp9_partition_tree);
+    memcpy(cache->partition_prob[i], probs, sizeof(cache->partition_prob[i]));
+  }
+  cache->partition_costs_valid = 1;
+}
+
+static void fill_nmv_costs(VP9_COMP *cpi) {
+  const VP9_COMMON *const cm = &cpi->common;
+  MACROBLOCK *const x = &cpi->td.mb;
+  RD_COST_CACHE *const cache = &cpi->rd.cost_cache;
+  if (cache->nmv_costs_valid &&
+      cache->nmv_allow_hp == cm->allow_high_precision_mv &&
+      !memcmp(&cache->nmvc, &cm->fc->nmvc, sizeof(cache->nmvc)))
+    return;
+  vp9_build_nmv_cost_table(
+      x->nmvjointcost, cm->allow_high_precision_mv ? x->nmvcost_hp : x->nmvcost,
+      &cm->fc->nmvc, cm->allow_high_precision_mv);
+  cache->nmvc = cm->fc->nmvc;
+  cache->nmv_allow_hp = cm->allow_high_precision_mv;
+  cache->nmv_costs_valid = 1;
 }
 
 // Values are now correlated to quantizer.
@@ -386,11 +453,19 @@ static void set_block_thresholds(const VP9_COMMON *cm, RD_OPT *rd) {
 
 void vp9_build_inter_mode_cost(VP9_COMP *cpi) {
   const VP9_COMMON *const cm = &cpi->common;
+  RD_COST_CACHE *const cache = &cpi->rd.cost_cache;
   int i;
   for (i = 0; i < INTER_MODE_CONTEXTS; ++i) {
+    if (cache->inter_mode_costs_valid &&
+        !memcmp(cache->inter_mode_probs[i], cm->fc->inter_mode_probs[i],
+                sizeof(cache->inter_mode_probs[i])))
+      continue;
     vp9_cost_tokens((int *)cpi->inter_mode_cost[i], cm->fc->inter_mode_probs[i],
                     vp9_inter_mode_tree);
+    memcpy(cache->inter_mode_probs[i], cm->fc->inter_mode_probs[i],
+           sizeof(cache->inter_mode_probs[i]));
   }
+  cache->inter_mode_costs_valid = 1;
 }
 
 void vp9_initialize_rd_consts(VP9_COMP *cpi) {
@@ -398,7 +473,6 @@ void vp9_initialize_rd_consts(VP9_COMP *cpi) {
   MACROBLOCK *const x = &cpi->td.mb;
   MACROBLOCKD *const xd = &cpi->td.mb.e_mbd;
   RD_OPT *const rd = &cpi->rd;
-  int i;
 
   vpx_clear_system_state();
 
@@ -415,32 +489,31 @@ void vp9_initialize_rd_consts(VP9_COMP *cpi) {
   set_block_thresholds(cm, rd);
   set_partition_probs(cm, xd);
 
+  // The cost tables only depend on the probabilities, so each of them keeps
+  // the entries whose probabilities did not change since it was last built.
+  if (rd->cost_cache.disabled) {
+    rd->cost_cache.coef_costs_valid = 0;
+    rd->cost_cache.mode_costs_valid = 0;
+    rd->cost_cache.partition_costs_valid = 0;
+    rd->cost_cache.inter_mode_costs_valid = 0;
+    rd->cost_cache.nmv_costs_valid = 0;
+  }
   if (cpi->oxcf.pass == 1) {
-    if (!frame_is_intra_only(cm))
-      vp9_build_nmv_cost_table(
-          x->nmvjointcost,
-          cm->allow_high_precision_mv ? x->nmvcost_hp : x->nmvcost,
-          &cm->fc->nmvc, cm->allow_high_precision_mv);
+    if (!frame_is_intra_only(cm)) fill_nmv_costs(cpi);
   } else {
     if (!cpi->sf.use_nonrd_pick_mode || cm->frame_type == KEY_FRAME)
-      fill_token_costs(x->token_costs, cm->fc->coef_probs);
+      fill_token_costs(x->token_costs, cm->fc->coef_probs, &rd->cost_cache);
 
     if (cpi->sf.partition_search_type != VAR_BASED_PARTITION ||
-        cm->frame_type == KEY_FRAME) {
-      for (i = 0; i < PARTITION_CONTEXTS; ++i)
-        vp9_cost_tokens(cpi->partition_cost[i], get_partition_probs(xd, i),
-                        vp9_partition_tree);
-    }
+        cm->frame_type == KEY_FRAME)
+      fill_partition_costs(cpi, xd);
 
     if (!cpi->sf.use_nonrd_pick_mode || (cm->current_video_frame & 0x07) == 1 ||
         cm->frame_type == KEY_FRAME) {
       fill_mode_costs(cpi);
 
       if (!frame_is_intra_only(cm)) {
-        vp9_build_nmv_cost_table(
-            x->nmvjointcost,
-            cm->allow_high_precision_mv ? x->nmvcost_hp : x->nmvcost,
-            &cm->fc->nmvc, cm->allow_high_precision_mv);
+        fill_nmv_costs(cpi);
         vp9_build_inter_mode_cost(cpi);
       }
     }
@@ -620,6 +693,12 @@ void vp9_mv_pred(VP9_COMP *cpi, MACROBLOCK *x, uint8_t *ref_y_buffer,
 
     if (fp_row == 0 && fp_col == 0 && zero_seen) continue;
     zero_seen |= (fp_row == 0 && fp_col == 0);
+    // With a small border the candidate may point past the reference. The
+    // pixels there repeat the frame edge, so measure the nearest block within.
+    if (cpi->border_in_pixels < VP9_ENC_BORDER_IN_PIXELS) {
+      fp_row = clamp(fp_row, x->mv_limits.row_min, x->mv_limits.row_max);
+      fp_col = clamp(fp_col, x->mv_limits.col_min, x->mv_limits.col_max);
+    }
 
     ref_y_ptr = &ref_y_buffer[ref_y_stride * fp_row + fp_col];
     // Find sad for current vector.
@@ -108,6 +108,29 @@ typedef struct {
   double rd_mult_key_qp_fac;
 } RD_CONTROL;
 
+// Probabilities the rate cost tables were last built from. Only the entries
+// whose probabilities changed are rebuilt, see vp9_initialize_rd_consts().
+typedef struct RD_COST_CACHE {
+  vp9_coeff_probs_model coef_probs[TX_SIZES][PLANE_TYPES];
+  vpx_prob y_mode_prob[INTRA_MODES - 1];
+  vpx_prob uv_mode_prob[INTRA_MODES][INTRA_MODES - 1];
+  vpx_prob switchable_interp_prob[SWITCHABLE_FILTER_CONTEXTS]
+                                 [SWITCHABLE_FILTERS - 1];
+  struct tx_probs tx_probs;
+  vpx_prob partition_prob[PARTITION_CONTEXTS][PARTITION_TYPES - 1];
+  vpx_prob inter_mode_probs[INTER_MODE_CONTEXTS][INTER_MODES - 1];
+  nmv_context nmvc;
+  int nmv_allow_hp;
+  // Set once the corresponding tables have been built.
+  int coef_costs_valid;
+  int mode_costs_valid;
+  int partition_costs_valid;
+  int inter_mode_costs_valid;
+  int nmv_costs_valid;
+  // Rebuild every table on each frame, see VP9E_SET_DISABLE_RD_COST_CACHE.
+  int disabled;
+} RD_COST_CACHE;
+
 typedef struct RD_OPT {
   // Thresh_mult is used to set a threshold for the rd score. A higher value
   // means that we will accept the best mode so far more often. This number
@@ -127,6 +150,8 @@ typedef struct RD_OPT {
   int RDMULT;
   int RDDIV;
   double r0;
+
+  RD_COST_CACHE cost_cache;
 } RD_OPT;
 
 typedef struct RD_COST {
@@ -2580,6 +2580,7 @@ static void single_motion_search(VP9_COMP *cpi, MACROBLOCK *x, BLOCK_SIZE bsize,
   const int pw = num_4x4_blocks_wide_lookup[bsize] << 2;
   const int ph = num_4x4_blocks_high_lookup[bsize] << 2;
   MV pred_mv[3];
+  int has_hint = 0;
 
   int bestsme = INT_MAX;
 #if CONFIG_NON_GREEDY_MV
@@ -2662,7 +2663,30 @@ static void single_motion_search(VP9_COMP *cpi, MACROBLOCK *x, BLOCK_SIZE bsize,
   // after full-pixel motion search.
   vp9_set_mv_search_range(&x->mv_limits, &ref_mv);
 
-  mvp_full = pred_mv[best_predmv_idx];
+  if (!scaled_ref_frame &&
+      vp9_hash_motion_search(cpi, x, bsize, mi_row, mi_col, ref, &ref_mv,
+                             &tmp_mv->as_mv)) {
+    // The block moved by whole pixels, there is nothing to refine.
+    const struct buf_2d *const pre = &xd->plane[0].pre[0];
+    cpi->fn_ptr[bsize].vf(
+        x->plane[0].src.buf, x->plane[0].src.stride,
+        pre->buf + tmp_mv->as_mv.row * pre->stride + tmp_mv->as_mv.col,
+        pre->stride, &x->pred_sse[ref]);
+    x->mv_limits = tmp_mv_limits;
+    tmp_mv->as_mv.row *= 8;
+    tmp_mv->as_mv.col *= 8;
+    *rate_mv = vp9_mv_bit_cost(&tmp_mv->as_mv, &ref_mv, x->nmvjointcost,
+                               x->mvcost, MV_COST_WEIGHT);
+    x->pred_mv[ref] = tmp_mv->as_mv;
+    return;
+  }
+
+  if (get_motion_hint(cpi, ref, mi_row, mi_col, bsize, &mvp_full)) {
+    has_hint = 1;
+    step_param = VPXMAX(step_param, MOTION_HINT_STEP_PARAM);
+  } else {
+    mvp_full = pred_mv[best_predmv_idx];
+  }
   mvp_full.col >>= 3;
   mvp_full.row >>= 3;
 
@@ -2676,7 +2700,7 @@ static void single_motion_search(VP9_COMP *cpi, MACROBLOCK *x, BLOCK_SIZE bsize,
       cond_cost_list(cpi, cost_list), &ref_mv, &tmp_mv->as_mv, INT_MAX, 1);
 #endif  // CONFIG_NON_GREEDY_MV
 
-  if (cpi->sf.enhanced_full_pixel_motion_search) {
+  if (cpi->sf.enhanced_full_pixel_motion_search && !has_hint) {
     int i;
     for (i = 0; i < 3; ++i) {
       int this_me;
@@ -309,6 +309,7 @@ static void set_good_speed_feature_framesize_independent(VP9_COMP *cpi,
 
     sf->recode_tolerance_low = 15;
     sf->recode_tolerance_high = 30;
+    sf->recode_reuse_partition = 1;
 
     sf->exhaustive_searches_thresh =
         (cpi->twopass.fr_content_type == FC_GRAPHICS_ANIMATION) ? (1 << 23)
@@ -480,6 +481,7 @@ static void set_rt_speed_feature_framesize_independent(
   sf->cb_pred_filter_search = 0;
   sf->force_smooth_interpol = 0;
   sf->rt_intra_dc_only_low_content = 0;
+  sf->rt_sb_ref_sad = 0;
   sf->mv.enable_adaptive_subpel_force_stop = 0;
 
   if (speed >= 1) {
@@ -746,6 +748,7 @@ static void set_rt_speed_feature_framesize_independent(
         svc->temporal_layer_id > 0)
       cpi->ref_frame_flags &= (~VP9_GOLD_FLAG);
     if (cm->width * cm->height > 640 * 480) sf->cb_pred_filter_search = 2;
+    if (!cpi->use_svc) sf->rt_sb_ref_sad = 1;
   }
 
   if (speed >= 8) {
@@ -934,6 +937,7 @@ void vp9_set_speed_features_framesize_independent(VP9_COMP *cpi, int speed) {
   sf->mv.auto_mv_step_size = 0;
   sf->mv.fullpel_search_step_param = 6;
   sf->mv.use_downsampled_sad = 0;
+  sf->mv.use_hash_search = oxcf->content == VP9E_CONTENT_SCREEN;
   sf->comp_inter_joint_search_iter_level = 0;
   sf->tx_size_search_method = USE_FULL_RD;
   sf->use_lp32x32fdct = 0;
@@ -1002,6 +1006,7 @@ void vp9_set_speed_features_framesize_independent(VP9_COMP *cpi, int speed) {
   // Recode loop tolerance %.
   sf->recode_tolerance_low = 12;
   sf->recode_tolerance_high = 25;
+  sf->recode_reuse_partition = 0;
   sf->default_interp_filter = SWITCHABLE;
   sf->simple_model_rd_from_var = 0;
   sf->short_circuit_flat_blocks = 0;
@@ -214,6 +214,10 @@ typedef struct MV_SPEED_FEATURES {
   // Whether to downsample the rows in sad calculation during motion search.
   // This is only active when there are at least 8 rows.
   int use_downsampled_sad;
+
+  // Look up exact matches of the block in a hash table of each reference
+  // before searching around the predicted motion vector, for screen content.
+  int use_hash_search;
 } MV_SPEED_FEATURES;
 
 typedef struct PARTITION_SEARCH_BREAKOUT_THR {
@@ -512,6 +516,10 @@ typedef struct SPEED_FEATURES {
   int recode_tolerance_low;
   int recode_tolerance_high;
 
+  // When a frame is recoded at the same size, keep the partitioning chosen by
+  // the previous iteration and only search the modes of its blocks again.
+  int recode_reuse_partition;
+
   // This variable controls the maximum block size where intra blocks can be
   // used in inter frames.
   // TODO(aconverse): Fold this into one of the other many mode skips
@@ -653,6 +661,11 @@ typedef struct SPEED_FEATURES {
   // does not have high souce SAD.
   int rt_intra_dc_only_low_content;
 
+  // For real-time mode: compute the sad of the 16x16 blocks of each
+  // superblock against each reference, and use it to prune references and
+  // the interpolation filter search in the non-rd mode decision.
+  int rt_sb_ref_sad;
+
   // The encoder has a feature that skips forward transform and quantization
   // based on a model rd estimation to reduce encoding time.
   // However, this feature is dangerous since it could lead to bad perceptual
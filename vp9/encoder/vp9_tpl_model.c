@@ -53,7 +53,7 @@ static int init_gop_frames(VP9_COMP *cpi, GF_PICTURE *gf_picture,
 #if CONFIG_VP9_HIGHBITDEPTH
                                    cm->use_highbitdepth,
 #endif
-                                   VP9_ENC_BORDER_IN_PIXELS, cm->byte_alignment,
+                                   cpi->border_in_pixels, cm->byte_alignment,
                                    NULL, NULL, NULL))
         vpx_internal_error(&cm->error, VPX_CODEC_MEM_ERROR,
                            "Failed to allocate frame buffer");
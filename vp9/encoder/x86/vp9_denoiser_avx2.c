@@ -0,0 +1,218 @@
+/*
+ *  Copyright (c) 2024 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <immintrin.h>
+
+#include "./vpx_config.h"
+#include "./vp9_rtcd.h"
+
+#include "vpx/vpx_integer.h"
+#include "vp9/common/vp9_reconinter.h"
+#include "vp9/encoder/vp9_context_tree.h"
+#include "vp9/encoder/vp9_denoiser.h"
+
+// Each register holds 32 pixels of the block: one row of 32 for blocks at
+// least 32 wide, two rows of 16 or four rows of 8 otherwise. The per pixel
+// adjustments are accumulated in signed bytes and folded into the total every
+// FLUSH_ROWS register rows, before they can saturate.
+#define FLUSH_ROWS 4
+
+typedef struct {
+  __m256i k_4, k_8, k_16;
+  __m256i l3, l32, l21;
+} denoiser_consts;
+
+static INLINE __m256i load_chunk(const uint8_t *p, int stride, int width) {
+  if (width >= 32) return _mm256_loadu_si256((const __m256i *)p);
+  if (width == 16) {
+    return _mm256_inserti128_si256(
+        _mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)p)),
+        _mm_loadu_si128((const __m128i *)(p + stride)), 1);
+  }
+  return _mm256_inserti128_si256(
+      _mm256_castsi128_si256(
+          _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i *)p),
+                             _mm_loadl_epi64((const __m128i *)(p + stride)))),
+      _mm_unpacklo_epi64(
+          _mm_loadl_epi64((const __m128i *)(p + 2 * stride)),
+          _mm_loadl_epi64((const __m128i *)(p + 3 * stride))),
+      1);
+}
+
+static INLINE void store_chunk(uint8_t *p, int stride, int width,
+                               const __m256i v) {
+  const __m128i lo = _mm256_castsi256_si128(v);
+  const __m128i hi = _mm256_extracti128_si256(v, 1);
+  if (width >= 32) {
+    _mm256_storeu_si256((__m256i *)p, v);
+  } else if (width == 16) {
+    _mm_storeu_si128((__m128i *)p, lo);
+    _mm_storeu_si128((__m128i *)(p + stride), hi);
+  } else {
+    _mm_storel_epi64((__m128i *)p, lo);
+    _mm_storel_epi64((__m128i *)(p + stride), _mm_srli_si128(lo, 8));
+    _mm_storel_epi64((__m128i *)(p + 2 * stride), hi);
+    _mm_storel_epi64((__m128i *)(p + 3 * stride), _mm_srli_si128(hi, 8));
+  }
+}
+
+// Adds the signed bytes of |acc_diff| to |sum|, as 64-bit partial sums biased
+// by 128 per byte.
+static INLINE __m256i flush_acc_diff(const __m256i acc_diff,
+                                     const __m256i sum) {
+  const __m256i biased = _mm256_xor_si256(acc_diff, _mm256_set1_epi8(-128));
+  return _mm256_add_epi64(sum,
+                          _mm256_sad_epu8(biased, _mm256_setzero_si256()));
+}
+
+static INLINE int sum_diff(const __m256i sum, int num_flushes) {
+  // The biased total of a 64x64 block still fits in the low 32 bits.
+  __m128i s = _mm_add_epi64(_mm256_castsi256_si128(sum),
+                            _mm256_extracti128_si256(sum, 1));
+  s = _mm_add_epi64(s, _mm_srli_si128(s, 8));
+  return _mm_cvtsi128_si32(s) - num_flushes * 32 * 128;
+}
+
+// Same as vp9_denoiser_16x1_sse2(), for 32 pixels.
+static INLINE __m256i denoiser_32(const uint8_t *sig, int sig_stride,
+                                  const uint8_t *mc_avg, int mc_avg_stride,
+                                  uint8_t *avg, int avg_stride, int width,
+                                  const denoiser_consts *k, __m256i acc_diff) {
+  const __m256i v_sig = load_chunk(sig, sig_stride, width);
+  const __m256i v_mc_avg = load_chunk(mc_avg, mc_avg_stride, width);
+  const __m256i pdiff = _mm256_subs_epu8(v_mc_avg, v_sig);
+  const __m256i ndiff = _mm256_subs_epu8(v_sig, v_mc_avg);
+  // FF where the difference is negative.
+  const __m256i diff_sign = _mm256_cmpeq_epi8(pdiff, _mm256_setzero_si256());
+  // Clamping to 16 lets the level masks use the signed byte compares.
+  const __m256i clamped_absdiff =
+      _mm256_min_epu8(_mm256_or_si256(pdiff, ndiff), k->k_16);
+  const __m256i mask2 = _mm256_cmpgt_epi8(k->k_16, clamped_absdiff);
+  const __m256i mask1 = _mm256_cmpgt_epi8(k->k_8, clamped_absdiff);
+  const __m256i mask0 = _mm256_cmpgt_epi8(k->k_4, clamped_absdiff);
+  const __m256i adj2 = _mm256_add_epi8(_mm256_and_si256(mask2, k->l32),
+                                       _mm256_and_si256(mask1, k->l21));
+  __m256i adj = _mm256_sub_epi8(k->l3, adj2);
+  __m256i padj, nadj, v_avg;
+
+  adj = _mm256_or_si256(_mm256_andnot_si256(mask0, adj),
+                        _mm256_and_si256(mask0, clamped_absdiff));
+  padj = _mm256_andnot_si256(diff_sign, adj);
+  nadj = _mm256_and_si256(diff_sign, adj);
+
+  v_avg = _mm256_subs_epu8(_mm256_adds_epu8(v_sig, padj), nadj);
+  store_chunk(avg, avg_stride, width, v_avg);
+
+  acc_diff = _mm256_adds_epi8(acc_diff, padj);
+  return _mm256_subs_epi8(acc_diff, nadj);
+}
+
+// Same as vp9_denoiser_adj_16x1_sse2(), for 32 pixels.
+static INLINE __m256i denoiser_adj_32(const uint8_t *sig, int sig_stride,
+                                      const uint8_t *mc_avg, int mc_avg_stride,
+                                      uint8_t *avg, int avg_stride, int width,
+                                      const __m256i k_delta,
+                                      __m256i acc_diff) {
+  const __m256i v_sig = load_chunk(sig, sig_stride, width);
+  const __m256i v_mc_avg = load_chunk(mc_avg, mc_avg_stride, width);
+  const __m256i pdiff = _mm256_subs_epu8(v_mc_avg, v_sig);
+  const __m256i ndiff = _mm256_subs_epu8(v_sig, v_mc_avg);
+  const __m256i diff_sign = _mm256_cmpeq_epi8(pdiff, _mm256_setzero_si256());
+  const __m256i adj = _mm256_min_epu8(_mm256_or_si256(pdiff, ndiff), k_delta);
+  const __m256i padj = _mm256_andnot_si256(diff_sign, adj);
+  const __m256i nadj = _mm256_and_si256(diff_sign, adj);
+  __m256i v_avg = load_chunk(avg, avg_stride, width);
+
+  v_avg = _mm256_adds_epu8(_mm256_subs_epu8(v_avg, padj), nadj);
+  store_chunk(avg, avg_stride, width, v_avg);
+
+  acc_diff = _mm256_subs_epi8(acc_diff, padj);
+  return _mm256_adds_epi8(acc_diff, nadj);
+}
+
+int vp9_denoiser_filter_avx2(const uint8_t *sig, int sig_stride,
+                             const uint8_t *mc_avg, int mc_avg_stride,
+                             uint8_t *avg, int avg_stride,
+                             int increase_denoising, BLOCK_SIZE bs,
+                             int motion_magnitude) {
+  const int shift_inc =
+      (increase_denoising && motion_magnitude <= MOTION_MAGNITUDE_THRESHOLD)
+          ? 1
+          : 0;
+  const int b_width = 4 << b_width_log2_lookup[bs];
+  const int b_height = 4 << b_height_log2_lookup[bs];
+  // Block rows covered by one register row.
+  const int rows = b_width >= 32 ? 1 : 32 / b_width;
+  const int sum_diff_thresh = total_adj_strong_thresh(bs, increase_denoising);
+  denoiser_consts k;
+  __m256i acc_diff = _mm256_setzero_si256();
+  __m256i sum = _mm256_setzero_si256();
+  int num_flushes = 0;
+  int total_adj;
+  int r, c;
+
+  if (b_width < 8 || b_height < 8) return COPY_BLOCK;
+
+  k.k_4 = _mm256_set1_epi8(4 + shift_inc);
+  k.k_8 = _mm256_set1_epi8(8);
+  k.k_16 = _mm256_set1_epi8(16);
+  // Modify each level's adjustment according to motion_magnitude.
+  k.l3 = _mm256_set1_epi8(
+      (motion_magnitude <= MOTION_MAGNITUDE_THRESHOLD) ? 7 + shift_inc : 6);
+  // Difference between level 3 and level 2 is 2.
+  k.l32 = _mm256_set1_epi8(2);
+  // Difference between level 2 and level 1 is 1.
+  k.l21 = _mm256_set1_epi8(1);
+
+  for (r = 0; r < b_height; r += rows) {
+    for (c = 0; c < b_width; c += 32) {
+      acc_diff = denoiser_32(sig + r * sig_stride + c, sig_stride,
+                             mc_avg + r * mc_avg_stride + c, mc_avg_stride,
+                             avg + r * avg_stride + c, avg_stride, b_width, &k,
+                             acc_diff);
+    }
+    if ((r / rows) % FLUSH_ROWS == FLUSH_ROWS - 1 || r + rows == b_height) {
+      sum = flush_acc_diff(acc_diff, sum);
+      acc_diff = _mm256_setzero_si256();
+      ++num_flushes;
+    }
+  }
+
+  total_adj = sum_diff(sum, num_flushes);
+  if (abs(total_adj) > sum_diff_thresh) {
+    // Before giving up on the block, try a weaker filter that pulls the
+    // result back towards the source by at most delta per pixel. See
+    // vp9_denoiser_NxM_sse2_small().
+    const int delta =
+        ((abs(total_adj) - sum_diff_thresh) >> num_pels_log2_lookup[bs]) + 1;
+    __m256i k_delta;
+
+    if (delta >= 4) return COPY_BLOCK;
+
+    k_delta = _mm256_set1_epi8(delta);
+    for (r = 0; r < b_height; r += rows) {
+      for (c = 0; c < b_width; c += 32) {
+        acc_diff = denoiser_adj_32(
+            sig + r * sig_stride + c, sig_stride,
+            mc_avg + r * mc_avg_stride + c, mc_avg_stride,
+            avg + r * avg_stride + c, avg_stride, b_width, k_delta, acc_diff);
+      }
+      if ((r / rows) % FLUSH_ROWS == FLUSH_ROWS - 1 || r + rows == b_height) {
+        sum = flush_acc_diff(acc_diff, sum);
+        acc_diff = _mm256_setzero_si256();
+        ++num_flushes;
+      }
+    }
+
+    total_adj = sum_diff(sum, num_flushes);
+    if (abs(total_adj) > sum_diff_thresh) return COPY_BLOCK;
+  }
+  return FILTER_BLOCK;
+}
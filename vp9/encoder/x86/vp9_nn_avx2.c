@@ -0,0 +1,127 @@
+/*
+ *  Copyright (c) 2024 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <assert.h>
+#include <immintrin.h>
+
+#include "./vp9_rtcd.h"
+#include "vpx_dsp/vpx_dsp_common.h"
+#include "vpx_ports/mem.h"
+#include "vp9/encoder/vp9_nn.h"
+
+// Each lane computes one node of a layer and adds the products of its weights
+// with the inputs one input at a time, in the order of vp9_nn_predict_c(), so
+// the output is bit-exact with it.
+
+// Selects the first n (0 to 8) lanes.
+static INLINE __m256i partial_mask(int n) {
+  static const int32_t kMask[16] = { -1, -1, -1, -1, -1, -1, -1, -1,
+                                     0,  0,  0,  0,  0,  0,  0,  0 };
+  return _mm256_loadu_si256((const __m256i *)(kMask + 8 - n));
+}
+
+// Loads the first n floats of p and clears the other lanes, without reading
+// past p[n - 1].
+static INLINE __m256 load_partial(const float *p, int n) {
+  return _mm256_maskload_ps(p, partial_mask(n));
+}
+
+// Transposes the 8x8 block of floats in r[0] to r[7], so that r[k] holds
+// element k of each of the input rows.
+static INLINE void transpose_8x8(__m256 *r) {
+  const __m256 t0 = _mm256_unpacklo_ps(r[0], r[1]);
+  const __m256 t1 = _mm256_unpackhi_ps(r[0], r[1]);
+  const __m256 t2 = _mm256_unpacklo_ps(r[2], r[3]);
+  const __m256 t3 = _mm256_unpackhi_ps(r[2], r[3]);
+  const __m256 t4 = _mm256_unpacklo_ps(r[4], r[5]);
+  const __m256 t5 = _mm256_unpackhi_ps(r[4], r[5]);
+  const __m256 t6 = _mm256_unpacklo_ps(r[6], r[7]);
+  const __m256 t7 = _mm256_unpackhi_ps(r[6], r[7]);
+  const __m256 u0 = _mm256_shuffle_ps(t0, t2, 0x44);
+  const __m256 u1 = _mm256_shuffle_ps(t0, t2, 0xee);
+  const __m256 u2 = _mm256_shuffle_ps(t1, t3, 0x44);
+  const __m256 u3 = _mm256_shuffle_ps(t1, t3, 0xee);
+  const __m256 u4 = _mm256_shuffle_ps(t4, t6, 0x44);
+  const __m256 u5 = _mm256_shuffle_ps(t4, t6, 0xee);
+  const __m256 u6 = _mm256_shuffle_ps(t5, t7, 0x44);
+  const __m256 u7 = _mm256_shuffle_ps(t5, t7, 0xee);
+  r[0] = _mm256_permute2f128_ps(u0, u4, 0x20);
+  r[1] = _mm256_permute2f128_ps(u1, u5, 0x20);
+  r[2] = _mm256_permute2f128_ps(u2, u6, 0x20);
+  r[3] = _mm256_permute2f128_ps(u3, u7, 0x20);
+  r[4] = _mm256_permute2f128_ps(u0, u4, 0x31);
+  r[5] = _mm256_permute2f128_ps(u1, u5, 0x31);
+  r[6] = _mm256_permute2f128_ps(u2, u6, 0x31);
+  r[7] = _mm256_permute2f128_ps(u3, u7, 0x31);
+}
+
+// Fully connected layer, eight nodes at a time. The weights of each node are
+// read eight inputs at a time and transposed, so that the products can be
+// added in input order. Nodes past num_outputs read the zero weights.
+static void predict_layer(const float *input, int num_inputs,
+                          const float *weights, const float *bias,
+                          int num_outputs, int relu, float *output) {
+  static const float kZeros[NN_MAX_NODES_PER_LAYER] = { 0 };
+  int node, i, j, k;
+
+  assert(num_inputs > 0 && num_inputs <= NN_MAX_NODES_PER_LAYER);
+  for (node = 0; node < num_outputs; node += 8) {
+    const int num_nodes = VPXMIN(num_outputs - node, 8);
+    const float *rows[8];
+    __m256 acc = _mm256_setzero_ps();
+    __m256 w[8];
+
+    for (j = 0; j < 8; ++j) {
+      rows[j] = j < num_nodes ? weights + (node + j) * num_inputs : kZeros;
+    }
+    for (i = 0; i + 8 <= num_inputs; i += 8) {
+      for (j = 0; j < 8; ++j) w[j] = _mm256_loadu_ps(rows[j] + i);
+      transpose_8x8(w);
+      for (k = 0; k < 8; ++k) {
+        acc = _mm256_add_ps(acc,
+                            _mm256_mul_ps(w[k], _mm256_set1_ps(input[i + k])));
+      }
+    }
+    if (i < num_inputs) {
+      const int tail = num_inputs - i;
+      for (j = 0; j < 8; ++j) w[j] = load_partial(rows[j] + i, tail);
+      transpose_8x8(w);
+      for (k = 0; k < tail; ++k) {
+        acc = _mm256_add_ps(acc,
+                            _mm256_mul_ps(w[k], _mm256_set1_ps(input[i + k])));
+      }
+    }
+
+    acc = _mm256_add_ps(acc, load_partial(bias + node, num_nodes));
+    if (relu) acc = _mm256_max_ps(acc, _mm256_setzero_ps());
+    _mm256_maskstore_ps(output + node, partial_mask(num_nodes), acc);
+  }
+}
+
+void vp9_nn_predict_avx2(const float *features, const NN_CONFIG *nn_config,
+                         float *output) {
+  DECLARE_ALIGNED(32, float, buf[2][NN_MAX_NODES_PER_LAYER]);
+  const int num_layers = nn_config->num_hidden_layers;
+  const float *input = features;
+  int num_inputs = nn_config->num_inputs;
+  int layer;
+
+  assert(num_layers <= NN_MAX_HIDDEN_LAYERS);
+  for (layer = 0; layer < num_layers; ++layer) {
+    const int num_nodes = nn_config->num_hidden_nodes[layer];
+    assert(num_nodes < NN_MAX_NODES_PER_LAYER);
+    predict_layer(input, num_inputs, nn_config->weights[layer],
+                  nn_config->bias[layer], num_nodes, 1, buf[layer & 1]);
+    input = buf[layer & 1];
+    num_inputs = num_nodes;
+  }
+  predict_layer(input, num_inputs, nn_config->weights[num_layers],
+                nn_config->bias[num_layers], nn_config->num_outputs, 0, output);
+}
@@ -68,6 +68,9 @@ typedef struct vp9_extracfg {
   unsigned int row_mt;
   unsigned int motion_vector_unit_test;
   int delta_q_uv;
+  int min_border;
+  int skip_static_sb;
+  unsigned int target_frame_time;
 } vp9_extracfg;
 
 static struct vp9_extracfg default_extra_cfg = {
@@ -107,6 +110,9 @@ static struct vp9_extracfg default_extra_cfg = {
   0,                     // row_mt
   0,                     // motion_vector_unit_test
   0,                     // delta_q_uv
+  0,                     // min_border
+  0,                     // skip_static_sb
+  0,                     // target_frame_time
 };
 
 struct vpx_codec_alg_priv {
@@ -275,6 +281,8 @@ static vpx_codec_err_t validate_config(vpx_codec_alg_priv_t *ctx,
         "or kf_max_dist instead.");
 
   RANGE_CHECK(extra_cfg, row_mt, 0, 1);
+  RANGE_CHECK(extra_cfg, min_border, 0, 1);
+  RANGE_CHECK(extra_cfg, skip_static_sb, 0, 1);
   RANGE_CHECK(extra_cfg, motion_vector_unit_test, 0, 2);
   RANGE_CHECK(extra_cfg, enable_auto_alt_ref, 0, MAX_ARF_LAYERS);
   RANGE_CHECK(extra_cfg, cpu_used, -9, 9);
@@ -643,6 +651,9 @@ static vpx_codec_err_t set_encoder_config(
   oxcf->motion_vector_unit_test = extra_cfg->motion_vector_unit_test;
 
   oxcf->delta_q_uv = extra_cfg->delta_q_uv;
+  oxcf->min_border = extra_cfg->min_border;
+  oxcf->skip_static_sb = extra_cfg->skip_static_sb;
+  oxcf->target_frame_time = extra_cfg->target_frame_time;
 
   for (sl = 0; sl < oxcf->ss_number_layers; ++sl) {
     for (tl = 0; tl < oxcf->ts_number_layers; ++tl) {
@@ -863,6 +874,32 @@ static vpx_codec_err_t ctrl_get_quantizer(vpx_codec_alg_priv_t *ctx,
   return VPX_CODEC_OK;
 }
 
+static vpx_codec_err_t ctrl_get_last_speed(vpx_codec_alg_priv_t *ctx,
+                                           va_list args) {
+  int *const arg = va_arg(args, int *);
+  if (arg == NULL) return VPX_CODEC_INVALID_PARAM;
+  *arg = ctx->cpi->speed_ctrl.last_speed;
+  return VPX_CODEC_OK;
+}
+
+static vpx_codec_err_t ctrl_get_sb_sad_prune_stats(vpx_codec_alg_priv_t *ctx,
+                                                   va_list args) {
+  vpx_sb_sad_prune_stats_t *const arg =
+      va_arg(args, vpx_sb_sad_prune_stats_t *);
+  if (arg == NULL) return VPX_CODEC_INVALID_PARAM;
+  arg->ref_prunes = ctx->cpi->sb_sad_ref_prunes;
+  arg->filter_skips = ctx->cpi->sb_sad_filter_skips;
+  return VPX_CODEC_OK;
+}
+
+static vpx_codec_err_t ctrl_get_static_sb_count(vpx_codec_alg_priv_t *ctx,
+                                                va_list args) {
+  int *const arg = va_arg(args, int *);
+  if (arg == NULL) return VPX_CODEC_INVALID_PARAM;
+  *arg = ctx->cpi->static_sb_count;
+  return VPX_CODEC_OK;
+}
+
 static vpx_codec_err_t ctrl_get_quantizer64(vpx_codec_alg_priv_t *ctx,
                                             va_list args) {
   int *const arg = va_arg(args, int *);
@@ -1296,6 +1333,91 @@ static vpx_codec_frame_flags_t get_frame_pkt_flags(const VP9_COMP *cpi,
   return flags;
 }
 
+// Hands a frame packet to the application, either through the registered
+// callback or the packet list. With VPX_CODEC_USE_OUTPUT_PARTITION the frame
+// is split into one fragment holding the frame headers and one per tile, with
+// VPX_FRAME_IS_FRAGMENT set on all but the last. The packet holds |prefix_sz|
+// bytes of pending invisible frames, which go out with the headers, then the
+// |frame_sz| bytes of the last packed frame, then any superframe index, which
+// goes out with the last tile.
+static void output_frame_pkt(vpx_codec_alg_priv_t *ctx,
+                             vpx_codec_cx_pkt_t *pkt, size_t prefix_sz,
+                             size_t frame_sz) {
+  const VP9_COMP *const cpi = ctx->cpi;
+  unsigned char *buf = (unsigned char *)pkt->data.frame.buf;
+  size_t remaining = pkt->data.frame.sz;
+  int num_partitions = 1;
+  int i;
+
+  // Already handed out by output_partition_pkt() while it was being packed.
+  if (cpi->partitions_streamed) return;
+
+  if (ctx->base.init_flags & VPX_CODEC_USE_OUTPUT_PARTITION) {
+    size_t packed_sz = 0;
+    for (i = 0; i < cpi->num_partitions; ++i) packed_sz += cpi->partition_sz[i];
+    // Only split what vp9_pack_bitstream() just described.
+    if (frame_sz > 0 && packed_sz == frame_sz) {
+      num_partitions = cpi->num_partitions;
+    }
+  }
+
+  for (i = 0; i < num_partitions; ++i) {
+    vpx_codec_cx_pkt_t part = *pkt;
+    size_t sz = remaining;
+    if (i < num_partitions - 1) {
+      sz = VPXMIN(cpi->partition_sz[i] + (i == 0 ? prefix_sz : 0), remaining);
+      part.data.frame.flags |= VPX_FRAME_IS_FRAGMENT;
+    }
+    part.data.frame.buf = buf;
+    part.data.frame.sz = sz;
+    part.data.frame.partition_id = num_partitions > 1 ? i : -1;
+
+    if (ctx->output_cx_pkt_cb.output_cx_pkt)
+      ctx->output_cx_pkt_cb.output_cx_pkt(&part,
+                                          ctx->output_cx_pkt_cb.user_priv);
+    else
+      vpx_codec_pkt_list_add(&ctx->pkt_list.head, &part);
+
+    buf += sz;
+    remaining -= sz;
+  }
+}
+
+// Called by vp9_pack_bitstream() with each partition of a frame as soon as it
+// has been written, when the frame goes to the registered output callback
+// with VPX_CODEC_USE_OUTPUT_PARTITION. The fragments match the ones
+// output_frame_pkt() would split the frame into after the encode.
+static void output_partition_pkt(void *priv, uint8_t *buf, size_t sz,
+                                 int partition_id, int is_last) {
+  vpx_codec_alg_priv_t *const ctx = (vpx_codec_alg_priv_t *)priv;
+  const VP9_COMP *const cpi = ctx->cpi;
+  const VP9_COMMON *const cm = &cpi->common;
+  const vpx_rational64_t *const timebase_in_ts = &ctx->oxcf.g_timebase_in_ts;
+  unsigned int lib_flags = cm->frame_type == KEY_FRAME ? FRAMEFLAGS_KEY : 0;
+  vpx_codec_cx_pkt_t pkt;
+
+  // The flags vp9_get_compressed_data() returns once the frame is done.
+  if (cpi->refresh_golden_frame == 1) lib_flags |= FRAMEFLAGS_GOLDEN;
+  if (cpi->refresh_alt_ref_frame == 1) lib_flags |= FRAMEFLAGS_ALTREF;
+
+  memset(&pkt, 0, sizeof(pkt));
+  pkt.kind = VPX_CODEC_CX_FRAME_PKT;
+  pkt.data.frame.buf = buf;
+  pkt.data.frame.sz = sz;
+  pkt.data.frame.pts =
+      ticks_to_timebase_units(timebase_in_ts, cpi->source_time_stamp) +
+      ctx->pts_offset;
+  pkt.data.frame.duration = (unsigned long)ticks_to_timebase_units(
+      timebase_in_ts, cpi->source_end_time_stamp - cpi->source_time_stamp);
+  pkt.data.frame.flags = get_frame_pkt_flags(cpi, lib_flags);
+  if (!is_last) pkt.data.frame.flags |= VPX_FRAME_IS_FRAGMENT;
+  pkt.data.frame.partition_id = cpi->num_partitions > 1 ? partition_id : -1;
+  pkt.data.frame.width[0] = cm->width;
+  pkt.data.frame.height[0] = cm->height;
+  pkt.data.frame.spatial_layer_encoded[0] = 1;
+  ctx->output_cx_pkt_cb.output_cx_pkt(&pkt, ctx->output_cx_pkt_cb.user_priv);
+}
+
 static INLINE vpx_codec_cx_pkt_t get_psnr_pkt(const PSNR_STATS *psnr) {
   vpx_codec_cx_pkt_t pkt;
   pkt.kind = VPX_CODEC_PSNR_PKT;
@@ -1518,6 +1640,14 @@ static vpx_codec_err_t encoder_encode(vpx_codec_alg_priv_t *ctx,
       int64_t dst_time_stamp;
       int64_t dst_end_time_stamp;
       vp9_init_encode_frame_result(&encode_frame_result);
+      // Tiles can go out as they are packed only when every frame goes to the
+      // callback on its own, which is not the case for the layers of SVC.
+      cpi->output_partition =
+          (ctx->base.init_flags & VPX_CODEC_USE_OUTPUT_PARTITION) &&
+                  ctx->output_cx_pkt_cb.output_cx_pkt != NULL && !cpi->use_svc
+              ? output_partition_pkt
+              : NULL;
+      cpi->output_partition_priv = ctx;
       while (cx_data_sz >= ctx->cx_data_sz / 2 &&
              -1 != vp9_get_compressed_data(cpi, &lib_flags, &size, cx_data,
                                            cx_data_sz, &dst_time_stamp,
@@ -1566,13 +1696,14 @@ static vpx_codec_err_t encoder_encode(vpx_codec_alg_priv_t *ctx,
               ctx->pending_cx_data_sz = 0;
               ctx->pending_frame_count = 0;
               ctx->pending_frame_magnitude = 0;
-              ctx->output_cx_pkt_cb.output_cx_pkt(
-                  &pkt, ctx->output_cx_pkt_cb.user_priv);
+              output_frame_pkt(ctx, &pkt, 0, size);
             }
             continue;
           }
 
           // Add the frame packet to the list of returned packets.
+          const size_t frame_sz = size;
+          size_t prefix_sz = 0;
           pkt.kind = VPX_CODEC_CX_FRAME_PKT;
           pkt.data.frame.pts =
               ticks_to_timebase_units(timebase_in_ts, dst_time_stamp) +
@@ -1586,6 +1717,7 @@ static vpx_codec_err_t encoder_encode(vpx_codec_alg_priv_t *ctx,
               1 - cpi->svc.drop_spatial_layer[cpi->svc.spatial_layer_id];
 
           if (ctx->pending_cx_data) {
+            prefix_sz = ctx->pending_cx_data_sz;
             if (size)
               ctx->pending_frame_sizes[ctx->pending_frame_count++] = size;
             ctx->pending_frame_magnitude |= size;
@@ -1603,13 +1735,7 @@ static vpx_codec_err_t encoder_encode(vpx_codec_alg_priv_t *ctx,
             pkt.data.frame.buf = cx_data;
             pkt.data.frame.sz = size;
           }
-          pkt.data.frame.partition_id = -1;
-
-          if (ctx->output_cx_pkt_cb.output_cx_pkt)
-            ctx->output_cx_pkt_cb.output_cx_pkt(
-                &pkt, ctx->output_cx_pkt_cb.user_priv);
-          else
-            vpx_codec_pkt_list_add(&ctx->pkt_list.head, &pkt);
+          output_frame_pkt(ctx, &pkt, prefix_sz, frame_sz);
 
           cx_data += size;
           cx_data_sz -= size;
@@ -1966,6 +2092,59 @@ static vpx_codec_err_t ctrl_set_delta_q_uv(vpx_codec_alg_priv_t *ctx,
   return update_extra_cfg(ctx, &extra_cfg);
 }
 
+static vpx_codec_err_t ctrl_set_min_border(vpx_codec_alg_priv_t *ctx,
+                                           va_list args) {
+  struct vp9_extracfg extra_cfg = ctx->extra_cfg;
+  extra_cfg.min_border = CAST(VP9E_SET_MIN_BORDER, args);
+  return update_extra_cfg(ctx, &extra_cfg);
+}
+
+static vpx_codec_err_t ctrl_set_skip_static_sb(vpx_codec_alg_priv_t *ctx,
+                                               va_list args) {
+  struct vp9_extracfg extra_cfg = ctx->extra_cfg;
+  extra_cfg.skip_static_sb = CAST(VP9E_SET_SKIP_STATIC_SB, args);
+  return update_extra_cfg(ctx, &extra_cfg);
+}
+
+static vpx_codec_err_t ctrl_set_target_frame_time(vpx_codec_alg_priv_t *ctx,
+                                                  va_list args) {
+  struct vp9_extracfg extra_cfg = ctx->extra_cfg;
+  extra_cfg.target_frame_time = CAST(VP9E_SET_TARGET_FRAME_TIME, args);
+  return update_extra_cfg(ctx, &extra_cfg);
+}
+
+static vpx_codec_err_t ctrl_set_sb_dirty_map(vpx_codec_alg_priv_t *ctx,
+                                             va_list args) {
+  vpx_sb_dirty_map_t *const map = va_arg(args, vpx_sb_dirty_map_t *);
+
+  if (map) {
+    if (!vp9_set_sb_dirty_map(ctx->cpi, map->dirty_map, (int)map->rows,
+                              (int)map->cols))
+      return VPX_CODEC_OK;
+
+    return VPX_CODEC_INVALID_PARAM;
+  }
+  return VPX_CODEC_INVALID_PARAM;
+}
+
+static vpx_codec_err_t ctrl_set_motion_hints(vpx_codec_alg_priv_t *ctx,
+                                             va_list args) {
+  vpx_motion_hints_t *const hints = va_arg(args, vpx_motion_hints_t *);
+
+  if (!vp9_set_motion_hints(ctx->cpi, hints)) return VPX_CODEC_OK;
+
+  return VPX_CODEC_INVALID_PARAM;
+}
+
+static vpx_codec_err_t ctrl_set_mode_info(vpx_codec_alg_priv_t *ctx,
+                                          va_list args) {
+  vpx_mode_info_map_t *const map = va_arg(args, vpx_mode_info_map_t *);
+
+  if (!vp9_set_mode_info(ctx->cpi, map)) return VPX_CODEC_OK;
+
+  return VPX_CODEC_INVALID_PARAM;
+}
+
 static vpx_codec_err_t ctrl_register_cx_callback(vpx_codec_alg_priv_t *ctx,
                                                  va_list args) {
   vpx_codec_priv_output_cx_pkt_cb_pair_t *cbp =
@@ -2030,6 +2209,14 @@ static vpx_codec_err_t ctrl_set_disable_loopfilter(vpx_codec_alg_priv_t *ctx,
   return VPX_CODEC_OK;
 }
 
+static vpx_codec_err_t ctrl_set_disable_rd_cost_cache(
+    vpx_codec_alg_priv_t *ctx, va_list args) {
+  VP9_COMP *const cpi = ctx->cpi;
+  const int data = va_arg(args, int);
+  cpi->rd.cost_cache.disabled = data;
+  return VPX_CODEC_OK;
+}
+
 static vpx_codec_err_t ctrl_set_external_rate_control(vpx_codec_alg_priv_t *ctx,
                                                       va_list args) {
   vpx_rc_funcs_t funcs = *CAST(VP9E_SET_EXTERNAL_RATE_CONTROL, args);
@@ -2156,11 +2343,21 @@ static vpx_codec_ctrl_fn_map_t encoder_ctrl_maps[] = {
   { VP9E_SET_EXTERNAL_RATE_CONTROL, ctrl_set_external_rate_control },
   { VP9E_SET_QUANTIZER_ONE_PASS, ctrl_set_quantizer_one_pass },
   { VP9E_ENABLE_EXTERNAL_RC_TPL, ctrl_enable_external_rc_tpl },
+  { VP9E_SET_MIN_BORDER, ctrl_set_min_border },
+  { VP9E_SET_SKIP_STATIC_SB, ctrl_set_skip_static_sb },
+  { VP9E_SET_TARGET_FRAME_TIME, ctrl_set_target_frame_time },
+  { VP9E_SET_SB_DIRTY_MAP, ctrl_set_sb_dirty_map },
+  { VP9E_SET_MOTION_HINTS, ctrl_set_motion_hints },
+  { VP9E_SET_MODE_INFO, ctrl_set_mode_info },
+  { VP9E_SET_DISABLE_RD_COST_CACHE, ctrl_set_disable_rd_cost_cache },
 
   // Getters
   { VP8E_GET_LAST_QUANTIZER, ctrl_get_quantizer },
   { VP8E_GET_LAST_QUANTIZER_64, ctrl_get_quantizer64 },
   { VP9E_GET_LAST_QUANTIZER_SVC_LAYERS, ctrl_get_quantizer_svc_layers },
+  { VP9E_GET_LAST_SPEED, ctrl_get_last_speed },
+  { VP9E_GET_SB_SAD_PRUNE_STATS, ctrl_get_sb_sad_prune_stats },
+  { VP9E_GET_STATIC_SB_COUNT, ctrl_get_static_sb_count },
   { VP9E_GET_LOOPFILTER_LEVEL, ctrl_get_loopfilter_level },
   { VP9_GET_REFERENCE, ctrl_get_reference },
   { VP9E_GET_SVC_LAYER_ID, ctrl_get_svc_layer_id },
@@ -2260,7 +2457,8 @@ CODEC_INTERFACE(vpx_codec_vp9_cx) = {
 #if CONFIG_VP9_HIGHBITDEPTH
   VPX_CODEC_CAP_HIGHBITDEPTH |
 #endif
-      VPX_CODEC_CAP_ENCODER | VPX_CODEC_CAP_PSNR,  // vpx_codec_caps_t
+      VPX_CODEC_CAP_ENCODER | VPX_CODEC_CAP_PSNR |
+      VPX_CODEC_CAP_OUTPUT_PARTITION,  // vpx_codec_caps_t
   encoder_init,                                    // vpx_codec_init_fn_t
   encoder_destroy,                                 // vpx_codec_destroy_fn_t
   encoder_ctrl_maps,                               // vpx_codec_ctrl_fn_map_t
@@ -2484,6 +2682,9 @@ void vp9_dump_encoder_config(const VP9EncoderConfig *oxcf, FILE *fp) {
   DUMP_STRUCT_VALUE(fp, oxcf, row_mt);
   DUMP_STRUCT_VALUE(fp, oxcf, motion_vector_unit_test);
   DUMP_STRUCT_VALUE(fp, oxcf, delta_q_uv);
+  DUMP_STRUCT_VALUE(fp, oxcf, min_border);
+  DUMP_STRUCT_VALUE(fp, oxcf, skip_static_sb);
+  DUMP_STRUCT_VALUE(fp, oxcf, target_frame_time);
   DUMP_STRUCT_VALUE(fp, oxcf, use_simple_encode_api);
 }
 
@@ -8,6 +8,7 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <limits.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -66,6 +67,8 @@ static vpx_codec_err_t decoder_destroy(vpx_codec_alg_priv_t *ctx) {
   }
 
   vpx_free(ctx->buffer_pool);
+  vpx_free(ctx->sp_buf);
+  vpx_free(ctx->sp_jobs);
   vpx_free(ctx);
   return VPX_CODEC_OK;
 }
@@ -254,6 +257,13 @@ static void set_ppflags(const vpx_codec_alg_priv_t *ctx, vp9_ppflags_t *flags) {
       ERROR(#memb " out of range [" #lo ".." #hi "]");                   \
   } while (0)
 
+static void set_decode_region(vpx_codec_alg_priv_t *ctx) {
+  const vpx_image_rect_t *const r = &ctx->decode_region;
+  const int empty = r->w == 0 || r->h == 0;
+  ctx->pbi->region_x_start = empty ? 0 : (int)r->x;
+  ctx->pbi->region_x_end = empty ? 0 : (int)(r->x + r->w);
+}
+
 static vpx_codec_err_t init_decoder(vpx_codec_alg_priv_t *ctx) {
   vpx_codec_err_t res;
   ctx->last_show_frame = -1;
@@ -279,6 +289,10 @@ static vpx_codec_err_t init_decoder(vpx_codec_alg_priv_t *ctx) {
   RANGE_CHECK(ctx, lpf_opt, 0, 1);
   ctx->pbi->lpf_mt_opt = ctx->lpf_opt;
 
+  set_decode_region(ctx);
+  ctx->pbi->skip_non_ref_frames = ctx->skip_non_ref_frames;
+  ctx->pbi->next_reduce_log2 = ctx->reduce_log2;
+
   // If postprocessing was enabled by the application and a
   // configuration has not been provided, default it.
   if (!ctx->postproc_cfg_set && (ctx->base.init_flags & VPX_CODEC_USE_POSTPROC))
@@ -302,6 +316,226 @@ static INLINE void check_resync(vpx_codec_alg_priv_t *const ctx,
     ctx->need_resync = 0;
 }
 
+typedef struct SemiPlanarJob {
+  const YV12_BUFFER_CONFIG *src;
+  uint8_t *dst;
+  int dst_stride;
+  int row_start;
+  int row_end;
+} SemiPlanarJob;
+
+static int use_semi_planar(const vpx_codec_alg_priv_t *ctx,
+                           const YV12_BUFFER_CONFIG *src) {
+  return ctx->semi_planar && src->subsampling_x == 1 &&
+         src->subsampling_y == 1;
+}
+
+// Byte stride of the semi-planar planes, which matches the one of the luma
+// plane of src.
+static int semi_planar_stride(const YV12_BUFFER_CONFIG *src) {
+#if CONFIG_VP9_HIGHBITDEPTH
+  if (src->flags & YV12_FLAG_HIGHBITDEPTH) return 2 * src->y_stride;
+#endif
+  return src->y_stride;
+}
+
+// Rows of sp_buf holding the luma plane, which is only copied for high
+// bitdepth frames to move the samples to the most significant bits.
+static int semi_planar_luma_rows(const YV12_BUFFER_CONFIG *src) {
+#if CONFIG_VP9_HIGHBITDEPTH
+  if (src->flags & YV12_FLAG_HIGHBITDEPTH) return src->y_crop_height;
+#endif
+  (void)src;
+  return 0;
+}
+
+// Makes sp_buf large enough for src and forgets what it held.
+static int alloc_semi_planar(vpx_codec_alg_priv_t *ctx,
+                             const YV12_BUFFER_CONFIG *src) {
+  const size_t size =
+      (size_t)semi_planar_stride(src) *
+      (semi_planar_luma_rows(src) + src->uv_crop_height);
+  ctx->sp_src = NULL;
+  ctx->sp_rows = 0;
+  if (size > ctx->sp_buf_sz) {
+    vpx_free(ctx->sp_buf);
+    ctx->sp_buf_sz = 0;
+    ctx->sp_buf = (uint8_t *)vpx_memalign(32, size);
+    if (ctx->sp_buf == NULL) return -1;
+    ctx->sp_buf_sz = size;
+  }
+  ctx->sp_src = src->y_buffer;
+  return 0;
+}
+
+// Converts the luma rows [row_start, row_end) of job->src, and the chroma
+// rows they cover.
+static int convert_semi_planar_rows(void *arg1, void *arg2) {
+  const SemiPlanarJob *const job = (const SemiPlanarJob *)arg1;
+  const YV12_BUFFER_CONFIG *const src = job->src;
+  const int uv_start = (job->row_start + 1) >> 1;
+  const int uv_end = (job->row_end + 1) >> 1;
+  uint8_t *const uv_dst =
+      job->dst + (size_t)job->dst_stride * semi_planar_luma_rows(src);
+  int r, c;
+  (void)arg2;
+#if CONFIG_VP9_HIGHBITDEPTH
+  if (src->flags & YV12_FLAG_HIGHBITDEPTH) {
+    const int shift = 16 - src->bit_depth;
+    for (r = job->row_start; r < job->row_end; ++r) {
+      const uint16_t *const y =
+          CONVERT_TO_SHORTPTR(src->y_buffer) + r * src->y_stride;
+      uint16_t *const dst =
+          (uint16_t *)(job->dst + (size_t)r * job->dst_stride);
+      for (c = 0; c < src->y_crop_width; ++c) dst[c] = y[c] << shift;
+    }
+    for (r = uv_start; r < uv_end; ++r) {
+      const uint16_t *const u =
+          CONVERT_TO_SHORTPTR(src->u_buffer) + r * src->uv_stride;
+      const uint16_t *const v =
+          CONVERT_TO_SHORTPTR(src->v_buffer) + r * src->uv_stride;
+      uint16_t *const dst = (uint16_t *)(uv_dst + (size_t)r * job->dst_stride);
+      for (c = 0; c < src->uv_crop_width; ++c) {
+        dst[2 * c] = u[c] << shift;
+        dst[2 * c + 1] = v[c] << shift;
+      }
+    }
+    return 1;
+  }
+#endif  // CONFIG_VP9_HIGHBITDEPTH
+  for (r = uv_start; r < uv_end; ++r) {
+    const uint8_t *const u = src->u_buffer + r * src->uv_stride;
+    const uint8_t *const v = src->v_buffer + r * src->uv_stride;
+    uint8_t *const dst = uv_dst + (size_t)r * job->dst_stride;
+    for (c = 0; c < src->uv_crop_width; ++c) {
+      dst[2 * c] = u[c];
+      dst[2 * c + 1] = v[c];
+    }
+  }
+  return 1;
+}
+
+// Converts the rows of src up to row_end, splitting them between the tile
+// workers of the decoder when there are enough of them, as when a whole frame
+// from a multi-threaded decode is done at once.
+static void convert_semi_planar(vpx_codec_alg_priv_t *ctx,
+                                const YV12_BUFFER_CONFIG *src, int row_end) {
+  const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
+  const int row_start = ctx->sp_rows;
+  const int rows = row_end - row_start;
+  const int num_jobs = VPXMIN(ctx->pbi->num_tile_workers, rows >> 6);
+  int i;
+
+  if (num_jobs > ctx->num_sp_jobs) {
+    vpx_free(ctx->sp_jobs);
+    ctx->sp_jobs =
+        (SemiPlanarJob *)vpx_malloc(num_jobs * sizeof(*ctx->sp_jobs));
+    ctx->num_sp_jobs = ctx->sp_jobs != NULL ? num_jobs : 0;
+  }
+  if (num_jobs < 2 || num_jobs > ctx->num_sp_jobs) {
+    SemiPlanarJob job;
+    job.src = src;
+    job.dst = ctx->sp_buf;
+    job.dst_stride = semi_planar_stride(src);
+    job.row_start = row_start;
+    job.row_end = row_end;
+    convert_semi_planar_rows(&job, NULL);
+  } else {
+    // Each job gets an even number of rows, so the chroma rows are split too.
+    const int rows_per_job = ((rows + num_jobs - 1) / num_jobs + 1) & ~1;
+    for (i = 0; i < num_jobs; ++i) {
+      VPxWorker *const worker = &ctx->pbi->tile_workers[i];
+      SemiPlanarJob *const job = &ctx->sp_jobs[i];
+      job->src = src;
+      job->dst = ctx->sp_buf;
+      job->dst_stride = semi_planar_stride(src);
+      job->row_start = VPXMIN(row_start + i * rows_per_job, row_end);
+      job->row_end = VPXMIN(row_start + (i + 1) * rows_per_job, row_end);
+      worker->hook = convert_semi_planar_rows;
+      worker->data1 = job;
+      worker->data2 = NULL;
+      if (i == num_jobs - 1) {
+        winterface->execute(worker);
+      } else {
+        winterface->launch(worker);
+      }
+    }
+    for (i = 0; i < num_jobs; ++i) winterface->sync(&ctx->pbi->tile_workers[i]);
+  }
+  ctx->sp_rows = row_end;
+}
+
+// Describes src as an output image, in the semi-planar format if it has been
+// converted.
+static void frame_to_image(const vpx_codec_alg_priv_t *ctx,
+                           const YV12_BUFFER_CONFIG *src, vpx_image_t *img) {
+  yuvconfig2image(img, src, ctx->user_priv);
+  if (use_semi_planar(ctx, src) && ctx->sp_src == src->y_buffer) {
+    const int stride = semi_planar_stride(src);
+    uint8_t *const uv = ctx->sp_buf + stride * semi_planar_luma_rows(src);
+    if (img->fmt & VPX_IMG_FMT_HIGHBITDEPTH) {
+      img->fmt = VPX_IMG_FMT_P010;
+      img->bps = 24;
+      img->planes[VPX_PLANE_Y] = ctx->sp_buf;
+      img->planes[VPX_PLANE_V] = uv + 2;
+    } else {
+      img->fmt = VPX_IMG_FMT_NV12;
+      img->planes[VPX_PLANE_V] = uv + 1;
+    }
+    img->planes[VPX_PLANE_U] = uv;
+    img->stride[VPX_PLANE_U] = img->stride[VPX_PLANE_V] = stride;
+    // Like vpx_img_alloc(), so that the plane widths are in samples.
+    img->x_chroma_shift = 0;
+  }
+}
+
+// Called as rows of the frame being decoded are final. Converts them to the
+// semi-planar output format and passes them to the put_slice callback.
+// Frames that will not be output, or that are postprocessed before output,
+// are left to decoder_get_frame().
+static void frame_rows_done(void *priv, int sb_row_start, int sb_row_end) {
+  vpx_codec_alg_priv_t *const ctx = (vpx_codec_alg_priv_t *)priv;
+  VP9_COMMON *const cm = &ctx->pbi->common;
+  const YV12_BUFFER_CONFIG *const src = get_frame_new_buffer(cm);
+  const RefCntBuffer *const frame_bufs = cm->buffer_pool->frame_bufs;
+  const int resynced = ctx->pbi->need_resync == 0 &&
+                       (cm->intra_only || cm->frame_type == KEY_FRAME);
+  // Rows of the frame buffer, which is smaller than the coded frame with
+  // VP9D_SET_REDUCED_RESOLUTION.
+  const int shift = ctx->pbi->reduce_log2;
+  const int row_start = (sb_row_start * MI_BLOCK_SIZE * MI_SIZE) >> shift;
+  const int row_end = VPXMIN((sb_row_end * MI_BLOCK_SIZE * MI_SIZE) >> shift,
+                             src->y_crop_height);
+  vpx_image_t img;
+  vpx_image_rect_t valid, update;
+
+  if (!cm->show_frame || (ctx->need_resync && !resynced)) return;
+  if ((ctx->base.init_flags & VPX_CODEC_USE_POSTPROC) &&
+      ctx->postproc_cfg.post_proc_flag) {
+    return;
+  }
+
+  if (use_semi_planar(ctx, src)) {
+    if (sb_row_start == 0 && alloc_semi_planar(ctx, src)) {
+      vpx_internal_error(&cm->error, VPX_CODEC_MEM_ERROR,
+                         "Failed to allocate semi-planar output");
+    }
+    convert_semi_planar(ctx, src, row_end);
+  }
+  if (!ctx->base.dec.put_slice_cb.u.put_slice) return;
+
+  frame_to_image(ctx, src, &img);
+  img.fb_priv = frame_bufs[cm->new_fb_idx].raw_frame_buffer.priv;
+  valid.x = update.x = 0;
+  valid.w = update.w = img.d_w;
+  valid.y = 0;
+  valid.h = row_end;
+  update.y = row_start;
+  update.h = row_end - row_start;
+  ctx->base.dec.put_slice_cb.u.put_slice(ctx->base.dec.put_slice_cb.user_priv,
+                                         &img, &valid, &update);
+}
+
 static vpx_codec_err_t decode_one(vpx_codec_alg_priv_t *ctx,
                                   const uint8_t **data, unsigned int data_sz,
                                   void *user_priv) {
@@ -318,12 +552,37 @@ static vpx_codec_err_t decode_one(vpx_codec_alg_priv_t *ctx,
     if (!ctx->si.is_kf && !is_intra_only) return VPX_CODEC_ERROR;
   }
 
+  if (ctx->skip_to_keyframe) {
+    vpx_codec_stream_info_t si;
+    int is_intra_only = 0;
+    const vpx_codec_err_t res =
+        decoder_peek_si_internal(*data, data_sz, &si, &is_intra_only,
+                                 ctx->decrypt_cb, ctx->decrypt_state);
+    if (res != VPX_CODEC_OK) return res;
+
+    if (!si.is_kf) {
+      // Drop the frame, and any frame left from an earlier decode call.
+      ctx->pbi->ready_for_new_data = 1;
+      *data += data_sz;
+      return VPX_CODEC_OK;
+    }
+    ctx->skip_to_keyframe = 0;
+  }
+
   ctx->user_priv = user_priv;
 
   // Set these even if already initialized.  The caller may have changed the
   // decrypt config between frames.
   ctx->pbi->decrypt_cb = ctx->decrypt_cb;
   ctx->pbi->decrypt_state = ctx->decrypt_state;
+  ctx->pbi->rows_done_cb =
+      ctx->base.dec.put_slice_cb.u.put_slice || ctx->semi_planar
+          ? frame_rows_done
+          : NULL;
+  ctx->pbi->rows_done_priv = ctx;
+  // The frame may be decoded into the buffer the output was converted from.
+  ctx->sp_src = NULL;
+  ctx->sp_rows = 0;
 
   if (vp9_receive_compressed_data(ctx->pbi, data_sz, data)) {
     ctx->pbi->cur_buf->buf.corrupted = 1;
@@ -421,7 +680,13 @@ static vpx_image_t *decoder_get_frame(vpx_codec_alg_priv_t *ctx,
       RefCntBuffer *const frame_bufs = cm->buffer_pool->frame_bufs;
       ctx->last_show_frame = ctx->pbi->common.new_fb_idx;
       if (ctx->need_resync) return NULL;
-      yuvconfig2image(&ctx->img, &sd, ctx->user_priv);
+      if (use_semi_planar(ctx, &sd) &&
+          (ctx->sp_src != sd.y_buffer || ctx->sp_rows < sd.y_crop_height)) {
+        // Shown directly, postprocessed, or from an earlier decode call.
+        if (alloc_semi_planar(ctx, &sd)) return NULL;
+        convert_semi_planar(ctx, &sd, sd.y_crop_height);
+      }
+      frame_to_image(ctx, &sd, &ctx->img);
       ctx->img.fb_priv = frame_bufs[cm->new_fb_idx].raw_frame_buffer.priv;
       img = &ctx->img;
       return img;
@@ -611,6 +876,21 @@ static vpx_codec_err_t ctrl_get_bit_depth(vpx_codec_alg_priv_t *ctx,
   return VPX_CODEC_INVALID_PARAM;
 }
 
+static vpx_codec_err_t ctrl_get_mode_info(vpx_codec_alg_priv_t *ctx,
+                                          va_list args) {
+  vpx_mode_info_map_t *const map = va_arg(args, vpx_mode_info_map_t *);
+
+  if (map) {
+    if (ctx->pbi != NULL) {
+      return vp9_get_mode_info_dec(ctx->pbi, map);
+    } else {
+      return VPX_CODEC_ERROR;
+    }
+  }
+
+  return VPX_CODEC_INVALID_PARAM;
+}
+
 static vpx_codec_err_t ctrl_set_invert_tile_order(vpx_codec_alg_priv_t *ctx,
                                                   va_list args) {
   ctx->invert_tile_order = va_arg(args, int);
@@ -680,6 +960,56 @@ static vpx_codec_err_t ctrl_enable_lpf_opt(vpx_codec_alg_priv_t *ctx,
   return VPX_CODEC_OK;
 }
 
+static vpx_codec_err_t ctrl_set_decode_region(vpx_codec_alg_priv_t *ctx,
+                                              va_list args) {
+  const vpx_image_rect_t *const region = va_arg(args, vpx_image_rect_t *);
+
+  if (region != NULL) {
+    if (region->w > INT_MAX || region->x > INT_MAX - region->w)
+      return VPX_CODEC_INVALID_PARAM;
+    ctx->decode_region = *region;
+  } else {
+    memset(&ctx->decode_region, 0, sizeof(ctx->decode_region));
+  }
+  if (ctx->pbi != NULL) set_decode_region(ctx);
+
+  return VPX_CODEC_OK;
+}
+
+static vpx_codec_err_t ctrl_set_skip_non_ref_frames(vpx_codec_alg_priv_t *ctx,
+                                                    va_list args) {
+  ctx->skip_non_ref_frames = va_arg(args, int) != 0;
+
+  if (ctx->pbi != NULL) {
+    ctx->pbi->skip_non_ref_frames = ctx->skip_non_ref_frames;
+  }
+
+  return VPX_CODEC_OK;
+}
+
+static vpx_codec_err_t ctrl_set_skip_to_keyframe(vpx_codec_alg_priv_t *ctx,
+                                                 va_list args) {
+  ctx->skip_to_keyframe = va_arg(args, int) != 0;
+  return VPX_CODEC_OK;
+}
+
+static vpx_codec_err_t ctrl_set_reduced_resolution(vpx_codec_alg_priv_t *ctx,
+                                                   va_list args) {
+  const int reduce_log2 = va_arg(args, int);
+
+  if (reduce_log2 < 0 || reduce_log2 > 2) return VPX_CODEC_INVALID_PARAM;
+  ctx->reduce_log2 = reduce_log2;
+  if (ctx->pbi != NULL) ctx->pbi->next_reduce_log2 = reduce_log2;
+
+  return VPX_CODEC_OK;
+}
+
+static vpx_codec_err_t ctrl_set_semi_planar_output(vpx_codec_alg_priv_t *ctx,
+                                                   va_list args) {
+  ctx->semi_planar = va_arg(args, int) != 0;
+  return VPX_CODEC_OK;
+}
+
 static vpx_codec_ctrl_fn_map_t decoder_ctrl_maps[] = {
   { VP8_COPY_REFERENCE, ctrl_copy_reference },
 
@@ -693,6 +1023,11 @@ static vpx_codec_ctrl_fn_map_t decoder_ctrl_maps[] = {
   { VP9_DECODE_SVC_SPATIAL_LAYER, ctrl_set_spatial_layer_svc },
   { VP9D_SET_ROW_MT, ctrl_set_row_mt },
   { VP9D_SET_LOOP_FILTER_OPT, ctrl_enable_lpf_opt },
+  { VP9D_SET_DECODE_REGION, ctrl_set_decode_region },
+  { VP9D_SET_SKIP_NON_REF_FRAMES, ctrl_set_skip_non_ref_frames },
+  { VP9D_SET_SKIP_TO_KEYFRAME, ctrl_set_skip_to_keyframe },
+  { VP9D_SET_REDUCED_RESOLUTION, ctrl_set_reduced_resolution },
+  { VP9D_SET_SEMI_PLANAR_OUTPUT, ctrl_set_semi_planar_output },
 
   // Getters
   { VPXD_GET_LAST_QUANTIZER, ctrl_get_quantizer },
@@ -702,6 +1037,7 @@ static vpx_codec_ctrl_fn_map_t decoder_ctrl_maps[] = {
   { VP9D_GET_DISPLAY_SIZE, ctrl_get_render_size },
   { VP9D_GET_BIT_DEPTH, ctrl_get_bit_depth },
   { VP9D_GET_FRAME_SIZE, ctrl_get_frame_size },
+  { VP9D_GET_MODE_INFO, ctrl_get_mode_info },
 
   { -1, NULL },
 };
@@ -715,7 +1051,7 @@ CODEC_INTERFACE(vpx_codec_vp9_dx) = {
 #if CONFIG_VP9_HIGHBITDEPTH
   VPX_CODEC_CAP_HIGHBITDEPTH |
 #endif
-      VPX_CODEC_CAP_DECODER | VP9_CAP_POSTPROC |
+      VPX_CODEC_CAP_DECODER | VP9_CAP_POSTPROC | VPX_CODEC_CAP_PUT_SLICE |
       VPX_CODEC_CAP_EXTERNAL_FRAME_BUFFER,  // vpx_codec_caps_t
   decoder_init,                             // vpx_codec_init_fn_t
   decoder_destroy,                          // vpx_codec_destroy_fn_t
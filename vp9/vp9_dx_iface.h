@@ -47,6 +47,21 @@ struct vpx_codec_alg_priv {
   int svc_spatial_layer;
   int row_mt;
   int lpf_opt;
+  vpx_image_rect_t decode_region;
+  int skip_non_ref_frames;
+  int skip_to_keyframe;
+  int reduce_log2;
+
+  // VP9D_SET_SEMI_PLANAR_OUTPUT: chroma of 4:2:0 frames is interleaved into
+  // sp_buf, which follows the luma for high bitdepth frames. sp_rows luma
+  // rows of the frame starting at sp_src have been converted.
+  int semi_planar;
+  uint8_t *sp_buf;
+  size_t sp_buf_sz;
+  const uint8_t *sp_src;
+  int sp_rows;
+  struct SemiPlanarJob *sp_jobs;
+  int num_sp_jobs;
 };
 
 #endif  // VPX_VP9_VP9_DX_IFACE_H_
@@ -341,6 +341,7 @@ typedef struct vpx_codec_priv_cb_pair {
 struct vpx_codec_priv {
   const char *err_detail;
   vpx_codec_flags_t init_flags;
+  struct vpx_mem_allocator *mem_allocator;
   struct {
     vpx_codec_priv_cb_pair_t put_frame_cb;
     vpx_codec_priv_cb_pair_t put_slice_cb;
@@ -473,6 +474,13 @@ void vpx_internal_error(struct vpx_internal_error_info *info,
                         vpx_codec_err_t error, const char *fmt, ...)
     LIBVPX_FORMAT_PRINTF(3, 4) CLANG_ANALYZER_NORETURN;
 
+/* Calls the init() function of ctx->iface with the memory allocator set on
+ * the calling thread by vpx_codec_set_mem_allocator(), and attaches the
+ * allocator to the new instance.
+ */
+vpx_codec_err_t vpx_codec_init_instance(vpx_codec_ctx_t *ctx,
+                                        vpx_codec_priv_enc_mr_cfg_t *data);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
@@ -15,12 +15,18 @@
 #include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "vpx/vpx_integer.h"
 #include "vpx/internal/vpx_codec_internal.h"
+#include "vpx_mem/vpx_mem.h"
+#include "vpx_ports/mem.h"
 #include "vpx_version.h"
 
 #define SAVE_STATUS(ctx, var) (ctx ? (ctx->err = var) : var)
 
+// Allocator given to the codec instances initialized by this thread.
+static VPX_THREAD_LOCAL vpx_codec_mem_allocator_t init_allocator;
+
 int vpx_codec_version(void) { return VERSION_PACKED; }
 
 const char *vpx_codec_version_str(void) { return VERSION_STRING_NOSP; }
@@ -71,7 +77,11 @@ vpx_codec_err_t vpx_codec_destroy(vpx_codec_ctx_t *ctx) {
   else if (!ctx->iface || !ctx->priv)
     res = VPX_CODEC_ERROR;
   else {
+    vpx_mem_allocator *const allocator = ctx->priv->mem_allocator;
+    vpx_mem_allocator *const prev = vpx_mem_set_thread_allocator(allocator);
     ctx->iface->destroy((vpx_codec_alg_priv_t *)ctx->priv);
+    vpx_mem_set_thread_allocator(prev);
+    vpx_mem_allocator_release(allocator);
 
     ctx->iface = NULL;
     ctx->name = NULL;
@@ -86,6 +96,50 @@ vpx_codec_caps_t vpx_codec_get_caps(vpx_codec_iface_t *iface) {
   return iface ? iface->caps : 0;
 }
 
+vpx_codec_err_t vpx_codec_set_mem_allocator(
+    const vpx_codec_mem_allocator_t *allocator) {
+  if (!allocator) {
+    memset(&init_allocator, 0, sizeof(init_allocator));
+  } else if (!allocator->alloc_cb != !allocator->free_cb) {
+    return VPX_CODEC_INVALID_PARAM;
+  } else {
+    init_allocator = *allocator;
+  }
+  return VPX_CODEC_OK;
+}
+
+vpx_codec_err_t vpx_codec_get_mem_stats(const vpx_codec_ctx_t *ctx,
+                                        vpx_codec_mem_stats_t *stats) {
+  if (!ctx || !stats) return VPX_CODEC_INVALID_PARAM;
+  if (!ctx->iface || !ctx->priv || !ctx->priv->mem_allocator) {
+    return VPX_CODEC_ERROR;
+  }
+  vpx_mem_allocator_get_stats(ctx->priv->mem_allocator, stats);
+  return VPX_CODEC_OK;
+}
+
+vpx_codec_err_t vpx_codec_init_instance(vpx_codec_ctx_t *ctx,
+                                        vpx_codec_priv_enc_mr_cfg_t *data) {
+  vpx_codec_err_t res;
+  vpx_mem_allocator *prev;
+  vpx_mem_allocator *const allocator =
+      vpx_mem_allocator_create(&init_allocator);
+  if (!allocator) return VPX_CODEC_MEM_ERROR;
+  if (ctx->init_flags & VPX_CODEC_USE_HUGE_PAGES) {
+    vpx_mem_allocator_use_huge_pages(allocator);
+  }
+
+  prev = vpx_mem_set_thread_allocator(allocator);
+  res = ctx->iface->init(ctx, data);
+  vpx_mem_set_thread_allocator(prev);
+  if (ctx->priv) {
+    ctx->priv->mem_allocator = allocator;
+  } else {
+    vpx_mem_allocator_release(allocator);
+  }
+  return res;
+}
+
 vpx_codec_err_t vpx_codec_control_(vpx_codec_ctx_t *ctx, int ctrl_id, ...) {
   vpx_codec_err_t res;
 
@@ -102,9 +156,12 @@ vpx_codec_err_t vpx_codec_control_(vpx_codec_ctx_t *ctx, int ctrl_id, ...) {
       if (!entry->ctrl_id || entry->ctrl_id == ctrl_id) {
         va_list ap;
 
+        vpx_mem_allocator *const prev =
+            vpx_mem_set_thread_allocator(ctx->priv->mem_allocator);
         va_start(ap, ctrl_id);
         res = entry->fn((vpx_codec_alg_priv_t *)ctx->priv, ap);
         va_end(ap);
+        vpx_mem_set_thread_allocator(prev);
         break;
       }
     }
@@ -14,6 +14,7 @@
  */
 #include <string.h>
 #include "vpx/internal/vpx_codec_internal.h"
+#include "vpx_mem/vpx_mem.h"
 
 #define SAVE_STATUS(ctx, var) (ctx ? (ctx->err = var) : var)
 
@@ -52,7 +53,7 @@ vpx_codec_err_t vpx_codec_dec_init_ver(vpx_codec_ctx_t *ctx,
     ctx->init_flags = flags;
     ctx->config.dec = cfg;
 
-    res = ctx->iface->init(ctx, NULL);
+    res = vpx_codec_init_instance(ctx, NULL);
     if (res) {
       ctx->err_detail = ctx->priv ? ctx->priv->err_detail : NULL;
       vpx_codec_destroy(ctx);
@@ -113,8 +114,12 @@ vpx_codec_err_t vpx_codec_decode(vpx_codec_ctx_t *ctx, const uint8_t *data,
     res = VPX_CODEC_INVALID_PARAM;
   else if (!ctx->iface || !ctx->priv)
     res = VPX_CODEC_ERROR;
-  else
+  else {
+    vpx_mem_allocator *const prev =
+        vpx_mem_set_thread_allocator(ctx->priv->mem_allocator);
     res = ctx->iface->dec.decode(get_alg_priv(ctx), data, data_sz, user_priv);
+    vpx_mem_set_thread_allocator(prev);
+  }
 
   return SAVE_STATUS(ctx, res);
 }
@@ -124,8 +129,12 @@ vpx_image_t *vpx_codec_get_frame(vpx_codec_ctx_t *ctx, vpx_codec_iter_t *iter) {
 
   if (!ctx || !iter || !ctx->iface || !ctx->priv)
     img = NULL;
-  else
+  else {
+    vpx_mem_allocator *const prev =
+        vpx_mem_set_thread_allocator(ctx->priv->mem_allocator);
     img = ctx->iface->dec.get_frame(get_alg_priv(ctx), iter);
+    vpx_mem_set_thread_allocator(prev);
+  }
 
   return img;
 }
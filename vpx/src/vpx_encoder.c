@@ -20,6 +20,7 @@
 #include "vp8/common/blockd.h"
 #include "vpx_config.h"
 #include "vpx/internal/vpx_codec_internal.h"
+#include "vpx_mem/vpx_mem.h"
 
 #define SAVE_STATUS(ctx, var) ((ctx) ? ((ctx)->err = (var)) : (var))
 
@@ -27,6 +28,18 @@ static vpx_codec_alg_priv_t *get_alg_priv(vpx_codec_ctx_t *ctx) {
   return (vpx_codec_alg_priv_t *)ctx->priv;
 }
 
+static vpx_codec_err_t encode(vpx_codec_ctx_t *ctx, const vpx_image_t *img,
+                              vpx_codec_pts_t pts, unsigned long duration,
+                              vpx_enc_frame_flags_t flags,
+                              vpx_enc_deadline_t deadline) {
+  vpx_mem_allocator *const prev =
+      vpx_mem_set_thread_allocator(ctx->priv->mem_allocator);
+  const vpx_codec_err_t res = ctx->iface->enc.encode(
+      get_alg_priv(ctx), img, pts, duration, flags, deadline);
+  vpx_mem_set_thread_allocator(prev);
+  return res;
+}
+
 vpx_codec_err_t vpx_codec_enc_init_ver(vpx_codec_ctx_t *ctx,
                                        vpx_codec_iface_t *iface,
                                        const vpx_codec_enc_cfg_t *cfg,
@@ -52,7 +65,7 @@ vpx_codec_err_t vpx_codec_enc_init_ver(vpx_codec_ctx_t *ctx,
     ctx->priv = NULL;
     ctx->init_flags = flags;
     ctx->config.enc = cfg;
-    res = ctx->iface->init(ctx, NULL);
+    res = vpx_codec_init_instance(ctx, NULL);
 
     if (res) {
       // IMPORTANT: ctx->priv->err_detail must be null or point to a string
@@ -114,7 +127,7 @@ vpx_codec_err_t vpx_codec_enc_init_multi_ver(
           ctx->priv = NULL;
           ctx->init_flags = flags;
           ctx->config.enc = cfg;
-          res = ctx->iface->init(ctx, &mr_cfg);
+          res = vpx_codec_init_instance(ctx, &mr_cfg);
         }
 
         if (res) {
@@ -214,8 +227,7 @@ vpx_codec_err_t vpx_codec_encode(vpx_codec_ctx_t *ctx, const vpx_image_t *img,
     FLOATING_POINT_INIT();
 
     if (num_enc == 1)
-      res = ctx->iface->enc.encode(get_alg_priv(ctx), img, pts, duration, flags,
-                                   deadline);
+      res = encode(ctx, img, pts, duration, flags, deadline);
     else {
       /* Multi-resolution encoding:
        * Encode multi-levels in reverse order. For example,
@@ -228,8 +240,7 @@ vpx_codec_err_t vpx_codec_encode(vpx_codec_ctx_t *ctx, const vpx_image_t *img,
       if (img) img += num_enc - 1;
 
       for (i = num_enc - 1; i >= 0; i--) {
-        if ((res = ctx->iface->enc.encode(get_alg_priv(ctx), img, pts, duration,
-                                          flags, deadline)))
+        if ((res = encode(ctx, img, pts, duration, flags, deadline)))
           break;
 
         ctx--;
@@ -352,8 +363,12 @@ vpx_codec_err_t vpx_codec_enc_config_set(vpx_codec_ctx_t *ctx,
     res = VPX_CODEC_INVALID_PARAM;
   else if (!(ctx->iface->caps & VPX_CODEC_CAP_ENCODER))
     res = VPX_CODEC_INCAPABLE;
-  else
+  else {
+    vpx_mem_allocator *const prev =
+        vpx_mem_set_thread_allocator(ctx->priv->mem_allocator);
     res = ctx->iface->enc.cfg_set(get_alg_priv(ctx), cfg);
+    vpx_mem_set_thread_allocator(prev);
+  }
 
   return SAVE_STATUS(ctx, res);
 }
@@ -59,7 +59,8 @@ static vpx_image_t *img_alloc_helper(vpx_image_t *img, vpx_img_fmt_t fmt,
     case VPX_IMG_FMT_I422:
     case VPX_IMG_FMT_I440: bps = 16; break;
     case VPX_IMG_FMT_I444: bps = 24; break;
-    case VPX_IMG_FMT_I42016: bps = 24; break;
+    case VPX_IMG_FMT_I42016:
+    case VPX_IMG_FMT_P010: bps = 24; break;
     case VPX_IMG_FMT_I42216:
     case VPX_IMG_FMT_I44016: bps = 32; break;
     case VPX_IMG_FMT_I44416: bps = 48; break;
@@ -67,8 +68,8 @@ static vpx_image_t *img_alloc_helper(vpx_image_t *img, vpx_img_fmt_t fmt,
   }
 
   /* Get chroma shift values for this format */
-  // For VPX_IMG_FMT_NV12, xcs needs to be 0 such that UV data is all read at
-  // once.
+  // For VPX_IMG_FMT_NV12 and VPX_IMG_FMT_P010, xcs needs to be 0 such that UV
+  // data is all read at once.
   switch (fmt) {
     case VPX_IMG_FMT_I420:
     case VPX_IMG_FMT_YV12:
@@ -81,6 +82,7 @@ static vpx_image_t *img_alloc_helper(vpx_image_t *img, vpx_img_fmt_t fmt,
   switch (fmt) {
     case VPX_IMG_FMT_I420:
     case VPX_IMG_FMT_NV12:
+    case VPX_IMG_FMT_P010:
     case VPX_IMG_FMT_I440:
     case VPX_IMG_FMT_YV12:
     case VPX_IMG_FMT_I42016:
@@ -201,10 +203,10 @@ int vpx_img_set_rect(vpx_image_t *img, unsigned int x, unsigned int y,
 
       unsigned int uv_x = x >> img->x_chroma_shift;
       unsigned int uv_y = y >> img->y_chroma_shift;
-      if (img->fmt == VPX_IMG_FMT_NV12) {
+      if (img->fmt == VPX_IMG_FMT_NV12 || img->fmt == VPX_IMG_FMT_P010) {
         img->planes[VPX_PLANE_U] =
-            data + uv_x + uv_y * img->stride[VPX_PLANE_U];
-        img->planes[VPX_PLANE_V] = img->planes[VPX_PLANE_U] + 1;
+            data + uv_x * bytes_per_sample + uv_y * img->stride[VPX_PLANE_U];
+        img->planes[VPX_PLANE_V] = img->planes[VPX_PLANE_U] + bytes_per_sample;
       } else if (!(img->fmt & VPX_IMG_FMT_UV_FLIP)) {
         img->planes[VPX_PLANE_U] =
             data + uv_x * bytes_per_sample + uv_y * img->stride[VPX_PLANE_U];
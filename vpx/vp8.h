@@ -112,6 +112,37 @@ typedef struct vp9_ref_frame {
   vpx_image_t img; /**< img structure to populate (output) */
 } vp9_ref_frame_t;
 
+/*!\brief VP9 mode info of an 8x8 block
+ *
+ * Describes the prediction block covering an 8x8 block of a decoded frame.
+ * Motion vectors are in 1/8 pel units.
+ */
+typedef struct vpx_mode_info {
+  unsigned char width;  /**< width of the prediction block, in pixels */
+  unsigned char height; /**< height of the prediction block, in pixels */
+  /*! references of the block: 0 for intra, 1 for last, 2 for golden and 3
+   * for altref, and -1 for no second reference */
+  signed char ref_frame[2];
+  short mv_row[2];        /**< motion vector rows, per reference */
+  short mv_col[2];        /**< motion vector columns, per reference */
+  unsigned char tx_size;  /**< transform size: 0 4x4, 1 8x8, 2 16x16, 3 32x32 */
+  unsigned char skip;     /**< nonzero if the block has no residual */
+} vpx_mode_info_t;
+
+/*!\brief VP9 mode info of a frame
+ *
+ * Holds a vpx_mode_info_t per 8x8 block of a frame of width x height pixels,
+ * in raster order. rows and cols are the size of the frame in 8x8 blocks,
+ * rounded up.
+ */
+typedef struct vpx_mode_info_map {
+  vpx_mode_info_t *mode_info; /**< rows * cols entries */
+  unsigned int rows;          /**< number of rows */
+  unsigned int cols;          /**< number of columns */
+  unsigned int width;         /**< frame width, in pixels */
+  unsigned int height;        /**< frame height, in pixels */
+} vpx_mode_info_map_t;
+
 /*!\cond */
 /*!\brief vp8 decoder control function parameter type
  *
@@ -778,6 +778,145 @@ enum vp8e_enc_control_id {
    * Supported in codecs: VP9
    */
   VP9E_ENABLE_EXTERNAL_RC_TPL,
+
+  /*!\brief Codec control function to allocate frame buffers with a small
+   * border, int parameter
+   *
+   * Reference and lookahead frames are allocated with a 64 pixel border
+   * instead of a 160 pixel one, which saves memory, especially with large
+   * frames and many lag frames. Motion search is restricted to the border and
+   * prediction from beyond it is done by replicating the edge pixels, which
+   * slightly lowers the quality of motion at the frame edges.
+   *
+   *  - 0 = off (default)
+   *  - 1 = on
+   *
+   * Must be set before the first frame is encoded.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9E_SET_MIN_BORDER,
+
+  /*!\brief Codec control function to skip static superblocks in realtime
+   * mode, int parameter
+   *
+   * Superblocks whose pixels all equal those of the previous frame are coded
+   * as a skipped copy of the last frame, without partitioning or mode search.
+   * The encoder compares each frame with the previous one, unless the
+   * application passes the changed superblocks with VP9E_SET_SB_DIRTY_MAP.
+   * Only used for one pass realtime encoding without lag, spatial layers or
+   * noise reduction.
+   *
+   *  - 0 = off (default)
+   *  - 1 = on
+   *
+   * Supported in codecs: VP9
+   */
+  VP9E_SET_SKIP_STATIC_SB,
+
+  /*!\brief Codec control function to pass the changed superblocks of the
+   * next frame, vpx_sb_dirty_map_t* parameter
+   *
+   * Used instead of comparing the next frame with the previous one when
+   * VP9E_SET_SKIP_STATIC_SB is on. The map applies to the next frame passed
+   * to vpx_codec_encode() only.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9E_SET_SB_DIRTY_MAP,
+
+  /*!\brief Codec control function to pass motion vectors the application
+   * already has for the next frame, vpx_motion_hints_t* parameter
+   *
+   * The motion search of each block starts from the hint of the reference
+   * it searches and only refines it, instead of searching the whole range.
+   * The hints may come from the decoder of a transcoded stream or from an
+   * optical flow pass. They apply to the next frame encoded only, which is
+   * the next frame passed to vpx_codec_encode() when lag_in_frames is 0.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9E_SET_MOTION_HINTS,
+
+  /*!\brief Codec control function to pass the mode info of the decoded
+   * frame being transcoded, vpx_mode_info_map_t* parameter
+   *
+   * Takes the map from VP9D_GET_MODE_INFO. The map is scaled to the frame
+   * size of the encoder, so a transcoder can reuse the decisions of the
+   * input stream for each rung of a resolution ladder. In realtime mode the
+   * block sizes of the map become the partitioning of inter frames, without
+   * the variance analysis. The motion vectors of blocks predicted from the
+   * last frame are passed as VP9E_SET_MOTION_HINTS for the last frame, and
+   * replace any hints already passed. The other references of the two
+   * streams may hold different frames and are searched as usual. The map
+   * applies to the next frame encoded only, and is not used with spatial
+   * layers.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9E_SET_MODE_INFO,
+
+  /*!\brief Codec control function to set the time budget to encode a frame,
+   * in microseconds, unsigned int parameter
+   *
+   * The encoder measures the time it spends on each frame and adjusts its
+   * speed between frames, from the speed set with VP8E_SET_CPUUSED up to 9,
+   * so the average time to encode a frame stays within the budget, e.g. as
+   * content gets harder to encode in live transcoding. The speed is raised
+   * as soon as frames take longer than the budget, and only lowered again
+   * once they have taken less than 3/4 of it for a while. Speeds below 5,
+   * which use the rd mode search, are only raised up to 4. Only used for one
+   * pass realtime encoding without spatial layers.
+   *
+   *  - 0 = off (default)
+   *
+   * Supported in codecs: VP9
+   */
+  VP9E_SET_TARGET_FRAME_TIME,
+
+  /*!\brief Codec control function to get the speed the last frame was
+   * encoded at, int* parameter
+   *
+   * Reports the speed chosen for VP9E_SET_TARGET_FRAME_TIME.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9E_GET_LAST_SPEED,
+
+  /*!\brief Codec control function to get the number of times the realtime
+   * mode search pruned a reference or an interpolation filter search by the
+   * superblock sad, vpx_sb_sad_prune_stats_t* parameter
+   *
+   * The counts are totals over all the frames encoded so far. The pruning is
+   * used in one pass realtime encoding at speed 7 and above without spatial
+   * or temporal layers.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9E_GET_SB_SAD_PRUNE_STATS,
+
+  /*!\brief Codec control function to get the number of superblocks of the
+   * last frame coded as unchanged copies of LAST_FRAME, int* parameter
+   *
+   * The count is 0 unless VP9E_SET_SKIP_STATIC_SB is on.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9E_GET_STATIC_SB_COUNT,
+
+  /*!\brief Codec control function to rebuild all the rate cost tables on
+   * every frame, int parameter
+   *
+   * By default only the tables whose probabilities changed since they were
+   * last built are rebuilt. The output is the same either way, so this is
+   * only useful to test that.
+   *
+   *  - 0 = off (default)
+   *  - 1 = on
+   *
+   * Supported in codecs: VP9
+   */
+  VP9E_SET_DISABLE_RD_COST_CACHE,
 };
 
 /*!\brief vpx 1-D scaling mode
@@ -855,6 +994,56 @@ typedef struct vpx_active_map {
   unsigned int cols; /**< number of cols */
 } vpx_active_map_t;
 
+/*!\brief  vpx superblock dirty map
+ *
+ * Marks the 64x64 superblocks of a frame that differ from the previous frame.
+ *
+ */
+
+typedef struct vpx_sb_dirty_map {
+  /*!\brief 1 for each superblock that changed, 0 if it is identical */
+  unsigned char *dirty_map;
+  unsigned int rows; /**< number of rows, (height + 63) / 64 */
+  unsigned int cols; /**< number of cols, (width + 63) / 64 */
+} vpx_sb_dirty_map_t;
+
+/*!\brief  vpx superblock sad pruning statistics
+ *
+ * Counts returned by VP9E_GET_SB_SAD_PRUNE_STATS.
+ *
+ */
+
+typedef struct vpx_sb_sad_prune_stats {
+  /*!\brief Blocks for which a reference was not searched */
+  uint64_t ref_prunes;
+  /*!\brief Modes whose interpolation filter search was skipped */
+  uint64_t filter_skips;
+} vpx_sb_sad_prune_stats_t;
+
+/*!\brief Marks a block of vpx_motion_hints_t without a motion vector. */
+#define VPX_MOTION_HINT_NONE (-32768)
+
+/*!\brief  vpx motion vector hint */
+typedef struct vpx_motion_hint {
+  short row; /**< vertical component in 1/8 pixels, or VPX_MOTION_HINT_NONE */
+  short col; /**< horizontal component in 1/8 pixels */
+} vpx_motion_hint_t;
+
+/*!\brief  vpx motion hints
+ *
+ * Motion vectors of the blocks of a frame, in raster order, pointing to
+ * where each block comes from in a reference frame.
+ *
+ */
+
+typedef struct vpx_motion_hints {
+  /*!\brief Hints for the last, golden and altref frames, NULL if none */
+  vpx_motion_hint_t *hints[3];
+  unsigned int block_size; /**< 8 or 16 */
+  unsigned int rows;       /**< (height + block_size - 1) / block_size */
+  unsigned int cols;       /**< (width + block_size - 1) / block_size */
+} vpx_motion_hints_t;
+
 /*!\brief  vpx image scaling mode
  *
  * This defines the data structure for image scaling mode
@@ -1110,6 +1299,26 @@ VPX_CTRL_USE_TYPE(VP9E_SET_QUANTIZER_ONE_PASS, int)
 #define VPX_CTRL_VP9E_SET_QUANTIZER_ONE_PASS
 VPX_CTRL_USE_TYPE(VP9E_ENABLE_EXTERNAL_RC_TPL, int)
 #define VPX_CTRL_VP9E_ENABLE_EXTERNAL_RC_TPL
+VPX_CTRL_USE_TYPE(VP9E_SET_MIN_BORDER, int)
+#define VPX_CTRL_VP9E_SET_MIN_BORDER
+VPX_CTRL_USE_TYPE(VP9E_SET_SKIP_STATIC_SB, int)
+#define VPX_CTRL_VP9E_SET_SKIP_STATIC_SB
+VPX_CTRL_USE_TYPE(VP9E_SET_SB_DIRTY_MAP, vpx_sb_dirty_map_t *)
+#define VPX_CTRL_VP9E_SET_SB_DIRTY_MAP
+VPX_CTRL_USE_TYPE(VP9E_SET_MOTION_HINTS, vpx_motion_hints_t *)
+#define VPX_CTRL_VP9E_SET_MOTION_HINTS
+VPX_CTRL_USE_TYPE(VP9E_SET_MODE_INFO, vpx_mode_info_map_t *)
+#define VPX_CTRL_VP9E_SET_MODE_INFO
+VPX_CTRL_USE_TYPE(VP9E_SET_TARGET_FRAME_TIME, unsigned int)
+#define VPX_CTRL_VP9E_SET_TARGET_FRAME_TIME
+VPX_CTRL_USE_TYPE(VP9E_GET_LAST_SPEED, int *)
+#define VPX_CTRL_VP9E_GET_LAST_SPEED
+VPX_CTRL_USE_TYPE(VP9E_GET_SB_SAD_PRUNE_STATS, vpx_sb_sad_prune_stats_t *)
+#define VPX_CTRL_VP9E_GET_SB_SAD_PRUNE_STATS
+VPX_CTRL_USE_TYPE(VP9E_GET_STATIC_SB_COUNT, int *)
+#define VPX_CTRL_VP9E_GET_STATIC_SB_COUNT
+VPX_CTRL_USE_TYPE(VP9E_SET_DISABLE_RD_COST_CACHE, int)
+#define VPX_CTRL_VP9E_SET_DISABLE_RD_COST_CACHE
 
 /*!\endcond */
 /*! @} - end defgroup vp8_encoder */
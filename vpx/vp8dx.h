@@ -158,6 +158,98 @@ enum vp8_dec_control_id {
    */
   VP9D_SET_LOOP_FILTER_OPT,
 
+  /*!\brief Codec control function to restrict decoding to a region.
+   *
+   * Takes a vpx_image_rect_t * giving the part of the frame, in luma pixels,
+   * that the application displays. Tile columns that do not intersect it are
+   * not decoded, so only the horizontal extent of the rectangle matters. Pixels
+   * outside the decoded tile columns are undefined. NULL or an empty rectangle
+   * decodes the whole frame, which is the default.
+   *
+   * Tiles are only skipped in frames whose probability adaptation does not
+   * carry over to later frames, i.e. error resilient or frame parallel
+   * streams, or frames that do not refresh the frame context. Frames with
+   * skipped tiles, and frames predicting from them, are decoded on a single
+   * thread. The decoder tracks which columns still match a full decode, as
+   * far as prediction and the loop filter can carry the missing tiles into
+   * the decoded ones, and reports a frame through VP8D_GET_FRAME_CORRUPTED
+   * once they no longer cover the region. Streams without the loop filter
+   * and with motion vectors kept inside the tiles stay exact.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9D_SET_DECODE_REGION,
+
+  /*!\brief Codec control function to skip non-reference frames.
+   *
+   * When set to nonzero, frames that refresh no reference buffer are dropped
+   * after their headers, without decoding their tiles, and produce no output
+   * frame. This speeds up seeking and thumbnail generation. Frames whose
+   * probability adaptation carries over to later frames are still decoded.
+   * A later frame that predicts motion vectors or segment ids from a dropped
+   * frame is reported through VP8D_GET_FRAME_CORRUPTED, as are the frames
+   * predicting from it until the next key frame. The default value is 0.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9D_SET_SKIP_NON_REF_FRAMES,
+
+  /*!\brief Codec control function to drop frames until the next key frame.
+   *
+   * When set to nonzero, the frames passed to vpx_codec_decode() are dropped
+   * without being decoded until a key frame arrives, which is decoded and
+   * clears the setting. Combined with VP9D_SET_SKIP_NON_REF_FRAMES, an
+   * application can decode only up to the frame it wants to show.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9D_SET_SKIP_TO_KEYFRAME,
+
+  /*!\brief Codec control function to decode at reduced resolution.
+   *
+   * Takes the log2 of the downscaling factor: 0 decodes at full resolution,
+   * which is the default, 1 at half and 2 at a quarter of the width and
+   * height. Frames are reconstructed directly at the reduced size, from a
+   * low frequency subset of the coefficients and with motion compensation
+   * scaled down, and the loop filter and postprocessing are skipped. The
+   * output only approximates a downscaled full decode and drifts from it
+   * until the next key frame, so it is meant for previews and thumbnails.
+   *
+   * The setting takes effect at the next key frame, and is ignored for high
+   * bit depth streams. VP9D_GET_FRAME_SIZE still returns the coded size.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9D_SET_REDUCED_RESOLUTION,
+
+  /*!\brief Codec control function to output 4:2:0 frames semi-planar.
+   *
+   * When set to nonzero, 4:2:0 frames are output as VPX_IMG_FMT_NV12, or as
+   * VPX_IMG_FMT_P010 for high bit depth streams, instead of planar. The
+   * chroma is interleaved as the rows of each frame are finished, while they
+   * are still in cache, so applications feeding semi-planar consumers need
+   * no conversion pass of their own. The luma plane of NV12 frames is the
+   * decoder's frame buffer. Other subsamplings are still output planar. The
+   * default value is 0.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9D_SET_SEMI_PLANAR_OUTPUT,
+
+  /*!\brief Codec control function to get the mode info of the last frame.
+   *
+   * Takes a vpx_mode_info_map_t * whose rows and cols match the size of the
+   * frame from VP9D_GET_FRAME_SIZE, in 8x8 blocks rounded up, and fills its
+   * mode_info array, width and height from the last decoded frame. A
+   * transcoder passes the map to the encoder through VP9E_SET_MODE_INFO. It
+   * fails when the last frame showed an existing frame, or was not fully
+   * decoded because of VP9D_SET_DECODE_REGION or
+   * VP9D_SET_SKIP_NON_REF_FRAMES.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9D_GET_MODE_INFO,
+
   VP8_DECODER_CTRL_ID_MAX
 };
 
@@ -217,6 +309,18 @@ VPX_CTRL_USE_TYPE(VP9D_SET_ROW_MT, int)
 #define VPX_CTRL_VP9_DECODE_SET_ROW_MT
 VPX_CTRL_USE_TYPE(VP9D_SET_LOOP_FILTER_OPT, int)
 #define VPX_CTRL_VP9_SET_LOOP_FILTER_OPT
+VPX_CTRL_USE_TYPE(VP9D_SET_DECODE_REGION, vpx_image_rect_t *)
+#define VPX_CTRL_VP9D_SET_DECODE_REGION
+VPX_CTRL_USE_TYPE(VP9D_SET_SKIP_NON_REF_FRAMES, int)
+#define VPX_CTRL_VP9D_SET_SKIP_NON_REF_FRAMES
+VPX_CTRL_USE_TYPE(VP9D_SET_SKIP_TO_KEYFRAME, int)
+#define VPX_CTRL_VP9D_SET_SKIP_TO_KEYFRAME
+VPX_CTRL_USE_TYPE(VP9D_SET_REDUCED_RESOLUTION, int)
+#define VPX_CTRL_VP9D_SET_REDUCED_RESOLUTION
+VPX_CTRL_USE_TYPE(VP9D_SET_SEMI_PLANAR_OUTPUT, int)
+#define VPX_CTRL_VP9D_SET_SEMI_PLANAR_OUTPUT
+VPX_CTRL_USE_TYPE(VP9D_GET_MODE_INFO, vpx_mode_info_map_t *)
+#define VPX_CTRL_VP9D_GET_MODE_INFO
 
 /*!\endcond */
 /*! @} - end defgroup vp8_decoder */
@@ -169,6 +169,16 @@ typedef long vpx_codec_caps_t;
  */
 typedef long vpx_codec_flags_t;
 
+/*!\brief Back large buffers with huge pages
+ *
+ * Accepted by all encoders and decoders. Frame buffers allocated by the codec
+ * are aligned to 2 MB and the kernel is asked to back them with transparent
+ * huge pages, which reduces TLB misses when predicting from large reference
+ * frames. This costs up to 2 MB of address space per frame buffer. Has no
+ * effect where transparent huge pages are not available.
+ */
+#define VPX_CODEC_USE_HUGE_PAGES 0x1000000
+
 /*!\brief Codec interface structure.
  *
  * Contains function pointers and other data private to the codec
@@ -223,6 +233,48 @@ typedef enum vpx_bit_depth {
   VPX_BITS_12 = 12, /**< 12 bits */
 } vpx_bit_depth_t;
 
+/*!\brief Memory allocation callback prototype
+ *
+ * Returns a block of at least \p size bytes, or NULL if the allocation is
+ * refused, in which case the codec call that needed it fails with
+ * #VPX_CODEC_MEM_ERROR. The block does not need to be aligned. \p site is
+ * "file:line" of the codec call site when libvpx is built with
+ * VPX_MEM_TRACK_CALL_SITES defined, and NULL otherwise.
+ */
+typedef void *(*vpx_codec_alloc_cb_fn_t)(void *priv, size_t size,
+                                         const char *site);
+
+/*!\brief Memory release callback prototype
+ *
+ * Releases a block returned by the matching #vpx_codec_alloc_cb_fn_t. It may
+ * be called from any of the codec's worker threads.
+ */
+typedef void (*vpx_codec_free_cb_fn_t)(void *priv, void *mem);
+
+/*!\brief Memory allocator of a codec instance
+ *
+ * Installed with vpx_codec_set_mem_allocator(). Leaving both callbacks NULL
+ * selects malloc() and free().
+ */
+typedef struct vpx_codec_mem_allocator {
+  vpx_codec_alloc_cb_fn_t alloc_cb; /**< Allocation callback */
+  vpx_codec_free_cb_fn_t free_cb;   /**< Release callback */
+  void *priv;                       /**< Passed to both callbacks */
+} vpx_codec_mem_allocator_t;
+
+/*!\brief Memory statistics of a codec instance
+ *
+ * Sizes are the ones requested by the codec and do not include the alignment
+ * and bookkeeping overhead.
+ */
+typedef struct vpx_codec_mem_stats {
+  uint64_t bytes_in_use;      /**< Bytes currently allocated */
+  uint64_t peak_bytes_in_use; /**< Largest value of bytes_in_use so far */
+  uint64_t num_allocs;        /**< Number of successful allocations */
+  uint64_t num_frees;         /**< Number of releases */
+  uint64_t num_failed_allocs; /**< Number of refused allocations */
+} vpx_codec_mem_stats_t;
+
 /*
  * Library Version Number Interface
  *
@@ -364,6 +416,39 @@ vpx_codec_err_t vpx_codec_destroy(vpx_codec_ctx_t *ctx);
  */
 vpx_codec_caps_t vpx_codec_get_caps(vpx_codec_iface_t *iface);
 
+/*!\brief Set the memory allocator for new codec instances
+ *
+ * Codec instances initialized afterwards by the calling thread get their
+ * memory from this allocator, including the memory their worker threads
+ * allocate. Each instance keeps the allocator it was initialized with until
+ * it is destroyed, so the allocator may be changed between initializations
+ * to give every instance its own arena or budget. The structure is copied.
+ *
+ * \param[in] allocator   Allocator to use, or NULL for malloc() and free()
+ *
+ * \retval #VPX_CODEC_OK
+ *     The allocator has been set.
+ * \retval #VPX_CODEC_INVALID_PARAM
+ *     Only one of the callbacks is set.
+ */
+vpx_codec_err_t vpx_codec_set_mem_allocator(
+    const vpx_codec_mem_allocator_t *allocator);
+
+/*!\brief Get the memory statistics of a codec instance
+ *
+ * \param[in]  ctx     Pointer to this instance's context
+ * \param[out] stats   Statistics of the memory owned by the instance
+ *
+ * \retval #VPX_CODEC_OK
+ *     The statistics have been retrieved.
+ * \retval #VPX_CODEC_INVALID_PARAM
+ *     ctx or stats is a null pointer.
+ * \retval #VPX_CODEC_ERROR
+ *     Codec context not initialized.
+ */
+vpx_codec_err_t vpx_codec_get_mem_stats(const vpx_codec_ctx_t *ctx,
+                                        vpx_codec_mem_stats_t *stats);
+
 /*!\brief Control algorithm
  *
  * This function is used to exchange algorithm specific data with the codec
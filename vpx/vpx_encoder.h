@@ -80,7 +80,12 @@ extern "C" {
 /*! Can output one partition at a time. Each partition is returned in its
  *  own VPX_CODEC_CX_FRAME_PKT, with the FRAME_IS_FRAGMENT flag set for
  *  every partition but the last. In this mode all frames are always
- *  returned partition by partition.
+ *  returned partition by partition. For VP9 the first partition holds the
+ *  frame headers and each following partition holds one tile, including
+ *  its tile size marker. With a callback registered through
+ *  VP9E_REGISTER_CX_CALLBACK, VP9 hands out each partition as soon as it has
+ *  been packed, unless the frame may still be dropped after it is packed or
+ *  spatial layers are in use.
  */
 #define VPX_CODEC_CAP_OUTPUT_PARTITION 0x20000
 
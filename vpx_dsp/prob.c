@@ -8,6 +8,7 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include "./vpx_dsp_rtcd.h"
 #include "./prob.h"
 
 const uint8_t vpx_norm[256] = {
@@ -45,3 +46,17 @@ void vpx_tree_merge_probs(const vpx_tree_index *tree, const vpx_prob *pre_probs,
                           const unsigned int *counts, vpx_prob *probs) {
   tree_merge_probs_impl(0, tree, pre_probs, counts, probs);
 }
+
+// Adapts n binary probabilities at once from interleaved branch counts
+// { ct0[0], ct1[0], ct0[1], ct1[1], ... }. mode_mv_merge_probs() is equivalent
+// to merge_probs() with MODE_MV_COUNT_SAT and MODE_MV_MAX_UPDATE_FACTOR, so
+// this covers the coefficient as well as the mode and mv adaptation.
+void vpx_merge_probs_c(const vpx_prob *pre_probs, const unsigned int *branch_ct,
+                       int n, unsigned int count_sat,
+                       unsigned int max_update_factor, vpx_prob *probs) {
+  int i;
+  for (i = 0; i < n; ++i) {
+    probs[i] = merge_probs(pre_probs[i], branch_ct + 2 * i, count_sat,
+                           max_update_factor);
+  }
+}
@@ -35,6 +35,7 @@ typedef int8_t vpx_tree_index;
 #define vpx_complement(x) (255 - (x))
 
 #define MODE_MV_COUNT_SAT 20
+#define MODE_MV_MAX_UPDATE_FACTOR 128
 
 /* We build coding trees compactly in arrays.
    Each node of the tree is a pair of vpx_tree_indices.
@@ -75,7 +76,7 @@ static INLINE vpx_prob merge_probs(vpx_prob pre_prob, const unsigned int ct[2],
   return weighted_prob(pre_prob, prob, factor);
 }
 
-// MODE_MV_MAX_UPDATE_FACTOR (128) * count / MODE_MV_COUNT_SAT;
+// MODE_MV_MAX_UPDATE_FACTOR * count / MODE_MV_COUNT_SAT;
 static const int count_to_update_factor[MODE_MV_COUNT_SAT + 1] = {
   0,  6,  12, 19, 25, 32,  38,  44,  51,  57, 64,
   70, 76, 83, 89, 96, 102, 108, 115, 121, 128
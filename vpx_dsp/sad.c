@@ -71,58 +71,83 @@ static INLINE unsigned int sad(const uint8_t *src_ptr, int src_stride,
     }                                                                          \
   }
 
+// Compare |src_ptr| to the 8 references starting at |ref_ptr| and stepping
+// one pixel to the right.
+#define sadMxNx8(m, n)                                                        \
+  void vpx_sad##m##x##n##x8_c(const uint8_t *src_ptr, int src_stride,         \
+                              const uint8_t *ref_ptr, int ref_stride,         \
+                              uint32_t sad_array[8]) {                        \
+    int i;                                                                    \
+    for (i = 0; i < 8; ++i)                                                   \
+      sad_array[i] =                                                          \
+          vpx_sad##m##x##n##_c(src_ptr, src_stride, ref_ptr + i, ref_stride); \
+  }
+
 /* clang-format off */
 // 64x64
 sadMxN(64, 64)
 sadMxNx4D(64, 64)
+sadMxNx8(64, 64)
 
 // 64x32
 sadMxN(64, 32)
 sadMxNx4D(64, 32)
+sadMxNx8(64, 32)
 
 // 32x64
 sadMxN(32, 64)
 sadMxNx4D(32, 64)
+sadMxNx8(32, 64)
 
 // 32x32
 sadMxN(32, 32)
 sadMxNx4D(32, 32)
+sadMxNx8(32, 32)
 
 // 32x16
 sadMxN(32, 16)
 sadMxNx4D(32, 16)
+sadMxNx8(32, 16)
 
 // 16x32
 sadMxN(16, 32)
 sadMxNx4D(16, 32)
+sadMxNx8(16, 32)
 
 // 16x16
 sadMxN(16, 16)
 sadMxNx4D(16, 16)
+sadMxNx8(16, 16)
 
 // 16x8
 sadMxN(16, 8)
 sadMxNx4D(16, 8)
+sadMxNx8(16, 8)
 
 // 8x16
 sadMxN(8, 16)
 sadMxNx4D(8, 16)
+sadMxNx8(8, 16)
 
 // 8x8
 sadMxN(8, 8)
 sadMxNx4D(8, 8)
+sadMxNx8(8, 8)
 
 // 8x4
 sadMxN(8, 4)
 sadMxNx4D(8, 4)
+sadMxNx8(8, 4)
 
 // 4x8
 sadMxN(4, 8)
 sadMxNx4D(4, 8)
+sadMxNx8(4, 8)
 
 // 4x4
 sadMxN(4, 4)
 sadMxNx4D(4, 4)
+sadMxNx8(4, 4)
 /* clang-format on */
 
 #if CONFIG_VP9_HIGHBITDEPTH
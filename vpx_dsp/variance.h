@@ -78,6 +78,9 @@ typedef struct vp9_variance_vtable {
   vpx_sad_multi_d_fn_t sdx4df;
   // Same as sadx4, but downsample the rows by a factor of 2.
   vpx_sad_multi_d_fn_t sdsx4df;
+  // SADs against the 8 references starting at ref_ptr and stepping one pixel
+  // to the right. May be NULL, in which case callers fall back to sdx4df.
+  vpx_sad_multi_fn_t sdx8f;
 } vp9_variance_fn_ptr_t;
 #endif  // CONFIG_VP9
 
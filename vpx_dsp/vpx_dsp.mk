@@ -23,6 +23,7 @@ DSP_SRCS-$(HAVE_SSE2)   += x86/bitdepth_conversion_sse2.h
 # bit reader
 DSP_SRCS-yes += prob.h
 DSP_SRCS-yes += prob.c
+DSP_SRCS-$(HAVE_SSE2) += x86/prob_sse2.c
 
 ifeq ($(CONFIG_ENCODERS),yes)
 DSP_SRCS-yes += bitwriter.h
@@ -391,6 +392,7 @@ DSP_SRCS-$(HAVE_LSX)    += loongarch/sad_lsx.c
 DSP_SRCS-$(HAVE_MMI)    += mips/sad_mmi.c
 DSP_SRCS-$(HAVE_MMI)    += mips/subtract_mmi.c
 
+DSP_SRCS-$(HAVE_SSE4_1) += x86/sad_sse4.c
 DSP_SRCS-$(HAVE_AVX2)   += x86/sad4d_avx2.c
 DSP_SRCS-$(HAVE_AVX2)   += x86/sad_avx2.c
 DSP_SRCS-$(HAVE_AVX2)   += x86/subtract_avx2.c
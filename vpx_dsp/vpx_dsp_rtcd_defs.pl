@@ -37,6 +37,12 @@ if ($opts{arch} eq "x86_64") {
   $avx512_x86_64 = 'avx512';
 }
 
+#
+# Probability adaptation
+#
+add_proto qw/void vpx_merge_probs/, "const uint8_t *pre_probs, const unsigned int *branch_ct, int n, unsigned int count_sat, unsigned int max_update_factor, uint8_t *probs";
+specialize qw/vpx_merge_probs sse2/;
+
 #
 # Intra prediction
 #
@@ -1008,6 +1014,48 @@ specialize qw/vpx_sad_skip_4x8x4d neon sse2/;
 add_proto qw/void vpx_sad_skip_4x4x4d/, "const uint8_t *src_ptr, int src_stride, const uint8_t *const ref_array[4], int ref_stride, uint32_t sad_array[4]";
 specialize qw/vpx_sad_skip_4x4x4d neon/;
 
+#
+# Multi-block SAD, comparing a reference to 8 horizontally adjacent blocks
+#
+add_proto qw/void vpx_sad64x64x8/, "const uint8_t *src_ptr, int src_stride, const uint8_t *ref_ptr, int ref_stride, uint32_t sad_array[8]";
+specialize qw/vpx_sad64x64x8 sse4_1/;
+
+add_proto qw/void vpx_sad64x32x8/, "const uint8_t *src_ptr, int src_stride, const uint8_t *ref_ptr, int ref_stride, uint32_t sad_array[8]";
+specialize qw/vpx_sad64x32x8 sse4_1/;
+
+add_proto qw/void vpx_sad32x64x8/, "const uint8_t *src_ptr, int src_stride, const uint8_t *ref_ptr, int ref_stride, uint32_t sad_array[8]";
+specialize qw/vpx_sad32x64x8 sse4_1/;
+
+add_proto qw/void vpx_sad32x32x8/, "const uint8_t *src_ptr, int src_stride, const uint8_t *ref_ptr, int ref_stride, uint32_t sad_array[8]";
+specialize qw/vpx_sad32x32x8 sse4_1/;
+
+add_proto qw/void vpx_sad32x16x8/, "const uint8_t *src_ptr, int src_stride, const uint8_t *ref_ptr, int ref_stride, uint32_t sad_array[8]";
+specialize qw/vpx_sad32x16x8 sse4_1/;
+
+add_proto qw/void vpx_sad16x32x8/, "const uint8_t *src_ptr, int src_stride, const uint8_t *ref_ptr, int ref_stride, uint32_t sad_array[8]";
+specialize qw/vpx_sad16x32x8 sse4_1/;
+
+add_proto qw/void vpx_sad16x16x8/, "const uint8_t *src_ptr, int src_stride, const uint8_t *ref_ptr, int ref_stride, uint32_t sad_array[8]";
+specialize qw/vpx_sad16x16x8 sse4_1/;
+
+add_proto qw/void vpx_sad16x8x8/, "const uint8_t *src_ptr, int src_stride, const uint8_t *ref_ptr, int ref_stride, uint32_t sad_array[8]";
+specialize qw/vpx_sad16x8x8 sse4_1/;
+
+add_proto qw/void vpx_sad8x16x8/, "const uint8_t *src_ptr, int src_stride, const uint8_t *ref_ptr, int ref_stride, uint32_t sad_array[8]";
+specialize qw/vpx_sad8x16x8 sse4_1/;
+
+add_proto qw/void vpx_sad8x8x8/, "const uint8_t *src_ptr, int src_stride, const uint8_t *ref_ptr, int ref_stride, uint32_t sad_array[8]";
+specialize qw/vpx_sad8x8x8 sse4_1/;
+
+add_proto qw/void vpx_sad8x4x8/, "const uint8_t *src_ptr, int src_stride, const uint8_t *ref_ptr, int ref_stride, uint32_t sad_array[8]";
+specialize qw/vpx_sad8x4x8 sse4_1/;
+
+add_proto qw/void vpx_sad4x8x8/, "const uint8_t *src_ptr, int src_stride, const uint8_t *ref_ptr, int ref_stride, uint32_t sad_array[8]";
+specialize qw/vpx_sad4x8x8 sse4_1/;
+
+add_proto qw/void vpx_sad4x4x8/, "const uint8_t *src_ptr, int src_stride, const uint8_t *ref_ptr, int ref_stride, uint32_t sad_array[8]";
+specialize qw/vpx_sad4x4x8 sse4_1/;
+
 add_proto qw/uint64_t vpx_sum_squares_2d_i16/, "const int16_t *src, int stride, int size";
 specialize qw/vpx_sum_squares_2d_i16 neon sve sse2 msa/;
 
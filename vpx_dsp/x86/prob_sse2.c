@@ -0,0 +1,104 @@
+/*
+ *  Copyright (c) 2024 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <emmintrin.h>
+
+#include "./vpx_dsp_rtcd.h"
+#include "vpx_dsp/prob.h"
+#include "vpx_dsp/x86/mem_sse2.h"
+
+// Converts the unsigned 32-bit values in the low two lanes to double.
+static INLINE __m128d cvt_epu32_pd(__m128i v) {
+  const __m128i sign = _mm_set1_epi32((int)0x80000000u);
+  return _mm_add_pd(_mm_cvtepi32_pd(_mm_xor_si128(v, sign)),
+                    _mm_set1_pd(2147483648.0));
+}
+
+// Returns floor(num / den) for the four 32-bit lanes. The quotients are at
+// most 256 and the operands below 2^41, so the double division is exact after
+// truncation.
+static INLINE __m128i div_floor_epu32(const __m128d num[2],
+                                      const __m128d den[2]) {
+  const __m128i q0 = _mm_cvttpd_epi32(_mm_div_pd(num[0], den[0]));
+  const __m128i q1 = _mm_cvttpd_epi32(_mm_div_pd(num[1], den[1]));
+  return _mm_unpacklo_epi64(q0, q1);
+}
+
+void vpx_merge_probs_sse2(const vpx_prob *pre_probs,
+                          const unsigned int *branch_ct, int n,
+                          unsigned int count_sat,
+                          unsigned int max_update_factor, vpx_prob *probs) {
+  const __m128i sign = _mm_set1_epi32((int)0x80000000u);
+  const __m128i sat = _mm_set1_epi32((int)count_sat);
+  const __m128i sat_signed = _mm_xor_si128(sat, sign);
+  const __m128i one = _mm_set1_epi32(1);
+  const __m128i min_prob = _mm_set1_epi16(1);
+  const __m128i max_prob = _mm_set1_epi16(MAX_PROB);
+  const __m128i round = _mm_set1_epi16(128);
+  const __m128i c256 = _mm_set1_epi16(256);
+  const __m128d sat_pd[2] = { _mm_set1_pd((double)count_sat),
+                              _mm_set1_pd((double)count_sat) };
+  const __m128d muf_pd = _mm_set1_pd((double)max_update_factor);
+  const __m128d c256_pd = _mm_set1_pd(256.0);
+  int i = 0;
+
+  for (; i + 4 <= n; i += 4) {
+    // { a0 b0 a1 b1 } { a2 b2 a3 b3 } -> { a0 a1 a2 a3 } { b0 b1 b2 b3 }
+    const __m128i c01 = _mm_loadu_si128((const __m128i *)(branch_ct + 2 * i));
+    const __m128i c23 =
+        _mm_loadu_si128((const __m128i *)(branch_ct + 2 * i + 4));
+    const __m128i t0 = _mm_shuffle_epi32(c01, 0xd8);
+    const __m128i t1 = _mm_shuffle_epi32(c23, 0xd8);
+    const __m128i ct0 = _mm_unpacklo_epi64(t0, t1);
+    const __m128i ct1 = _mm_unpackhi_epi64(t0, t1);
+    const __m128i den = _mm_add_epi32(ct0, ct1);
+    // count = VPXMIN(den, count_sat), compared as unsigned.
+    const __m128i gt = _mm_cmpgt_epi32(_mm_xor_si128(den, sign), sat_signed);
+    const __m128i count =
+        _mm_or_si128(_mm_and_si128(gt, sat), _mm_andnot_si128(gt, den));
+    // An empty branch has factor 0 and keeps pre_prob whatever prob is, so a
+    // zero denominator is only replaced to keep the division finite.
+    const __m128i den_nz = _mm_or_si128(
+        den, _mm_and_si128(_mm_cmpeq_epi32(den, _mm_setzero_si128()), one));
+    const __m128i half = _mm_srli_epi32(den, 1);
+    __m128d num_pd[2], den_pd[2];
+    __m128i prob, factor, pre, lo, hi, res;
+
+    num_pd[0] = _mm_add_pd(_mm_mul_pd(cvt_epu32_pd(ct0), c256_pd),
+                           _mm_cvtepi32_pd(half));
+    num_pd[1] = _mm_add_pd(
+        _mm_mul_pd(cvt_epu32_pd(_mm_srli_si128(ct0, 8)), c256_pd),
+        _mm_cvtepi32_pd(_mm_srli_si128(half, 8)));
+    den_pd[0] = cvt_epu32_pd(den_nz);
+    den_pd[1] = cvt_epu32_pd(_mm_srli_si128(den_nz, 8));
+    prob = div_floor_epu32(num_pd, den_pd);
+    prob = _mm_packs_epi32(prob, prob);
+    prob = _mm_min_epi16(_mm_max_epi16(prob, min_prob), max_prob);
+
+    num_pd[0] = _mm_mul_pd(_mm_cvtepi32_pd(count), muf_pd);
+    num_pd[1] = _mm_mul_pd(_mm_cvtepi32_pd(_mm_srli_si128(count, 8)), muf_pd);
+    factor = div_floor_epu32(num_pd, sat_pd);
+
+    // weighted_prob(): all terms fit in unsigned 16 bits.
+    pre = _mm_cvtsi32_si128(loadu_int32(pre_probs + i));
+    pre = _mm_unpacklo_epi8(pre, _mm_setzero_si128());
+    factor = _mm_packs_epi32(factor, factor);
+    lo = _mm_mullo_epi16(pre, _mm_sub_epi16(c256, factor));
+    hi = _mm_mullo_epi16(prob, factor);
+    res = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(lo, hi), round), 8);
+    res = _mm_packus_epi16(res, res);
+    storeu_int32(probs + i, _mm_cvtsi128_si32(res));
+  }
+
+  for (; i < n; ++i) {
+    probs[i] = merge_probs(pre_probs[i], branch_ct + 2 * i, count_sat,
+                           max_update_factor);
+  }
+}
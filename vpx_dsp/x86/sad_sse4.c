@@ -0,0 +1,99 @@
+/*
+ *  Copyright (c) 2024 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <smmintrin.h>
+
+#include "./vpx_dsp_rtcd.h"
+#include "vpx/vpx_integer.h"
+#include "vpx_dsp/vpx_dsp_common.h"
+#include "vpx_dsp/x86/mem_sse2.h"
+
+// mpsadbw reads 11 reference bytes for every 4 source pixels. Load exactly
+// the 15 bytes needed for the last 8 source pixels of a row so the final
+// column never reads beyond ref_ptr + 7 + width - 1.
+static INLINE __m128i load_ref_15(const uint8_t *ref) {
+  const __m128i lo = _mm_loadl_epi64((const __m128i *)ref);
+  const __m128i hi = _mm_loadl_epi64((const __m128i *)(ref + 7));
+  return _mm_unpacklo_epi64(lo, _mm_srli_epi64(hi, 8));
+}
+
+static INLINE __m128i load_ref_11(const uint8_t *ref) {
+  const __m128i lo = _mm_loadl_epi64((const __m128i *)ref);
+  const __m128i hi = _mm_cvtsi32_si128(loadu_int32(ref + 7));
+  return _mm_unpacklo_epi64(lo, _mm_srli_epi32(hi, 8));
+}
+
+// Returns the 8 SADs of 8 source pixels against |ref| + 0..7.
+static INLINE __m128i sad8_x8(const __m128i src, const __m128i ref) {
+  // Source pixels 0-3 against ref bytes 0-10 and pixels 4-7 against 4-14.
+  return _mm_add_epi16(_mm_mpsadbw_epu8(ref, src, 0x0),
+                       _mm_mpsadbw_epu8(ref, src, 0x5));
+}
+
+static INLINE void sad_wxh_x8_sse4_1(const uint8_t *src_ptr, int src_stride,
+                                     const uint8_t *ref_ptr, int ref_stride,
+                                     int w, int h, uint32_t sad_array[8]) {
+  // A row adds at most w * 255 to each 16-bit lane, so widen the row sums to
+  // 32 bits every 256 / w rows.
+  const int rows = VPXMIN(h, 256 / w);
+  __m128i sum_lo = _mm_setzero_si128();
+  __m128i sum_hi = _mm_setzero_si128();
+  int i, j, x;
+
+  for (i = 0; i < h; i += rows) {
+    __m128i sum16 = _mm_setzero_si128();
+    for (j = 0; j < rows; ++j) {
+      if (w == 4) {
+        const __m128i s = _mm_cvtsi32_si128(loadu_int32(src_ptr));
+        sum16 = _mm_add_epi16(sum16,
+                              _mm_mpsadbw_epu8(load_ref_11(ref_ptr), s, 0x0));
+      } else {
+        for (x = 0; x < w - 8; x += 8) {
+          const __m128i s = _mm_loadl_epi64((const __m128i *)(src_ptr + x));
+          const __m128i r = _mm_loadu_si128((const __m128i *)(ref_ptr + x));
+          sum16 = _mm_add_epi16(sum16, sad8_x8(s, r));
+        }
+        sum16 = _mm_add_epi16(
+            sum16, sad8_x8(_mm_loadl_epi64((const __m128i *)(src_ptr + x)),
+                           load_ref_15(ref_ptr + x)));
+      }
+      src_ptr += src_stride;
+      ref_ptr += ref_stride;
+    }
+    sum_lo = _mm_add_epi32(sum_lo, _mm_cvtepu16_epi32(sum16));
+    sum_hi = _mm_add_epi32(sum_hi,
+                           _mm_cvtepu16_epi32(_mm_srli_si128(sum16, 8)));
+  }
+
+  _mm_storeu_si128((__m128i *)sad_array, sum_lo);
+  _mm_storeu_si128((__m128i *)(sad_array + 4), sum_hi);
+}
+
+#define SAD_WXH_X8(w, h)                                                   \
+  void vpx_sad##w##x##h##x8_sse4_1(const uint8_t *src_ptr, int src_stride, \
+                                   const uint8_t *ref_ptr, int ref_stride, \
+                                   uint32_t sad_array[8]) {                \
+    sad_wxh_x8_sse4_1(src_ptr, src_stride, ref_ptr, ref_stride, w, h,      \
+                      sad_array);                                          \
+  }
+
+SAD_WXH_X8(64, 64)
+SAD_WXH_X8(64, 32)
+SAD_WXH_X8(32, 64)
+SAD_WXH_X8(32, 32)
+SAD_WXH_X8(32, 16)
+SAD_WXH_X8(16, 32)
+SAD_WXH_X8(16, 16)
+SAD_WXH_X8(16, 8)
+SAD_WXH_X8(8, 16)
+SAD_WXH_X8(8, 8)
+SAD_WXH_X8(8, 4)
+SAD_WXH_X8(4, 8)
+SAD_WXH_X8(4, 4)
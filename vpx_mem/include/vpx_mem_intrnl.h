@@ -12,8 +12,6 @@
 #define VPX_VPX_MEM_INCLUDE_VPX_MEM_INTRNL_H_
 #include "./vpx_config.h"
 
-#define ADDRESS_STORAGE_SIZE sizeof(size_t)
-
 #ifndef DEFAULT_ALIGNMENT
 #if defined(VXWORKS)
 /*default addr alignment to use in calls to vpx_* functions other than
@@ -15,6 +15,19 @@
 #include <string.h>
 #include "include/vpx_mem_intrnl.h"
 #include "vpx/vpx_integer.h"
+#include "vpx_ports/mem.h"
+#if CONFIG_MULTITHREAD
+#include "vpx_util/vpx_pthread.h"
+#endif
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+// The call site tracking macros would clash with the definitions below.
+#undef vpx_memalign
+#undef vpx_malloc
+#undef vpx_calloc
+#undef vpx_memalign_large
 
 #if !defined(VPX_MAX_ALLOCABLE_MEMORY)
 #if SIZE_MAX > (1ULL << 40)
@@ -25,6 +38,27 @@
 #endif
 #endif
 
+struct vpx_mem_allocator {
+  vpx_codec_mem_allocator_t callbacks;
+  vpx_codec_mem_stats_t stats;
+  int huge_pages;
+  // Set once the owner is done with the allocator. It is freed when its last
+  // block is.
+  int released;
+#if CONFIG_MULTITHREAD
+  pthread_mutex_t mutex;
+#endif
+};
+
+// Stored right before every block.
+typedef struct {
+  vpx_mem_allocator *allocator;
+  size_t size;
+  void *malloc_addr;
+} block_header;
+
+static VPX_THREAD_LOCAL vpx_mem_allocator *thread_allocator;
+
 // Returns 0 in case of overflow of nmemb * size.
 static int check_size_argument_overflow(uint64_t nmemb, uint64_t size) {
   const uint64_t total_size = nmemb * size;
@@ -35,52 +69,198 @@ static int check_size_argument_overflow(uint64_t nmemb, uint64_t size) {
   return 1;
 }
 
-static size_t *get_malloc_address_location(void *const mem) {
-  return ((size_t *)mem) - 1;
+static block_header *get_block_header(void *const mem) {
+  return ((block_header *)mem) - 1;
 }
 
 static uint64_t get_aligned_malloc_size(size_t size, size_t align) {
-  return (uint64_t)size + align - 1 + ADDRESS_STORAGE_SIZE;
+  return (uint64_t)size + align - 1 + sizeof(block_header);
 }
 
-static void set_actual_malloc_address(void *const mem,
-                                      const void *const malloc_addr) {
-  size_t *const malloc_addr_location = get_malloc_address_location(mem);
-  *malloc_addr_location = (size_t)malloc_addr;
+static void lock(vpx_mem_allocator *allocator) {
+#if CONFIG_MULTITHREAD
+  pthread_mutex_lock(&allocator->mutex);
+#else
+  (void)allocator;
+#endif
 }
 
-static void *get_actual_malloc_address(void *const mem) {
-  size_t *const malloc_addr_location = get_malloc_address_location(mem);
-  return (void *)(*malloc_addr_location);
+static void unlock(vpx_mem_allocator *allocator) {
+#if CONFIG_MULTITHREAD
+  pthread_mutex_unlock(&allocator->mutex);
+#else
+  (void)allocator;
+#endif
 }
 
-void *vpx_memalign(size_t align, size_t size) {
+static void destroy_allocator(vpx_mem_allocator *allocator) {
+#if CONFIG_MULTITHREAD
+  pthread_mutex_destroy(&allocator->mutex);
+#endif
+  free(allocator);
+}
+
+static void *allocate(vpx_mem_allocator *allocator, size_t size,
+                      const char *site) {
+  void *addr;
+  if (!allocator) return malloc(size);
+  if (allocator->callbacks.alloc_cb) {
+    addr = allocator->callbacks.alloc_cb(allocator->callbacks.priv, size, site);
+  } else {
+    addr = malloc(size);
+  }
+  if (!addr) {
+    lock(allocator);
+    ++allocator->stats.num_failed_allocs;
+    unlock(allocator);
+  }
+  return addr;
+}
+
+static void account_alloc(vpx_mem_allocator *allocator, size_t size) {
+  vpx_codec_mem_stats_t *const stats = &allocator->stats;
+  lock(allocator);
+  ++stats->num_allocs;
+  stats->bytes_in_use += size;
+  if (stats->bytes_in_use > stats->peak_bytes_in_use) {
+    stats->peak_bytes_in_use = stats->bytes_in_use;
+  }
+  unlock(allocator);
+}
+
+static void release(vpx_mem_allocator *allocator, void *addr, size_t size) {
+  int destroy;
+  if (allocator->callbacks.free_cb) {
+    allocator->callbacks.free_cb(allocator->callbacks.priv, addr);
+  } else {
+    free(addr);
+  }
+  lock(allocator);
+  ++allocator->stats.num_frees;
+  allocator->stats.bytes_in_use -= size;
+  destroy = allocator->released &&
+            allocator->stats.num_frees == allocator->stats.num_allocs;
+  unlock(allocator);
+  if (destroy) destroy_allocator(allocator);
+}
+
+void *vpx_memalign_at(size_t align, size_t size, const char *site) {
+  vpx_mem_allocator *const allocator = thread_allocator;
   void *x = NULL, *addr;
   const uint64_t aligned_size = get_aligned_malloc_size(size, align);
   if (!check_size_argument_overflow(1, aligned_size)) return NULL;
 
-  addr = malloc((size_t)aligned_size);
+  addr = allocate(allocator, (size_t)aligned_size, site);
   if (addr) {
-    x = align_addr((unsigned char *)addr + ADDRESS_STORAGE_SIZE, align);
-    set_actual_malloc_address(x, addr);
+    block_header *header;
+    x = align_addr((unsigned char *)addr + sizeof(block_header), align);
+    header = get_block_header(x);
+    header->allocator = allocator;
+    header->size = size;
+    header->malloc_addr = addr;
+    if (allocator) account_alloc(allocator, size);
   }
   return x;
 }
 
-void *vpx_malloc(size_t size) { return vpx_memalign(DEFAULT_ALIGNMENT, size); }
+void *vpx_malloc_at(size_t size, const char *site) {
+  return vpx_memalign_at(DEFAULT_ALIGNMENT, size, site);
+}
 
-void *vpx_calloc(size_t num, size_t size) {
+void *vpx_calloc_at(size_t num, size_t size, const char *site) {
   void *x;
   if (!check_size_argument_overflow(num, size)) return NULL;
 
-  x = vpx_malloc(num * size);
+  x = vpx_malloc_at(num * size, site);
   if (x) memset(x, 0, num * size);
   return x;
 }
 
+void *vpx_memalign(size_t align, size_t size) {
+  return vpx_memalign_at(align, size, NULL);
+}
+
+void *vpx_malloc(size_t size) { return vpx_malloc_at(size, NULL); }
+
+void *vpx_calloc(size_t num, size_t size) {
+  return vpx_calloc_at(num, size, NULL);
+}
+
+void *vpx_memalign_large_at(size_t align, size_t size, const char *site) {
+  const vpx_mem_allocator *const allocator = thread_allocator;
+  void *x;
+  if (!allocator || !allocator->huge_pages || size < VPX_HUGE_PAGE_SIZE) {
+    return vpx_memalign_at(align, size, site);
+  }
+#if defined(MADV_HUGEPAGE)
+  if (align < VPX_HUGE_PAGE_SIZE) align = VPX_HUGE_PAGE_SIZE;
+  x = vpx_memalign_at(align, size, site);
+  // Only whole huge pages can be collapsed, and the tail of the last one may
+  // belong to another block. Failure just means regular pages are used.
+  if (x) madvise(x, size & ~(size_t)(VPX_HUGE_PAGE_SIZE - 1), MADV_HUGEPAGE);
+#else
+  x = vpx_memalign_at(align, size, site);
+#endif
+  return x;
+}
+
+void *vpx_memalign_large(size_t align, size_t size) {
+  return vpx_memalign_large_at(align, size, NULL);
+}
+
 void vpx_free(void *memblk) {
   if (memblk) {
-    void *addr = get_actual_malloc_address(memblk);
-    free(addr);
+    const block_header *const header = get_block_header(memblk);
+    if (header->allocator) {
+      release(header->allocator, header->malloc_addr, header->size);
+    } else {
+      free(header->malloc_addr);
+    }
   }
 }
+
+vpx_mem_allocator *vpx_mem_allocator_create(
+    const vpx_codec_mem_allocator_t *callbacks) {
+  vpx_mem_allocator *const allocator =
+      (vpx_mem_allocator *)calloc(1, sizeof(*allocator));
+  if (!allocator) return NULL;
+  if (callbacks) allocator->callbacks = *callbacks;
+#if CONFIG_MULTITHREAD
+  if (pthread_mutex_init(&allocator->mutex, NULL)) {
+    free(allocator);
+    return NULL;
+  }
+#endif
+  return allocator;
+}
+
+void vpx_mem_allocator_release(vpx_mem_allocator *allocator) {
+  int destroy;
+  if (!allocator) return;
+  lock(allocator);
+  allocator->released = 1;
+  destroy = allocator->stats.num_frees == allocator->stats.num_allocs;
+  unlock(allocator);
+  if (destroy) destroy_allocator(allocator);
+}
+
+void vpx_mem_allocator_use_huge_pages(vpx_mem_allocator *allocator) {
+  allocator->huge_pages = 1;
+}
+
+void vpx_mem_allocator_get_stats(vpx_mem_allocator *allocator,
+                                 vpx_codec_mem_stats_t *stats) {
+  lock(allocator);
+  *stats = allocator->stats;
+  unlock(allocator);
+}
+
+vpx_mem_allocator *vpx_mem_set_thread_allocator(vpx_mem_allocator *allocator) {
+  vpx_mem_allocator *const prev = thread_allocator;
+  thread_allocator = allocator;
+  return prev;
+}
+
+vpx_mem_allocator *vpx_mem_get_thread_allocator(void) {
+  return thread_allocator;
+}
@@ -19,6 +19,7 @@
 #include <stdlib.h>
 #include <stddef.h>
 
+#include "vpx/vpx_codec.h"
 #include "vpx/vpx_integer.h"
 
 #if defined(__cplusplus)
@@ -30,6 +31,55 @@ void *vpx_malloc(size_t size);
 void *vpx_calloc(size_t num, size_t size);
 void vpx_free(void *memblk);
 
+// Variants that pass the call site on to the allocator callback.
+void *vpx_memalign_at(size_t align, size_t size, const char *site);
+void *vpx_malloc_at(size_t size, const char *site);
+void *vpx_calloc_at(size_t num, size_t size, const char *site);
+
+// For large, long lived buffers such as frames. If the allocator of the
+// calling thread uses huge pages, blocks of at least VPX_HUGE_PAGE_SIZE bytes
+// start on a huge page boundary and are advised to be backed by huge pages.
+// Released with vpx_free().
+void *vpx_memalign_large(size_t align, size_t size);
+void *vpx_memalign_large_at(size_t align, size_t size, const char *site);
+
+#define VPX_HUGE_PAGE_SIZE (2 << 20)
+
+#if defined(VPX_MEM_TRACK_CALL_SITES)
+#define VPX_MEM_STR_(x) #x
+#define VPX_MEM_STR(x) VPX_MEM_STR_(x)
+#define VPX_MEM_SITE __FILE__ ":" VPX_MEM_STR(__LINE__)
+#define vpx_memalign(align, size) vpx_memalign_at(align, size, VPX_MEM_SITE)
+#define vpx_malloc(size) vpx_malloc_at(size, VPX_MEM_SITE)
+#define vpx_calloc(num, size) vpx_calloc_at(num, size, VPX_MEM_SITE)
+#define vpx_memalign_large(align, size) \
+  vpx_memalign_large_at(align, size, VPX_MEM_SITE)
+#endif
+
+// Allocation bookkeeping of a codec instance. Blocks remember the allocator
+// they came from, so vpx_free() may be called from any thread.
+typedef struct vpx_mem_allocator vpx_mem_allocator;
+
+// Creates an allocator using the given callbacks, or malloc() and free() if
+// callbacks is NULL or both of them are NULL.
+vpx_mem_allocator *vpx_mem_allocator_create(
+    const vpx_codec_mem_allocator_t *callbacks);
+
+// Gives up the caller's reference. The allocator is destroyed once all of its
+// blocks are freed.
+void vpx_mem_allocator_release(vpx_mem_allocator *allocator);
+
+// Makes vpx_memalign_large() use huge pages for the blocks of allocator.
+void vpx_mem_allocator_use_huge_pages(vpx_mem_allocator *allocator);
+
+void vpx_mem_allocator_get_stats(vpx_mem_allocator *allocator,
+                                 vpx_codec_mem_stats_t *stats);
+
+// Makes the allocations of the calling thread go through allocator, NULL
+// meaning plain malloc() without bookkeeping. Returns the previous allocator.
+vpx_mem_allocator *vpx_mem_set_thread_allocator(vpx_mem_allocator *allocator);
+vpx_mem_allocator *vpx_mem_get_thread_allocator(void);
+
 #if CONFIG_VP9_HIGHBITDEPTH
 static INLINE void *vpx_memset16(void *dest, int val, size_t length) {
   size_t i;
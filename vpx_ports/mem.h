@@ -23,6 +23,14 @@
 #define DECLARE_ALIGNED(n, typ, val) typ val
 #endif
 
+#if !CONFIG_MULTITHREAD
+#define VPX_THREAD_LOCAL
+#elif defined(_MSC_VER)
+#define VPX_THREAD_LOCAL __declspec(thread)
+#else
+#define VPX_THREAD_LOCAL __thread
+#endif
+
 #if defined(__has_builtin)
 #define VPX_HAS_BUILTIN(x) __has_builtin(x)
 #else
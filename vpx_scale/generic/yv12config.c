@@ -63,7 +63,7 @@ int vp8_yv12_realloc_frame_buffer(YV12_BUFFER_CONFIG *ybf, int width,
     const size_t frame_size = yplane_size + 2 * uvplane_size;
 
     if (!ybf->buffer_alloc) {
-      ybf->buffer_alloc = (uint8_t *)vpx_memalign(32, frame_size);
+      ybf->buffer_alloc = (uint8_t *)vpx_memalign_large(32, frame_size);
       if (!ybf->buffer_alloc) {
         ybf->buffer_alloc_sz = 0;
         return -1;
@@ -234,7 +234,8 @@ int vpx_realloc_frame_buffer(YV12_BUFFER_CONFIG *ybf, int width, int height,
       ybf->buffer_alloc = NULL;
       ybf->buffer_alloc_sz = 0;
 
-      ybf->buffer_alloc = (uint8_t *)vpx_memalign(32, (size_t)frame_size);
+      ybf->buffer_alloc =
+          (uint8_t *)vpx_memalign_large(32, (size_t)frame_size);
       if (!ybf->buffer_alloc) return -1;
 
       ybf->buffer_alloc_sz = (size_t)frame_size;
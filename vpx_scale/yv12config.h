@@ -25,6 +25,9 @@ extern "C" {
 #define VP9_INTERP_EXTEND 4
 #define VP9_ENC_BORDER_IN_PIXELS 160
 #define VP9_DEC_BORDER_IN_PIXELS 32
+// Smallest border the VP9 encoder works with. A superblock on the bottom or
+// right edge of the frame covers up to 56 pixels outside of it.
+#define VP9_ENC_MIN_BORDER_IN_PIXELS 64
 
 typedef struct yv12_buffer_config {
   int y_width;
@@ -31,6 +31,8 @@ struct VPxWorkerImpl {
   pthread_mutex_t mutex_;
   pthread_cond_t condition_;
   pthread_t thread_;
+  // Allocator of the thread that started the worker.
+  vpx_mem_allocator *allocator_;
 };
 
 //------------------------------------------------------------------------------
@@ -39,6 +41,7 @@ static void execute(VPxWorker *const worker);  // Forward declaration.
 
 static THREADFN thread_loop(void *ptr) {
   VPxWorker *const worker = (VPxWorker *)ptr;
+  vpx_mem_set_thread_allocator(worker->impl_->allocator_);
 #ifdef __APPLE__
   if (worker->thread_name != NULL) {
     // Apple's version of pthread_setname_np takes one argument and operates on
@@ -137,6 +140,7 @@ static int reset(VPxWorker *const worker) {
     if (worker->impl_ == NULL) {
       return 0;
     }
+    worker->impl_->allocator_ = vpx_mem_get_thread_allocator();
     if (pthread_mutex_init(&worker->impl_->mutex_, NULL)) {
       goto Error;
     }